@@ -6,6 +6,8 @@
 #include <pybind11/eigen.h>
 
 #include "algorithms.hpp"
+#include <cstdint>
+#include <string>
 #include <proxsuite/proxqp/dense/utils.hpp>
 #include <proxsuite/helpers/version.hpp>
 
@@ -13,30 +15,32 @@ namespace proxsuite {
 namespace proxqp {
 namespace python {
 
+// the classes and functions instantiated with other scalar or index types
+// than f64 and int32_t are exposed with a suffix (e.g., QP_f32)
 template<typename T>
 void
-exposeCommon(pybind11::module_ m)
+exposeCommon(pybind11::module_ m, std::string const& suffix = "")
 {
-  exposeResults<T>(m);
-  exposeSettings<T>(m);
+  exposeResults<T>(m, suffix);
+  exposeSettings<T>(m, suffix);
 }
 
 template<typename T, typename I>
 void
-exposeSparseAlgorithms(pybind11::module_ m)
+exposeSparseAlgorithms(pybind11::module_ m, std::string const& suffix = "")
 {
-  sparse::python::exposeSparseModel<T, I>(m);
-  sparse::python::exposeQpObjectSparse<T, I>(m);
-  sparse::python::solveSparseQp<T, I>(m);
+  sparse::python::exposeSparseModel<T, I>(m, suffix);
+  sparse::python::exposeQpObjectSparse<T, I>(m, suffix);
+  sparse::python::solveSparseQp<T, I>(m, suffix);
 }
 
 template<typename T>
 void
-exposeDenseAlgorithms(pybind11::module_ m)
+exposeDenseAlgorithms(pybind11::module_ m, std::string const& suffix = "")
 {
-  dense::python::exposeDenseModel<T>(m);
-  dense::python::exposeQpObjectDense<T>(m);
-  dense::python::solveDenseQp<T>(m);
+  dense::python::exposeDenseModel<T>(m, suffix);
+  dense::python::exposeQpObjectDense<T>(m, suffix);
+  dense::python::solveDenseQp<T>(m, suffix);
 }
 
 PYBIND11_MODULE(PYTHON_MODULE_NAME, m)
@@ -54,13 +58,26 @@ PYBIND11_MODULE(PYTHON_MODULE_NAME, m)
 
   pybind11::module_ proxqp_module =
     m.def_submodule("proxqp", "The proxQP solvers of the proxSuite library");
+  // the enums are shared by all instantiations
+  exposeInitialGuessStatus(proxqp_module);
+  exposeSolverMethod(proxqp_module);
+  exposeQPSolverOutput(proxqp_module);
+  exposePhase(proxqp_module);
   exposeCommon<f64>(proxqp_module);
+  exposeCommon<f32>(proxqp_module, "_f32");
   pybind11::module_ dense_module =
     proxqp_module.def_submodule("dense", "Dense solver of proxQP");
+  dense::python::exposeModelStorage(dense_module);
+  dense::python::exposeKktMode(dense_module);
   exposeDenseAlgorithms<f64>(dense_module);
+  exposeDenseAlgorithms<f32>(dense_module, "_f32");
   pybind11::module_ sparse_module =
     proxqp_module.def_submodule("sparse", "Sparse solver of proxQP");
   exposeSparseAlgorithms<f64, int32_t>(sparse_module);
+  exposeSparseAlgorithms<f32, int32_t>(sparse_module, "_f32");
+  // int64_t indices avoid the overflow of the number of non zeros of the
+  // factorization of large KKT matrices
+  exposeSparseAlgorithms<f64, int64_t>(sparse_module, "_i64");
 
   // Add version
   m.attr("__version__") = helpers::printVersion();
@@ -5,21 +5,35 @@
 #include <proxsuite/proxqp/sparse/model.hpp>
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <string>
 #include <proxsuite/proxqp/dense/utils.hpp>
 
 namespace proxsuite {
 namespace proxqp {
 namespace dense {
 namespace python {
+inline void
+exposeModelStorage(pybind11::module_ m)
+{
+  ::pybind11::enum_<ModelStorage>(m, "ModelStorage", pybind11::module_local())
+    .value("OWNING", ModelStorage::OWNING)
+    .value("NON_OWNING", ModelStorage::NON_OWNING)
+    .export_values();
+}
+
 template<typename T>
 void
-exposeDenseModel(pybind11::module_ m)
+exposeDenseModel(pybind11::module_ m, std::string const& suffix = "")
 {
-  ::pybind11::class_<proxsuite::proxqp::dense::Model<T>>(m, "model")
-    .def(::pybind11::init<i64, i64, i64>(),
+  std::string class_name = "model" + suffix;
+  ::pybind11::class_<proxsuite::proxqp::dense::Model<T>>(m, class_name.c_str())
+    .def(::pybind11::init<i64, i64, i64, ModelStorage>(),
          pybind11::arg_v("n", 0, "primal dimension."),
          pybind11::arg_v("n_eq", 0, "number of equality constraints."),
          pybind11::arg_v("n_in", 0, "number of inequality constraints."),
+         pybind11::arg_v("storage",
+                         ModelStorage::OWNING,
+                         "storage policy of the matrices of the model."),
          "Constructor using QP model dimensions.") // constructor)
     .def_readonly("H", &Model<T>::H)
     .def_readonly("g", &Model<T>::g)
@@ -31,7 +45,8 @@ exposeDenseModel(pybind11::module_ m)
     .def_readonly("dim", &Model<T>::dim)
     .def_readonly("n_eq", &Model<T>::n_eq)
     .def_readonly("n_in", &Model<T>::n_in)
-    .def_readonly("n_total", &Model<T>::n_total);
+    .def_readonly("n_total", &Model<T>::n_total)
+    .def_readonly("storage", &Model<T>::storage);
 }
 } // namespace python
 } // namespace dense
@@ -40,9 +55,11 @@ namespace sparse {
 namespace python {
 template<typename T, typename I>
 void
-exposeSparseModel(pybind11::module_ m)
+exposeSparseModel(pybind11::module_ m, std::string const& suffix = "")
 {
-  ::pybind11::class_<proxsuite::proxqp::sparse::Model<T, I>>(m, "model")
+  std::string class_name = "model" + suffix;
+  ::pybind11::class_<proxsuite::proxqp::sparse::Model<T, I>>(
+    m, class_name.c_str())
     .def(::pybind11::init<i64, i64, i64>(),
          pybind11::arg_v("n", 0, "primal dimension."),
          pybind11::arg_v("n_eq", 0, "number of equality constraints."),
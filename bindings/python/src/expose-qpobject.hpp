@@ -7,7 +7,9 @@
 #include <proxsuite/proxqp/status.hpp>
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include <string>
 
 namespace proxsuite {
 namespace proxqp {
@@ -19,14 +21,20 @@ namespace python {
 
 template<typename T>
 void
-exposeQpObjectDense(pybind11::module_ m)
+exposeQpObjectDense(pybind11::module_ m, std::string const& suffix = "")
 {
-
-  ::pybind11::class_<dense::QP<T>>(m, "QP")
-    .def(::pybind11::init<i64, i64, i64>(),
+  std::string class_name = "QP" + suffix;
+  ::pybind11::class_<dense::QP<T>>(m, class_name.c_str())
+    .def(::pybind11::init<i64, i64, i64, ModelStorage, KktMode>(),
          pybind11::arg_v("n", 0, "primal dimension."),
          pybind11::arg_v("n_eq", 0, "number of equality constraints."),
          pybind11::arg_v("n_in", 0, "number of inequality constraints."),
+         pybind11::arg_v("storage",
+                         ModelStorage::OWNING,
+                         "storage policy of the matrices of the model."),
+         pybind11::arg_v("kkt_mode",
+                         KktMode::AUTOMATIC,
+                         "linear system factorized by the solver."),
          "Default constructor using QP model dimensions.") // constructor
     .def_readwrite(
       "results",
@@ -113,16 +121,37 @@ exposeQpObjectDense(pybind11::module_ m)
                                             std::optional<dense::VecRef<T>> z)>(
            &dense::QP<T>::solve),
          "function used for solving the QP problem, when passing a warm start.")
+    .def("begin_solve",
+         &dense::QP<T>::begin_solve,
+         "function used for starting a step-wise solve of the QP problem.")
+    .def("step",
+         &dense::QP<T>::step,
+         "function used for running iterations of a step-wise solve, until "
+         "it is done or max_inner_iters inner iterations have been run. "
+         "It returns whether the solve is done.",
+         pybind11::arg("max_inner_iters"))
+    .def("is_done",
+         &dense::QP<T>::is_done,
+         "function returning whether the step-wise solve is done.")
+    .def_property_readonly(
+      "factorization_cache_hits",
+      [](const dense::QP<T>& qp) { return qp.factorization_cache().hits(); },
+      "number of solves whose factorization was restored from the "
+      "factorization cache.")
+    .def_property_readonly(
+      "factorization_cache_misses",
+      [](const dense::QP<T>& qp) { return qp.factorization_cache().misses(); },
+      "number of solves whose factorization was computed anew.")
 
     .def(
       "update",
       static_cast<void (dense::QP<T>::*)(std::optional<dense::MatRef<T>>,
-                                         std::optional<dense::Vec<T>>,
+                                         std::optional<dense::VecRef<T>>,
                                          std::optional<dense::MatRef<T>>,
-                                         std::optional<dense::Vec<T>>,
+                                         std::optional<dense::VecRef<T>>,
                                          std::optional<dense::MatRef<T>>,
-                                         std::optional<dense::Vec<T>>,
-                                         std::optional<dense::Vec<T>>,
+                                         std::optional<dense::VecRef<T>>,
+                                         std::optional<dense::VecRef<T>>,
                                          bool update_preconditioner,
                                          std::optional<T>,
                                          std::optional<T>,
@@ -152,12 +181,12 @@ exposeQpObjectDense(pybind11::module_ m)
       "update",
       static_cast<void (dense::QP<T>::*)(
         const std::optional<dense::SparseMat<T>>,
-        std::optional<dense::Vec<T>>,
+        std::optional<dense::VecRef<T>>,
         const std::optional<dense::SparseMat<T>>,
-        std::optional<dense::Vec<T>>,
+        std::optional<dense::VecRef<T>>,
         const std::optional<dense::SparseMat<T>>,
-        std::optional<dense::Vec<T>>,
-        std::optional<dense::Vec<T>>,
+        std::optional<dense::VecRef<T>>,
+        std::optional<dense::VecRef<T>>,
         bool update_preconditioner,
         std::optional<T>,
         std::optional<T>,
@@ -194,12 +223,116 @@ namespace sparse {
 
 namespace python {
 
+/*!
+ * Views the buffers of a scipy.sparse matrix as a compressed sparse column
+ * matrix, without copying them: a csc_matrix is viewed as is, and a csr_matrix
+ * as its transpose. Returns nullopt when the storage of the matrix does not
+ * match the one of the solver (format, scalar or index types, non canonical
+ * indices).
+ * @param mat scipy.sparse matrix.
+ * @param transpose whether the transpose of the matrix is viewed.
+ */
 template<typename T, typename I>
-void
-exposeQpObjectSparse(pybind11::module_ m)
+auto
+view_compressed_columns(pybind11::handle mat, bool transpose)
+  -> std::optional<proxsuite::linalg::sparse::MatRef<T, I>>
+{
+  using ValArray = pybind11::array_t<T, pybind11::array::c_style>;
+  using IdxArray = pybind11::array_t<I, pybind11::array::c_style>;
+
+  if (!pybind11::hasattr(mat, "format") ||
+      mat.attr("format").cast<std::string>() != (transpose ? "csr" : "csc") ||
+      !mat.attr("has_canonical_format").cast<bool>()) {
+    return std::nullopt;
+  }
+  pybind11::object data = mat.attr("data");
+  pybind11::object indices = mat.attr("indices");
+  pybind11::object indptr = mat.attr("indptr");
+  if (!ValArray::check_(data) || !IdxArray::check_(indices) ||
+      !IdxArray::check_(indptr)) {
+    return std::nullopt;
+  }
+  auto shape = mat.attr("shape").cast<std::pair<isize, isize>>();
+  isize nrows = transpose ? shape.second : shape.first;
+  isize ncols = transpose ? shape.first : shape.second;
+  I const* col_ptrs = pybind11::reinterpret_borrow<IdxArray>(indptr).data();
+  return proxsuite::linalg::sparse::MatRef<T, I>{
+    proxsuite::linalg::sparse::from_raw_parts,
+    nrows,
+    ncols,
+    isize(col_ptrs[ncols]),
+    col_ptrs,
+    nullptr,
+    pybind11::reinterpret_borrow<IdxArray>(indices).data(),
+    pybind11::reinterpret_borrow<ValArray>(data).data(),
+  };
+}
+/*!
+ * Views of the matrices given to init or update in the storage format of the
+ * solver (upper triangular part of H, transposes of A and C). zero_copy is
+ * false when one of the matrices has to be converted.
+ */
+template<typename T, typename I>
+struct MatrixViews
 {
+  std::optional<proxsuite::linalg::sparse::MatRef<T, I>> H_triu;
+  std::optional<proxsuite::linalg::sparse::MatRef<T, I>> AT;
+  std::optional<proxsuite::linalg::sparse::MatRef<T, I>> CT;
+  bool zero_copy = true;
 
-  ::pybind11::class_<sparse::QP<T, I>>(m, "QP") //,pybind11::module_local()
+  MatrixViews(std::optional<pybind11::object> const& H,
+              std::optional<pybind11::object> const& A,
+              std::optional<pybind11::object> const& C)
+  {
+    if (H != std::nullopt) {
+      H_triu = view_compressed_columns<T, I>(H.value(), false);
+      zero_copy = zero_copy && H_triu != std::nullopt;
+      if (H_triu != std::nullopt) {
+        // the row indices being sorted, only the last one of each column is
+        // checked
+        auto const& m = H_triu.value();
+        for (isize j = 0; j < m.ncols(); ++j) {
+          usize col_end = m.col_end(j);
+          if (col_end > m.col_start(j) &&
+              isize(m.row_indices()[col_end - 1]) > j) {
+            zero_copy = false;
+            break;
+          }
+        }
+      }
+    }
+    if (A != std::nullopt) {
+      AT = view_compressed_columns<T, I>(A.value(), true);
+      zero_copy = zero_copy && AT != std::nullopt;
+    }
+    if (C != std::nullopt) {
+      CT = view_compressed_columns<T, I>(C.value(), true);
+      zero_copy = zero_copy && CT != std::nullopt;
+    }
+  }
+};
+/*!
+ * Converts a matrix (scipy.sparse or dense) to the sparse matrix type of the
+ * solver.
+ */
+template<typename T, typename I>
+auto
+to_sparse(std::optional<pybind11::object> const& mat)
+  -> std::optional<sparse::SparseMat<T, I>>
+{
+  if (mat == std::nullopt) {
+    return std::nullopt;
+  }
+  return mat.value().cast<sparse::SparseMat<T, I>>();
+}
+
+template<typename T, typename I>
+void
+exposeQpObjectSparse(pybind11::module_ m, std::string const& suffix = "")
+{
+  std::string class_name = "QP" + suffix;
+  ::pybind11::class_<sparse::QP<T, I>>(
+    m, class_name.c_str()) //,pybind11::module_local()
     .def(::pybind11::init<i64, i64, i64>(),
          pybind11::arg_v("n", 0, "primal dimension."),
          pybind11::arg_v("n_eq", 0, "number of equality constraints."),
@@ -227,9 +360,49 @@ exposeQpObjectSparse(pybind11::module_ m)
                    "class with settings option of the solver.")
     .def(
       "init",
-      &sparse::QP<T, I>::init,
+      [](sparse::QP<T, I>& qp,
+         std::optional<pybind11::object> H,
+         std::optional<sparse::VecRef<T>> g,
+         std::optional<pybind11::object> A,
+         std::optional<sparse::VecRef<T>> b,
+         std::optional<pybind11::object> C,
+         std::optional<sparse::VecRef<T>> u,
+         std::optional<sparse::VecRef<T>> l,
+         bool compute_preconditioner,
+         std::optional<T> rho,
+         std::optional<T> mu_eq,
+         std::optional<T> mu_in) {
+        MatrixViews<T, I> views(H, A, C);
+        if (views.zero_copy) {
+          qp.init(views.H_triu,
+                  g,
+                  views.AT,
+                  b,
+                  views.CT,
+                  u,
+                  l,
+                  compute_preconditioner,
+                  rho,
+                  mu_eq,
+                  mu_in);
+        } else {
+          qp.init(to_sparse<T, I>(H),
+                  g,
+                  to_sparse<T, I>(A),
+                  b,
+                  to_sparse<T, I>(C),
+                  u,
+                  l,
+                  compute_preconditioner,
+                  rho,
+                  mu_eq,
+                  mu_in);
+        }
+      },
       "function for initializing the model when passing sparse matrices in "
-      "entry.",
+      "entry. The buffers of H (upper triangular csc_matrix), A and C "
+      "(csr_matrix) are read in place when their scalar and index types match "
+      "the ones of the solver, otherwise the matrices are converted.",
       pybind11::arg_v("H", std::nullopt, "quadratic cost"),
       pybind11::arg_v("g", std::nullopt, "linear cost"),
       pybind11::arg_v("A", std::nullopt, "equality constraint matrix"),
@@ -247,11 +420,99 @@ exposeQpObjectSparse(pybind11::module_ m)
       pybind11::arg_v(
         "mu_in", std::nullopt, "dual inequality constraint proximal parameter"))
 
+    .def(
+      "init_least_squares",
+      [](sparse::QP<T, I>& qp,
+         pybind11::object J,
+         sparse::VecRef<T> r,
+         std::optional<sparse::VecRef<T>> g,
+         std::optional<pybind11::object> A,
+         std::optional<sparse::VecRef<T>> b,
+         std::optional<pybind11::object> C,
+         std::optional<sparse::VecRef<T>> u,
+         std::optional<sparse::VecRef<T>> l,
+         bool compute_preconditioner,
+         std::optional<T> rho,
+         std::optional<T> mu_eq,
+         std::optional<T> mu_in) {
+        qp.init_least_squares(J.cast<sparse::SparseMat<T, I>>(),
+                              r,
+                              g,
+                              to_sparse<T, I>(A),
+                              b,
+                              to_sparse<T, I>(C),
+                              u,
+                              l,
+                              compute_preconditioner,
+                              rho,
+                              mu_eq,
+                              mu_in);
+      },
+      "function for initializing the model with the least-squares cost "
+      "1/2 ||J x - r||^2 + g^T x, without forming J^T J.",
+      pybind11::arg("J"),
+      pybind11::arg("r"),
+      pybind11::arg_v("g", std::nullopt, "linear cost"),
+      pybind11::arg_v("A", std::nullopt, "equality constraint matrix"),
+      pybind11::arg_v("b", std::nullopt, "equality constraint vector"),
+      pybind11::arg_v("C", std::nullopt, "inequality constraint matrix"),
+      pybind11::arg_v("u", std::nullopt, "upper inequality constraint vector"),
+      pybind11::arg_v("l", std::nullopt, "lower inequality constraint vector"),
+      pybind11::arg_v("compute_preconditioner",
+                      true,
+                      "execute the preconditioner for reducing "
+                      "ill-conditioning and speeding up solver execution."),
+      pybind11::arg_v("rho", std::nullopt, "primal proximal parameter"),
+      pybind11::arg_v(
+        "mu_eq", std::nullopt, "dual equality constraint proximal parameter"),
+      pybind11::arg_v(
+        "mu_in", std::nullopt, "dual inequality constraint proximal parameter"))
+
     .def(
       "update",
-      &sparse::QP<T, I>::update,
+      [](sparse::QP<T, I>& qp,
+         std::optional<pybind11::object> H,
+         std::optional<sparse::VecRef<T>> g,
+         std::optional<pybind11::object> A,
+         std::optional<sparse::VecRef<T>> b,
+         std::optional<pybind11::object> C,
+         std::optional<sparse::VecRef<T>> u,
+         std::optional<sparse::VecRef<T>> l,
+         bool update_preconditioner,
+         std::optional<T> rho,
+         std::optional<T> mu_eq,
+         std::optional<T> mu_in) {
+        MatrixViews<T, I> views(H, A, C);
+        if (views.zero_copy) {
+          qp.update(views.H_triu,
+                    g,
+                    views.AT,
+                    b,
+                    views.CT,
+                    u,
+                    l,
+                    update_preconditioner,
+                    rho,
+                    mu_eq,
+                    mu_in);
+        } else {
+          qp.update(to_sparse<T, I>(H),
+                    g,
+                    to_sparse<T, I>(A),
+                    b,
+                    to_sparse<T, I>(C),
+                    u,
+                    l,
+                    update_preconditioner,
+                    rho,
+                    mu_eq,
+                    mu_in);
+        }
+      },
       "function for updating the model when passing sparse matrices in "
-      "entry.",
+      "entry. The buffers of H (upper triangular csc_matrix), A and C "
+      "(csr_matrix) are read in place when their scalar and index types match "
+      "the ones of the solver, otherwise the matrices are converted.",
       pybind11::arg_v("H", std::nullopt, "quadratic cost"),
       pybind11::arg_v("g", std::nullopt, "linear cost"),
       pybind11::arg_v("A", std::nullopt, "equality constraint matrix"),
@@ -278,6 +539,31 @@ exposeQpObjectSparse(pybind11::module_ m)
            std::optional<sparse::VecRef<T>> y,
            std::optional<sparse::VecRef<T>> z)>(&sparse::QP<T, I>::solve),
          "function used for solving the QP problem, when passing a warm start.")
+    .def("begin_solve",
+         &sparse::QP<T, I>::begin_solve,
+         "function used for starting a step-wise solve of the QP problem.")
+    .def("step",
+         &sparse::QP<T, I>::step,
+         "function used for running iterations of a step-wise solve, until "
+         "it is done or max_inner_iters inner iterations have been run. "
+         "It returns whether the solve is done.",
+         pybind11::arg("max_inner_iters"))
+    .def("is_done",
+         &sparse::QP<T, I>::is_done,
+         "function returning whether the step-wise solve is done.")
+    .def_property_readonly(
+      "factorization_cache_hits",
+      [](const sparse::QP<T, I>& qp) {
+        return qp.factorization_cache().hits();
+      },
+      "number of solves whose factorization was restored from the "
+      "factorization cache.")
+    .def_property_readonly(
+      "factorization_cache_misses",
+      [](const sparse::QP<T, I>& qp) {
+        return qp.factorization_cache().misses();
+      },
+      "number of solves whose factorization was computed anew.")
     .def("cleanup",
          &sparse::QP<T, I>::cleanup,
          "function used for cleaning the result "
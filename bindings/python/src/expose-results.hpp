@@ -4,6 +4,7 @@
 #include <proxsuite/proxqp/results.hpp>
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <string>
 
 #include "helpers.hpp"
 
@@ -11,9 +12,8 @@ namespace proxsuite {
 namespace proxqp {
 namespace python {
 
-template<typename T>
-void
-exposeResults(pybind11::module_ m)
+inline void
+exposeQPSolverOutput(pybind11::module_ m)
 {
   ::pybind11::enum_<QPSolverOutput>(
     m, "QPSolverOutput", pybind11::module_local())
@@ -21,9 +21,40 @@ exposeResults(pybind11::module_ m)
     .value("PROXQP_MAX_ITER_REACHED", QPSolverOutput::PROXQP_MAX_ITER_REACHED)
     .value("PROXQP_PRIMAL_INFEASIBLE", QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE)
     .value("PROXQP_DUAL_INFEASIBLE", QPSolverOutput::PROXQP_DUAL_INFEASIBLE)
+    .value("PROXQP_TIME_LIMIT_REACHED",
+           QPSolverOutput::PROXQP_TIME_LIMIT_REACHED)
+    .export_values();
+}
+
+inline void
+exposePhase(pybind11::module_ m)
+{
+  ::pybind11::enum_<Phase>(m, "Phase", pybind11::module_local())
+    .value("EQUILIBRATION", Phase::EQUILIBRATION)
+    .value("FACTORIZATION", Phase::FACTORIZATION)
+    .value("REFACTORIZATION", Phase::REFACTORIZATION)
+    .value("ACTIVE_SET_UPDATE", Phase::ACTIVE_SET_UPDATE)
+    .value("ITERATIVE_REFINEMENT", Phase::ITERATIVE_REFINEMENT)
+    .value("LINE_SEARCH", Phase::LINE_SEARCH)
+    .value("RESIDUALS", Phase::RESIDUALS)
+    .value("POLISH", Phase::POLISH)
     .export_values();
+}
+
+template<typename T>
+void
+exposeResults(pybind11::module_ m, std::string const& suffix = "")
+{
+  std::string phase_timings_name = "PhaseTimings" + suffix;
+  ::pybind11::class_<PhaseTimings<T>>(
+    m, phase_timings_name.c_str(), pybind11::module_local())
+    .def("time",
+         &PhaseTimings<T>::time,
+         "Cumulative time spent in a phase (in microseconds).")
+    .def("count", &PhaseTimings<T>::count, "Number of calls of a phase.");
 
-  ::pybind11::class_<Info<T>>(m, "Info", pybind11::module_local())
+  std::string info_name = "Info" + suffix;
+  ::pybind11::class_<Info<T>>(m, info_name.c_str(), pybind11::module_local())
     .def(::pybind11::init(), "Default constructor.")
     .def_readwrite("mu_eq", &Info<T>::mu_eq)
     .def_readwrite("mu_in", &Info<T>::mu_in)
@@ -38,9 +69,13 @@ exposeResults(pybind11::module_ m)
     .def_readwrite("objValue", &Info<T>::objValue)
     .def_readwrite("status", &Info<T>::status)
     .def_readwrite("rho_updates", &Info<T>::rho_updates)
-    .def_readwrite("mu_updates", &Info<T>::mu_updates);
+    .def_readwrite("mu_updates", &Info<T>::mu_updates)
+    .def_readwrite("polished", &Info<T>::polished)
+    .def_readwrite("phase_timings", &Info<T>::phase_timings);
 
-  ::pybind11::class_<Results<T>>(m, "Results", pybind11::module_local())
+  std::string results_name = "Results" + suffix;
+  ::pybind11::class_<Results<T>>(
+    m, results_name.c_str(), pybind11::module_local())
     .def(::pybind11::init<i64, i64, i64>(),
          pybind11::arg_v("n", 0, "primal dimension."),
          pybind11::arg_v("n_eq", 0, "number of equality constraints."),
@@ -5,15 +5,14 @@
 #include <proxsuite/proxqp/status.hpp>
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <string>
 
 namespace proxsuite {
 namespace proxqp {
 namespace python {
-template<typename T>
-void
-exposeSettings(pybind11::module_ m)
+inline void
+exposeInitialGuessStatus(pybind11::module_ m)
 {
-
   ::pybind11::enum_<InitialGuessStatus>(
     m, "InitialGuess", pybind11::module_local())
     .value("NO_INITIAL_GUESS", InitialGuessStatus::NO_INITIAL_GUESS)
@@ -25,8 +24,24 @@ exposeSettings(pybind11::module_ m)
     .value("COLD_START_WITH_PREVIOUS_RESULT",
            InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT)
     .export_values();
+}
 
-  ::pybind11::class_<Settings<T>>(m, "Settings", pybind11::module_local())
+inline void
+exposeSolverMethod(pybind11::module_ m)
+{
+  ::pybind11::enum_<SolverMethod>(m, "SolverMethod", pybind11::module_local())
+    .value("PROXQP", SolverMethod::PROXQP)
+    .value("INTERIOR_POINT", SolverMethod::INTERIOR_POINT)
+    .export_values();
+}
+
+template<typename T>
+void
+exposeSettings(pybind11::module_ m, std::string const& suffix = "")
+{
+  std::string class_name = "Settings" + suffix;
+  ::pybind11::class_<Settings<T>>(
+    m, class_name.c_str(), pybind11::module_local())
     .def(::pybind11::init(), "Default constructor.") // constructor
     .def_readwrite("alpha_bcl", &Settings<T>::alpha_bcl)
     .def_readwrite("beta_bcl", &Settings<T>::beta_bcl)
@@ -57,7 +72,20 @@ exposeSettings(pybind11::module_ m)
                    &Settings<T>::compute_preconditioner)
     .def_readwrite("update_preconditioner", &Settings<T>::update_preconditioner)
     .def_readwrite("verbose", &Settings<T>::verbose)
-    .def_readwrite("bcl_update", &Settings<T>::bcl_update);
+    .def_readwrite("bcl_update", &Settings<T>::bcl_update)
+    .def_readwrite("decompose_separable_blocks",
+                   &Settings<T>::decompose_separable_blocks)
+    .def_readwrite("nb_threads", &Settings<T>::nb_threads)
+    .def_readwrite("polish", &Settings<T>::polish)
+    .def_readwrite("polish_eps_abs", &Settings<T>::polish_eps_abs)
+    .def_readwrite("polish_refine_iter", &Settings<T>::polish_refine_iter)
+    .def_readwrite("anderson_acceleration",
+                   &Settings<T>::anderson_acceleration)
+    .def_readwrite("anderson_memory", &Settings<T>::anderson_memory)
+    .def_readwrite("method", &Settings<T>::method)
+    .def_readwrite("time_limit", &Settings<T>::time_limit)
+    .def_readwrite("factorization_cache_max_bytes",
+                   &Settings<T>::factorization_cache_max_bytes);
 }
 } // namespace python
 } // namespace proxqp
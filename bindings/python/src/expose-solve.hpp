@@ -6,6 +6,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
 #include <pybind11/stl.h>
+#include <string>
 
 namespace proxsuite {
 namespace proxqp {
@@ -16,10 +17,11 @@ namespace python {
 
 template<typename T>
 void
-solveDenseQp(pybind11::module_ m)
+solveDenseQp(pybind11::module_ m, std::string const& suffix = "")
 {
+  std::string function_name = "solve" + suffix;
   m.def(
-    "solve",
+    function_name.c_str(),
     pybind11::overload_cast<std::optional<dense::MatRef<T>>,
                             std::optional<dense::VecRef<T>>,
                             std::optional<dense::MatRef<T>>,
@@ -85,7 +87,7 @@ solveDenseQp(pybind11::module_ m)
       proxsuite::proxqp::InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS,
       "maximum number of iteration."));
   m.def(
-    "solve",
+    function_name.c_str(),
     pybind11::overload_cast<std::optional<dense::SparseMat<T>>,
                             std::optional<dense::VecRef<T>>,
                             std::optional<dense::SparseMat<T>>,
@@ -160,11 +162,11 @@ namespace python {
 
 template<typename T, typename I>
 void
-solveSparseQp(pybind11::module_ m)
+solveSparseQp(pybind11::module_ m, std::string const& suffix = "")
 {
-
+  std::string function_name = "solve" + suffix;
   m.def(
-    "solve",
+    function_name.c_str(),
     &sparse::solve<T, I>,
     "Function for solving a QP problem using PROXQP dense backend directly "
     "without defining a QP object. It is possible to set up some of the solver "
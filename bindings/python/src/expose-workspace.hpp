@@ -10,16 +10,32 @@ namespace proxsuite {
 namespace proxqp {
 namespace dense {
 namespace python {
+inline void
+exposeKktMode(pybind11::module_ m)
+{
+  ::pybind11::enum_<KktMode>(m, "KktMode", pybind11::module_local())
+    .value("AUTOMATIC", KktMode::AUTOMATIC)
+    .value("AUGMENTED", KktMode::AUGMENTED)
+    .value("CONDENSED", KktMode::CONDENSED)
+    .value("DUAL", KktMode::DUAL)
+    .value("BANDED", KktMode::BANDED)
+    .export_values();
+}
+
 template<typename T>
 void
 exposeWorkspaceDense(pybind11::module_ m)
 {
   ::pybind11::class_<Workspace<T>>(m, "Workspace")
-    .def(::pybind11::init<i64, i64, i64>(),
+    .def(::pybind11::init<i64, i64, i64, KktMode>(),
          pybind11::arg_v("n", 0, "primal dimension."),
          pybind11::arg_v("n_eq", 0, "number of equality constraints."),
          pybind11::arg_v("n_in", 0, "number of inequality constraints."),
+         pybind11::arg_v("kkt_mode",
+                         KktMode::AUTOMATIC,
+                         "linear system factorized by the solver."),
          "Constructor using QP model dimensions.") // constructor)
+    .def_readonly("kkt_mode", &Workspace<T>::kkt_mode)
     .def_readonly("H_scaled", &Workspace<T>::H_scaled)
     .def_readonly("g_scaled", &Workspace<T>::g_scaled)
     .def_readonly("A_scaled", &Workspace<T>::A_scaled)
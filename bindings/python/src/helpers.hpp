@@ -4,10 +4,15 @@
 #ifndef proxsuite_python_helpers_hpp
 #define proxsuite_python_helpers_hpp
 
+// The getter returns a reference, so that pybind11 exposes the field as a
+// NumPy array viewing the C++ storage (kept alive by the owning object)
+// instead of a copy.
 #define PROXSUITE_PYTHON_EIGEN_READWRITE(class, field_name, doc)               \
   def_property(                                                                \
     #field_name,                                                               \
-    [](class& self) { return self.field_name; },                               \
+    [](class& self) -> decltype(class ::field_name)& {                         \
+      return self.field_name;                                                  \
+    },                                                                         \
     [](class& self, const decltype(class ::field_name)& value) {               \
       self.field_name = value;                                                 \
     },                                                                         \
@@ -0,0 +1,90 @@
+#include <proxsuite/proxqp/dense/dense.hpp> // load the dense solver backend
+#include <proxsuite/proxqp/sparse/sparse.hpp> // load the sparse solver backend
+#include <proxsuite/proxqp/utils/random_qp_problems.hpp> // used for generating a random convex Qp
+
+using namespace proxsuite::proxqp;
+using T = double;
+int
+main()
+{
+  isize dim = 200;
+  isize n_eq(dim / 4);
+  isize n_in(dim / 4);
+  isize n_problems = 20;
+  // generate a random qp
+  T sparsity_factor(0.15);
+  T strong_convexity_factor(1.e-2);
+  dense::Model<T> qp = utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  // derive the scaling variables once for the problem family
+  dense::QP<T> Qp(dim, n_eq, n_in);
+  Qp.settings.compute_timings = true;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  T setup_time_ruiz = 0;
+  T setup_time_loaded = 0;
+  for (isize i = 0; i < n_problems; ++i) {
+    // only the linear cost changes between the problems of the family
+    auto g = utils::rand::vector_rand<T>(dim);
+    dense::QP<T> Qp_ruiz(dim, n_eq, n_in); // executes the equilibration
+    Qp_ruiz.settings.compute_timings = true;
+    Qp_ruiz.init(qp.H, g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    setup_time_ruiz += Qp_ruiz.results.info.setup_time;
+
+    dense::QP<T> Qp_loaded(dim, n_eq, n_in); // re-uses the scaling variables
+    Qp_loaded.settings.compute_timings = true;
+    Qp_loaded.load_preconditioner(Qp.ruiz.delta, Qp.ruiz.c);
+    Qp_loaded.init(qp.H, g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    setup_time_loaded += Qp_loaded.results.info.setup_time;
+  }
+  std::cout << "dense backend, mean setup time (in microseconds) with ruiz "
+               "equilibration: "
+            << setup_time_ruiz / T(n_problems)
+            << ", with loaded preconditioner: "
+            << setup_time_loaded / T(n_problems) << std::endl;
+
+  // same with the sparse backend
+  sparse::SparseModel<T> sparse_qp = utils::sparse_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+  sparse::QP<T, isize> Qp_sparse(dim, n_eq, n_in);
+  Qp_sparse.settings.compute_timings = true;
+  Qp_sparse.init(sparse_qp.H,
+                 sparse_qp.g,
+                 sparse_qp.A,
+                 sparse_qp.b,
+                 sparse_qp.C,
+                 sparse_qp.u,
+                 sparse_qp.l);
+  setup_time_ruiz = 0;
+  setup_time_loaded = 0;
+  for (isize i = 0; i < n_problems; ++i) {
+    auto g = utils::rand::vector_rand<T>(dim);
+    sparse::QP<T, isize> Qp_ruiz(dim, n_eq, n_in);
+    Qp_ruiz.settings.compute_timings = true;
+    Qp_ruiz.init(sparse_qp.H,
+                 g,
+                 sparse_qp.A,
+                 sparse_qp.b,
+                 sparse_qp.C,
+                 sparse_qp.u,
+                 sparse_qp.l);
+    setup_time_ruiz += Qp_ruiz.results.info.setup_time;
+
+    sparse::QP<T, isize> Qp_loaded(dim, n_eq, n_in);
+    Qp_loaded.settings.compute_timings = true;
+    Qp_loaded.load_preconditioner(Qp_sparse.ruiz.delta, Qp_sparse.ruiz.c);
+    Qp_loaded.init(sparse_qp.H,
+                   g,
+                   sparse_qp.A,
+                   sparse_qp.b,
+                   sparse_qp.C,
+                   sparse_qp.u,
+                   sparse_qp.l);
+    setup_time_loaded += Qp_loaded.results.info.setup_time;
+  }
+  std::cout << "sparse backend, mean setup time (in microseconds) with ruiz "
+               "equilibration: "
+            << setup_time_ruiz / T(n_problems)
+            << ", with loaded preconditioner: "
+            << setup_time_loaded / T(n_problems) << std::endl;
+}
@@ -0,0 +1,274 @@
+/** \file */
+//
+// Copyright (c) 2022 INRIA
+//
+#ifndef PROXSUITE_LINALG_DENSE_LDLT_BAND_LDLT_HPP
+#define PROXSUITE_LINALG_DENSE_LDLT_BAND_LDLT_HPP
+
+#include "proxsuite/linalg/dense/core.hpp"
+#include <proxsuite/linalg/veg/vec.hpp>
+#include <Eigen/Core>
+#include <algorithm>
+
+namespace proxsuite {
+namespace linalg {
+namespace dense {
+/*!
+ * Wrapper class that handles an allocated LDLT decomposition of a symmetric
+ * band matrix, without permutation.
+ * When provided with a matrix `A` whose coefficients `A(i, j)` vanish for
+ * `|i - j| > bw`, this internally stores a lower triangular matrix with unit
+ * diagonal `L` and the same bandwidth, and a vector `D`, such that
+ * `A = L diag(D) L.T`. The decomposition costs `O(n bw²)` operations and a
+ * solve `O(n bw)` operations.
+ *
+ * The rows of `L` only depend on the previous rows of `A`: after modifying
+ * the rows of `A` from the index `p` on, the decomposition is updated by
+ * refactorizing these rows only. As no pivoting is performed, the matrix is
+ * expected to be quasi-definite (e.g., a regularized KKT matrix).
+ *
+ * Example usage:
+ * ```cpp
+#include <proxsuite/linalg/dense/band_ldlt.hpp>
+
+auto main() -> int {
+        using Vector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+        using BandLdlt = proxsuite::linalg::dense::BandLdlt<double>;
+
+        // tridiagonal matrix
+        // 2.0 1.0 0.0
+        // 1.0 2.0 1.0
+        // 0.0 1.0 2.0
+        BandLdlt ldl;
+        ldl.reset(3, 1);
+        for (proxsuite::linalg::veg::isize i = 0; i < 3; ++i) {
+                ldl.coeff_mut(i, i) = 2.0;
+                if (i > 0) {
+                        ldl.coeff_mut(i, i - 1) = 1.0;
+                }
+        }
+        ldl.factorize(0);
+
+        // modify the last row, then refactorize it only
+        ldl.coeff_mut(2, 2) = 3.0;
+        ldl.factorize(2);
+
+        auto rhs = Vector{3};
+        rhs << 3.0, 4.0, 4.0;
+        ldl.solve_in_place(rhs);
+}
+ * ```
+ */
+template<typename T>
+struct BandLdlt
+{
+private:
+  static constexpr auto DYN = Eigen::Dynamic;
+  using ColMat = Eigen::Matrix<T, DYN, DYN, Eigen::ColMajor>;
+  using Vec = Eigen::Matrix<T, DYN, 1>;
+  using VecMap = Eigen::Map<Vec>;
+  using VecMapConst = Eigen::Map<Vec const>;
+
+  // row i of the band storages holds the coefficients (i, i - bw) to (i, i)
+  proxsuite::linalg::veg::Vec<T> a_storage;
+  proxsuite::linalg::veg::Vec<T> l_storage;
+  proxsuite::linalg::veg::Vec<T> d_storage;
+  // L(i, k) D(k) for the row being factorized
+  proxsuite::linalg::veg::Vec<T> work;
+  isize n{};
+  isize bw{};
+
+  // soft invariants:
+  // - a_storage.len() == l_storage.len() == n * (bw + 1)
+  // - d_storage.len() == n
+  // - work.len() == bw + 1
+public:
+  /*!
+   * Default constructor, initialized with a `0×0` empty matrix.
+   */
+  BandLdlt() = default;
+
+  /*!
+   * Resizes the matrix `A` to a `dim×dim` zero matrix of the given bandwidth.
+   * This operation invalidates the existing decomposition.
+   *
+   * @param dim dimension of the matrix
+   * @param bandwidth number of nonzero subdiagonals of the matrix
+   */
+  void reset(isize dim, isize bandwidth)
+  {
+    VEG_ASSERT(dim >= 0);
+    VEG_ASSERT(bandwidth >= 0);
+    n = dim;
+    bw = bandwidth;
+    isize len = n * (bw + 1);
+    a_storage.resize_for_overwrite(len);
+    l_storage.resize_for_overwrite(len);
+    d_storage.resize_for_overwrite(n);
+    work.resize_for_overwrite(bw + 1);
+    std::fill(a_storage.ptr_mut(), a_storage.ptr_mut() + len, T(0));
+    std::fill(l_storage.ptr_mut(), l_storage.ptr_mut() + len, T(0));
+    std::fill(d_storage.ptr_mut(), d_storage.ptr_mut() + n, T(0));
+  }
+
+  /*!
+   * Returns the dimension of the stored matrix.
+   */
+  auto dim() const noexcept -> isize { return n; }
+
+  /*!
+   * Returns the bandwidth of the stored matrix.
+   */
+  auto bandwidth() const noexcept -> isize { return bw; }
+
+  /*!
+   * Returns the coefficient `A(i, j)` of the lower triangular part of the
+   * matrix, with `0 ≤ i - j ≤ bw`.
+   */
+  auto coeff(isize i, isize j) const noexcept -> T
+  {
+    VEG_DEBUG_ASSERT(j <= i && i - j <= bw);
+    return a_storage.ptr()[i * (bw + 1) + (j - i + bw)];
+  }
+
+  /*!
+   * Returns a reference to the coefficient `A(i, j)` of the lower triangular
+   * part of the matrix, with `0 ≤ i - j ≤ bw`. The decomposition is updated
+   * by factorize.
+   */
+  auto coeff_mut(isize i, isize j) noexcept -> T&
+  {
+    VEG_DEBUG_ASSERT(j <= i && i - j <= bw);
+    return a_storage.ptr_mut()[i * (bw + 1) + (j - i + bw)];
+  }
+
+  /*!
+   * Sets to zero the row `i` of the lower triangular part of the matrix.
+   */
+  void clear_row(isize i) noexcept
+  {
+    T* row = a_storage.ptr_mut() + i * (bw + 1);
+    std::fill(row, row + bw + 1, T(0));
+  }
+
+  /*!
+   * Returns the diagonal `D` of the decomposition.
+   */
+  auto d() const noexcept -> VecMapConst { return { d_storage.ptr(), n }; }
+
+  /*!
+   * Computes the rows `from` to `dim() - 1` of the decomposition, the
+   * previous ones being kept as is. Calling it with `from = 0` computes the
+   * whole decomposition.
+   *
+   * @param from index of the first modified row of the matrix since the last
+   * decomposition
+   */
+  void factorize(isize from)
+  {
+    isize w = bw + 1;
+    T const* a = a_storage.ptr();
+    T* l = l_storage.ptr_mut();
+    T* d = d_storage.ptr_mut();
+    T* ld = work.ptr_mut();
+
+    for (isize i = std::max(from, isize(0)); i < n; ++i) {
+      isize lo = std::max(i - bw, isize(0));
+      isize off = bw - i; // A(i, j) is stored at the position j + off of row i
+      T const* a_i = a + i * w;
+      T* l_i = l + i * w;
+
+      for (isize j = lo; j < i; ++j) {
+        T const* l_j = l + j * w + bw - j;
+        isize k0 = std::max(lo, j - bw);
+        T acc = a_i[j + off];
+        if (j > k0) {
+          acc -= VecMapConst(ld + k0 + off, j - k0)
+                   .dot(VecMapConst(l_j + k0, j - k0));
+        }
+        ld[j + off] = acc;
+        l_i[j + off] = acc / d[j];
+      }
+      T acc = a_i[bw];
+      if (i > lo) {
+        acc -= VecMapConst(ld + lo + off, i - lo)
+                 .dot(VecMapConst(l_i + lo + off, i - lo));
+      }
+      d[i] = acc;
+    }
+  }
+
+  /*!
+   * Solves the system `A×x = rhs`, and stores the result in `rhs`.
+   *
+   * @param rhs right hand side of the linear system
+   */
+  void solve_in_place(Eigen::Ref<Vec> rhs) const
+  {
+    VEG_ASSERT(rhs.rows() == n);
+    isize w = bw + 1;
+    T const* l = l_storage.ptr();
+    T* x = rhs.data();
+
+    // L y = rhs
+    for (isize i = 0; i < n; ++i) {
+      isize lo = std::max(i - bw, isize(0));
+      if (i > lo) {
+        T const* l_i = l + i * w + (lo - i + bw);
+        x[i] -= VecMapConst(l_i, i - lo).dot(VecMapConst(x + lo, i - lo));
+      }
+    }
+    rhs.array() /= d().array();
+    // L.T x = y
+    for (isize i = n - 1; i > 0; --i) {
+      isize lo = std::max(i - bw, isize(0));
+      T const* l_i = l + i * w + (lo - i + bw);
+      VecMap(x + lo, i - lo) -= x[i] * VecMapConst(l_i, i - lo);
+    }
+  }
+
+  /*!
+   * Returns the matrix `L diag(D) L.T` reconstructed from the decomposition.
+   */
+  auto dbg_reconstructed_matrix() const -> ColMat
+  {
+    ColMat l_mat = ColMat::Identity(n, n);
+    for (isize i = 0; i < n; ++i) {
+      for (isize j = std::max(i - bw, isize(0)); j < i; ++j) {
+        l_mat(i, j) = l_storage.ptr()[i * (bw + 1) + (j - i + bw)];
+      }
+    }
+    return l_mat * d().asDiagonal() * l_mat.transpose();
+  }
+
+  /*!
+   * Visits the internal storage of the decomposition (e.g., for saving it and
+   * restoring it later without refactorizing).
+   *
+   * @param visitor callable on the storage vectors and on the dimensions
+   */
+  template<typename Visitor>
+  void visit_storage(Visitor&& visitor) const
+  {
+    visitor(a_storage);
+    visitor(l_storage);
+    visitor(d_storage);
+    visitor(n);
+    visitor(bw);
+  }
+  template<typename Visitor>
+  void visit_storage_mut(Visitor&& visitor)
+  {
+    visitor(a_storage);
+    visitor(l_storage);
+    visitor(d_storage);
+    visitor(n);
+    visitor(bw);
+    work.resize_for_overwrite(bw + 1);
+  }
+};
+} // namespace dense
+} // namespace linalg
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_LINALG_DENSE_LDLT_BAND_LDLT_HPP */
@@ -806,7 +806,9 @@ noalias_mul_add_impl(Dst dst, Lhs lhs, Rhs rhs, T factor)
   } else
 #endif
   {
-    dst.noalias().operator+=(lhs.operator*(rhs).operator*(factor));
+    // the factor is applied on the left, so that Eigen does not evaluate the
+    // product in a heap allocated temporary
+    dst.noalias().operator+=(factor * lhs.operator*(rhs));
   }
 }
 } // namespace _detail
@@ -613,6 +613,31 @@ public:
    */
   auto dim() const noexcept -> isize { return perm.len(); }
 
+  /*!
+   * Visits the internal storage of the decomposition (e.g., for saving it and
+   * restoring it later without refactorizing).
+   *
+   * @param visitor callable on the storage vectors and on the column stride
+   */
+  template<typename Visitor>
+  void visit_storage(Visitor&& visitor) const
+  {
+    visitor(ld_storage);
+    visitor(stride);
+    visitor(perm);
+    visitor(perm_inv);
+    visitor(maybe_sorted_diag);
+  }
+  template<typename Visitor>
+  void visit_storage_mut(Visitor&& visitor)
+  {
+    visitor(ld_storage);
+    visitor(stride);
+    visitor(perm);
+    visitor(perm_inv);
+    visitor(maybe_sorted_diag);
+  }
+
   auto ld_col() const noexcept -> Eigen::Map< //
     ColMat const,
     Eigen::Unaligned,
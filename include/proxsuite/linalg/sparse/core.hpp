@@ -524,6 +524,93 @@ private:
     T* val;
   } _;
 };
+
+/*!
+ * View of a sparse matrix whose column pointers and row indices are read-only
+ * (e.g., stored in read-only memory), and whose values may be modified. When
+ * the matrix is not compressed, its numbers of non zeros per column may also
+ * be modified, which selects the first entries of each column.
+ */
+template<typename T, typename I = isize>
+struct MatValuesMut : _detail::SymbolicMatRefInterface<MatValuesMut<T, I>, I>
+{
+  friend struct _detail::SymbolicMatRefInterface<MatValuesMut, I>;
+  MatValuesMut(FromRawParts /*from_raw_parts*/,
+               isize nrows,
+               isize ncols,
+               isize nnz,
+               I const* col_ptrs,
+               I* nnz_per_col,
+               I const* row_indices,
+               T* values)
+    : _{
+      nrows, ncols, nnz, col_ptrs, nnz_per_col, row_indices, values,
+    }
+  {
+  }
+
+  template<typename M>
+  MatValuesMut(FromEigen /*from_eigen*/, M&& m)
+    : _{
+      m.rows(),
+      m.cols(),
+      m.nonZeros(),
+      m.outerIndexPtr(),
+      m.innerNonZeroPtr(),
+      m.innerIndexPtr(),
+      m.valuePtr(),
+    }
+  {
+    static_assert(!bool(proxsuite::linalg::veg::uncvref_t<M>::IsRowMajor), ".");
+  }
+
+  MatValuesMut(MatMut<T, I> mat)
+    : _{
+      mat.nrows(),      mat.ncols(),           mat.nnz(),
+      mat.col_ptrs(),   mat.nnz_per_col_mut(), mat.row_indices(),
+      mat.values_mut(),
+    }
+  {
+  }
+
+  auto values() const noexcept -> T const* { return _.val; }
+  auto values_mut() const noexcept -> T* { return _.val; }
+  auto nnz_per_col_mut() noexcept -> I* { return _.nnz_per_col; }
+
+  auto as_const() const noexcept -> MatRef<T, I>
+  {
+    return {
+      from_raw_parts,      this->nrows(),    this->ncols(),
+      this->nnz(),         this->col_ptrs(), this->nnz_per_col(),
+      this->row_indices(), this->values(),
+    };
+  }
+  auto symbolic() const noexcept -> SymbolicMatRef<I>
+  {
+    return {
+      from_raw_parts,   this->nrows(),       this->ncols(),       this->nnz(),
+      this->col_ptrs(), this->nnz_per_col(), this->row_indices(),
+    };
+  }
+  auto to_eigen() const noexcept
+    -> Eigen::Map<Eigen::SparseMatrix<T, Eigen::ColMajor, I> const>
+  {
+    return { _.nrows, _.ncols, _.nnz, _.col, _.row, _.val, _.nnz_per_col };
+  }
+  void _set_nnz(isize new_nnz) noexcept { _.nnz = new_nnz; }
+
+private:
+  struct
+  {
+    isize nrows;
+    isize ncols;
+    isize nnz;
+    I const* col;
+    I* nnz_per_col;
+    I const* row;
+    T* val;
+  } _;
+};
 } // namespace sparse
 } // namespace linalg
 } // namespace proxsuite
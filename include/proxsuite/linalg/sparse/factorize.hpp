@@ -716,10 +716,13 @@ column_counts(I* counts,
 
 template<typename I>
 auto
-amd_req(proxsuite::linalg::veg::Tag<I> /*tag*/, isize /*n*/, isize nnz) noexcept
+amd_req(proxsuite::linalg::veg::Tag<I> /*tag*/, isize n, isize nnz) noexcept
   -> proxsuite::linalg::veg::dynstack::StackReq
 {
-  return { nnz * isize{ sizeof(char) }, alignof(char) };
+  using proxsuite::linalg::veg::dynstack::StackReq;
+  return StackReq{ (n + 1) * isize{ sizeof(I) }, alignof(I) } &
+         StackReq{ (nnz + n) * isize{ sizeof(I) }, alignof(I) } &
+         StackReq{ (nnz + n) * isize{ sizeof(char) }, alignof(char) };
 }
 
 template<typename I>
@@ -729,21 +732,50 @@ amd(I* perm, SymbolicMatRef<I> mat, DynStackMut stack) noexcept
   // TODO: reimplement amd under BSD-3
   // https://github.com/DrTimothyAldenDavis/SuiteSparse/tree/master/AMD
 
+  using proxsuite::linalg::veg::Tag;
+
   isize n = mat.nrows();
   isize nnz = mat.nnz();
 
-  Eigen::PermutationMatrix<-1, -1, I> perm_eigen;
-  auto _ = stack.make_new(proxsuite::linalg::veg::Tag<char>{}, nnz);
+  // the ordering defers the nodes without a structural diagonal entry, as the
+  // dense ones, so the diagonal (which the rows of the constraints of a kkt
+  // matrix do not store) is added to the pattern
+  auto _col_ptrs = stack.make_new_for_overwrite(Tag<I>{}, n + 1);
+  auto _row_indices = stack.make_new_for_overwrite(Tag<I>{}, nnz + n);
+  auto _ = stack.make_new(Tag<char>{}, nnz + n);
+  I* col_ptrs = _col_ptrs.ptr_mut();
+  I* row_indices = _row_indices.ptr_mut();
+
+  I const* mi = mat.row_indices();
+  usize pos = 0;
+  col_ptrs[0] = I(0);
+  for (usize j = 0; j < usize(n); ++j) {
+    bool has_diag = false;
+    usize col_start = mat.col_start(j);
+    usize col_end = mat.col_end(j);
+    for (usize p = col_start; p < col_end; ++p) {
+      usize i = util::zero_extend(mi[p]);
+      has_diag = has_diag || i == j;
+      row_indices[pos] = mi[p];
+      ++pos;
+    }
+    if (!has_diag) {
+      row_indices[pos] = I(j);
+      ++pos;
+    }
+    col_ptrs[j + 1] = I(pos);
+  }
 
+  Eigen::PermutationMatrix<-1, -1, I> perm_eigen;
   Eigen::AMDOrdering<I>{}(
     Eigen::Map<Eigen::SparseMatrix<char, Eigen::ColMajor, I> const>{
       n,
       n,
-      nnz,
-      mat.col_ptrs(),
-      mat.row_indices(),
+      isize(pos),
+      col_ptrs,
+      row_indices,
       _.ptr(),
-      mat.nnz_per_col(),
+      nullptr,
     }
       .template selfadjointView<Eigen::Upper>(),
 
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file anderson.hpp
+ */
+#ifndef PROXSUITE_QP_ANDERSON_HPP
+#define PROXSUITE_QP_ANDERSON_HPP
+
+#include <Eigen/Cholesky>
+#include <algorithm>
+#include "proxsuite/proxqp/sparse/fwd.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+///
+/// @brief Memory of the Anderson acceleration of the outer loop.
+///
+/*!
+ * For fixed proximal parameters, an outer iteration maps its proximal center
+ * w = (x_prev, y_prev, z_prev) to the (approximate) solution g = T(w) of the
+ * proximal subproblem. Anderson acceleration (type II) replaces g by
+ *
+ *   g - dG gamma,   gamma = argmin ||f - dF gamma||^2 + lambda ||gamma||^2,
+ *
+ * where f = g - w, and the columns of dF and dG are the differences of f and
+ * of g between consecutive iterations, kept in a window of at most m columns.
+ * The window is only valid for one map, so it is reset whenever a proximal
+ * parameter changes.
+ */
+template<typename T>
+struct AndersonAcceleration
+{
+  sparse::DMat<T> dF;
+  sparse::DMat<T> dG;
+  sparse::DMat<T> gram;
+  sparse::Vec<T> gamma;
+  sparse::Vec<T> f_prev;
+  sparse::Vec<T> g_prev;
+  // input w of the map, overwritten by the accelerated point
+  sparse::Vec<T> w;
+  // image g = T(w) of the map
+  sparse::Vec<T> g;
+
+  sparse::isize size; // number of columns of the window
+  sparse::isize next; // column overwritten by the next difference
+  bool has_prev;      // whether f_prev and g_prev are set
+
+  // proximal parameters of the map of the window
+  T mu_eq;
+  T mu_in;
+  T rho;
+
+  AndersonAcceleration()
+    : size(0)
+    , next(0)
+    , has_prev(false)
+    , mu_eq(0)
+    , mu_in(0)
+    , rho(0)
+  {
+  }
+  /*!
+   * Allocates the window, when its dimensions change.
+   * @param n dimension of the iterates.
+   * @param m maximal number of columns of the window.
+   */
+  void resize(sparse::isize n, sparse::isize m)
+  {
+    if (dF.rows() != n || dF.cols() != m) {
+      dF.resize(n, m);
+      dG.resize(n, m);
+      gram.resize(m, m);
+      gamma.resize(m);
+      f_prev.resize(n);
+      g_prev.resize(n);
+      w.resize(n);
+      g.resize(n);
+    }
+    reset();
+  }
+  /*!
+   * Clears the window.
+   */
+  void reset()
+  {
+    size = 0;
+    next = 0;
+    has_prev = false;
+  }
+  /*!
+   * Clears the window if the proximal parameters differ from the ones of the
+   * iterations it holds.
+   */
+  void set_parameters(T mu_eq_, T mu_in_, T rho_)
+  {
+    if (mu_eq_ != mu_eq || mu_in_ != mu_in || rho_ != rho) {
+      reset();
+      mu_eq = mu_eq_;
+      mu_in = mu_in_;
+      rho = rho_;
+    }
+  }
+  /*!
+   * Adds the pair (w, g) to the window and overwrites w by the accelerated
+   * point. Returns false (w being left unchanged) while the window is empty.
+   * @param regularization Tikhonov regularization of the least-squares
+   * problem, relative to the squared Frobenius norm of dF.
+   */
+  bool step(T regularization)
+  {
+    sparse::isize m = dF.cols();
+    if (m == 0) {
+      return false;
+    }
+    if (has_prev) {
+      dF.col(next) = (g - w) - f_prev;
+      dG.col(next) = g - g_prev;
+      next = (next + 1) % m;
+      size = std::min(size + 1, m);
+    }
+    f_prev = g - w;
+    g_prev = g;
+    has_prev = true;
+    if (size == 0) {
+      return false;
+    }
+
+    // the window fills its columns in order, so its first size columns hold
+    // the differences
+    auto dF_k = dF.leftCols(size);
+    auto gram_k = gram.topLeftCorner(size, size);
+    auto gamma_k = gamma.head(size);
+    gram_k.noalias() = dF_k.transpose() * dF_k;
+    T lambda = regularization * gram_k.trace();
+    if (!(lambda > T(0))) {
+      return false;
+    }
+    gram_k.diagonal().array() += lambda;
+    gamma_k.noalias() = dF_k.transpose() * f_prev;
+    Eigen::LLT<Eigen::Ref<sparse::DMat<T>>> llt(gram_k);
+    if (llt.info() != Eigen::Success) {
+      return false;
+    }
+    llt.solveInPlace(gamma_k);
+    w = g;
+    w.noalias() -= dG.leftCols(size) * gamma_k;
+    return true;
+  }
+};
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_ANDERSON_HPP */
@@ -11,7 +11,9 @@
 #include <proxsuite/proxqp/results.hpp>
 #include <proxsuite/proxqp/settings.hpp>
 #include <proxsuite/proxqp/status.hpp>
+#include <proxsuite/proxqp/trace.hpp>
 #include <proxsuite/proxqp/dense/fwd.hpp>
+#include <proxsuite/proxqp/dense/kkt.hpp>
 #include <proxsuite/proxqp/dense/preconditioner/ruiz.hpp>
 #include <chrono>
 #include <optional>
@@ -56,8 +58,8 @@ compute_equality_constrained_initial_guess(Workspace<T>& qpwork,
 }
 
 /*!
- * Setups and performs the first factorization of the regularized KKT matrix of
- * the problem.
+ * Assembles the regularized KKT matrix of the AUGMENTED mode without
+ * inequalities, which the refactorizations then update in place.
  *
  * @param qpwork workspace of the solver.
  * @param qpmodel QP problem model as defined by the user (without any scaling
@@ -66,16 +68,10 @@ compute_equality_constrained_initial_guess(Workspace<T>& qpwork,
  */
 template<typename T>
 void
-setup_factorization(Workspace<T>& qpwork,
-                    const Model<T>& qpmodel,
-                    Results<T>& qpresults)
+assemble_augmented_kkt(Workspace<T>& qpwork,
+                       const Model<T>& qpmodel,
+                       const Results<T>& qpresults)
 {
-
-  proxsuite::linalg::veg::dynstack::DynStackMut stack{
-    proxsuite::linalg::veg::from_slice_mut,
-    qpwork.ldl_stack.as_mut(),
-  };
-
   qpwork.kkt.topLeftCorner(qpmodel.dim, qpmodel.dim) = qpwork.H_scaled;
   qpwork.kkt.topLeftCorner(qpmodel.dim, qpmodel.dim).diagonal().array() +=
     qpresults.info.rho;
@@ -86,7 +82,62 @@ setup_factorization(Workspace<T>& qpwork,
   qpwork.kkt.diagonal()
     .segment(qpmodel.dim, qpmodel.n_eq)
     .setConstant(-qpresults.info.mu_eq);
+}
+/*!
+ * Setups and performs the first factorization of the regularized KKT matrix of
+ * the problem (without active inequalities).
+ *
+ * @param qpwork workspace of the solver.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpresults solution results.
+ */
+template<typename T>
+void
+setup_factorization(Workspace<T>& qpwork,
+                    const Model<T>& qpmodel,
+                    Results<T>& qpresults)
+{
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::FACTORIZATION);
+  trace::Span span("setup_factorization");
+
+  qpwork.interior_point_ldl = false;
+  select_kkt_mode(qpwork);
+  if (qpwork.kkt_mode == KktMode::CONDENSED) {
+    qpwork.n_c = 0;
+    factorize_condensed_kkt(qpmodel,
+                            qpwork,
+                            qpresults.info.rho,
+                            qpresults.info.mu_eq,
+                            qpresults.info.mu_in);
+    return;
+  }
+  if (qpwork.kkt_mode == KktMode::BANDED) {
+    qpwork.n_c = 0;
+    setup_banded_kkt(qpmodel, qpwork);
+    factorize_banded_kkt(qpmodel,
+                         qpwork,
+                         qpresults.info.rho,
+                         qpresults.info.mu_eq,
+                         qpresults.info.mu_in);
+    return;
+  }
+  if (qpwork.kkt_mode == KktMode::DUAL) {
+    qpwork.n_c = 0;
+    factorize_dual_kkt(qpmodel,
+                       qpwork,
+                       qpresults.info.rho,
+                       qpresults.info.mu_eq,
+                       qpresults.info.mu_in);
+    return;
+  }
+
+  proxsuite::linalg::veg::dynstack::DynStackMut stack{
+    proxsuite::linalg::veg::from_slice_mut,
+    qpwork.ldl_stack.as_mut(),
+  };
 
+  assemble_augmented_kkt(qpwork, qpmodel, qpresults);
   qpwork.ldl.factorize(qpwork.kkt, stack);
 }
 /*!
@@ -127,6 +178,27 @@ setup_equilibration(Workspace<T>& qpwork,
                          stack);
   qpwork.correction_guess_rhs_g = infty_norm(qpwork.g_scaled);
 }
+/*!
+ * Unscales in place the matrices of the workspace, which are the only copy of
+ * the matrices of a model not owning them.
+ *
+ * @param qpwork solver workspace.
+ * @param ruiz ruiz preconditioner.
+ */
+template<typename T>
+void
+unscale_matrices(Workspace<T>& qpwork,
+                 preconditioner::RuizEquilibration<T>& ruiz)
+{
+  ruiz.unscale_matrices_in_place(QpViewBoxMut<T>{
+    { from_eigen, qpwork.H_scaled },
+    { from_eigen, qpwork.g_scaled },
+    { from_eigen, qpwork.A_scaled },
+    { from_eigen, qpwork.b_scaled },
+    { from_eigen, qpwork.C_scaled },
+    { from_eigen, qpwork.u_scaled },
+    { from_eigen, qpwork.l_scaled } });
+}
 
 /*!
  * Setups the solver initial guess.
@@ -172,12 +244,12 @@ initial_guess(Workspace<T>& qpwork,
 template<typename Mat, typename T>
 void
 update(std::optional<Mat> H_,
-       std::optional<Vec<T>> g_,
+       std::optional<VecRef<T>> g_,
        std::optional<Mat> A_,
-       std::optional<Vec<T>> b_,
+       std::optional<VecRef<T>> b_,
        std::optional<Mat> C_,
-       std::optional<Vec<T>> u_,
-       std::optional<Vec<T>> l_,
+       std::optional<VecRef<T>> u_,
+       std::optional<VecRef<T>> l_,
        Model<T>& model,
        Workspace<T>& work)
 {
@@ -249,6 +321,13 @@ update(std::optional<Mat> H_,
   if (l_ != std::nullopt) {
     model.l = l_.value().eval();
   }
+  if (model.storage == ModelStorage::NON_OWNING) {
+    // the matrices are directly copied into the workspace by the setup
+    if (H_ != std::nullopt || A_ != std::nullopt || C_ != std::nullopt) {
+      work.refactorize = true;
+    }
+    return;
+  }
   if (H_ != std::nullopt) {
     work.refactorize = true;
     if (A_ != std::nullopt) {
@@ -339,7 +418,11 @@ setup( //
   preconditioner::RuizEquilibration<T>& ruiz,
   PreconditionerStatus preconditioner_status)
 {
-
+  trace::Span span("init");
+  qpresults.info.phase_timings.clear();
+  // the scaled matrices are the only copy of the matrices of a model not
+  // owning them
+  bool keep_matrices = qpmodel.storage == ModelStorage::NON_OWNING;
   switch (qpsettings.initial_guess) {
     case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
       if (qpwork.proximal_parameter_update) {
@@ -347,7 +430,7 @@ setup( //
       } else {
         qpresults.cleanup();
       }
-      qpwork.cleanup();
+      qpwork.cleanup(keep_matrices);
       break;
     }
     case InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT: {
@@ -357,7 +440,7 @@ setup( //
       } else {
         qpresults.cold_start();
       }
-      qpwork.cleanup();
+      qpwork.cleanup(keep_matrices);
       break;
     }
     case InitialGuessStatus::NO_INITIAL_GUESS: {
@@ -366,7 +449,7 @@ setup( //
       } else {
         qpresults.cleanup();
       }
-      qpwork.cleanup();
+      qpwork.cleanup(keep_matrices);
       break;
     }
     case InitialGuessStatus::WARM_START: {
@@ -377,47 +460,75 @@ setup( //
       } else {
         qpresults.cleanup();
       }
-      qpwork.cleanup();
+      qpwork.cleanup(keep_matrices);
       break;
     }
     case InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT: {
       if (qpwork.refactorize || qpwork.proximal_parameter_update) {
-        qpwork.cleanup(); // meaningful for when there is an upate of the model
-                          // and one wants to warm start with previous result
+        // meaningful for when there is an upate of the model and one wants to
+        // warm start with previous result
+        qpwork.cleanup(keep_matrices);
         qpwork.refactorize = true;
       }
       qpresults.cleanup_statistics();
       break;
     }
   }
-  if (H != std::nullopt) {
-    qpmodel.H = Eigen::
-      Matrix<T, Eigen::Dynamic, Eigen::Dynamic, to_eigen_layout(rowmajor)>(
-        H.value());
-  } // else qpmodel.H remains initialzed to a matrix with zero elements
+  // the cached factorizations are the ones of the previous scaled matrices,
+  // which scaling anew with the same preconditioner only changes by rounding
+  // errors
+  if (H != std::nullopt || A != std::nullopt || C != std::nullopt ||
+      preconditioner_status != PreconditionerStatus::KEEP) {
+    qpwork.factorization_cache.clear();
+  }
+  if (keep_matrices) {
+    // the matrices which are not given are recovered from their scaled copy
+    if (H == std::nullopt || A == std::nullopt || C == std::nullopt) {
+      unscale_matrices(qpwork, ruiz);
+    }
+    if (H != std::nullopt) {
+      qpwork.H_scaled = H.value();
+    }
+    if (A != std::nullopt) {
+      qpwork.A_scaled = A.value();
+    }
+    if (C != std::nullopt) {
+      qpwork.C_scaled = C.value();
+    }
+  } else {
+    if (H != std::nullopt) {
+      qpmodel.H = Eigen::
+        Matrix<T, Eigen::Dynamic, Eigen::Dynamic, to_eigen_layout(rowmajor)>(
+          H.value());
+    } // else qpmodel.H remains initialzed to a matrix with zero elements
+
+    if (A != std::nullopt) {
+      qpmodel.A = Eigen::
+        Matrix<T, Eigen::Dynamic, Eigen::Dynamic, to_eigen_layout(rowmajor)>(
+          A.value());
+    } // else qpmodel.A remains initialized to a matrix with zero elements or
+      // zero shape
+
+    if (C != std::nullopt) {
+      qpmodel.C = Eigen::
+        Matrix<T, Eigen::Dynamic, Eigen::Dynamic, to_eigen_layout(rowmajor)>(
+          C.value());
+    } // else qpmodel.C remains initialized to a matrix with zero elements or
+      // zero shape
+
+    qpwork.H_scaled = qpmodel.H;
+    qpwork.A_scaled = qpmodel.A;
+    qpwork.C_scaled = qpmodel.C;
+  }
   if (g != std::nullopt) {
     qpmodel.g = g.value();
   }
 
-  if (A != std::nullopt) {
-    qpmodel.A = Eigen::
-      Matrix<T, Eigen::Dynamic, Eigen::Dynamic, to_eigen_layout(rowmajor)>(
-        A.value());
-  } // else qpmodel.A remains initialized to a matrix with zero elements or zero
-    // shape
-
   if (b != std::nullopt) {
     qpmodel.b = b.value();
   } // else qpmodel.b remains initialized to a matrix with zero elements or zero
     // shape
 
-  if (C != std::nullopt) {
-    qpmodel.C = Eigen::
-      Matrix<T, Eigen::Dynamic, Eigen::Dynamic, to_eigen_layout(rowmajor)>(
-        C.value());
-  } // else qpmodel.C remains initialized to a matrix with zero elements or zero
-    // shape
-
   if (u != std::nullopt) {
     qpmodel.u = u.value();
   } // else qpmodel.u remains initialized to a matrix with zero elements or zero
@@ -428,11 +539,8 @@ setup( //
   } // else qpmodel.l remains initialized to a matrix with zero elements or zero
     // shape
 
-  qpwork.H_scaled = qpmodel.H;
   qpwork.g_scaled = qpmodel.g;
-  qpwork.A_scaled = qpmodel.A;
   qpwork.b_scaled = qpmodel.b;
-  qpwork.C_scaled = qpmodel.C;
   qpwork.u_scaled =
     (qpmodel.u.array() <= T(1.E20))
       .select(qpmodel.u,
@@ -449,11 +557,17 @@ setup( //
   qpwork.primal_feasibility_rhs_1_in_l = infty_norm(qpwork.l_scaled);
   qpwork.dual_feasibility_rhs_2 = infty_norm(qpmodel.g);
 
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::EQUILIBRATION);
   switch (preconditioner_status) {
     case PreconditionerStatus::EXECUTE:
       setup_equilibration(qpwork, qpsettings, ruiz, true);
+      qpwork.preconditioner_loaded = false;
       break;
     case PreconditionerStatus::IDENTITY:
+      // discard previous scaling variables (derived or loaded)
+      ruiz.delta.setOnes();
+      ruiz.c = T(1);
+      qpwork.preconditioner_loaded = false;
       setup_equilibration(qpwork, qpsettings, ruiz, false);
       break;
     case PreconditionerStatus::KEEP:
@@ -0,0 +1,565 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file interior_point.hpp
+ */
+
+#ifndef PROXSUITE_QP_DENSE_INTERIOR_POINT_HPP
+#define PROXSUITE_QP_DENSE_INTERIOR_POINT_HPP
+
+#include "proxsuite/proxqp/dense/views.hpp"
+#include "proxsuite/proxqp/dense/utils.hpp"
+#include "proxsuite/proxqp/observer.hpp"
+#include "proxsuite/proxqp/trace.hpp"
+#include <proxsuite/linalg/veg/util/dynstack_alloc.hpp>
+#include <proxsuite/linalg/dense/ldlt.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace proxsuite {
+namespace proxqp {
+namespace dense {
+namespace interior_point {
+
+/*!
+ * Returns the largest step alpha keeping v + alpha dv nonnegative (infinite
+ * if dv is nonnegative).
+ *
+ * @param v nonnegative vector.
+ * @param dv direction.
+ */
+template<typename T>
+T
+max_step(const Vec<T>& v, const Vec<T>& dv)
+{
+  T alpha = std::numeric_limits<T>::infinity();
+  for (isize i = 0; i < v.size(); ++i) {
+    if (dv[i] < T(0)) {
+      alpha = std::min(alpha, -v[i] / dv[i]);
+    }
+  }
+  return alpha;
+}
+
+/*!
+ * Sizes the iterates of the interior-point method in the workspace, and grows
+ * its memory stack so that the Newton system can be assembled and factorized
+ * in it. Nothing is allocated when the dimensions are unchanged.
+ *
+ * @param qpwork solver workspace.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ */
+template<typename T>
+void
+reserve(Workspace<T>& qpwork, const Model<T>& qpmodel)
+{
+  using proxsuite::linalg::dense::Ldlt;
+  using proxsuite::linalg::dense::temp_mat_req;
+  using proxsuite::linalg::veg::Tag;
+  isize n_kkt = qpmodel.dim + qpmodel.n_eq + qpmodel.n_in;
+  qpwork.interior_point.resize(qpmodel.dim, qpmodel.n_eq, qpmodel.n_in);
+  isize req =
+    ((temp_mat_req(Tag<T>{}, n_kkt, n_kkt) &
+      (temp_mat_req(Tag<T>{}, qpmodel.n_in, qpmodel.dim) |
+       Ldlt<T>::factorize_req(n_kkt))) |
+     Ldlt<T>::solve_in_place_req(n_kkt))
+      .alloc_req();
+  if (qpwork.ldl_stack.len() < req) {
+    qpwork.ldl_stack.resize_for_overwrite(req);
+  }
+  qpwork.ldl.reserve_uninit(n_kkt);
+}
+
+/*!
+ * Runs iterations of a primal-dual interior-point method (Mehrotra
+ * predictor-corrector) on the scaled QP problem of the workspace.
+ *
+ * Each finite side of the inequality constraints gets a slack and a
+ * multiplier:
+ *
+ *   C x - l = t_l,   u - C x = t_u,   t_l, t_u, lambda_l, lambda_u >= 0,
+ *
+ * and z = lambda_u - lambda_l. Eliminating the slacks and the inequality
+ * multipliers, with D = lambda_l / t_l + lambda_u / t_u, the Newton steps
+ * solve the quasi-definite system
+ *
+ *   [ H + C_1^T D_1 C_1   A^T   C_2^T       ] [dx ]   [-r_d - C_1^T q_1]
+ *   [ A                   0     0           ] [dy ] = [-r_p            ],
+ *   [ C_2                 0     -D_2^{-1}   ] [dz2]   [-D_2^{-1} q_2   ]
+ *
+ * the rows C_1 of small weight being condensed into the first block and the
+ * nearly active rows C_2 being kept apart. The system is factorized once per
+ * iteration with linalg::dense::Ldlt, with a regularization increased until
+ * the factorization succeeds, and both the predictor and the corrector steps
+ * are solved by iterative refinement against the unregularized matrix. The
+ * iterates are left scaled in qpresults, as in the PROXQP loop.
+ *
+ * The starting point is computed by the first call of a solve, and the
+ * iterations then resume from the iteration counter of qpwork.solve_state.
+ *
+ * @param qpsettings solver settings.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpresults solver results.
+ * @param qpwork solver workspace.
+ * @param ruiz ruiz preconditioner.
+ * @param budget number of iterations the call may run, decreased by the
+ * iterations run. Once it is zero, the method is suspended until the next call.
+ * @param observer callable receiving the IterationRecord of each iteration.
+ * @return true once the method is finished, false if it is suspended.
+ */
+template<typename T, typename Observer>
+bool
+step(const Settings<T>& qpsettings,
+     const Model<T>& qpmodel,
+     Results<T>& qpresults,
+     Workspace<T>& qpwork,
+     preconditioner::RuizEquilibration<T>& ruiz,
+     isize& budget,
+     Observer&& observer)
+{
+  isize n = qpmodel.dim;
+  isize n_eq = qpmodel.n_eq;
+  isize n_in = qpmodel.n_in;
+  // bounds of the regularization of the Newton system, increased while its
+  // factorization breaks down
+  T const regularization_min(1.E-8);
+  T const regularization_max(1.E-2);
+  // scaled complementarity targeted once the tolerance is reached
+  T const complementarity_floor = T(0.1) * qpsettings.eps_abs * ruiz.c;
+  // fraction of the maximal step to the boundary
+  T const step_fraction(0.99);
+
+  InteriorPointWorkspace<T>& ipm = qpwork.interior_point;
+  Vec<T>& mask_l = ipm.mask_l;
+  Vec<T>& mask_u = ipm.mask_u;
+  Vec<T>& t_l = ipm.t_l;
+  Vec<T>& t_u = ipm.t_u;
+  Vec<T>& lambda_l = ipm.lambda_l;
+  Vec<T>& lambda_u = ipm.lambda_u;
+  Vec<T>& r_d = ipm.r_d;
+  Vec<T>& r_p = ipm.r_p;
+  Vec<T>& r_l = ipm.r_l;
+  Vec<T>& r_u = ipm.r_u;
+  Vec<T>& r_cl = ipm.r_cl;
+  Vec<T>& r_cu = ipm.r_cu;
+  Vec<T>& d = ipm.d;
+  Vec<T>& d_condensed = ipm.d_condensed;
+  Vec<T>& q = ipm.q;
+  Vec<T>& v = ipm.v;
+  Vec<T>& Cx = ipm.Cx;
+  VecISize& augmented = ipm.augmented;
+  Vec<T>& dt_l = ipm.dt_l;
+  Vec<T>& dt_u = ipm.dt_u;
+  Vec<T>& dlambda_l = ipm.dlambda_l;
+  Vec<T>& dlambda_u = ipm.dlambda_u;
+  // vectors of size n_kkt of the PROXQP Newton step
+  Vec<T>& rhs = qpwork.rhs;
+  Vec<T>& sol = qpwork.dw_aug;
+  Vec<T>& err = qpwork.err;
+  Vec<T>& Cdx = qpwork.Cdx;
+  isize n_augmented = 0;
+  isize dim = n + n_eq;
+
+  // masks of the finite sides of the inequality constraints
+  for (isize i = 0; i < n_in; ++i) {
+    mask_l[i] = qpmodel.l[i] > T(-1.E20) ? T(1) : T(0);
+    mask_u[i] = qpmodel.u[i] < T(1.E20) ? T(1) : T(0);
+  }
+  T const n_sides = mask_l.sum() + mask_u.sum();
+
+  Vec<T>& x = qpresults.x;
+  Vec<T>& y = qpresults.y;
+  Vec<T>& z = qpresults.z;
+  SolveState<T>& state = qpwork.solve_state;
+  // step size of the last iteration
+  T& alpha = state.last_alpha;
+
+  // the factorization of PROXQP is overwritten, and set up anew by the next
+  // PROXQP solve
+  qpwork.interior_point_ldl = true;
+  proxsuite::linalg::dense::Ldlt<T>& ldl = qpwork.ldl;
+  proxsuite::linalg::veg::dynstack::DynStackMut stack{
+    proxsuite::linalg::veg::from_slice_mut, qpwork.ldl_stack.as_mut()
+  };
+
+  // solves the Newton system for the complementarity residuals r_cl and r_cu:
+  // the steps of x and y are left in sol
+  auto newton_step = [&]() {
+    PhaseTimer<T> timer(qpresults.info.phase_timings,
+                        Phase::ITERATIVE_REFINEMENT);
+    q = (mask_l.array() * (r_cl + lambda_l.cwiseProduct(r_l)).array() /
+           t_l.array() -
+         mask_u.array() * (r_cu + lambda_u.cwiseProduct(r_u)).array() /
+           t_u.array())
+          .matrix();
+    v = q;
+    for (isize k = 0; k < n_augmented; ++k) {
+      isize i = augmented[k];
+      v[i] = T(0);
+      rhs[n + n_eq + k] = -q[i] / d[i];
+    }
+    rhs.head(n) = -r_d;
+    rhs.head(n).noalias() -= qpwork.C_scaled.transpose() * v;
+    rhs.segment(n, n_eq) = -r_p;
+
+    sol.head(dim) = rhs.head(dim);
+    ldl.solve_in_place(sol.head(dim), stack);
+    T prev_err_norm = std::numeric_limits<T>::infinity();
+    for (isize k = 0; k < qpsettings.nb_iterative_refinement; ++k) {
+      // err = rhs - K_0 sol, K_0 being the unregularized matrix
+      Cdx.noalias() = qpwork.C_scaled * sol.head(n);
+      v = d_condensed.cwiseProduct(Cdx);
+      err.head(dim) = rhs.head(dim);
+      for (isize j = 0; j < n_augmented; ++j) {
+        isize i = augmented[j];
+        v[i] = sol[n + n_eq + j];
+        err[n + n_eq + j] -= Cdx[i] - sol[n + n_eq + j] / d[i];
+      }
+      err.head(n).noalias() -=
+        qpwork.H_scaled.template selfadjointView<Eigen::Lower>() * sol.head(n);
+      err.head(n).noalias() -= qpwork.C_scaled.transpose() * v;
+      err.head(n).noalias() -=
+        qpwork.A_scaled.transpose() * sol.segment(n, n_eq);
+      err.segment(n, n_eq).noalias() -= qpwork.A_scaled * sol.head(n);
+      T err_norm = infty_norm(err.head(dim));
+      if (!(err_norm < prev_err_norm) ||
+          err_norm <= std::numeric_limits<T>::epsilon() *
+                        std::max(T(1), infty_norm(rhs.head(dim)))) {
+        break;
+      }
+      prev_err_norm = err_norm;
+      ldl.solve_in_place(err.head(dim), stack);
+      sol.head(dim) += err.head(dim);
+    }
+
+    Cdx.noalias() = qpwork.C_scaled * sol.head(n);
+    // the multiplier steps of the augmented rows are consistent with the ones
+    // of the first block, C dx being approximated within the refinement error
+    for (isize k = 0; k < n_augmented; ++k) {
+      isize i = augmented[k];
+      Cdx[i] = (sol[n + n_eq + k] - q[i]) / d[i];
+    }
+    dt_l = mask_l.cwiseProduct(Cdx + r_l);
+    dt_u = mask_u.cwiseProduct(r_u - Cdx);
+    dlambda_l =
+      (-mask_l.array() * (r_cl + lambda_l.cwiseProduct(dt_l)).array() /
+       t_l.array())
+        .matrix();
+    dlambda_u =
+      (-mask_u.array() * (r_cu + lambda_u.cwiseProduct(dt_u)).array() /
+       t_u.array())
+        .matrix();
+  };
+
+  // computes the residuals of the scaled problem at the current iterate and
+  // factorizes the Newton system
+  auto linearize = [&]() {
+    Cx.noalias() = qpwork.C_scaled * x;
+    r_d = qpwork.g_scaled;
+    r_d.noalias() +=
+      qpwork.H_scaled.template selfadjointView<Eigen::Lower>() * x;
+    r_d.noalias() += qpwork.A_scaled.transpose() * y;
+    // the multipliers are formed in Cdx, free until the next step, so that
+    // the product does not evaluate them in a temporary
+    Cdx = lambda_u - lambda_l;
+    r_d.noalias() += qpwork.C_scaled.transpose() * Cdx;
+    r_p.noalias() = qpwork.A_scaled * x;
+    r_p -= qpwork.b_scaled;
+    r_l = mask_l.cwiseProduct(Cx - qpwork.l_scaled - t_l);
+    r_u = mask_u.cwiseProduct(qpwork.u_scaled - Cx - t_u);
+
+    PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::FACTORIZATION);
+    d = (mask_l.array() * lambda_l.array() / t_l.array() +
+         mask_u.array() * lambda_u.array() / t_u.array())
+          .matrix();
+    // the rows with a large weight (close to active) are kept in the system
+    // with the diagonal entry -1 / d, which is better conditioned than their
+    // contribution to the condensed block
+    n_augmented = 0;
+    for (isize i = 0; i < n_in; ++i) {
+      if (d[i] > T(1)) {
+        augmented[n_augmented] = i;
+        ++n_augmented;
+        d_condensed[i] = T(0);
+      } else {
+        d_condensed[i] = d[i];
+      }
+    }
+    dim = n + n_eq + n_augmented;
+    // the matrix is assembled in the memory stack of the workspace
+    LDLT_TEMP_MAT_UNINIT(T, kkt, dim, dim, stack);
+    kkt.topLeftCorner(n, n) = qpwork.H_scaled;
+    {
+      LDLT_TEMP_MAT_UNINIT(T, sqrt_d_C, n_in, n, stack);
+      sqrt_d_C = d_condensed.cwiseSqrt().asDiagonal() * qpwork.C_scaled;
+      kkt.topLeftCorner(n, n)
+        .template selfadjointView<Eigen::Lower>()
+        .rankUpdate(sqrt_d_C.transpose());
+    }
+    kkt.block(n, 0, n_eq, n) = qpwork.A_scaled;
+    kkt.block(n, n, dim - n, dim - n).setZero();
+    for (isize k = 0; k < n_augmented; ++k) {
+      isize i = augmented[k];
+      kkt.row(n + n_eq + k).head(n) = qpwork.C_scaled.row(i);
+      kkt(n + n_eq + k, n + n_eq + k) = -T(1) / d[i];
+    }
+    T regularization(0);
+    for (T next = regularization_min;; next *= T(100)) {
+      kkt.diagonal().head(n).array() += next - regularization;
+      kkt.diagonal().segment(n, dim - n).array() -= next - regularization;
+      regularization = next;
+      ldl.factorize(kkt, stack);
+      auto pivots = ldl.d();
+      if ((pivots.array().abs() > T(0)).all() && pivots.allFinite()) {
+        break;
+      }
+      if (regularization >= regularization_max) {
+        break;
+      }
+    }
+  };
+
+  if (!state.interior_point_started) {
+    Cx.noalias() = qpwork.C_scaled * x;
+    // the infinite sides keep t = 1 and lambda = 0
+    t_l = (mask_l.array() > T(0))
+            .select((Cx - qpwork.l_scaled).array().cwiseMax(T(1)), T(1))
+            .matrix();
+    t_u = (mask_u.array() > T(0))
+            .select((qpwork.u_scaled - Cx).array().cwiseMax(T(1)), T(1))
+            .matrix();
+    lambda_l = mask_l;
+    lambda_u = mask_u;
+
+    // starting point (Mehrotra's heuristic): full affine scaling step from
+    // t = lambda = 1, whose slacks and multipliers are then shifted to be
+    // positive and of balanced products
+    linearize();
+    r_cl = t_l.cwiseProduct(lambda_l);
+    r_cu = t_u.cwiseProduct(lambda_u);
+    newton_step();
+    x += sol.head(n);
+    y += sol.segment(n, n_eq);
+    if (n_sides > T(0)) {
+      t_l += dt_l;
+      t_u += dt_u;
+      lambda_l += dlambda_l;
+      lambda_u += dlambda_u;
+      T t_min = std::numeric_limits<T>::infinity();
+      T lambda_min = std::numeric_limits<T>::infinity();
+      for (isize i = 0; i < n_in; ++i) {
+        if (mask_l[i] > T(0)) {
+          t_min = std::min(t_min, t_l[i]);
+          lambda_min = std::min(lambda_min, lambda_l[i]);
+        }
+        if (mask_u[i] > T(0)) {
+          t_min = std::min(t_min, t_u[i]);
+          lambda_min = std::min(lambda_min, lambda_u[i]);
+        }
+      }
+      T t_shift = std::max(-T(1.5) * t_min, T(0));
+      T lambda_shift = std::max(-T(1.5) * lambda_min, T(0));
+      t_l += t_shift * mask_l;
+      t_u += t_shift * mask_u;
+      lambda_l += lambda_shift * mask_l;
+      lambda_u += lambda_shift * mask_u;
+      T product = t_l.dot(lambda_l) + t_u.dot(lambda_u);
+      T t_sum = t_l.dot(mask_l) + t_u.dot(mask_u);
+      T lambda_sum = lambda_l.sum() + lambda_u.sum();
+      if (product > T(0)) {
+        t_shift = T(0.5) * product / lambda_sum;
+        lambda_shift = T(0.5) * product / t_sum;
+      } else {
+        t_shift = T(1);
+        lambda_shift = T(1);
+      }
+      t_l =
+        (mask_l.array() > T(0)).select(t_l.array() + t_shift, T(1)).matrix();
+      t_u =
+        (mask_u.array() > T(0)).select(t_u.array() + t_shift, T(1)).matrix();
+      lambda_l += lambda_shift * mask_l;
+      lambda_u += lambda_shift * mask_u;
+    }
+
+    state.interior_point_started = true;
+  }
+
+  T primal_feasibility_lhs(0);
+  T primal_feasibility_eq_rhs_0(0);
+  T primal_feasibility_in_rhs_0(0);
+  T primal_feasibility_eq_lhs(0);
+  T primal_feasibility_in_lhs(0);
+  T dual_feasibility_lhs(0);
+  T dual_feasibility_rhs_0(0);
+  T dual_feasibility_rhs_1(0);
+  T dual_feasibility_rhs_3(0);
+
+  for (; state.iter < qpsettings.max_iter; ++state.iter) {
+    i64 const iter = state.iter;
+    if (budget == 0) {
+      return false;
+    }
+    trace::Span iteration_span("interior_point_iteration", iter);
+
+    z = lambda_u - lambda_l;
+    global_primal_residual(qpmodel,
+                           qpresults,
+                           qpwork,
+                           ruiz,
+                           primal_feasibility_lhs,
+                           primal_feasibility_eq_rhs_0,
+                           primal_feasibility_in_rhs_0,
+                           primal_feasibility_eq_lhs,
+                           primal_feasibility_in_lhs);
+    global_dual_residual(qpresults,
+                         qpwork,
+                         ruiz,
+                         dual_feasibility_lhs,
+                         dual_feasibility_rhs_0,
+                         dual_feasibility_rhs_1,
+                         dual_feasibility_rhs_3);
+    // the unscaled complementarity t lambda is the scaled one divided by c
+    T complementarity =
+      std::max(T(t_l.cwiseProduct(lambda_l).maxCoeff()),
+               T(t_u.cwiseProduct(lambda_u).maxCoeff())) /
+      ruiz.c;
+    if (n_in == 0) {
+      complementarity = T(0);
+    }
+    qpresults.info.pri_res = primal_feasibility_lhs;
+    qpresults.info.dua_res = dual_feasibility_lhs;
+    if (is_observing<Observer>()) {
+      observer(make_iteration_record(iter,
+                                     primal_feasibility_lhs,
+                                     dual_feasibility_lhs,
+                                     qpresults.info,
+                                     isize(0),
+                                     alpha));
+    }
+    if (qpsettings.verbose) {
+      std::cout << "\033[1;32m[interior point iteration " << iter + 1
+                << "]\033[0m" << std::endl;
+      std::cout << std::scientific << std::setw(2) << std::setprecision(2)
+                << "| primal residual=" << primal_feasibility_lhs
+                << "| dual residual=" << dual_feasibility_lhs
+                << " | complementarity=" << complementarity
+                << " | step=" << alpha << std::endl;
+    }
+
+    T rhs_pri(qpsettings.eps_abs);
+    T rhs_dua(qpsettings.eps_abs);
+    if (qpsettings.eps_rel != 0) {
+      rhs_pri +=
+        qpsettings.eps_rel *
+        std::max(
+          std::max(primal_feasibility_eq_rhs_0, primal_feasibility_in_rhs_0),
+          std::max(std::max(qpwork.primal_feasibility_rhs_1_eq,
+                            qpwork.primal_feasibility_rhs_1_in_u),
+                   qpwork.primal_feasibility_rhs_1_in_l));
+      rhs_dua +=
+        qpsettings.eps_rel *
+        std::max(
+          std::max(dual_feasibility_rhs_3, dual_feasibility_rhs_0),
+          std::max(dual_feasibility_rhs_1, qpwork.dual_feasibility_rhs_2));
+    }
+    if (primal_feasibility_lhs <= rhs_pri &&
+        dual_feasibility_lhs <= rhs_dua &&
+        complementarity <= qpsettings.eps_abs) {
+      qpresults.info.status = QPSolverOutput::PROXQP_SOLVED;
+      break;
+    }
+    if (!std::isfinite(primal_feasibility_lhs) ||
+        !std::isfinite(dual_feasibility_lhs)) {
+      break;
+    }
+    if (qpwork.deadline.is_set()) {
+      qpwork.best.update(x,
+                         y,
+                         z,
+                         primal_feasibility_lhs,
+                         dual_feasibility_lhs,
+                         std::max(std::max(primal_feasibility_lhs,
+                                           dual_feasibility_lhs),
+                                  complementarity));
+      if (qpwork.deadline.reached()) {
+        x = qpwork.best.x;
+        y = qpwork.best.y;
+        z = qpwork.best.z;
+        qpresults.info.pri_res = qpwork.best.pri_res;
+        qpresults.info.dua_res = qpwork.best.dua_res;
+        qpresults.info.status = QPSolverOutput::PROXQP_TIME_LIMIT_REACHED;
+        return true;
+      }
+    }
+    qpresults.info.iter_ext += 1;
+    qpresults.info.iter += 1;
+    --budget;
+
+    T mu = n_sides > T(0) ? (t_l.dot(lambda_l) + t_u.dot(lambda_u)) / n_sides
+                          : T(0);
+    linearize();
+
+    // predictor (affine scaling) step
+    r_cl = t_l.cwiseProduct(lambda_l);
+    r_cu = t_u.cwiseProduct(lambda_u);
+    newton_step();
+    T alpha_aff = std::min(
+      T(1),
+      std::min(std::min(max_step(t_l, dt_l), max_step(t_u, dt_u)),
+               std::min(max_step(lambda_l, dlambda_l),
+                        max_step(lambda_u, dlambda_u))));
+    T mu_aff =
+      n_sides > T(0)
+        ? ((t_l + alpha_aff * dt_l).dot(lambda_l + alpha_aff * dlambda_l) +
+           (t_u + alpha_aff * dt_u).dot(lambda_u + alpha_aff * dlambda_u)) /
+            n_sides
+        : T(0);
+    T sigma = mu > T(0) ? std::pow(mu_aff / mu, T(3)) : T(0);
+
+    // corrector step, centered with sigma mu and with the second order term
+    // of the predictor step. The centering target is kept above a fraction of
+    // the complementarity tolerance, so that the Newton system does not become
+    // more ill-conditioned than needed while the residuals are reduced.
+    T target = std::max(sigma * mu, complementarity_floor);
+    r_cl = (mask_l.array() * (t_l.array() * lambda_l.array() +
+                              dt_l.array() * dlambda_l.array() - target))
+             .matrix();
+    r_cu = (mask_u.array() * (t_u.array() * lambda_u.array() +
+                              dt_u.array() * dlambda_u.array() - target))
+             .matrix();
+    newton_step();
+    alpha = std::min(
+      T(1),
+      step_fraction *
+        std::min(std::min(max_step(t_l, dt_l), max_step(t_u, dt_u)),
+                 std::min(max_step(lambda_l, dlambda_l),
+                          max_step(lambda_u, dlambda_u))));
+
+    if (!sol.head(dim).allFinite() || !dlambda_l.allFinite() ||
+        !dlambda_u.allFinite()) {
+      // the Newton system is too ill-conditioned: the last iterate is kept
+      break;
+    }
+    x += alpha * sol.head(n);
+    y += alpha * sol.segment(n, n_eq);
+    t_l += alpha * dt_l;
+    t_u += alpha * dt_u;
+    lambda_l += alpha * dlambda_l;
+    lambda_u += alpha * dlambda_u;
+  }
+  z = lambda_u - lambda_l;
+  return true;
+}
+
+} // namespace interior_point
+} // namespace dense
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_DENSE_INTERIOR_POINT_HPP */
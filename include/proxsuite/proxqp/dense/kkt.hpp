@@ -0,0 +1,546 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file kkt.hpp
+ */
+#ifndef PROXSUITE_QP_DENSE_KKT_HPP
+#define PROXSUITE_QP_DENSE_KKT_HPP
+
+#include <proxsuite/linalg/dense/ldlt.hpp>
+#include <proxsuite/linalg/veg/util/dynstack_alloc.hpp>
+#include "proxsuite/proxqp/dense/model.hpp"
+#include "proxsuite/proxqp/dense/workspace.hpp"
+#include "proxsuite/proxqp/results.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+namespace dense {
+/*!
+ * Builds and factorizes the condensed KKT matrix
+ * H + rho I + A^T A / mu_eq + C_a^T C_a / mu_in, C_a being the rows of C of the
+ * qpwork.n_c active inequalities.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace.
+ * @param rho primal proximal parameter.
+ * @param mu_eq dual equality constrained proximal parameter.
+ * @param mu_in dual inequality constrained proximal parameter.
+ */
+template<typename T>
+void
+factorize_condensed_kkt(const Model<T>& qpmodel,
+                        Workspace<T>& qpwork,
+                        T rho,
+                        T mu_eq,
+                        T mu_in)
+{
+  isize n = qpmodel.dim;
+  isize n_c = qpwork.n_c;
+
+  proxsuite::linalg::veg::dynstack::DynStackMut stack{
+    proxsuite::linalg::veg::from_slice_mut, qpwork.ldl_stack.as_mut()
+  };
+
+  qpwork.kkt = qpwork.H_scaled;
+  qpwork.kkt.diagonal().array() += rho;
+  if (qpmodel.n_eq > 0) {
+    qpwork.kkt.template selfadjointView<Eigen::Lower>().rankUpdate(
+      qpwork.A_scaled.transpose(), T(1) / mu_eq);
+  }
+  if (n_c > 0) {
+    LDLT_TEMP_MAT_UNINIT(T, active_rows, n, n_c, stack);
+    for (isize i = 0; i < qpmodel.n_in; ++i) {
+      isize j = qpwork.current_bijection_map(i);
+      if (j < n_c) {
+        active_rows.col(j) = qpwork.C_scaled.row(i).transpose();
+      }
+    }
+    qpwork.kkt.template selfadjointView<Eigen::Lower>().rankUpdate(
+      active_rows, T(1) / mu_in);
+  }
+  qpwork.ldl.factorize(qpwork.kkt, stack);
+}
+/*!
+ * Adds alpha C_i^T C_i to the factorized condensed KKT matrix, for the given
+ * inequalities i.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace.
+ * @param indices indices of the inequalities.
+ * @param count number of inequalities.
+ * @param alpha 1 / mu_in for an activation, -1 / mu_in for a deactivation.
+ * @param stack memory stack of the workspace.
+ */
+template<typename T>
+void
+condensed_active_set_update(const Model<T>& qpmodel,
+                            Workspace<T>& qpwork,
+                            isize const* indices,
+                            isize count,
+                            T alpha,
+                            proxsuite::linalg::veg::dynstack::DynStackMut stack)
+{
+  if (count == 0) {
+    return;
+  }
+  LDLT_TEMP_MAT_UNINIT(T, w, qpmodel.dim, count, stack);
+  LDLT_TEMP_VEC_UNINIT(T, alphas, count, stack);
+  for (isize k = 0; k < count; ++k) {
+    w.col(k) = qpwork.C_scaled.row(indices[k]).transpose();
+  }
+  alphas.setConstant(alpha);
+  qpwork.ldl.rank_r_update(w, alphas, stack);
+}
+/*!
+ * Grows the memory stack of the workspace so that the DUAL mode can factorize
+ * H_scaled + rho I when H is not diagonal.
+ *
+ * @param qpwork solver workspace.
+ */
+template<typename T>
+void
+reserve_dual_kkt_dense_hessian(Workspace<T>& qpwork)
+{
+  isize req = dual_kkt_stack_req<T>(qpwork.H_scaled.rows(),
+                                    qpwork.A_scaled.rows(),
+                                    qpwork.C_scaled.rows(),
+                                    true)
+                .alloc_req();
+  if (qpwork.ldl_stack.len() < req) {
+    qpwork.ldl_stack.resize_for_overwrite(req);
+  }
+}
+/*!
+ * Inspects the structure of H_scaled and chooses the linear system of the
+ * AUTOMATIC mode when it depends on it (see KktMode).
+ *
+ * @param qpwork solver workspace.
+ */
+template<typename T>
+void
+select_kkt_mode(Workspace<T>& qpwork)
+{
+  isize n = qpwork.H_scaled.rows();
+  bool allowed = dual_kkt_mode_allowed(qpwork.requested_kkt_mode,
+                                       n,
+                                       qpwork.A_scaled.rows(),
+                                       qpwork.C_scaled.rows());
+  if (!allowed && qpwork.kkt_mode != KktMode::DUAL) {
+    return;
+  }
+  qpwork.h_diagonal = true;
+  for (isize j = 0; j < n && qpwork.h_diagonal; ++j) {
+    for (isize i = j + 1; i < n; ++i) {
+      if (qpwork.H_scaled(i, j) != T(0)) {
+        qpwork.h_diagonal = false;
+        break;
+      }
+    }
+  }
+  if (allowed) {
+    qpwork.kkt_mode =
+      qpwork.h_diagonal ? KktMode::DUAL : KktMode::AUGMENTED;
+  } else if (!qpwork.h_diagonal) {
+    reserve_dual_kkt_dense_hessian(qpwork);
+  }
+}
+/*!
+ * Solves in place (H_scaled + rho I) x = rhs, with the inverse diagonal or the
+ * factorization computed by factorize_dual_kkt.
+ *
+ * @param qpwork solver workspace.
+ * @param rhs right hand side, overwritten by the solution.
+ * @param stack memory stack of the workspace.
+ */
+template<typename T>
+void
+dual_kkt_hessian_solve_in_place(
+  const Workspace<T>& qpwork,
+  Eigen::Ref<Vec<T>> rhs,
+  proxsuite::linalg::veg::dynstack::DynStackMut stack)
+{
+  if (qpwork.h_diagonal) {
+    rhs.array() *= qpwork.h_rho_inv.array();
+  } else {
+    qpwork.ldl_h.solve_in_place(rhs, stack);
+  }
+}
+/*!
+ * Builds and factorizes the dual KKT matrix
+ * B (H + rho I)^-1 B^T + diag(mu_eq, mu_in), B = [A; C_a] gathering the rows
+ * of A and of C for the qpwork.n_c active inequalities.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace.
+ * @param rho primal proximal parameter.
+ * @param mu_eq dual equality constrained proximal parameter.
+ * @param mu_in dual inequality constrained proximal parameter.
+ */
+template<typename T>
+void
+factorize_dual_kkt(const Model<T>& qpmodel,
+                   Workspace<T>& qpwork,
+                   T rho,
+                   T mu_eq,
+                   T mu_in)
+{
+  isize n = qpmodel.dim;
+  isize n_eq = qpmodel.n_eq;
+  isize m = n_eq + qpwork.n_c;
+
+  proxsuite::linalg::veg::dynstack::DynStackMut stack{
+    proxsuite::linalg::veg::from_slice_mut, qpwork.ldl_stack.as_mut()
+  };
+
+  if (qpwork.h_diagonal) {
+    qpwork.h_rho_inv =
+      (qpwork.H_scaled.diagonal().array() + rho).inverse().matrix();
+  } else {
+    LDLT_TEMP_MAT_UNINIT(T, h_rho, n, n, stack);
+    h_rho = qpwork.H_scaled;
+    h_rho.diagonal().array() += rho;
+    qpwork.ldl_h.factorize(h_rho, stack);
+  }
+
+  LDLT_TEMP_MAT_UNINIT(T, bt, n, m, stack);
+  LDLT_TEMP_MAT_UNINIT(T, h_inv_bt, n, m, stack);
+  LDLT_TEMP_MAT_UNINIT(T, schur, m, m, stack);
+  bt.leftCols(n_eq) = qpwork.A_scaled.transpose();
+  for (isize i = 0; i < qpmodel.n_in; ++i) {
+    isize j = qpwork.current_bijection_map(i);
+    if (j < qpwork.n_c) {
+      bt.col(n_eq + j) = qpwork.C_scaled.row(i).transpose();
+    }
+  }
+  h_inv_bt = bt;
+  for (isize k = 0; k < m; ++k) {
+    dual_kkt_hessian_solve_in_place<T>(qpwork, h_inv_bt.col(k), stack);
+  }
+  schur.noalias() = bt.transpose() * h_inv_bt;
+  schur.diagonal().head(n_eq).array() += mu_eq;
+  schur.diagonal().tail(m - n_eq).array() += mu_in;
+  qpwork.ldl.factorize(schur, stack);
+}
+/*!
+ * Inserts the given inequalities at the end of the factorized dual KKT matrix.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace, whose new_bijection_map gives the positions
+ * of the active inequalities after the insertion.
+ * @param indices indices of the inequalities.
+ * @param count number of inequalities.
+ * @param n_c number of active inequalities before the insertion.
+ * @param mu_in dual inequality constrained proximal parameter.
+ * @param stack memory stack of the workspace.
+ */
+template<typename T>
+void
+dual_kkt_insert_constraints(
+  const Model<T>& qpmodel,
+  Workspace<T>& qpwork,
+  isize const* indices,
+  isize count,
+  isize n_c,
+  T mu_in,
+  proxsuite::linalg::veg::dynstack::DynStackMut stack)
+{
+  isize n = qpmodel.dim;
+  isize n_eq = qpmodel.n_eq;
+  isize n_c_f = n_c + count;
+  LDLT_TEMP_MAT_UNINIT(T, new_cols, n_eq + n_c_f, count, stack);
+  LDLT_TEMP_VEC_UNINIT(T, h_inv_c, n, stack);
+  LDLT_TEMP_VEC_UNINIT(T, c_h_inv_c, qpmodel.n_in, stack);
+
+  for (isize k = 0; k < count; ++k) {
+    auto col = new_cols.col(k);
+    h_inv_c = qpwork.C_scaled.row(indices[k]).transpose();
+    dual_kkt_hessian_solve_in_place<T>(qpwork, h_inv_c, stack);
+    col.head(n_eq).noalias() = qpwork.A_scaled * h_inv_c;
+    c_h_inv_c.noalias() = qpwork.C_scaled * h_inv_c;
+    for (isize i = 0; i < qpmodel.n_in; ++i) {
+      isize j = qpwork.new_bijection_map(i);
+      if (j < n_c_f) {
+        col(n_eq + j) = c_h_inv_c(i);
+      }
+    }
+    col(n_eq + n_c + k) += mu_in;
+  }
+  qpwork.ldl.insert_block_at(n_eq + n_c, new_cols, stack);
+}
+/*!
+ * Orders the rows of the banded KKT matrix (see KktMode::BANDED), computes its
+ * bandwidth from the sparsity pattern of H_scaled, A_scaled and C_scaled, and
+ * resizes the banded factorization accordingly.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace.
+ */
+template<typename T>
+void
+setup_banded_kkt(const Model<T>& qpmodel, Workspace<T>& qpwork)
+{
+  isize n = qpmodel.dim;
+  isize n_eq = qpmodel.n_eq;
+  isize m = n_eq + qpmodel.n_in;
+  auto& position = qpwork.band_position;
+
+  // first and last variables of each constraint (-1 if it has none), and
+  // number of constraints placed right after each variable (the constraints
+  // without variables being placed first)
+  VecISize first(m);
+  VecISize last(m);
+  VecISize count = VecISize::Zero(n + 1);
+  for (isize r = 0; r < m; ++r) {
+    auto row = r < n_eq ? qpwork.A_scaled.row(r)
+                        : qpwork.C_scaled.row(r - n_eq);
+    first(r) = -1;
+    last(r) = -1;
+    for (isize v = 0; v < n; ++v) {
+      if (row(v) != T(0)) {
+        if (first(r) < 0) {
+          first(r) = v;
+        }
+        last(r) = v;
+      }
+    }
+    ++count(last(r) + 1);
+  }
+  VecISize next(n + 1);
+  isize p = 0;
+  for (isize k = 0; k <= n; ++k) {
+    if (k > 0) {
+      position(k - 1) = p;
+      ++p;
+    }
+    next(k) = p;
+    p += count(k);
+  }
+  for (isize r = 0; r < m; ++r) {
+    position(n + r) = next(last(r) + 1)++;
+  }
+
+  isize bandwidth = 0;
+  for (isize j = 0; j < n; ++j) {
+    for (isize i = j + 1; i < n; ++i) {
+      if (qpwork.H_scaled(i, j) != T(0)) {
+        bandwidth = std::max(bandwidth, position(i) - position(j));
+      }
+    }
+  }
+  for (isize r = 0; r < m; ++r) {
+    if (first(r) >= 0) {
+      bandwidth = std::max(bandwidth, position(n + r) - position(first(r)));
+    }
+  }
+  qpwork.band_ldl.reset(n + m, bandwidth);
+}
+/*!
+ * Sets the row of a constraint in the banded KKT matrix, without updating its
+ * factorization. An active constraint is coupled with its variables and has
+ * -mu on the diagonal, an inactive one is decoupled with a unit diagonal.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace.
+ * @param k index of the constraint (k < n_eq for an equality, n_eq + i for the
+ * inequality i).
+ * @param active whether the constraint is active.
+ * @param mu dual proximal parameter of the constraint.
+ * @return the position of the row in the banded KKT matrix.
+ */
+template<typename T>
+isize
+banded_kkt_set_constraint(const Model<T>& qpmodel,
+                          Workspace<T>& qpwork,
+                          isize k,
+                          bool active,
+                          T mu)
+{
+  isize n = qpmodel.dim;
+  isize p = qpwork.band_position(n + k);
+  auto& band = qpwork.band_ldl;
+  band.clear_row(p);
+  if (!active) {
+    band.coeff_mut(p, p) = T(1);
+    return p;
+  }
+  auto row = k < qpmodel.n_eq ? qpwork.A_scaled.row(k)
+                              : qpwork.C_scaled.row(k - qpmodel.n_eq);
+  for (isize v = 0; v < n; ++v) {
+    if (row(v) != T(0)) {
+      band.coeff_mut(p, qpwork.band_position(v)) = row(v);
+    }
+  }
+  band.coeff_mut(p, p) = -mu;
+  return p;
+}
+/*!
+ * Builds and factorizes the banded KKT matrix, the qpwork.n_c active
+ * inequalities being given by qpwork.current_bijection_map.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace.
+ * @param rho primal proximal parameter.
+ * @param mu_eq dual equality constrained proximal parameter.
+ * @param mu_in dual inequality constrained proximal parameter.
+ */
+template<typename T>
+void
+factorize_banded_kkt(const Model<T>& qpmodel,
+                     Workspace<T>& qpwork,
+                     T rho,
+                     T mu_eq,
+                     T mu_in)
+{
+  isize n = qpmodel.dim;
+  auto& band = qpwork.band_ldl;
+  auto const& position = qpwork.band_position;
+
+  for (isize j = 0; j < n; ++j) {
+    band.clear_row(position(j));
+  }
+  for (isize j = 0; j < n; ++j) {
+    for (isize i = j;
+         i < n && position(i) - position(j) <= band.bandwidth();
+         ++i) {
+      band.coeff_mut(position(i), position(j)) = qpwork.H_scaled(i, j);
+    }
+    band.coeff_mut(position(j), position(j)) += rho;
+  }
+  for (isize k = 0; k < qpmodel.n_eq; ++k) {
+    banded_kkt_set_constraint(qpmodel, qpwork, k, true, mu_eq);
+  }
+  for (isize i = 0; i < qpmodel.n_in; ++i) {
+    banded_kkt_set_constraint(qpmodel,
+                              qpwork,
+                              qpmodel.n_eq + i,
+                              qpwork.current_bijection_map(i) < qpwork.n_c,
+                              mu_in);
+  }
+  band.factorize(0);
+}
+/*!
+ * Solves in place the KKT system of the current active set with the factorized
+ * matrix of the workspace. The vector is ordered as the augmented KKT system
+ * (primal, equality and active inequality parts).
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpresults solver results.
+ * @param qpwork solver workspace.
+ * @param rhs right hand side, overwritten by the solution.
+ * @param stack memory stack of the workspace.
+ */
+template<typename T>
+void
+solve_kkt_in_place(const Model<T>& qpmodel,
+                   const Results<T>& qpresults,
+                   Workspace<T>& qpwork,
+                   Eigen::Ref<Vec<T>> rhs,
+                   proxsuite::linalg::veg::dynstack::DynStackMut stack)
+{
+  if (qpwork.kkt_mode == KktMode::AUGMENTED) {
+    qpwork.ldl.solve_in_place(rhs, stack);
+    return;
+  }
+
+  isize n = qpmodel.dim;
+  isize n_eq = qpmodel.n_eq;
+  isize n_c = rhs.rows() - n - n_eq;
+  T mu_eq = qpresults.info.mu_eq;
+  T mu_in = qpresults.info.mu_in;
+
+  if (qpwork.kkt_mode == KktMode::BANDED) {
+    // the rows of the inactive inequalities are decoupled: their part of the
+    // solution vanishes with their right hand side
+    auto const& position = qpwork.band_position;
+    LDLT_TEMP_VEC(T, work, qpwork.band_ldl.dim(), stack);
+    for (isize k = 0; k < n + n_eq; ++k) {
+      work(position(k)) = rhs(k);
+    }
+    for (isize i = 0; i < qpmodel.n_in; ++i) {
+      isize j = qpwork.current_bijection_map(i);
+      if (j < n_c) {
+        work(position(n + n_eq + i)) = rhs(n + n_eq + j);
+      }
+    }
+    qpwork.band_ldl.solve_in_place(work);
+    for (isize k = 0; k < n + n_eq; ++k) {
+      rhs(k) = work(position(k));
+    }
+    for (isize i = 0; i < qpmodel.n_in; ++i) {
+      isize j = qpwork.current_bijection_map(i);
+      if (j < n_c) {
+        rhs(n + n_eq + j) = work(position(n + n_eq + i));
+      }
+    }
+    return;
+  }
+
+  if (qpwork.kkt_mode == KktMode::DUAL) {
+    // eliminates the primal variable: dx = (H + rho I)^-1 (r_x - B^T dw), with
+    // (B (H + rho I)^-1 B^T + diag(mu)) dw = B (H + rho I)^-1 r_x - r_w
+    LDLT_TEMP_VEC_UNINIT(T, dx, n, stack);
+    dx = rhs.head(n);
+    dual_kkt_hessian_solve_in_place<T>(qpwork, dx, stack);
+    auto dw = rhs.tail(n_eq + n_c);
+    dw.head(n_eq) = -dw.head(n_eq);
+    dw.head(n_eq).noalias() += qpwork.A_scaled * dx;
+    for (isize i = 0; i < qpmodel.n_in; ++i) {
+      isize j = qpwork.current_bijection_map(i);
+      if (j < n_c) {
+        dw(n_eq + j) = qpwork.C_scaled.row(i).dot(dx) - dw(n_eq + j);
+      }
+    }
+    qpwork.ldl.solve_in_place(dw, stack);
+
+    dx = rhs.head(n);
+    dx.noalias() -= qpwork.A_scaled.transpose() * dw.head(n_eq);
+    for (isize i = 0; i < qpmodel.n_in; ++i) {
+      isize j = qpwork.current_bijection_map(i);
+      if (j < n_c) {
+        dx -= dw(n_eq + j) * qpwork.C_scaled.row(i).transpose();
+      }
+    }
+    dual_kkt_hessian_solve_in_place<T>(qpwork, dx, stack);
+    rhs.head(n) = dx;
+    return;
+  }
+
+  // eliminates the multipliers: dy = (A dx - r_y) / mu_eq and
+  // dz = (C_a dx - r_z) / mu_in
+  LDLT_TEMP_VEC_UNINIT(T, dx, n, stack);
+  dx = rhs.head(n);
+  dx.noalias() += qpwork.A_scaled.transpose() * rhs.segment(n, n_eq) / mu_eq;
+  for (isize i = 0; i < qpmodel.n_in; ++i) {
+    isize j = qpwork.current_bijection_map(i);
+    if (j < n_c) {
+      dx += (rhs(n + n_eq + j) / mu_in) * qpwork.C_scaled.row(i).transpose();
+    }
+  }
+  qpwork.ldl.solve_in_place(dx, stack);
+
+  rhs.head(n) = dx;
+  rhs.segment(n, n_eq) =
+    (qpwork.A_scaled * dx - rhs.segment(n, n_eq)) / mu_eq;
+  for (isize i = 0; i < qpmodel.n_in; ++i) {
+    isize j = qpwork.current_bijection_map(i);
+    if (j < n_c) {
+      rhs(n + n_eq + j) =
+        (qpwork.C_scaled.row(i).dot(dx) - rhs(n + n_eq + j)) / mu_in;
+    }
+  }
+}
+
+} // namespace dense
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_DENSE_KKT_HPP */
@@ -9,7 +9,9 @@
 #include "proxsuite/proxqp/dense/model.hpp"
 #include "proxsuite/proxqp/results.hpp"
 #include "proxsuite/proxqp/dense/workspace.hpp"
+#include "proxsuite/proxqp/dense/kkt.hpp"
 #include "proxsuite/proxqp/settings.hpp"
+#include "proxsuite/proxqp/trace.hpp"
 #include <cmath>
 
 namespace proxsuite {
@@ -188,6 +190,7 @@ primal_dual_ls(const Model<T>& qpmodel,
                Results<T>& qpresults,
                Workspace<T>& qpwork)
 {
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::LINE_SEARCH);
 
   /*
    * The algorithm performs the following step
@@ -352,7 +355,10 @@ primal_dual_ls(const Model<T>& qpmodel,
 
 /*!
  * Performs the active set change of the factorized KKT matrix (using rank one
- * updates or downgrades).
+ * updates or downgrades). In condensed mode, the rows of the inequalities
+ * entering (resp. leaving) the active set are added to (resp. subtracted from)
+ * the factorized matrix with a rank update. In dual mode, the rows and columns
+ * of the dual KKT matrix are inserted or deleted as in the augmented one.
  *
  * @param qpwork solver workspace.
  * @param qpmodel QP problem model as defined by the user (without any scaling
@@ -365,6 +371,8 @@ active_set_change(const Model<T>& qpmodel,
                   Results<T>& qpresults,
                   Workspace<T>& qpwork)
 {
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::ACTIVE_SET_UPDATE);
+  trace::Span span("active_set_change");
 
   /*
    * arguments
@@ -417,6 +425,13 @@ active_set_change(const Model<T>& qpmodel,
 
   isize n_c_f = qpwork.n_c;
   qpwork.new_bijection_map = qpwork.current_bijection_map;
+  bool condensed = qpwork.kkt_mode == KktMode::CONDENSED;
+  bool banded = qpwork.kkt_mode == KktMode::BANDED;
+  // first row of the banded KKT matrix modified by the active set change
+  isize band_first = qpwork.band_ldl.dim();
+  // offset of the inequality rows in the factorized matrix
+  isize in_offset =
+    (qpwork.kkt_mode == KktMode::DUAL ? 0 : qpmodel.dim) + qpmodel.n_eq;
 
   // suppression pour le nouvel active set, ajout dans le nouvel unactive set
 
@@ -436,7 +451,8 @@ active_set_change(const Model<T>& qpmodel,
           // delete current_bijection_map(i)
 
           planned_to_delete[planned_to_delete_count] =
-            qpwork.current_bijection_map(i) + qpmodel.dim + qpmodel.n_eq;
+            (condensed || banded) ? i
+                                  : qpwork.current_bijection_map(i) + in_offset;
           ++planned_to_delete_count;
 
           for (isize j = 0; j < qpmodel.n_in; j++) {
@@ -449,8 +465,28 @@ active_set_change(const Model<T>& qpmodel,
         }
       }
     }
-    std::sort(planned_to_delete, planned_to_delete + planned_to_delete_count);
-    qpwork.ldl.delete_at(planned_to_delete, planned_to_delete_count, stack);
+    if (condensed) {
+      condensed_active_set_update(qpmodel,
+                                  qpwork,
+                                  planned_to_delete,
+                                  planned_to_delete_count,
+                                  -T(1) / qpresults.info.mu_in,
+                                  stack);
+    } else if (banded) {
+      for (isize k = 0; k < planned_to_delete_count; ++k) {
+        band_first = std::min(
+          band_first,
+          banded_kkt_set_constraint(qpmodel,
+                                    qpwork,
+                                    qpmodel.n_eq + planned_to_delete[k],
+                                    false,
+                                    qpresults.info.mu_in));
+      }
+    } else {
+      std::sort(planned_to_delete,
+                planned_to_delete + planned_to_delete_count);
+      qpwork.ldl.delete_at(planned_to_delete, planned_to_delete_count, stack);
+    }
     if (planned_to_delete_count > 0) {
       qpwork.constraints_changed = true;
     }
@@ -484,7 +520,32 @@ active_set_change(const Model<T>& qpmodel,
         }
       }
     }
-    {
+    if (condensed) {
+      condensed_active_set_update(qpmodel,
+                                  qpwork,
+                                  planned_to_add,
+                                  planned_to_add_count,
+                                  T(1) / qpresults.info.mu_in,
+                                  stack);
+    } else if (banded) {
+      for (isize k = 0; k < planned_to_add_count; ++k) {
+        band_first = std::min(
+          band_first,
+          banded_kkt_set_constraint(qpmodel,
+                                    qpwork,
+                                    qpmodel.n_eq + planned_to_add[k],
+                                    true,
+                                    qpresults.info.mu_in));
+      }
+    } else if (qpwork.kkt_mode == KktMode::DUAL) {
+      dual_kkt_insert_constraints(qpmodel,
+                                  qpwork,
+                                  planned_to_add,
+                                  planned_to_add_count,
+                                  n_c,
+                                  qpresults.info.mu_in,
+                                  stack);
+    } else {
       isize n = qpmodel.dim;
       isize n_eq = qpmodel.n_eq;
       LDLT_TEMP_MAT_UNINIT(
@@ -504,6 +565,10 @@ active_set_change(const Model<T>& qpmodel,
     }
   }
 
+  if (banded && band_first < qpwork.band_ldl.dim()) {
+    qpwork.band_ldl.factorize(band_first);
+  }
+
   qpwork.n_c = n_c_f;
   qpwork.current_bijection_map = qpwork.new_bijection_map;
   qpwork.dw_aug.setZero();
@@ -14,6 +14,24 @@ namespace proxsuite {
 namespace proxqp {
 namespace dense {
 ///
+/// @brief Storage policy of the matrices of a dense QP model.
+///
+/*!
+ * With OWNING, the model keeps an unscaled copy of H, A and C next to the
+ * scaled copy of the workspace. With NON_OWNING, the model only keeps the
+ * vectors: the matrices given to init and update are copied once into the
+ * workspace, and their unscaled values are recovered from the scaled copy
+ * through the Ruiz scaling variables when needed (e.g., for computing the
+ * objective value or for updating the model). It halves the memory footprint
+ * of the matrices, at the price of an unscaling of the matrices at each
+ * update.
+ */
+enum struct ModelStorage
+{
+  OWNING,
+  NON_OWNING,
+};
+///
 /// @brief This class stores the model of the QP problem.
 ///
 /*!
@@ -37,17 +55,27 @@ struct Model
   isize n_eq;
   isize n_in;
   isize n_total;
+
+  ///// storage policy of H, A and C (which are empty when NON_OWNING)
+  ModelStorage storage;
   /*!
    * Default constructor.
    * @param _dim primal variable dimension.
    * @param _n_eq number of equality constraints.
    * @param _n_in number of inequality constraints.
+   * @param _storage storage policy of the matrices of the model.
    */
-  Model(isize _dim, isize _n_eq, isize _n_in)
-    : H(_dim, _dim)
+  Model(isize _dim,
+        isize _n_eq,
+        isize _n_in,
+        ModelStorage _storage = ModelStorage::OWNING)
+    : H(_storage == ModelStorage::OWNING ? _dim : 0,
+        _storage == ModelStorage::OWNING ? _dim : 0)
     , g(_dim)
-    , A(_n_eq, _dim)
-    , C(_n_in, _dim)
+    , A(_storage == ModelStorage::OWNING ? _n_eq : 0,
+        _storage == ModelStorage::OWNING ? _dim : 0)
+    , C(_storage == ModelStorage::OWNING ? _n_in : 0,
+        _storage == ModelStorage::OWNING ? _dim : 0)
     , b(_n_eq)
     , u(_n_in)
     , l(_n_in)
@@ -55,6 +83,7 @@ struct Model
     , n_eq(_n_eq)
     , n_in(_n_in)
     , n_total(_dim + _n_eq + _n_in)
+    , storage(_storage)
   {
     PROXSUITE_THROW_PRETTY(_dim == 0,
                            std::invalid_argument,
@@ -71,6 +100,9 @@ struct Model
 
   proxsuite::proxqp::sparse::SparseModel<T> to_sparse()
   {
+    PROXSUITE_THROW_PRETTY(storage == ModelStorage::NON_OWNING,
+                           std::runtime_error,
+                           "the model does not store its matrices.");
     SparseMat<T> H_sparse = H.sparseView();
     SparseMat<T> A_sparse = A.sparseView();
     SparseMat<T> C_sparse = C.sparseView();
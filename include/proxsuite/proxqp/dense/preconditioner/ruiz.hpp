@@ -9,6 +9,7 @@
 
 #include "proxsuite/proxqp/dense/views.hpp"
 #include "proxsuite/proxqp/dense/fwd.hpp"
+#include "proxsuite/proxqp/trace.hpp"
 #include <proxsuite/linalg/dense/core.hpp>
 #include <ostream>
 
@@ -80,6 +81,7 @@ ruiz_scale_qp_in_place( //
     } else {
       ++iter;
     }
+    trace::Span span("ruiz_iteration", iter);
 
     // normalization vector
     {
@@ -262,6 +264,25 @@ struct RuizEquilibration
     *logger_ptr << " delta : " << delta << "\n\n";
     *logger_ptr << " c : " << c << "\n\n";
   }
+  /*!
+   * Loads scaling variables derived previously (e.g., by another equilibrator
+   * of the same dimensions), so that they can be applied without executing
+   * anew the ruiz equilibration algorithm.
+   * @param delta_ scaling vector (of size dim + n_eq + n_in).
+   * @param c_ cost scaling factor.
+   */
+  void load(VecRef<T> delta_, T c_)
+  {
+    PROXSUITE_THROW_PRETTY(delta_.rows() != delta.rows(),
+                           std::invalid_argument,
+                           "the dimension of the scaling vector delta is not "
+                           "valid.");
+    PROXSUITE_THROW_PRETTY(!(c_ > T(0)) || !(delta_.array() > T(0)).all(),
+                           std::invalid_argument,
+                           "the scaling variables should be positive.");
+    delta = delta_;
+    c = c_;
+  }
   /*!
    * Determines memory requirements for executing the equilibrator.
    * @param tag tag for specifying entry type.
@@ -396,6 +417,54 @@ struct RuizEquilibration
 
     scale_qp_in_place(scaled_qp, tmp_delta_preallocated, epsilon, max_iter);
   }
+  /*!
+   * Unscales the matrices of a qp in place, using the current equilibrator
+   * scaling variables (the vectors of the qp are left untouched).
+   * @param qp qp whose matrices are unscaled (in place).
+   */
+  void unscale_matrices_in_place(QpViewBoxMut<T> qp)
+  {
+    auto H = qp.H.to_eigen();
+    auto A = qp.A.to_eigen();
+    auto C = qp.C.to_eigen();
+    isize n = qp.H.rows;
+    isize n_eq = qp.A.rows;
+    isize n_in = qp.C.rows;
+
+    A = delta.segment(n, n_eq).cwiseInverse().asDiagonal() * A *
+        delta.head(n).cwiseInverse().asDiagonal();
+    C = delta.tail(n_in).cwiseInverse().asDiagonal() * C *
+        delta.head(n).cwiseInverse().asDiagonal();
+
+    switch (sym) {
+      case Symmetry::upper: {
+        for (isize j = 0; j < n; ++j) {
+          H.col(j).head(j + 1) /= delta(j);
+        }
+        for (isize i = 0; i < n; ++i) {
+          H.row(i).tail(n - i) /= delta(i);
+        }
+        break;
+      }
+      case Symmetry::lower: {
+        for (isize j = 0; j < n; ++j) {
+          H.col(j).tail(n - j) /= delta(j);
+        }
+        for (isize i = 0; i < n; ++i) {
+          H.row(i).head(i + 1) /= delta(i);
+        }
+        break;
+      }
+      case Symmetry::general: {
+        H = delta.head(n).cwiseInverse().asDiagonal() * H *
+            delta.head(n).cwiseInverse().asDiagonal();
+        break;
+      }
+      default:
+        break;
+    }
+    H /= c;
+  }
   // modifies variables in place
   /*!
    * Scales a primal variable in place.
@@ -11,7 +11,11 @@
 #include "proxsuite/proxqp/dense/views.hpp"
 #include "proxsuite/proxqp/dense/linesearch.hpp"
 #include "proxsuite/proxqp/dense/helpers.hpp"
+#include "proxsuite/proxqp/dense/kkt.hpp"
 #include "proxsuite/proxqp/dense/utils.hpp"
+#include "proxsuite/proxqp/dense/interior_point.hpp"
+#include "proxsuite/proxqp/observer.hpp"
+#include "proxsuite/proxqp/trace.hpp"
 #include <cmath>
 #include <Eigen/Sparse>
 #include <iostream>
@@ -20,6 +24,7 @@
 #include <proxsuite/linalg/dense/ldlt.hpp>
 #include <chrono>
 #include <iomanip>
+#include <limits>
 
 namespace proxsuite {
 namespace proxqp {
@@ -45,8 +50,37 @@ refactorize(const Model<T>& qpmodel,
   if (!qpwork.constraints_changed && rho_new == qpresults.info.rho) {
     return;
   }
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::REFACTORIZATION);
+  trace::Span span("refactorize");
 
   qpwork.dw_aug.setZero();
+  if (qpwork.kkt_mode == KktMode::CONDENSED) {
+    factorize_condensed_kkt(qpmodel,
+                            qpwork,
+                            rho_new,
+                            qpresults.info.mu_eq,
+                            qpresults.info.mu_in);
+    qpwork.constraints_changed = false;
+    return;
+  }
+  if (qpwork.kkt_mode == KktMode::DUAL) {
+    factorize_dual_kkt(qpmodel,
+                       qpwork,
+                       rho_new,
+                       qpresults.info.mu_eq,
+                       qpresults.info.mu_in);
+    qpwork.constraints_changed = false;
+    return;
+  }
+  if (qpwork.kkt_mode == KktMode::BANDED) {
+    factorize_banded_kkt(qpmodel,
+                         qpwork,
+                         rho_new,
+                         qpresults.info.mu_eq,
+                         qpresults.info.mu_in);
+    qpwork.constraints_changed = false;
+    return;
+  }
   qpwork.kkt.diagonal().head(qpmodel.dim).array() +=
     rho_new - qpresults.info.rho;
   qpwork.kkt.diagonal().segment(qpmodel.dim, qpmodel.n_eq).array() =
@@ -99,6 +133,14 @@ mu_update(const Model<T>& qpmodel,
           T mu_eq_new,
           T mu_in_new)
 {
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::REFACTORIZATION);
+  trace::Span span("mu_update");
+  if (qpwork.kkt_mode == KktMode::CONDENSED) {
+    // mu scales whole blocks of the condensed matrix: it is factorized anew
+    factorize_condensed_kkt(
+      qpmodel, qpwork, qpresults.info.rho, mu_eq_new, mu_in_new);
+    return;
+  }
   proxsuite::linalg::veg::dynstack::DynStackMut stack{
     proxsuite::linalg::veg::from_slice_mut, qpwork.ldl_stack.as_mut()
   };
@@ -111,19 +153,47 @@ mu_update(const Model<T>& qpmodel,
     return;
   }
 
+  if (qpwork.kkt_mode == KktMode::BANDED) {
+    // only the diagonal of the constraint rows changes: the factorization is
+    // updated from the first of them on
+    auto& band = qpwork.band_ldl;
+    isize first = band.dim();
+    for (isize k = 0; k < n_eq; ++k) {
+      isize p = qpwork.band_position(n + k);
+      band.coeff_mut(p, p) = -mu_eq_new;
+      first = std::min(first, p);
+    }
+    for (isize i = 0; i < qpmodel.n_in; ++i) {
+      if (qpwork.current_bijection_map(i) < n_c) {
+        isize p = qpwork.band_position(n + n_eq + i);
+        band.coeff_mut(p, p) = -mu_in_new;
+        first = std::min(first, p);
+      }
+    }
+    band.factorize(first);
+    return;
+  }
+
+  // the dual KKT matrix has no primal block, and mu on its diagonal
+  bool dual = qpwork.kkt_mode == KktMode::DUAL;
+  isize offset = dual ? 0 : n;
+  T sign = dual ? T(-1) : T(1);
+
   LDLT_TEMP_VEC_UNINIT(T, rank_update_alpha, n_eq + n_c, stack);
-  rank_update_alpha.head(n_eq).setConstant(qpresults.info.mu_eq - mu_eq_new);
-  rank_update_alpha.tail(n_c).setConstant(qpresults.info.mu_in - mu_in_new);
+  rank_update_alpha.head(n_eq).setConstant(
+    sign * (qpresults.info.mu_eq - mu_eq_new));
+  rank_update_alpha.tail(n_c).setConstant(
+    sign * (qpresults.info.mu_in - mu_in_new));
 
   {
     auto _indices = stack.make_new_for_overwrite(
       proxsuite::linalg::veg::Tag<isize>{}, n_eq + n_c);
     isize* indices = _indices.ptr_mut();
     for (isize k = 0; k < n_eq; ++k) {
-      indices[k] = n + k;
+      indices[k] = offset + k;
     }
     for (isize k = 0; k < n_c; ++k) {
-      indices[n_eq + k] = n + n_eq + k;
+      indices[n_eq + k] = offset + n_eq + k;
     }
     qpwork.ldl.diagonal_update_clobber_indices(
       indices, n_eq + n_c, rank_update_alpha, stack);
@@ -198,6 +268,9 @@ iterative_solve_with_permut_fact( //
   T eps,
   isize inner_pb_dim)
 {
+  PhaseTimer<T> timer(qpresults.info.phase_timings,
+                      Phase::ITERATIVE_REFINEMENT);
+  trace::Span span("iterative_refinement");
 
   qpwork.err.setZero();
   i32 it = 0;
@@ -207,7 +280,8 @@ iterative_solve_with_permut_fact( //
   proxsuite::linalg::veg::dynstack::DynStackMut stack{
     proxsuite::linalg::veg::from_slice_mut, qpwork.ldl_stack.as_mut()
   };
-  qpwork.ldl.solve_in_place(qpwork.dw_aug.head(inner_pb_dim), stack);
+  solve_kkt_in_place<T>(
+    qpmodel, qpresults, qpwork, qpwork.dw_aug.head(inner_pb_dim), stack);
 
   iterative_residual<T>(qpmodel, qpresults, qpwork, inner_pb_dim);
 
@@ -227,7 +301,8 @@ iterative_solve_with_permut_fact( //
     }
 
     ++it;
-    qpwork.ldl.solve_in_place(qpwork.err.head(inner_pb_dim), stack);
+    solve_kkt_in_place<T>(
+      qpmodel, qpresults, qpwork, qpwork.err.head(inner_pb_dim), stack);
     qpwork.dw_aug.head(inner_pb_dim) += qpwork.err.head(inner_pb_dim);
 
     qpwork.err.head(inner_pb_dim).setZero();
@@ -259,7 +334,8 @@ iterative_solve_with_permut_fact( //
     it_stability = 0;
 
     qpwork.dw_aug.head(inner_pb_dim) = qpwork.rhs.head(inner_pb_dim);
-    qpwork.ldl.solve_in_place(qpwork.dw_aug.head(inner_pb_dim), stack);
+    solve_kkt_in_place<T>(
+      qpmodel, qpresults, qpwork, qpwork.dw_aug.head(inner_pb_dim), stack);
 
     iterative_residual<T>(qpmodel, qpresults, qpwork, inner_pb_dim);
 
@@ -278,7 +354,8 @@ iterative_solve_with_permut_fact( //
         break;
       }
       ++it;
-      qpwork.ldl.solve_in_place(qpwork.err.head(inner_pb_dim), stack);
+      solve_kkt_in_place<T>(
+        qpmodel, qpresults, qpwork, qpwork.err.head(inner_pb_dim), stack);
       qpwork.dw_aug.head(inner_pb_dim) += qpwork.err.head(inner_pb_dim);
 
       qpwork.err.head(inner_pb_dim).setZero();
@@ -416,7 +493,7 @@ Martinez_update(const Settings<T>& qpsettings,
 
 )
 {
-  bcl_eta_in = std::max(bcl_eta_in * 0.1, eps_in_min);
+  bcl_eta_in = std::max(bcl_eta_in * T(0.1), eps_in_min);
   if (primal_feasibility_lhs_new <= 0.95 * primal_feasibility_lhs_old) {
     /* TO PUT IN DEBUG MODE
     if (qpsettings.verbose) {
@@ -568,15 +645,20 @@ primal_dual_semi_smooth_newton_step(const Settings<T>& qpsettings,
  * @param qpresults solver results.
  * @param ruiz ruiz preconditioner.
  * @param eps_int accuracy required for solving the subproblem.
+ * @param budget number of Newton steps the call may run, decreased by the
+ * steps run. Once it is zero, the loop is suspended, and resumed by the next
+ * call from qpwork.solve_state.inner_iter.
+ * @return true once the loop is finished, false if it is suspended.
  */
 template<typename T>
-void
+bool
 primal_dual_newton_semi_smooth(const Settings<T>& qpsettings,
                                const Model<T>& qpmodel,
                                Results<T>& qpresults,
                                Workspace<T>& qpwork,
                                preconditioner::RuizEquilibration<T>& ruiz,
-                               T eps_int)
+                               T eps_int,
+                               isize& budget)
 {
 
   /* MUST CONTAIN IN ENTRY WITH x = x_prev ; y = y_prev ; z = z_prev
@@ -593,12 +675,18 @@ primal_dual_newton_semi_smooth(const Settings<T>& qpsettings,
   */
   T err_in = 1.e6;
 
-  for (i64 iter = 0; iter <= qpsettings.max_iter_in; ++iter) {
+  isize& iter = qpwork.solve_state.inner_iter;
+  for (; iter <= qpsettings.max_iter_in; ++iter) {
 
     if (iter == qpsettings.max_iter_in) {
       qpresults.info.iter += qpsettings.max_iter_in + 1;
       break;
     }
+    if (budget == 0) {
+      return false;
+    }
+    --budget;
+    trace::Span newton_span("newton_step", iter);
     primal_dual_semi_smooth_newton_step<T>(
       qpsettings, qpmodel, qpresults, qpwork, eps_int);
 
@@ -729,6 +817,11 @@ primal_dual_newton_semi_smooth(const Settings<T>& qpsettings,
       */
       break;
     }
+    if (qpwork.deadline.reached()) {
+      // the outer loop returns the best iterate
+      qpresults.info.iter += iter + 1;
+      break;
+    }
   }
   /* to put in debuger mode
   if (qpsettings.verbose) {
@@ -738,9 +831,414 @@ primal_dual_newton_semi_smooth(const Settings<T>& qpsettings,
     }
   }
   */
+  return true;
+}
+/*!
+ * Computes the objective value of the QP problem at a primal variable. If the
+ * model does not store its matrices, the quadratic term is evaluated from the
+ * scaled copy of H through the Ruiz scaling variables.
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpwork solver workspace.
+ * @param ruiz ruiz preconditioner.
+ * @param x primal variable (unscaled).
+ */
+template<typename T>
+T
+compute_objective(const Model<T>& qpmodel,
+                  const Workspace<T>& qpwork,
+                  const preconditioner::RuizEquilibration<T>& ruiz,
+                  const Vec<T>& x)
+{
+  // EigenAllowAlloc _{};
+  isize n = qpmodel.dim;
+  T obj(0);
+  if (qpmodel.storage == ModelStorage::OWNING) {
+    for (Eigen::Index j = 0; j < n; ++j) {
+      obj += 0.5 * (x(j) * x(j)) * qpmodel.H(j, j);
+      obj += x(j) * T(qpmodel.H.col(j).tail(n - j - 1).dot(x.tail(n - j - 1)));
+    }
+  } else {
+    // x^T H x = x_s^T H_scaled x_s / c, with x_s = x ./ delta the scaled
+    // primal variable
+    auto delta = ruiz.delta.head(n);
+    T quadratic_term(0);
+    for (Eigen::Index j = 0; j < n; ++j) {
+      T x_s = x(j) / delta(j);
+      quadratic_term += T(0.5) * (x_s * x_s) * qpwork.H_scaled(j, j);
+      quadratic_term +=
+        x_s * T((qpwork.H_scaled.col(j).tail(n - j - 1).array() *
+                 x.tail(n - j - 1).array() / delta.tail(n - j - 1).array())
+                  .sum());
+    }
+    obj += quadratic_term / ruiz.c;
+  }
+  obj += (qpmodel.g).dot(x);
+  return obj;
+}
+/*!
+ * Polishes the current iterate: the equality constrained QP problem of its
+ * active set (each active inequality constraint being set to the bound of
+ * the sign of its multiplier) is solved with the current factorization of the
+ * KKT matrix, by iterative refinement against the unregularized KKT matrix.
+ * The polished iterate is kept if its multipliers have the signs of their
+ * bounds and if it reduces the residuals, which are then the ones of the kept
+ * iterate.
+ *
+ * @param qpsettings solver settings.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpresults solver results.
+ * @param qpwork solver workspace.
+ * @param ruiz ruiz preconditioner.
+ * @param primal_feasibility_lhs primal infeasibility.
+ * @param primal_feasibility_eq_rhs_0 scalar variable used when using a relative
+ * stopping criterion.
+ * @param primal_feasibility_in_rhs_0 scalar variable used when using a relative
+ * stopping criterion.
+ * @param primal_feasibility_eq_lhs scalar variable used when using a relative
+ * stopping criterion.
+ * @param primal_feasibility_in_lhs scalar variable used when using a relative
+ * stopping criterion.
+ * @param dual_feasibility_lhs dual infeasibility.
+ * @param dual_feasibility_rhs_0 scalar variable used when using a relative
+ * stopping criterion.
+ * @param dual_feasibility_rhs_1 scalar variable used when using a relative
+ * stopping criterion.
+ * @param dual_feasibility_rhs_3 scalar variable used when using a relative
+ * stopping criterion.
+ * @return whether the polished iterate has been kept.
+ */
+template<typename T>
+bool
+polish(const Settings<T>& qpsettings,
+       const Model<T>& qpmodel,
+       Results<T>& qpresults,
+       Workspace<T>& qpwork,
+       preconditioner::RuizEquilibration<T>& ruiz,
+       T& primal_feasibility_lhs,
+       T& primal_feasibility_eq_rhs_0,
+       T& primal_feasibility_in_rhs_0,
+       T& primal_feasibility_eq_lhs,
+       T& primal_feasibility_in_lhs,
+       T& dual_feasibility_lhs,
+       T& dual_feasibility_rhs_0,
+       T& dual_feasibility_rhs_1,
+       T& dual_feasibility_rhs_3)
+{
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::POLISH);
+  trace::Span span("polish");
+
+  isize n = qpmodel.dim;
+  isize n_eq = qpmodel.n_eq;
+  isize n_in = qpmodel.n_in;
+  isize n_c = qpwork.n_c;
+  isize inner_pb_dim = n + n_eq + n_c;
+
+  auto rhs = qpwork.rhs.head(inner_pb_dim);
+  auto sol = qpwork.dw_aug.head(inner_pb_dim);
+  auto err = qpwork.err.head(inner_pb_dim);
+
+  rhs.head(n) = -qpwork.g_scaled;
+  rhs.segment(n, n_eq) = qpwork.b_scaled;
+  for (isize i = 0; i < n_in; ++i) {
+    isize j = qpwork.current_bijection_map(i);
+    if (j < n_c) {
+      T z_i = qpresults.z(i);
+      T c_i = qpwork.C_scaled.row(i).dot(qpresults.x);
+      bool upper = z_i > 0 || (z_i == 0 && qpwork.u_scaled(i) - c_i <=
+                                             c_i - qpwork.l_scaled(i));
+      rhs(n + n_eq + j) = upper ? qpwork.u_scaled(i) : qpwork.l_scaled(i);
+    }
+  }
+
+  proxsuite::linalg::veg::dynstack::DynStackMut stack{
+    proxsuite::linalg::veg::from_slice_mut, qpwork.ldl_stack.as_mut()
+  };
+  sol.setZero();
+  err = rhs;
+  T prev_err_norm = std::numeric_limits<T>::infinity();
+  for (isize it = 0; it < qpsettings.polish_refine_iter; ++it) {
+    T err_norm = infty_norm(err);
+    if (err_norm > prev_err_norm / T(2)) {
+      break;
+    }
+    prev_err_norm = err_norm;
+    solve_kkt_in_place<T>(
+      qpmodel, qpresults, qpwork, qpwork.err.head(inner_pb_dim), stack);
+    sol += err;
+
+    // err = rhs - K sol, with the unregularized KKT matrix K
+    err = rhs;
+    err.head(n).noalias() -=
+      qpwork.H_scaled.template selfadjointView<Eigen::Lower>() * sol.head(n);
+    err.head(n).noalias() -= qpwork.A_scaled.transpose() * sol.segment(n, n_eq);
+    err.segment(n, n_eq).noalias() -= qpwork.A_scaled * sol.head(n);
+    for (isize i = 0; i < n_in; ++i) {
+      isize j = qpwork.current_bijection_map(i);
+      if (j < n_c) {
+        err.head(n) -= sol(n + n_eq + j) * qpwork.C_scaled.row(i).transpose();
+        err(n + n_eq + j) -= qpwork.C_scaled.row(i).dot(sol.head(n));
+      }
+    }
+  }
+
+  // the multipliers must have the signs of their bounds
+  for (isize i = 0; i < n_in; ++i) {
+    isize j = qpwork.current_bijection_map(i);
+    if (j < n_c) {
+      T z_i = sol(n + n_eq + j);
+      T bound = rhs(n + n_eq + j);
+      if ((z_i > 0 && bound != qpwork.u_scaled(i)) ||
+          (z_i < 0 && bound != qpwork.l_scaled(i))) {
+        return false;
+      }
+    }
+  }
+
+  // x_prev, y_prev and z_prev are overwritten by the next outer iteration
+  qpwork.x_prev = qpresults.x;
+  qpwork.y_prev = qpresults.y;
+  qpwork.z_prev = qpresults.z;
+  qpresults.x = sol.head(n);
+  qpresults.y = sol.segment(n, n_eq);
+  for (isize i = 0; i < n_in; ++i) {
+    isize j = qpwork.current_bijection_map(i);
+    qpresults.z(i) = j < n_c ? sol(n + n_eq + j) : T(0);
+  }
+
+  T primal_feasibility_lhs_new(0);
+  T dual_feasibility_lhs_new(0);
+  global_primal_residual(qpmodel,
+                         qpresults,
+                         qpwork,
+                         ruiz,
+                         primal_feasibility_lhs_new,
+                         primal_feasibility_eq_rhs_0,
+                         primal_feasibility_in_rhs_0,
+                         primal_feasibility_eq_lhs,
+                         primal_feasibility_in_lhs);
+  global_dual_residual(qpresults,
+                       qpwork,
+                       ruiz,
+                       dual_feasibility_lhs_new,
+                       dual_feasibility_rhs_0,
+                       dual_feasibility_rhs_1,
+                       dual_feasibility_rhs_3);
+  if (std::max(primal_feasibility_lhs_new, dual_feasibility_lhs_new) <
+      std::max(primal_feasibility_lhs, dual_feasibility_lhs)) {
+    primal_feasibility_lhs = primal_feasibility_lhs_new;
+    dual_feasibility_lhs = dual_feasibility_lhs_new;
+    return true;
+  }
+
+  qpresults.x = qpwork.x_prev;
+  qpresults.y = qpwork.y_prev;
+  qpresults.z = qpwork.z_prev;
+  global_primal_residual(qpmodel,
+                         qpresults,
+                         qpwork,
+                         ruiz,
+                         primal_feasibility_lhs,
+                         primal_feasibility_eq_rhs_0,
+                         primal_feasibility_in_rhs_0,
+                         primal_feasibility_eq_lhs,
+                         primal_feasibility_in_lhs);
+  global_dual_residual(qpresults,
+                       qpwork,
+                       ruiz,
+                       dual_feasibility_lhs,
+                       dual_feasibility_rhs_0,
+                       dual_feasibility_rhs_1,
+                       dual_feasibility_rhs_3);
+  return false;
+}
+/*!
+ * Anderson acceleration of the outer loop (see AndersonAcceleration): adds
+ * the last outer iteration to the memory of the acceleration and replaces the
+ * iterate by its extrapolation, if this increases neither the primal nor the
+ * dual residual (otherwise, the memory is cleared).
+ *
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpresults solver results.
+ * @param qpwork solver workspace.
+ * @param ruiz ruiz preconditioner.
+ * @param new_bcl_mu_eq proximal parameter of the equality constraints of the
+ * next outer iteration.
+ * @param new_bcl_mu_in proximal parameter of the inequality constraints of the
+ * next outer iteration.
+ * @param primal_feasibility_lhs primal infeasibility of the iterate.
+ * @param dual_feasibility_lhs dual infeasibility of the iterate.
+ * @param primal_feasibility_eq_rhs_0 scalar variable used when using a relative
+ * stopping criterion.
+ * @param primal_feasibility_in_rhs_0 scalar variable used when using a relative
+ * stopping criterion.
+ * @param primal_feasibility_eq_lhs scalar variable used when using a relative
+ * stopping criterion.
+ * @param primal_feasibility_in_lhs scalar variable used when using a relative
+ * stopping criterion.
+ * @param dual_feasibility_rhs_0 scalar variable used when using a relative
+ * stopping criterion.
+ * @param dual_feasibility_rhs_1 scalar variable used when using a relative
+ * stopping criterion.
+ * @param dual_feasibility_rhs_3 scalar variable used when using a relative
+ * stopping criterion.
+ * @return whether the extrapolated iterate has been kept.
+ */
+template<typename T>
+bool
+anderson_step(const Model<T>& qpmodel,
+              Results<T>& qpresults,
+              Workspace<T>& qpwork,
+              preconditioner::RuizEquilibration<T>& ruiz,
+              T new_bcl_mu_eq,
+              T new_bcl_mu_in,
+              T primal_feasibility_lhs,
+              T dual_feasibility_lhs,
+              T& primal_feasibility_eq_rhs_0,
+              T& primal_feasibility_in_rhs_0,
+              T& primal_feasibility_eq_lhs,
+              T& primal_feasibility_in_lhs,
+              T& dual_feasibility_rhs_0,
+              T& dual_feasibility_rhs_1,
+              T& dual_feasibility_rhs_3)
+{
+  AndersonAcceleration<T>& anderson = qpwork.anderson;
+  anderson.set_parameters(
+    qpresults.info.mu_eq, qpresults.info.mu_in, qpresults.info.rho);
+  if (new_bcl_mu_eq != qpresults.info.mu_eq ||
+      new_bcl_mu_in != qpresults.info.mu_in) {
+    // the next outer iteration solves another proximal subproblem
+    anderson.reset();
+    return false;
+  }
+
+  isize n = qpmodel.dim;
+  isize n_eq = qpmodel.n_eq;
+  isize n_in = qpmodel.n_in;
+  anderson.w.head(n) = qpwork.x_prev;
+  anderson.w.segment(n, n_eq) = qpwork.y_prev;
+  anderson.w.tail(n_in) = qpwork.z_prev;
+  anderson.g.head(n) = qpresults.x;
+  anderson.g.segment(n, n_eq) = qpresults.y;
+  anderson.g.tail(n_in) = qpresults.z;
+  if (!anderson.step(T(1.e-10))) {
+    return false;
+  }
+  qpresults.x = anderson.w.head(n);
+  qpresults.y = anderson.w.segment(n, n_eq);
+  qpresults.z = anderson.w.tail(n_in);
+
+  T primal_feasibility_lhs_new(0);
+  T dual_feasibility_lhs_new(0);
+  global_primal_residual(qpmodel,
+                         qpresults,
+                         qpwork,
+                         ruiz,
+                         primal_feasibility_lhs_new,
+                         primal_feasibility_eq_rhs_0,
+                         primal_feasibility_in_rhs_0,
+                         primal_feasibility_eq_lhs,
+                         primal_feasibility_in_lhs);
+  global_dual_residual(qpresults,
+                       qpwork,
+                       ruiz,
+                       dual_feasibility_lhs_new,
+                       dual_feasibility_rhs_0,
+                       dual_feasibility_rhs_1,
+                       dual_feasibility_rhs_3);
+  if (primal_feasibility_lhs_new <= primal_feasibility_lhs &&
+      dual_feasibility_lhs_new <= dual_feasibility_lhs) {
+    return true;
+  }
+
+  // the residuals are computed again at the start of the next outer iteration
+  qpresults.x = anderson.g.head(n);
+  qpresults.y = anderson.g.segment(n, n_eq);
+  qpresults.z = anderson.g.tail(n_in);
+  anderson.reset();
+  return false;
 }
 /*!
- * Executes the PROXQP algorithm.
+ * Setups the factorization of the regularized KKT matrix with the inequalities
+ * active at the initial guess (i.e., with a nonzero multiplier). In AUGMENTED
+ * mode, the factorization is restored from the factorization cache when it
+ * was already computed for the same active set and proximal parameters (see
+ * Settings::factorization_cache_max_bytes).
+ *
+ * @param qpwork solver workspace.
+ * @param qpsettings solver settings.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpresults solver results.
+ */
+template<typename T>
+void
+setup_active_set_factorization(Workspace<T>& qpwork,
+                               const Settings<T>& qpsettings,
+                               const Model<T>& qpmodel,
+                               Results<T>& qpresults)
+{
+  isize n_in = qpmodel.n_in;
+  for (isize i = 0; i < n_in; i++) {
+    qpwork.active_inequalities[i] = qpresults.z[i] != 0;
+  }
+  isize max_bytes = qpsettings.factorization_cache_max_bytes;
+  bool cached = false;
+  if (max_bytes > 0) {
+    select_kkt_mode(qpwork);
+    cached = qpwork.kkt_mode == KktMode::AUGMENTED;
+  }
+  T rho = qpresults.info.rho;
+  T mu_eq = qpresults.info.mu_eq;
+  T mu_in = qpresults.info.mu_in;
+  auto& cache = qpwork.factorization_cache;
+  if (cached) {
+    CachedFactorization<T> const* entry =
+      cache.find(qpwork.active_inequalities, n_in, rho, mu_eq, mu_in);
+    if (entry != nullptr) {
+      PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::FACTORIZATION);
+      // the kkt matrix is updated in place by the refactorizations
+      assemble_augmented_kkt(qpwork, qpmodel, qpresults);
+      qpwork.ldl = entry->ldl;
+      qpwork.interior_point_ldl = false;
+      qpwork.n_c = entry->n_c;
+      qpwork.current_bijection_map = entry->bijection_map;
+      qpwork.new_bijection_map = entry->bijection_map;
+      qpwork.constraints_changed = entry->constraints_changed;
+      qpwork.dw_aug.setZero();
+      return;
+    }
+  }
+  setup_factorization(qpwork, qpmodel, qpresults);
+  //!\ TODO in a quicker way
+  qpwork.n_c = 0;
+  linesearch::active_set_change(qpmodel, qpresults, qpwork);
+  if (cached) {
+    // the factorization is stored with the capacity of the workspace
+    isize n_max = qpmodel.dim + qpmodel.n_eq + n_in;
+    isize bytes = n_max * n_max * isize(sizeof(T)) +
+                  (3 * n_max + n_in) * isize(sizeof(isize));
+    cache.insert(qpwork.active_inequalities,
+                 n_in,
+                 rho,
+                 mu_eq,
+                 mu_in,
+                 bytes,
+                 max_bytes,
+                 [&](CachedFactorization<T>& entry) {
+                   entry.ldl = qpwork.ldl;
+                   entry.n_c = qpwork.n_c;
+                   entry.bijection_map = qpwork.current_bijection_map;
+                   entry.constraints_changed = qpwork.constraints_changed;
+                 });
+  }
+}
+/*!
+ * Starts a solve: sets up the scaled vectors, the factorization and the
+ * initial guess. The iterations are then run by qp_solve_step.
  *
  * @param qpwork solver workspace.
  * @param qpmodel QP problem model as defined by the user (without any scaling
@@ -751,7 +1249,7 @@ primal_dual_newton_semi_smooth(const Settings<T>& qpsettings,
  */
 template<typename T>
 void
-qp_solve( //
+qp_solve_begin( //
   const Settings<T>& qpsettings,
   const Model<T>& qpmodel,
   Results<T>& qpresults,
@@ -770,20 +1268,25 @@ qp_solve( //
     qpwork.timer.stop();
     qpwork.timer.start();
   }
+  qpwork.deadline.start(qpsettings.time_limit, qpsettings.deadline);
   if (qpsettings.verbose) {
     dense::print_setup_header(qpsettings, qpresults, qpmodel);
   }
   if (qpwork.dirty) { // the following is used when a solve has already been
                       // executed (and without any intermediary model update)
+    qpresults.info.phase_timings.clear();
+    // the scaled matrices are the only copy of the matrices of a model not
+    // owning them
+    bool keep_matrices = qpmodel.storage == ModelStorage::NON_OWNING;
     switch (qpsettings.initial_guess) {
       case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
-        qpwork.cleanup();
+        qpwork.cleanup(keep_matrices);
         qpresults.cleanup();
         break;
       }
       case InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT: {
         // keep solutions but restart workspace and results
-        qpwork.cleanup();
+        qpwork.cleanup(keep_matrices);
         qpresults.cold_start();
         ruiz.scale_primal_in_place(
           { proxsuite::proxqp::from_eigen, qpresults.x });
@@ -794,12 +1297,12 @@ qp_solve( //
         break;
       }
       case InitialGuessStatus::NO_INITIAL_GUESS: {
-        qpwork.cleanup();
+        qpwork.cleanup(keep_matrices);
         qpresults.cleanup();
         break;
       }
       case InitialGuessStatus::WARM_START: {
-        qpwork.cleanup();
+        qpwork.cleanup(keep_matrices);
         qpresults.cold_start(); // because there was already a solve, precond
                                 // was already computed if set so
         ruiz.scale_primal_in_place(
@@ -826,50 +1329,48 @@ qp_solve( //
     }
     if (qpsettings.initial_guess !=
         InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT) {
-      qpwork.H_scaled = qpmodel.H;
       qpwork.g_scaled = qpmodel.g;
-      qpwork.A_scaled = qpmodel.A;
       qpwork.b_scaled = qpmodel.b;
-      qpwork.C_scaled = qpmodel.C;
       qpwork.u_scaled = qpmodel.u;
       qpwork.l_scaled = qpmodel.l;
-      proxsuite::proxqp::dense::setup_equilibration(
-        qpwork, qpsettings, ruiz, false); // reuse previous equilibration
-      proxsuite::proxqp::dense::setup_factorization(qpwork, qpmodel, qpresults);
+      if (keep_matrices) {
+        // the matrices are still scaled: only the vectors are scaled anew
+        ruiz.scale_dual_residual_in_place(
+          { proxsuite::proxqp::from_eigen, qpwork.g_scaled });
+        ruiz.scale_primal_residual_in_place_eq(
+          { proxsuite::proxqp::from_eigen, qpwork.b_scaled });
+        ruiz.scale_primal_residual_in_place_in(
+          { proxsuite::proxqp::from_eigen, qpwork.u_scaled });
+        ruiz.scale_primal_residual_in_place_in(
+          { proxsuite::proxqp::from_eigen, qpwork.l_scaled });
+        qpwork.correction_guess_rhs_g = infty_norm(qpwork.g_scaled);
+      } else {
+        qpwork.H_scaled = qpmodel.H;
+        qpwork.A_scaled = qpmodel.A;
+        qpwork.C_scaled = qpmodel.C;
+        PhaseTimer<T> timer(qpresults.info.phase_timings,
+                            Phase::EQUILIBRATION);
+        proxsuite::proxqp::dense::setup_equilibration(
+          qpwork, qpsettings, ruiz, false); // reuse previous equilibration
+      }
     }
     switch (qpsettings.initial_guess) {
       case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
+        setup_factorization(qpwork, qpmodel, qpresults);
         compute_equality_constrained_initial_guess(
           qpwork, qpsettings, qpmodel, qpresults);
         break;
       }
       case InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT: {
-        //!\ TODO in a quicker way
-        qpwork.n_c = 0;
-        for (isize i = 0; i < qpmodel.n_in; i++) {
-          if (qpresults.z[i] != 0) {
-            qpwork.active_inequalities[i] = true;
-          } else {
-            qpwork.active_inequalities[i] = false;
-          }
-        }
-        linesearch::active_set_change(qpmodel, qpresults, qpwork);
+        setup_active_set_factorization(qpwork, qpsettings, qpmodel, qpresults);
         break;
       }
       case InitialGuessStatus::NO_INITIAL_GUESS: {
+        setup_factorization(qpwork, qpmodel, qpresults);
         break;
       }
       case InitialGuessStatus::WARM_START: {
-        //!\ TODO in a quicker way
-        qpwork.n_c = 0;
-        for (isize i = 0; i < qpmodel.n_in; i++) {
-          if (qpresults.z[i] != 0) {
-            qpwork.active_inequalities[i] = true;
-          } else {
-            qpwork.active_inequalities[i] = false;
-          }
-        }
-        linesearch::active_set_change(qpmodel, qpresults, qpwork);
+        setup_active_set_factorization(qpwork, qpsettings, qpmodel, qpresults);
         break;
       }
       case InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT: {
@@ -901,16 +1402,7 @@ qp_solve( //
           { proxsuite::proxqp::from_eigen, qpresults.y });
         ruiz.scale_dual_in_place_in(
           { proxsuite::proxqp::from_eigen, qpresults.z });
-        setup_factorization(qpwork, qpmodel, qpresults);
-        qpwork.n_c = 0;
-        for (isize i = 0; i < qpmodel.n_in; i++) {
-          if (qpresults.z[i] != 0) {
-            qpwork.active_inequalities[i] = true;
-          } else {
-            qpwork.active_inequalities[i] = false;
-          }
-        }
-        linesearch::active_set_change(qpmodel, qpresults, qpwork);
+        setup_active_set_factorization(qpwork, qpsettings, qpmodel, qpresults);
         break;
       }
       case InitialGuessStatus::NO_INITIAL_GUESS: {
@@ -925,16 +1417,7 @@ qp_solve( //
           { proxsuite::proxqp::from_eigen, qpresults.y });
         ruiz.scale_dual_in_place_in(
           { proxsuite::proxqp::from_eigen, qpresults.z });
-        setup_factorization(qpwork, qpmodel, qpresults);
-        qpwork.n_c = 0;
-        for (isize i = 0; i < qpmodel.n_in; i++) {
-          if (qpresults.z[i] != 0) {
-            qpwork.active_inequalities[i] = true;
-          } else {
-            qpwork.active_inequalities[i] = false;
-          }
-        }
-        linesearch::active_set_change(qpmodel, qpresults, qpwork);
+        setup_active_set_factorization(qpwork, qpsettings, qpmodel, qpresults);
         break;
       }
       case InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT: {
@@ -951,26 +1434,191 @@ qp_solve( //
         if (qpwork.refactorize) { // refactorization only when one of the
                                   // matrices has changed or one proximal
                                   // parameter has changed
-          setup_factorization(qpwork, qpmodel, qpresults);
-          qpwork.n_c = 0;
-          for (isize i = 0; i < qpmodel.n_in; i++) {
-            if (qpresults.z[i] != 0) {
-              qpwork.active_inequalities[i] = true;
-            } else {
-              qpwork.active_inequalities[i] = false;
-            }
-          }
-          linesearch::active_set_change(qpmodel, qpresults, qpwork);
+          setup_active_set_factorization(
+            qpwork, qpsettings, qpmodel, qpresults);
           break;
         }
       }
     }
   }
 
-  T bcl_eta_ext_init = pow(T(0.1), qpsettings.alpha_bcl);
-  T bcl_eta_ext = bcl_eta_ext_init;
-  T bcl_eta_in(1);
-  T eps_in_min = std::min(qpsettings.eps_abs, T(1.E-9));
+  if (qpsettings.anderson_acceleration) {
+    qpwork.anderson.resize(qpmodel.dim + qpmodel.n_eq + qpmodel.n_in,
+                           qpsettings.anderson_memory);
+  }
+  if (qpwork.deadline.is_set()) {
+    qpwork.best.resize(qpmodel.dim, qpmodel.n_eq, qpmodel.n_in);
+  }
+  if (qpsettings.method == SolverMethod::INTERIOR_POINT) {
+    interior_point::reserve(qpwork, qpmodel);
+  } else if (qpwork.interior_point_ldl) {
+    // the factorization kept from the previous solve is the one of the
+    // interior-point method
+    setup_active_set_factorization(qpwork, qpsettings, qpmodel, qpresults);
+  }
+  qpwork.solve_state.start(
+    qpsettings.alpha_bcl, qpsettings.eps_abs, qpsettings.polish_eps_abs);
+  qpwork.solve_state.initialized = true;
+  if (qpsettings.compute_timings) {
+    qpwork.timer.stop();
+  }
+}
+/*!
+ * Finishes a solve: unscales the results, computes the objective value and
+ * prints the statistics of the solve.
+ *
+ * @param qpsettings solver settings.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpresults solver results.
+ * @param qpwork solver workspace.
+ * @param ruiz ruiz preconditioner.
+ */
+template<typename T>
+void
+qp_solve_end( //
+  const Settings<T>& qpsettings,
+  const Model<T>& qpmodel,
+  Results<T>& qpresults,
+  Workspace<T>& qpwork,
+  preconditioner::RuizEquilibration<T>& ruiz)
+{
+  ruiz.unscale_primal_in_place(VectorViewMut<T>{ from_eigen, qpresults.x });
+  ruiz.unscale_dual_in_place_eq(VectorViewMut<T>{ from_eigen, qpresults.y });
+  ruiz.unscale_dual_in_place_in(VectorViewMut<T>{ from_eigen, qpresults.z });
+
+  qpresults.info.objValue =
+    compute_objective(qpmodel, qpwork, ruiz, qpresults.x);
+
+  if (qpsettings.compute_timings) {
+    qpresults.info.solve_time = qpwork.timer.elapsed().user; // in nanoseconds
+    qpresults.info.run_time =
+      qpresults.info.solve_time + qpresults.info.setup_time;
+    if (qpsettings.verbose) {
+      std::cout << "-------------------SOLVER STATISTICS-------------------"
+                << std::endl;
+      std::cout << "outer iter:   " << qpresults.info.iter_ext << std::endl;
+      std::cout << "total iter:   " << qpresults.info.iter << std::endl;
+      std::cout << "mu updates:   " << qpresults.info.mu_updates << std::endl;
+      std::cout << "rho updates:  " << qpresults.info.rho_updates << std::endl;
+      std::cout << "objective:    " << qpresults.info.objValue << std::endl;
+      switch (qpresults.info.status) {
+        case QPSolverOutput::PROXQP_SOLVED: {
+          std::cout << "status:       "
+                    << "Solved" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
+          std::cout << "status:       "
+                    << "Maximum number of iterations reached" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Primal infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Dual infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_TIME_LIMIT_REACHED: {
+          std::cout << "status:       "
+                    << "Time limit reached" << std::endl;
+          break;
+        }
+      }
+      std::cout << "run time:     " << qpresults.info.solve_time << std::endl;
+      std::cout << "--------------------------------------------------------"
+                << std::endl;
+    }
+  } else {
+    if (qpsettings.verbose) {
+      std::cout << "-------------------SOLVER STATISTICS-------------------"
+                << std::endl;
+      std::cout << "outer iter:   " << qpresults.info.iter_ext << std::endl;
+      std::cout << "total iter:   " << qpresults.info.iter << std::endl;
+      std::cout << "mu updates:   " << qpresults.info.mu_updates << std::endl;
+      std::cout << "rho updates:  " << qpresults.info.rho_updates << std::endl;
+      std::cout << "objective:    " << qpresults.info.objValue << std::endl;
+      switch (qpresults.info.status) {
+        case QPSolverOutput::PROXQP_SOLVED: {
+          std::cout << "status:       "
+                    << "Solved." << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
+          std::cout << "status:       "
+                    << "Maximum number of iterations reached" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Primal infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Dual infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_TIME_LIMIT_REACHED: {
+          std::cout << "status:       "
+                    << "Time limit reached" << std::endl;
+          break;
+        }
+      }
+      std::cout << "--------------------------------------------------------"
+                << std::endl;
+    }
+  }
+  qpwork.dirty = true;
+  qpwork.solve_state.done = true;
+}
+/*!
+ * Runs iterations of a solve started by qp_solve_begin, until the solve is
+ * finished or max_inner_iters inner iterations (Newton steps of PROXQP, or
+ * iterations of the interior-point method) have been run by the call. A step
+ * may return in the middle of an outer iteration, whose inner loop is then
+ * resumed by the next step. Once the solve is finished, the results are
+ * unscaled.
+ *
+ * @param qpwork solver workspace.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpsettings solver settings.
+ * @param qpresults solver results.
+ * @param ruiz ruiz preconditioner.
+ * @param max_inner_iters number of inner iterations after which the step
+ * returns (at least one is run).
+ * @param observer callable receiving the IterationRecord of each outer
+ * iteration (by default, nothing is recorded).
+ * @return true once the solve is finished.
+ */
+template<typename T, typename Observer = NullObserver>
+bool
+qp_solve_step( //
+  const Settings<T>& qpsettings,
+  const Model<T>& qpmodel,
+  Results<T>& qpresults,
+  Workspace<T>& qpwork,
+  preconditioner::RuizEquilibration<T>& ruiz,
+  isize max_inner_iters,
+  Observer&& observer = Observer{})
+{
+  SolveState<T>& state = qpwork.solve_state;
+  if (state.done) {
+    return true;
+  }
+  if (qpsettings.compute_timings) {
+    qpwork.timer.resume();
+  }
+  T& bcl_eta_ext_init = state.bcl_eta_ext_init;
+  T& bcl_eta_ext = state.bcl_eta_ext;
+  T& bcl_eta_in = state.bcl_eta_in;
+  T& eps_in_min = state.eps_in_min;
+  T& polish_eps = state.polish_eps;
 
   T primal_feasibility_eq_rhs_0(0);
   T primal_feasibility_in_rhs_0(0);
@@ -982,161 +1630,230 @@ qp_solve( //
   T primal_feasibility_in_lhs(0);
   T dual_feasibility_lhs(0);
 
-  for (i64 iter = 0; iter < qpsettings.max_iter; ++iter) {
-
-    // compute primal residual
+  // a step runs at most max_inner_iters Newton steps (and at least one, so
+  // that the solve makes progress)
+  isize budget = std::max(max_inner_iters, isize(1));
+  if (qpsettings.method == SolverMethod::INTERIOR_POINT) {
+    if (!interior_point::step(
+          qpsettings, qpmodel, qpresults, qpwork, ruiz, budget, observer)) {
+      // the interior-point method is resumed by the next step
+      if (qpsettings.compute_timings) {
+        qpwork.timer.stop();
+      }
+      return false;
+    }
+    qp_solve_end(qpsettings, qpmodel, qpresults, qpwork, ruiz);
+    return true;
+  }
+  for (; state.iter < qpsettings.max_iter; ++state.iter) {
+    i64 const iter = state.iter;
+    trace::Span iteration_span("outer_iteration", iter);
+    if (!state.in_inner_loop) {
+      // compute primal residual
+
+      // PERF: fuse matrix product computations in global_{primal,
+      // dual}_residual
+      global_primal_residual(qpmodel,
+                             qpresults,
+                             qpwork,
+                             ruiz,
+                             primal_feasibility_lhs,
+                             primal_feasibility_eq_rhs_0,
+                             primal_feasibility_in_rhs_0,
+                             primal_feasibility_eq_lhs,
+                             primal_feasibility_in_lhs);
 
-    // PERF: fuse matrix product computations in global_{primal, dual}_residual
-    global_primal_residual(qpmodel,
-                           qpresults,
+      global_dual_residual(qpresults,
                            qpwork,
                            ruiz,
-                           primal_feasibility_lhs,
-                           primal_feasibility_eq_rhs_0,
-                           primal_feasibility_in_rhs_0,
-                           primal_feasibility_eq_lhs,
-                           primal_feasibility_in_lhs);
+                           dual_feasibility_lhs,
+                           dual_feasibility_rhs_0,
+                           dual_feasibility_rhs_1,
+                           dual_feasibility_rhs_3);
+      if (qpsettings.polish &&
+          std::max(primal_feasibility_lhs, dual_feasibility_lhs) <=
+            polish_eps &&
+          std::max(primal_feasibility_lhs, dual_feasibility_lhs) >
+            qpsettings.eps_abs) {
+        // the next polishing is tried on a more accurate active set
+        polish_eps /= T(100);
+        qpresults.info.polished = polish(qpsettings,
+                                         qpmodel,
+                                         qpresults,
+                                         qpwork,
+                                         ruiz,
+                                         primal_feasibility_lhs,
+                                         primal_feasibility_eq_rhs_0,
+                                         primal_feasibility_in_rhs_0,
+                                         primal_feasibility_eq_lhs,
+                                         primal_feasibility_in_lhs,
+                                         dual_feasibility_lhs,
+                                         dual_feasibility_rhs_0,
+                                         dual_feasibility_rhs_1,
+                                         dual_feasibility_rhs_3);
+      }
+      qpresults.info.pri_res = primal_feasibility_lhs;
+      qpresults.info.dua_res = dual_feasibility_lhs;
+      if (is_observing<Observer>()) {
+        observer(make_iteration_record(iter,
+                                       primal_feasibility_lhs,
+                                       dual_feasibility_lhs,
+                                       qpresults.info,
+                                       qpwork.n_c,
+                                       qpwork.alpha));
+      }
 
-    global_dual_residual(qpresults,
-                         qpwork,
-                         ruiz,
-                         dual_feasibility_lhs,
-                         dual_feasibility_rhs_0,
-                         dual_feasibility_rhs_1,
-                         dual_feasibility_rhs_3);
-    qpresults.info.pri_res = primal_feasibility_lhs;
-    qpresults.info.dua_res = dual_feasibility_lhs;
+      T rhs_pri(qpsettings.eps_abs);
+      if (qpsettings.eps_rel != 0) {
+        rhs_pri +=
+          qpsettings.eps_rel *
+          std::max(
+            std::max(primal_feasibility_eq_rhs_0, primal_feasibility_in_rhs_0),
+            std::max(std::max(qpwork.primal_feasibility_rhs_1_eq,
+                              qpwork.primal_feasibility_rhs_1_in_u),
+                     qpwork.primal_feasibility_rhs_1_in_l));
+      }
+      bool is_primal_feasible = primal_feasibility_lhs <= rhs_pri;
+
+      T rhs_dua(qpsettings.eps_abs);
+      if (qpsettings.eps_rel != 0) {
+        rhs_dua +=
+          qpsettings.eps_rel *
+          std::max(
+            std::max(dual_feasibility_rhs_3, dual_feasibility_rhs_0),
+            std::max(dual_feasibility_rhs_1, qpwork.dual_feasibility_rhs_2));
+      }
 
-    T new_bcl_mu_in(qpresults.info.mu_in);
-    T new_bcl_mu_eq(qpresults.info.mu_eq);
-    T new_bcl_mu_in_inv(qpresults.info.mu_in_inv);
-    T new_bcl_mu_eq_inv(qpresults.info.mu_eq_inv);
+      bool is_dual_feasible = dual_feasibility_lhs <= rhs_dua;
 
-    T rhs_pri(qpsettings.eps_abs);
-    if (qpsettings.eps_rel != 0) {
-      rhs_pri +=
-        qpsettings.eps_rel *
-        std::max(
-          std::max(primal_feasibility_eq_rhs_0, primal_feasibility_in_rhs_0),
-          std::max(std::max(qpwork.primal_feasibility_rhs_1_eq,
-                            qpwork.primal_feasibility_rhs_1_in_u),
-                   qpwork.primal_feasibility_rhs_1_in_l));
-    }
-    bool is_primal_feasible = primal_feasibility_lhs <= rhs_pri;
-
-    T rhs_dua(qpsettings.eps_abs);
-    if (qpsettings.eps_rel != 0) {
-      rhs_dua +=
-        qpsettings.eps_rel *
-        std::max(
-          std::max(dual_feasibility_rhs_3, dual_feasibility_rhs_0),
-          std::max(dual_feasibility_rhs_1, qpwork.dual_feasibility_rhs_2));
-    }
+      if (qpsettings.verbose) {
+        /* TO PUT IN DEBUG MODE
+        std::cout << "---------------it : " << iter
+                                                << " primal residual : " <<
+        primal_feasibility_lhs
+                                                << " dual residual : " <<
+        dual_feasibility_lhs << std::endl; std::cout << "bcl_eta_ext : " <<
+        bcl_eta_ext
+                                                << " bcl_eta_in : " << bcl_eta_in
+                                                << " rho : " << qpresults.info.rho
+                                                << " bcl_mu_eq : " <<
+        qpresults.info.mu_eq
+                                                << " bcl_mu_in : " <<
+        qpresults.info.mu_in << std::endl; std::cout << "qpsettings.eps_abs " <<
+        qpsettings.eps_abs
+                                                << "  qpsettings.eps_rel *rhs "
+                                                << qpsettings.eps_rel *
+                                                                         std::max(
+                                                                                         std::max(
+                                                                                                         primal_feasibility_eq_rhs_0,
+                                                                                                         primal_feasibility_in_rhs_0),
+                                                                                         std::max(
+                                                                                                         std::max(
+                                                                                                                         qpwork.primal_feasibility_rhs_1_eq,
+                                                                                                                         qpwork.primal_feasibility_rhs_1_in_u),
+                                                                                                         qpwork.primal_feasibility_rhs_1_in_l))
+                                                << std::endl;
+        std::cout << "is_primal_feasible " << is_primal_feasible
+                                                << " is_dual_feasible " <<
+        is_dual_feasible << std::endl;
+        */
+
+        ruiz.unscale_primal_in_place(
+          VectorViewMut<T>{ from_eigen, qpresults.x });
+        ruiz.unscale_dual_in_place_eq(
+          VectorViewMut<T>{ from_eigen, qpresults.y });
+        ruiz.unscale_dual_in_place_in(
+          VectorViewMut<T>{ from_eigen, qpresults.z });
+
+        qpresults.info.objValue =
+          compute_objective(qpmodel, qpwork, ruiz, qpresults.x);
+        std::cout << "\033[1;32m[outer iteration " << iter + 1 << "]\033[0m"
+                  << std::endl;
+        std::cout << std::scientific << std::setw(2) << std::setprecision(2)
+                  << "| primal residual=" << qpresults.info.pri_res
+                  << "| dual residual=" << qpresults.info.dua_res
+                  << " | mu_in=" << qpresults.info.mu_in
+                  << " | rho=" << qpresults.info.rho << std::endl;
+        ruiz.scale_primal_in_place(VectorViewMut<T>{ from_eigen, qpresults.x });
+        ruiz.scale_dual_in_place_eq(
+          VectorViewMut<T>{ from_eigen, qpresults.y });
+        ruiz.scale_dual_in_place_in(
+          VectorViewMut<T>{ from_eigen, qpresults.z });
+      }
+      if (is_primal_feasible) {
 
-    bool is_dual_feasible = dual_feasibility_lhs <= rhs_dua;
+        if (dual_feasibility_lhs >=
+              qpsettings.refactor_dual_feasibility_threshold &&
+            qpresults.info.rho != qpsettings.refactor_rho_threshold) {
 
-    if (qpsettings.verbose) {
-      /* TO PUT IN DEBUG MODE
-      std::cout << "---------------it : " << iter
-                                              << " primal residual : " <<
-      primal_feasibility_lhs
-                                              << " dual residual : " <<
-      dual_feasibility_lhs << std::endl; std::cout << "bcl_eta_ext : " <<
-      bcl_eta_ext
-                                              << " bcl_eta_in : " << bcl_eta_in
-                                              << " rho : " << qpresults.info.rho
-                                              << " bcl_mu_eq : " <<
-      qpresults.info.mu_eq
-                                              << " bcl_mu_in : " <<
-      qpresults.info.mu_in << std::endl; std::cout << "qpsettings.eps_abs " <<
-      qpsettings.eps_abs
-                                              << "  qpsettings.eps_rel *rhs "
-                                              << qpsettings.eps_rel *
-                                                                       std::max(
-                                                                                       std::max(
-                                                                                                       primal_feasibility_eq_rhs_0,
-                                                                                                       primal_feasibility_in_rhs_0),
-                                                                                       std::max(
-                                                                                                       std::max(
-                                                                                                                       qpwork.primal_feasibility_rhs_1_eq,
-                                                                                                                       qpwork.primal_feasibility_rhs_1_in_u),
-                                                                                                       qpwork.primal_feasibility_rhs_1_in_l))
-                                              << std::endl;
-      std::cout << "is_primal_feasible " << is_primal_feasible
-                                              << " is_dual_feasible " <<
-      is_dual_feasible << std::endl;
-      */
+          T rho_new(qpsettings.refactor_rho_threshold);
 
-      ruiz.unscale_primal_in_place(VectorViewMut<T>{ from_eigen, qpresults.x });
-      ruiz.unscale_dual_in_place_eq(
-        VectorViewMut<T>{ from_eigen, qpresults.y });
-      ruiz.unscale_dual_in_place_in(
-        VectorViewMut<T>{ from_eigen, qpresults.z });
+          refactorize(qpmodel, qpresults, qpwork, rho_new);
+          qpresults.info.rho_updates += 1;
 
-      {
-        // EigenAllowAlloc _{};
-        qpresults.info.objValue = 0;
-        for (Eigen::Index j = 0; j < qpmodel.dim; ++j) {
-          qpresults.info.objValue +=
-            0.5 * (qpresults.x(j) * qpresults.x(j)) * qpmodel.H(j, j);
-          qpresults.info.objValue +=
-            qpresults.x(j) * T(qpmodel.H.col(j)
-                                 .tail(qpmodel.dim - j - 1)
-                                 .dot(qpresults.x.tail(qpmodel.dim - j - 1)));
+          qpresults.info.rho = rho_new;
+        }
+        if (is_dual_feasible) {
+          qpresults.info.status = QPSolverOutput::PROXQP_SOLVED;
+          break;
         }
-        qpresults.info.objValue += (qpmodel.g).dot(qpresults.x);
       }
-      std::cout << "\033[1;32m[outer iteration " << iter + 1 << "]\033[0m"
-                << std::endl;
-      std::cout << std::scientific << std::setw(2) << std::setprecision(2)
-                << "| primal residual=" << qpresults.info.pri_res
-                << "| dual residual=" << qpresults.info.dua_res
-                << " | mu_in=" << qpresults.info.mu_in
-                << " | rho=" << qpresults.info.rho << std::endl;
-      ruiz.scale_primal_in_place(VectorViewMut<T>{ from_eigen, qpresults.x });
-      ruiz.scale_dual_in_place_eq(VectorViewMut<T>{ from_eigen, qpresults.y });
-      ruiz.scale_dual_in_place_in(VectorViewMut<T>{ from_eigen, qpresults.z });
+      if (qpwork.deadline.is_set()) {
+        qpwork.best.update(qpresults.x,
+                           qpresults.y,
+                           qpresults.z,
+                           primal_feasibility_lhs,
+                           dual_feasibility_lhs,
+                           std::max(primal_feasibility_lhs,
+                                    dual_feasibility_lhs));
+        if (qpwork.deadline.reached()) {
+          qpresults.x = qpwork.best.x;
+          qpresults.y = qpwork.best.y;
+          qpresults.z = qpwork.best.z;
+          qpresults.info.pri_res = qpwork.best.pri_res;
+          qpresults.info.dua_res = qpwork.best.dua_res;
+          qpresults.info.status = QPSolverOutput::PROXQP_TIME_LIMIT_REACHED;
+          break;
+        }
+      }
+      qpresults.info.iter_ext += 1; // We start a new external loop update
+      state.primal_feasibility_lhs = primal_feasibility_lhs;
+      state.dual_feasibility_lhs = dual_feasibility_lhs;
+
+      qpwork.x_prev = qpresults.x;
+      qpwork.y_prev = qpresults.y;
+      qpwork.z_prev = qpresults.z;
+
+      // primal dual version from gill and robinson
+
+      ruiz.scale_primal_residual_in_place_in(VectorViewMut<T>{
+        from_eigen,
+        qpwork.primal_residual_in_scaled_up }); // contains now scaled(Cx)
+      qpwork.primal_residual_in_scaled_up +=
+        qpwork.z_prev *
+        qpresults.info.mu_in; // contains now scaled(Cx+z_prev*mu_in)
+      qpwork.primal_residual_in_scaled_low =
+        qpwork.primal_residual_in_scaled_up;
+      qpwork.primal_residual_in_scaled_up -=
+        qpwork.u_scaled; // contains now scaled(Cx-u+z_prev*mu_in)
+      qpwork.primal_residual_in_scaled_low -=
+        qpwork.l_scaled; // contains now scaled(Cx-l+z_prev*mu_in)
+      state.in_inner_loop = true;
+      state.inner_iter = 0;
     }
-    if (is_primal_feasible) {
-
-      if (dual_feasibility_lhs >=
-            qpsettings.refactor_dual_feasibility_threshold &&
-          qpresults.info.rho != qpsettings.refactor_rho_threshold) {
-
-        T rho_new(qpsettings.refactor_rho_threshold);
-
-        refactorize(qpmodel, qpresults, qpwork, rho_new);
-        qpresults.info.rho_updates += 1;
 
-        qpresults.info.rho = rho_new;
-      }
-      if (is_dual_feasible) {
-        qpresults.info.status = QPSolverOutput::PROXQP_SOLVED;
-        break;
+    if (!primal_dual_newton_semi_smooth(
+          qpsettings, qpmodel, qpresults, qpwork, ruiz, bcl_eta_in, budget)) {
+      // the inner loop is resumed by the next step
+      if (qpsettings.compute_timings) {
+        qpwork.timer.stop();
       }
+      return false;
     }
-    qpresults.info.iter_ext += 1; // We start a new external loop update
-
-    qpwork.x_prev = qpresults.x;
-    qpwork.y_prev = qpresults.y;
-    qpwork.z_prev = qpresults.z;
-
-    // primal dual version from gill and robinson
-
-    ruiz.scale_primal_residual_in_place_in(VectorViewMut<T>{
-      from_eigen,
-      qpwork.primal_residual_in_scaled_up }); // contains now scaled(Cx)
-    qpwork.primal_residual_in_scaled_up +=
-      qpwork.z_prev *
-      qpresults.info.mu_in; // contains now scaled(Cx+z_prev*mu_in)
-    qpwork.primal_residual_in_scaled_low = qpwork.primal_residual_in_scaled_up;
-    qpwork.primal_residual_in_scaled_up -=
-      qpwork.u_scaled; // contains now scaled(Cx-u+z_prev*mu_in)
-    qpwork.primal_residual_in_scaled_low -=
-      qpwork.l_scaled; // contains now scaled(Cx-l+z_prev*mu_in)
-
-    primal_dual_newton_semi_smooth(
-      qpsettings, qpmodel, qpresults, qpwork, ruiz, bcl_eta_in);
+    state.in_inner_loop = false;
+    qpresults.info.polished = false;
+    primal_feasibility_lhs = state.primal_feasibility_lhs;
+    dual_feasibility_lhs = state.dual_feasibility_lhs;
 
     if (qpresults.info.status == QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE ||
         qpresults.info.status == QPSolverOutput::PROXQP_DUAL_INFEASIBLE) {
@@ -1146,6 +1863,22 @@ qp_solve( //
       qpresults.z = qpwork.dw_aug.tail(qpmodel.n_in);
       break;
     }
+    if (qpwork.deadline.reached()) {
+      // the inner iterate is not checked: the best iterate is returned, and
+      // the proximal parameters are not updated (nor the factorization)
+      qpresults.x = qpwork.best.x;
+      qpresults.y = qpwork.best.y;
+      qpresults.z = qpwork.best.z;
+      qpresults.info.pri_res = qpwork.best.pri_res;
+      qpresults.info.dua_res = qpwork.best.dua_res;
+      qpresults.info.status = QPSolverOutput::PROXQP_TIME_LIMIT_REACHED;
+      break;
+    }
+
+    T new_bcl_mu_in(qpresults.info.mu_in);
+    T new_bcl_mu_eq(qpresults.info.mu_eq);
+    T new_bcl_mu_in_inv(qpresults.info.mu_in_inv);
+    T new_bcl_mu_eq_inv(qpresults.info.mu_eq_inv);
 
     T primal_feasibility_lhs_new(primal_feasibility_lhs);
 
@@ -1159,7 +1892,7 @@ qp_solve( //
                            primal_feasibility_eq_lhs,
                            primal_feasibility_in_lhs);
 
-    is_primal_feasible =
+    bool is_primal_feasible =
       primal_feasibility_lhs_new <=
       (qpsettings.eps_abs +
        qpsettings.eps_rel *
@@ -1181,7 +1914,7 @@ qp_solve( //
                            dual_feasibility_rhs_3);
       qpresults.info.dua_res = dual_feasibility_lhs_new;
 
-      is_dual_feasible =
+      bool is_dual_feasible =
         dual_feasibility_lhs_new <=
         (qpsettings.eps_abs +
          qpsettings.eps_rel *
@@ -1247,6 +1980,23 @@ qp_solve( //
       new_bcl_mu_in_inv = qpsettings.cold_reset_mu_in_inv;
       new_bcl_mu_eq_inv = qpsettings.cold_reset_mu_eq_inv;
     }
+    if (qpsettings.anderson_acceleration) {
+      anderson_step(qpmodel,
+                    qpresults,
+                    qpwork,
+                    ruiz,
+                    new_bcl_mu_eq,
+                    new_bcl_mu_in,
+                    primal_feasibility_lhs_new,
+                    dual_feasibility_lhs_new,
+                    primal_feasibility_eq_rhs_0,
+                    primal_feasibility_in_rhs_0,
+                    primal_feasibility_eq_lhs,
+                    primal_feasibility_in_lhs,
+                    dual_feasibility_rhs_0,
+                    dual_feasibility_rhs_1,
+                    dual_feasibility_rhs_3);
+    }
 
     /// effective mu upddate
 
@@ -1264,97 +2014,41 @@ qp_solve( //
     qpresults.info.mu_in_inv = new_bcl_mu_in_inv;
   }
 
-  ruiz.unscale_primal_in_place(VectorViewMut<T>{ from_eigen, qpresults.x });
-  ruiz.unscale_dual_in_place_eq(VectorViewMut<T>{ from_eigen, qpresults.y });
-  ruiz.unscale_dual_in_place_in(VectorViewMut<T>{ from_eigen, qpresults.z });
-
-  {
-    // EigenAllowAlloc _{};
-    for (Eigen::Index j = 0; j < qpmodel.dim; ++j) {
-      qpresults.info.objValue +=
-        0.5 * (qpresults.x(j) * qpresults.x(j)) * qpmodel.H(j, j);
-      qpresults.info.objValue +=
-        qpresults.x(j) * T(qpmodel.H.col(j)
-                             .tail(qpmodel.dim - j - 1)
-                             .dot(qpresults.x.tail(qpmodel.dim - j - 1)));
-    }
-    qpresults.info.objValue += (qpmodel.g).dot(qpresults.x);
-  }
-
-  if (qpsettings.compute_timings) {
-    qpresults.info.solve_time = qpwork.timer.elapsed().user; // in nanoseconds
-    qpresults.info.run_time =
-      qpresults.info.solve_time + qpresults.info.setup_time;
-    if (qpsettings.verbose) {
-      std::cout << "-------------------SOLVER STATISTICS-------------------"
-                << std::endl;
-      std::cout << "outer iter:   " << qpresults.info.iter_ext << std::endl;
-      std::cout << "total iter:   " << qpresults.info.iter << std::endl;
-      std::cout << "mu updates:   " << qpresults.info.mu_updates << std::endl;
-      std::cout << "rho updates:  " << qpresults.info.rho_updates << std::endl;
-      std::cout << "objective:    " << qpresults.info.objValue << std::endl;
-      switch (qpresults.info.status) {
-        case QPSolverOutput::PROXQP_SOLVED: {
-          std::cout << "status:       "
-                    << "Solved" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
-          std::cout << "status:       "
-                    << "Maximum number of iterations reached" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Primal infeasible" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Dual infeasible" << std::endl;
-          break;
-        }
-      }
-      std::cout << "run time:     " << qpresults.info.solve_time << std::endl;
-      std::cout << "--------------------------------------------------------"
-                << std::endl;
-    }
-  } else {
-    if (qpsettings.verbose) {
-      std::cout << "-------------------SOLVER STATISTICS-------------------"
-                << std::endl;
-      std::cout << "outer iter:   " << qpresults.info.iter_ext << std::endl;
-      std::cout << "total iter:   " << qpresults.info.iter << std::endl;
-      std::cout << "mu updates:   " << qpresults.info.mu_updates << std::endl;
-      std::cout << "rho updates:  " << qpresults.info.rho_updates << std::endl;
-      std::cout << "objective:    " << qpresults.info.objValue << std::endl;
-      switch (qpresults.info.status) {
-        case QPSolverOutput::PROXQP_SOLVED: {
-          std::cout << "status:       "
-                    << "Solved." << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
-          std::cout << "status:       "
-                    << "Maximum number of iterations reached" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Primal infeasible" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Dual infeasible" << std::endl;
-          break;
-        }
-      }
-      std::cout << "--------------------------------------------------------"
-                << std::endl;
-    }
-  }
-  qpwork.dirty = true;
+  qp_solve_end(qpsettings, qpmodel, qpresults, qpwork, ruiz);
+  return true;
+}
+/*!
+ * Executes the PROXQP algorithm, or the interior-point method if so set by
+ * qpsettings.method.
+ *
+ * @param qpwork solver workspace.
+ * @param qpmodel QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param qpsettings solver settings.
+ * @param qpresults solver results.
+ * @param ruiz ruiz preconditioner.
+ * @param observer callable receiving the IterationRecord of each outer
+ * iteration (by default, nothing is recorded).
+ */
+template<typename T, typename Observer = NullObserver>
+void
+qp_solve( //
+  const Settings<T>& qpsettings,
+  const Model<T>& qpmodel,
+  Results<T>& qpresults,
+  Workspace<T>& qpwork,
+  preconditioner::RuizEquilibration<T>& ruiz,
+  Observer&& observer = Observer{})
+{
+  trace::Span span("solve");
+  qp_solve_begin(qpsettings, qpmodel, qpresults, qpwork, ruiz);
+  qp_solve_step(qpsettings,
+                qpmodel,
+                qpresults,
+                qpwork,
+                ruiz,
+                std::numeric_limits<isize>::max(),
+                observer);
 }
 
 } // namespace dense
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file stagewise.hpp
+ */
+#ifndef PROXSUITE_QP_DENSE_STAGEWISE_HPP
+#define PROXSUITE_QP_DENSE_STAGEWISE_HPP
+
+#include <proxsuite/linalg/veg/internal/macros.hpp>
+#include "proxsuite/proxqp/dense/model.hpp"
+#include <vector>
+
+namespace proxsuite {
+namespace proxqp {
+namespace dense {
+///
+/// @brief Stage of a stage-wise QP problem (e.g., an MPC problem).
+///
+/*!
+ * A horizon of N stages defines the QP problem
+ *
+ *   min  sum_k 1/2 x_k^T Q_k x_k + u_k^T S_k x_k + 1/2 u_k^T R_k u_k
+ *              + q_k^T x_k + r_k^T u_k
+ *   s.t. x_0 = x_init,
+ *        x_{k+1} = A_k x_k + B_k u_k + c_k,   k < N - 1,
+ *        l_k <= Cx_k x_k + Cu_k u_k <= u_k,
+ *
+ * of state x_k (of size Q_k.rows()) and input u_k (of size R_k.rows()). The
+ * last stage has no dynamics (A, B and c are empty), and usually no input.
+ * Empty S, Cx or Cu matrices stand for zero matrices.
+ */
+template<typename T>
+struct Stage
+{
+  ///// cost
+  Mat<T> Q;
+  Mat<T> S;
+  Mat<T> R;
+  Vec<T> q;
+  Vec<T> r;
+
+  ///// dynamics
+  Mat<T> A;
+  Mat<T> B;
+  Vec<T> c;
+
+  ///// stage constraints
+  Mat<T> Cx;
+  Mat<T> Cu;
+  Vec<T> l;
+  Vec<T> u;
+};
+/*!
+ * Builds the model of a stage-wise QP problem, with the variables ordered
+ * stage by stage (x_0, u_0, x_1, u_1, ..., x_{N-1}, u_{N-1}). The KKT matrix
+ * of this ordering being banded, the model is meant to be solved with the
+ * KktMode::BANDED mode, whose factorization cost is linear in the horizon.
+ *
+ * @param stages stages of the problem.
+ * @param x_init initial state.
+ */
+template<typename T>
+Model<T>
+stagewise_model(std::vector<Stage<T>> const& stages, Vec<T> const& x_init)
+{
+  isize n_stages = isize(stages.size());
+  PROXSUITE_THROW_PRETTY(n_stages == 0,
+                         std::invalid_argument,
+                         "wrong argument size: the horizon is empty.");
+
+  isize dim = 0;
+  isize n_eq = 0;
+  isize n_in = 0;
+  for (isize k = 0; k < n_stages; ++k) {
+    Stage<T> const& stage = stages[std::size_t(k)];
+    isize nx = stage.Q.rows();
+    isize nu = stage.R.rows();
+    isize nc = stage.l.rows();
+    isize nx_next =
+      k + 1 < n_stages ? stages[std::size_t(k + 1)].Q.rows() : 0;
+    PROXSUITE_THROW_PRETTY(
+      stage.Q.cols() != nx || stage.R.cols() != nu || stage.q.rows() != nx ||
+        stage.r.rows() != nu,
+      std::invalid_argument,
+      "wrong argument size: the cost of the stage "
+        << k << " is inconsistent.");
+    PROXSUITE_THROW_PRETTY(
+      stage.S.size() != 0 && (stage.S.rows() != nu || stage.S.cols() != nx),
+      std::invalid_argument,
+      "wrong argument size: S of the stage " << k << " is not of size "
+                                             << nu << "x" << nx << ".");
+    PROXSUITE_THROW_PRETTY(
+      stage.A.rows() != nx_next || stage.B.rows() != nx_next ||
+        stage.c.rows() != nx_next ||
+        (nx_next > 0 && (stage.A.cols() != nx || stage.B.cols() != nu)),
+      std::invalid_argument,
+      "wrong argument size: the dynamics of the stage "
+        << k << " is inconsistent.");
+    PROXSUITE_THROW_PRETTY(
+      stage.u.rows() != nc ||
+        (stage.Cx.size() != 0 &&
+         (stage.Cx.rows() != nc || stage.Cx.cols() != nx)) ||
+        (stage.Cu.size() != 0 &&
+         (stage.Cu.rows() != nc || stage.Cu.cols() != nu)),
+      std::invalid_argument,
+      "wrong argument size: the constraints of the stage "
+        << k << " are inconsistent.");
+    dim += nx + nu;
+    n_eq += nx;
+    n_in += nc;
+  }
+  PROXSUITE_THROW_PRETTY(x_init.rows() != stages[0].Q.rows(),
+                         std::invalid_argument,
+                         "wrong argument size: x_init is not of size "
+                           << stages[0].Q.rows() << ".");
+
+  Model<T> model(dim, n_eq, n_in);
+  isize offset = 0;
+  isize eq = 0;
+  isize in = 0;
+  model.A.topLeftCorner(x_init.rows(), x_init.rows()).setIdentity();
+  model.b.head(x_init.rows()) = x_init;
+  eq += x_init.rows();
+  for (isize k = 0; k < n_stages; ++k) {
+    Stage<T> const& stage = stages[std::size_t(k)];
+    isize nx = stage.Q.rows();
+    isize nu = stage.R.rows();
+    isize nc = stage.l.rows();
+    isize nx_next = stage.A.rows();
+    isize x = offset;
+    isize u = offset + nx;
+
+    model.H.block(x, x, nx, nx) = stage.Q;
+    model.H.block(u, u, nu, nu) = stage.R;
+    if (stage.S.size() != 0) {
+      model.H.block(u, x, nu, nx) = stage.S;
+      model.H.block(x, u, nx, nu) = stage.S.transpose();
+    }
+    model.g.segment(x, nx) = stage.q;
+    model.g.segment(u, nu) = stage.r;
+
+    if (nx_next > 0) {
+      model.A.block(eq, x, nx_next, nx) = -stage.A;
+      model.A.block(eq, u, nx_next, nu) = -stage.B;
+      model.A.block(eq, u + nu, nx_next, nx_next).setIdentity();
+      model.b.segment(eq, nx_next) = stage.c;
+      eq += nx_next;
+    }
+
+    if (stage.Cx.size() != 0) {
+      model.C.block(in, x, nc, nx) = stage.Cx;
+    }
+    if (stage.Cu.size() != 0) {
+      model.C.block(in, u, nc, nu) = stage.Cu;
+    }
+    model.l.segment(in, nc) = stage.l;
+    model.u.segment(in, nc) = stage.u;
+    in += nc;
+
+    offset += nx + nu;
+  }
+  return model;
+}
+} // namespace dense
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_DENSE_STAGEWISE_HPP */
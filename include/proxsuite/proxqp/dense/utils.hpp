@@ -156,6 +156,7 @@ global_primal_residual(const Model<T>& qpmodel,
                        T& primal_feasibility_eq_lhs,
                        T& primal_feasibility_in_lhs)
 {
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::RESIDUALS);
   // COMPUTES:
   // primal_residual_eq_scaled = scaled(Ax - b)
   //
@@ -344,6 +345,7 @@ global_dual_residual(Results<T>& qpresults,
                      T& dual_feasibility_rhs_1,
                      T& dual_feasibility_rhs_3)
 {
+  PhaseTimer<T> timer(qpresults.info.phase_timings, Phase::RESIDUALS);
   // dual_feasibility_lhs = norm(dual_residual_scaled)
   // dual_feasibility_rhs_0 = norm(unscaled(Hx))
   // dual_feasibility_rhs_1 = norm(unscaled(ATy))
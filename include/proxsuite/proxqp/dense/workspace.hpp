@@ -9,7 +9,12 @@
 
 #include <Eigen/Core>
 #include <proxsuite/linalg/dense/ldlt.hpp>
+#include <proxsuite/linalg/dense/band_ldlt.hpp>
 #include <proxsuite/proxqp/timings.hpp>
+#include <proxsuite/proxqp/anderson.hpp>
+#include <proxsuite/proxqp/time_limit.hpp>
+#include <proxsuite/proxqp/solve_state.hpp>
+#include <proxsuite/proxqp/factorization_cache.hpp>
 #include <proxsuite/linalg/veg/vec.hpp>
 //#include <proxsuite/proxqp/dense/preconditioner/ruiz.hpp>
 
@@ -17,6 +22,217 @@ namespace proxsuite {
 namespace proxqp {
 namespace dense {
 ///
+/// @brief Linear system factorized by the dense solver.
+///
+/*!
+ * AUGMENTED factorizes the KKT matrix of size dim + n_eq + n_c (n_c being the
+ * number of active inequalities), whose rows and columns are inserted or
+ * deleted when the active set changes.
+ *
+ * CONDENSED eliminates the multipliers and factorizes the primal Schur
+ * complement H + rho I + A^T A / mu_eq + C_a^T C_a / mu_in of size dim, which
+ * is updated (resp. downdated) with rank one updates when inequalities become
+ * active (resp. inactive). It is cheaper when the number of constraints is
+ * large compared to dim, but more sensitive to small values of mu.
+ *
+ * DUAL eliminates the primal variable and factorizes the dual Schur complement
+ * [A; C_a] (H + rho I)^-1 [A; C_a]^T + diag(mu_eq, mu_in) of size n_eq + n_c,
+ * whose rows and columns are inserted or deleted when the active set changes.
+ * It is cheaper when dim is large compared to the number of constraints and H
+ * is cheap to invert: a diagonal H is inverted directly, any other H is
+ * factorized once per value of rho.
+ *
+ * BANDED factorizes the KKT matrix of size dim + n_eq + n_in with a banded
+ * LDLT, the variables being kept in their order and each constraint being
+ * placed right after the last variable it involves. Inactive inequalities are
+ * kept as decoupled rows, so that an active set change only modifies the rows
+ * of the constraints concerned and the factorization is updated from the
+ * first of them on. It suits problems whose variables are ordered stage by
+ * stage, e.g. the MPC problems built by stagewise_model, for which the
+ * bandwidth is the size of a few stages and the factorization costs
+ * O(N stage^3) instead of O((N stage)^3). It is never chosen by AUTOMATIC.
+ *
+ * AUTOMATIC chooses CONDENSED when n_eq + n_in >= 4 dim. When
+ * dim >= 4 (n_eq + n_in), it chooses DUAL if H is diagonal at setup and
+ * AUGMENTED otherwise.
+ */
+enum struct KktMode
+{
+  AUTOMATIC,
+  AUGMENTED,
+  CONDENSED,
+  DUAL,
+  BANDED,
+};
+/*!
+ * Resolves the linear system factorized for the given dimensions.
+ * @param mode requested mode.
+ * @param dim primal variable dimension.
+ * @param n_eq number of equality constraints.
+ * @param n_in number of inequality constraints.
+ */
+inline KktMode
+resolve_kkt_mode(KktMode mode, isize dim, isize n_eq, isize n_in)
+{
+  if (mode != KktMode::AUTOMATIC) {
+    return mode;
+  }
+  return (dim > 0 && n_eq + n_in >= 4 * dim) ? KktMode::CONDENSED
+                                              : KktMode::AUGMENTED;
+}
+/*!
+ * Returns whether the AUTOMATIC mode may switch to the DUAL one at setup, when
+ * H is diagonal.
+ * @param mode requested mode.
+ * @param dim primal variable dimension.
+ * @param n_eq number of equality constraints.
+ * @param n_in number of inequality constraints.
+ */
+inline bool
+dual_kkt_mode_allowed(KktMode mode, isize dim, isize n_eq, isize n_in)
+{
+  return mode == KktMode::AUTOMATIC && n_eq + n_in > 0 &&
+         dim >= 4 * (n_eq + n_in);
+}
+/*!
+ * Returns the memory storage requirements of the DUAL mode.
+ * @param dim primal variable dimension.
+ * @param n_eq number of equality constraints.
+ * @param n_in number of inequality constraints.
+ * @param dense_hessian if set to true, H + rho I is factorized (H is not
+ * diagonal).
+ */
+template<typename T>
+proxsuite::linalg::veg::dynstack::StackReq
+dual_kkt_stack_req(isize dim, isize n_eq, isize n_in, bool dense_hessian)
+{
+  using proxsuite::linalg::dense::Ldlt;
+  using proxsuite::linalg::dense::temp_mat_req;
+  using proxsuite::linalg::dense::temp_vec_req;
+  using proxsuite::linalg::veg::Tag;
+  using proxsuite::linalg::veg::dynstack::StackReq;
+  isize m = n_eq + n_in;
+
+  StackReq req =
+    // equilibration and newton step
+    temp_vec_req(Tag<T>{}, dim + n_eq + n_in) |
+    (temp_vec_req(Tag<T>{}, dim) & temp_vec_req(Tag<T>{}, dim)) |
+
+    // factorization of the dual Schur complement
+    (temp_mat_req(Tag<T>{}, dim, m) & temp_mat_req(Tag<T>{}, dim, m) &
+     temp_mat_req(Tag<T>{}, m, m) &
+     (Ldlt<T>::factorize_req(m) | Ldlt<T>::solve_in_place_req(dim))) |
+
+    // mu update
+    (temp_vec_req(Tag<T>{}, m) &
+     StackReq{ isize{ sizeof(isize) } * m, alignof(isize) } &
+     Ldlt<T>::diagonal_update_req(m, m)) |
+
+    // active set changes
+    (StackReq{ isize{ sizeof(isize) } * n_in, alignof(isize) } &
+     (Ldlt<T>::delete_at_req(m, n_in) |
+      (temp_mat_req(Tag<T>{}, m, n_in) & temp_vec_req(Tag<T>{}, dim) &
+       temp_vec_req(Tag<T>{}, n_in) & Ldlt<T>::solve_in_place_req(dim) &
+       Ldlt<T>::insert_block_at_req(m, n_in)))) |
+
+    // solve
+    (temp_vec_req(Tag<T>{}, dim) &
+     (Ldlt<T>::solve_in_place_req(m) | Ldlt<T>::solve_in_place_req(dim)));
+
+  if (dense_hessian) {
+    req = req | (temp_mat_req(Tag<T>{}, dim, dim) & Ldlt<T>::factorize_req(dim));
+  }
+  return req;
+}
+///
+/// @brief Factorization of the AUGMENTED mode kept by the factorization cache.
+///
+template<typename T>
+struct CachedFactorization
+{
+  proxsuite::linalg::dense::Ldlt<T> ldl;
+  isize n_c;
+  VecISize bijection_map; // current_bijection_map of the factorization
+  bool constraints_changed;
+};
+///
+/// @brief Iterates and buffers of the interior-point method.
+///
+/*!
+ * The Newton system of the interior-point method is assembled in a temporary
+ * of ldl_stack and factorized in ldl, and its right hand side and solution are
+ * kept in the rhs, err and dw_aug vectors of the workspace: only the vectors
+ * of the inequality constraints are kept here.
+ */
+template<typename T>
+struct InteriorPointWorkspace
+{
+  // masks of the finite sides of the inequality constraints
+  Vec<T> mask_l;
+  Vec<T> mask_u;
+  // slacks and multipliers of the inequality constraints
+  Vec<T> t_l;
+  Vec<T> t_u;
+  Vec<T> lambda_l;
+  Vec<T> lambda_u;
+  // residuals of the optimality conditions
+  Vec<T> r_d;
+  Vec<T> r_p;
+  Vec<T> r_l;
+  Vec<T> r_u;
+  Vec<T> r_cl;
+  Vec<T> r_cu;
+  // weights of the inequality constraints, and the ones condensed in the
+  // first block of the Newton system
+  Vec<T> d;
+  Vec<T> d_condensed;
+  Vec<T> q;
+  Vec<T> v;
+  Vec<T> Cx;
+  // rows of the inequality constraints kept in the Newton system
+  VecISize augmented;
+  // steps of the slacks and of the multipliers
+  Vec<T> dt_l;
+  Vec<T> dt_u;
+  Vec<T> dlambda_l;
+  Vec<T> dlambda_u;
+
+  /*!
+   * Allocates the vectors, when their dimensions change.
+   * @param n primal variable dimension.
+   * @param n_eq number of equality constraints.
+   * @param n_in number of inequality constraints.
+   */
+  void resize(isize n, isize n_eq, isize n_in)
+  {
+    if (r_d.size() == n && r_p.size() == n_eq && d.size() == n_in) {
+      return;
+    }
+    mask_l.resize(n_in);
+    mask_u.resize(n_in);
+    t_l.resize(n_in);
+    t_u.resize(n_in);
+    lambda_l.resize(n_in);
+    lambda_u.resize(n_in);
+    r_d.resize(n);
+    r_p.resize(n_eq);
+    r_l.resize(n_in);
+    r_u.resize(n_in);
+    r_cl.resize(n_in);
+    r_cu.resize(n_in);
+    d.resize(n_in);
+    d_condensed.resize(n_in);
+    q.resize(n_in);
+    v.resize(n_in);
+    Cx.resize(n_in);
+    augmented.resize(n_in);
+    dt_l.resize(n_in);
+    dt_u.resize(n_in);
+    dlambda_l.resize(n_in);
+    dlambda_u.resize(n_in);
+  }
+};
+///
 /// @brief This class defines the workspace of the dense solver.
 ///
 /*!
@@ -25,6 +241,8 @@ namespace dense {
 template<typename T>
 struct Workspace
 {
+  KktMode requested_kkt_mode; // mode given at construction
+  KktMode kkt_mode;           // resolved linear system (never AUTOMATIC)
 
   ///// Cholesky Factorization
   proxsuite::linalg::dense::Ldlt<T> ldl{};
@@ -46,9 +264,36 @@ struct Workspace
   Vec<T> y_prev;
   Vec<T> z_prev;
 
+  ///// Anderson acceleration of the outer loop (sized at the solve)
+  AndersonAcceleration<T> anderson;
+
+  ///// Time limit of the solve, and best iterate (sized at the solve)
+  Deadline deadline;
+  BestIterate<T> best;
+
+  ///// State of the outer loop, kept between the steps of a solve
+  SolveState<T> solve_state;
+
+  ///// Iterates of the interior-point method (sized at the solve)
+  InteriorPointWorkspace<T> interior_point;
+
+  ///// Factorizations of the previous solves (kept by the cleanup)
+  FactorizationCache<T, CachedFactorization<T>> factorization_cache;
+
   ///// KKT system storage
   Mat<T> kkt;
 
+  ///// (H_scaled + rho I)^-1 in DUAL mode
+  bool h_diagonal;
+  Vec<T> h_rho_inv; // inverse of the diagonal of H_scaled + rho I
+  proxsuite::linalg::dense::Ldlt<T> ldl_h{}; // used when H is not diagonal
+
+  ///// banded KKT matrix in BANDED mode
+  proxsuite::linalg::dense::BandLdlt<T> band_ldl{};
+  // position in the banded KKT matrix of the variables, of the equalities and
+  // of all the inequalities (in this order)
+  VecISize band_position;
+
   //// Active set & permutation vector
   VecISize current_bijection_map;
   VecISize new_bijection_map;
@@ -94,6 +339,9 @@ struct Workspace
   bool dirty;
   bool refactorize;
   bool proximal_parameter_update;
+  bool preconditioner_loaded; // scaling variables loaded by the user are kept
+  bool interior_point_ldl; // ldl is the factorization of the interior-point
+                           // method, and not the one of PROXQP
 
   sparse::isize n_c; // final number of active inequalities
   /*!
@@ -101,11 +349,17 @@ struct Workspace
    * @param dim primal variable dimension.
    * @param n_eq number of equality constraints.
    * @param n_in number of inequality constraints.
+   * @param mode linear system factorized by the solver.
    */
-  Workspace(isize dim = 0, isize n_eq = 0, isize n_in = 0)
+  Workspace(isize dim = 0,
+            isize n_eq = 0,
+            isize n_in = 0,
+            KktMode mode = KktMode::AUTOMATIC)
     : //
       // ruiz(preconditioner::RuizEquilibration<T>{dim, n_eq + n_in}),
-    ldl{}
+    requested_kkt_mode(mode)
+    , kkt_mode(resolve_kkt_mode(mode, dim, n_eq, n_in))
+    , ldl{}
     , // old version with alloc
     H_scaled(dim, dim)
     , g_scaled(dim)
@@ -117,7 +371,20 @@ struct Workspace
     , x_prev(dim)
     , y_prev(n_eq)
     , z_prev(n_in)
-    , kkt(dim + n_eq, dim + n_eq)
+    , kkt(kkt_mode == KktMode::CONDENSED ? dim
+          : (kkt_mode == KktMode::DUAL || kkt_mode == KktMode::BANDED)
+            ? 0
+            : dim + n_eq,
+          kkt_mode == KktMode::CONDENSED ? dim
+          : (kkt_mode == KktMode::DUAL || kkt_mode == KktMode::BANDED)
+            ? 0
+            : dim + n_eq)
+    , h_diagonal(false)
+    , h_rho_inv((kkt_mode == KktMode::DUAL ||
+                 dual_kkt_mode_allowed(mode, dim, n_eq, n_in))
+                  ? dim
+                  : 0)
+    , band_position(kkt_mode == KktMode::BANDED ? dim + n_eq + n_in : 0)
     , current_bijection_map(n_in)
     , new_bijection_map(n_in)
     , active_set_up(n_in)
@@ -145,30 +412,90 @@ struct Workspace
     , dirty(false)
     , refactorize(false)
     , proximal_parameter_update(false)
+    , preconditioner_loaded(false)
+    , interior_point_ldl(false)
 
   {
-    ldl.reserve_uninit(dim + n_eq + n_in);
-    ldl_stack.resize_for_overwrite(
-      proxsuite::linalg::veg::dynstack::StackReq(
-
-        proxsuite::linalg::dense::Ldlt<T>::factorize_req(dim + n_eq + n_in) |
-
-        (proxsuite::linalg::dense::temp_vec_req(
-           proxsuite::linalg::veg::Tag<T>{}, n_eq + n_in) &
-         proxsuite::linalg::veg::dynstack::StackReq{
-           isize{ sizeof(isize) } * (n_eq + n_in), alignof(isize) } &
-         proxsuite::linalg::dense::Ldlt<T>::diagonal_update_req(
-           dim + n_eq + n_in, n_eq + n_in)) |
-
-        (proxsuite::linalg::dense::temp_mat_req(
-           proxsuite::linalg::veg::Tag<T>{}, dim + n_eq + n_in, n_in) &
-         proxsuite::linalg::dense::Ldlt<T>::insert_block_at_req(
-           dim + n_eq + n_in, n_in)) |
-
-        proxsuite::linalg::dense::Ldlt<T>::solve_in_place_req(dim + n_eq +
-                                                              n_in))
-
-        .alloc_req());
+    if (kkt_mode == KktMode::CONDENSED) {
+      ldl.reserve_uninit(dim);
+      ldl_stack.resize_for_overwrite(
+        proxsuite::linalg::veg::dynstack::StackReq(
+
+          proxsuite::linalg::dense::Ldlt<T>::factorize_req(dim) |
+
+          // equilibration
+          proxsuite::linalg::dense::temp_vec_req(
+            proxsuite::linalg::veg::Tag<T>{}, dim + n_eq + n_in) |
+
+          // gathering of the active rows of C and active set changes
+          (proxsuite::linalg::veg::dynstack::StackReq{
+             isize{ sizeof(isize) } * n_in, alignof(isize) } &
+           proxsuite::linalg::dense::temp_mat_req(
+             proxsuite::linalg::veg::Tag<T>{}, dim, n_in) &
+           proxsuite::linalg::dense::temp_vec_req(
+             proxsuite::linalg::veg::Tag<T>{}, n_in) &
+           proxsuite::linalg::dense::Ldlt<T>::rank_r_update_req(dim, n_in)) |
+
+          (proxsuite::linalg::dense::temp_vec_req(
+             proxsuite::linalg::veg::Tag<T>{}, dim) &
+           proxsuite::linalg::dense::Ldlt<T>::solve_in_place_req(dim)))
+
+          .alloc_req());
+    } else if (kkt_mode == KktMode::DUAL) {
+      ldl.reserve_uninit(n_eq + n_in);
+      ldl_stack.resize_for_overwrite(
+        dual_kkt_stack_req<T>(dim, n_eq, n_in, false).alloc_req());
+    } else if (kkt_mode == KktMode::BANDED) {
+      // band_ldl is sized at setup, once the bandwidth is known
+      ldl_stack.resize_for_overwrite(
+        proxsuite::linalg::veg::dynstack::StackReq(
+
+          // equilibration and reordering of the solved vectors
+          proxsuite::linalg::dense::temp_vec_req(
+            proxsuite::linalg::veg::Tag<T>{}, dim + n_eq + n_in) |
+
+          (proxsuite::linalg::dense::temp_vec_req(
+             proxsuite::linalg::veg::Tag<T>{}, dim) &
+           proxsuite::linalg::dense::temp_vec_req(
+             proxsuite::linalg::veg::Tag<T>{}, dim)) |
+
+          // active set changes
+          proxsuite::linalg::veg::dynstack::StackReq{
+            isize{ sizeof(isize) } * n_in, alignof(isize) })
+
+          .alloc_req());
+    } else {
+      // the AUTOMATIC mode may switch to DUAL at setup
+      proxsuite::linalg::veg::dynstack::StackReq dual_req{ 0, 1 };
+      if (dual_kkt_mode_allowed(mode, dim, n_eq, n_in)) {
+        dual_req = dual_kkt_stack_req<T>(dim, n_eq, n_in, false);
+      }
+      ldl.reserve_uninit(dim + n_eq + n_in);
+      ldl_stack.resize_for_overwrite(
+        proxsuite::linalg::veg::dynstack::StackReq(
+
+          proxsuite::linalg::dense::Ldlt<T>::factorize_req(dim + n_eq +
+                                                           n_in) |
+
+          (proxsuite::linalg::dense::temp_vec_req(
+             proxsuite::linalg::veg::Tag<T>{}, n_eq + n_in) &
+           proxsuite::linalg::veg::dynstack::StackReq{
+             isize{ sizeof(isize) } * (n_eq + n_in), alignof(isize) } &
+           proxsuite::linalg::dense::Ldlt<T>::diagonal_update_req(
+             dim + n_eq + n_in, n_eq + n_in)) |
+
+          (proxsuite::linalg::dense::temp_mat_req(
+             proxsuite::linalg::veg::Tag<T>{}, dim + n_eq + n_in, n_in) &
+           proxsuite::linalg::dense::Ldlt<T>::insert_block_at_req(
+             dim + n_eq + n_in, n_in)) |
+
+          proxsuite::linalg::dense::Ldlt<T>::solve_in_place_req(dim + n_eq +
+                                                                n_in) |
+
+          dual_req)
+
+          .alloc_req());
+    }
 
     alphas.reserve(2 * n_in);
     H_scaled.setZero();
@@ -182,6 +509,8 @@ struct Workspace
     y_prev.setZero();
     z_prev.setZero();
     kkt.setZero();
+    h_rho_inv.setZero();
+    band_position.setZero();
     for (isize i = 0; i < n_in; i++) {
       current_bijection_map(i) = i;
       new_bijection_map(i) = i;
@@ -214,14 +543,18 @@ struct Workspace
   }
   /*!
    * Clean-ups solver's workspace.
+   * @param keep_matrices if set to true, the scaled matrices are not cleaned
+   * (they are the only copy of the matrices of a model not owning them).
    */
-  void cleanup()
+  void cleanup(bool keep_matrices = false)
   {
     isize n_in = C_scaled.rows();
-    H_scaled.setZero();
+    if (!keep_matrices) {
+      H_scaled.setZero();
+      A_scaled.setZero();
+      C_scaled.setZero();
+    }
     g_scaled.setZero();
-    A_scaled.setZero();
-    C_scaled.setZero();
     b_scaled.setZero();
     u_scaled.setZero();
     l_scaled.setZero();
@@ -247,6 +580,7 @@ struct Workspace
     x_prev.setZero();
     y_prev.setZero();
     z_prev.setZero();
+    anderson.reset();
 
     for (isize i = 0; i < n_in; i++) {
       current_bijection_map(i) = i;
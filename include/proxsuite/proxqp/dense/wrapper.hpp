@@ -10,6 +10,8 @@
 #include <proxsuite/proxqp/dense/solver.hpp>
 #include <proxsuite/proxqp/dense/helpers.hpp>
 #include <proxsuite/proxqp/dense/preconditioner/ruiz.hpp>
+#include <proxsuite/proxqp/dense/stagewise.hpp>
+#include <proxsuite/proxqp/snapshot.hpp>
 #include <chrono>
 
 namespace proxsuite {
@@ -90,12 +92,18 @@ struct QP
    * @param _dim primal variable dimension.
    * @param _n_eq number of equality constraints.
    * @param _n_in number of inequality constraints.
+   * @param _storage storage policy of the matrices of the model.
+   * @param _kkt_mode linear system factorized by the solver.
    */
-  QP(isize _dim, isize _n_eq, isize _n_in)
+  QP(isize _dim,
+     isize _n_eq,
+     isize _n_in,
+     ModelStorage _storage = ModelStorage::OWNING,
+     KktMode _kkt_mode = KktMode::AUTOMATIC)
     : results(_dim, _n_eq, _n_in)
     , settings()
-    , model(_dim, _n_eq, _n_in)
-    , work(_dim, _n_eq, _n_in)
+    , model(_dim, _n_eq, _n_in, _storage)
+    , work(_dim, _n_eq, _n_in, _kkt_mode)
     , ruiz(preconditioner::RuizEquilibration<T>{ _dim, _n_eq + _n_in })
   {
     work.timer.stop();
@@ -207,7 +215,10 @@ struct QP
       work.timer.start();
     }
     PreconditionerStatus preconditioner_status;
-    if (compute_preconditioner) {
+    if (compute_preconditioner && work.preconditioner_loaded) {
+      // scaling variables loaded by the user are re-used as they are
+      preconditioner_status = proxsuite::proxqp::PreconditionerStatus::KEEP;
+    } else if (compute_preconditioner) {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::EXECUTE;
     } else {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::IDENTITY;
@@ -337,7 +348,10 @@ struct QP
       work.timer.start();
     }
     PreconditionerStatus preconditioner_status;
-    if (compute_preconditioner) {
+    if (compute_preconditioner && work.preconditioner_loaded) {
+      // scaling variables loaded by the user are re-used as they are
+      preconditioner_status = proxsuite::proxqp::PreconditionerStatus::KEEP;
+    } else if (compute_preconditioner) {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::EXECUTE;
     } else {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::IDENTITY;
@@ -378,12 +392,12 @@ struct QP
    * @param mu_in proximal step size wrt inequality constrained multiplier.
    */
   void update(const std::optional<MatRef<T>> H,
-              std::optional<Vec<T>> g,
+              std::optional<VecRef<T>> g,
               const std::optional<MatRef<T>> A,
-              std::optional<Vec<T>> b,
+              std::optional<VecRef<T>> b,
               const std::optional<MatRef<T>> C,
-              std::optional<Vec<T>> u,
-              std::optional<Vec<T>> l,
+              std::optional<VecRef<T>> u,
+              std::optional<VecRef<T>> l,
               bool update_preconditioner = true,
               std::optional<T> rho = std::nullopt,
               std::optional<T> mu_eq = std::nullopt,
@@ -411,11 +425,12 @@ struct QP
     }
     proxsuite::proxqp::dense::update_proximal_parameters(
       results, work, rho, mu_eq, mu_in);
-    proxsuite::proxqp::dense::setup(std::optional(model.H),
+    // the matrices are passed as given (the model may not store them)
+    proxsuite::proxqp::dense::setup(H,
                                     std::optional(dense::VecRef<T>(model.g)),
-                                    std::optional(model.A),
+                                    A,
                                     std::optional(dense::VecRef<T>(model.b)),
-                                    std::optional(model.C),
+                                    C,
                                     std::optional(dense::VecRef<T>(model.u)),
                                     std::optional(dense::VecRef<T>(model.l)),
                                     settings,
@@ -445,12 +460,12 @@ struct QP
    * @param mu_in proximal step size wrt inequality constrained multiplier.
    */
   void update(const std::optional<SparseMat<T>> H,
-              std::optional<Vec<T>> g,
+              std::optional<VecRef<T>> g,
               const std::optional<SparseMat<T>> A,
-              std::optional<Vec<T>> b,
+              std::optional<VecRef<T>> b,
               const std::optional<SparseMat<T>> C,
-              std::optional<Vec<T>> u,
-              std::optional<Vec<T>> l,
+              std::optional<VecRef<T>> u,
+              std::optional<VecRef<T>> l,
               bool update_preconditioner = true,
               std::optional<T> rho = std::nullopt,
               std::optional<T> mu_eq = std::nullopt,
@@ -478,11 +493,12 @@ struct QP
     }
     proxsuite::proxqp::dense::update_proximal_parameters(
       results, work, rho, mu_eq, mu_in);
-    proxsuite::proxqp::dense::setup(std::optional(model.H),
+    // the matrices are passed as given (the model may not store them)
+    proxsuite::proxqp::dense::setup(H,
                                     std::optional(dense::VecRef<T>(model.g)),
-                                    std::optional(model.A),
+                                    A,
                                     std::optional(dense::VecRef<T>(model.b)),
-                                    std::optional(model.C),
+                                    C,
                                     std::optional(dense::VecRef<T>(model.u)),
                                     std::optional(dense::VecRef<T>(model.l)),
                                     settings,
@@ -512,12 +528,12 @@ struct QP
    * @param mu_in proximal step size wrt inequality constrained multiplier.
    */
   void update([[maybe_unused]] const std::nullopt_t H,
-              std::optional<Vec<T>> g,
+              std::optional<VecRef<T>> g,
               [[maybe_unused]] const std::nullopt_t A,
-              std::optional<Vec<T>> b,
+              std::optional<VecRef<T>> b,
               [[maybe_unused]] const std::nullopt_t C,
-              std::optional<Vec<T>> u,
-              std::optional<Vec<T>> l,
+              std::optional<VecRef<T>> u,
+              std::optional<VecRef<T>> l,
               bool update_preconditioner = true,
               std::optional<T> rho = std::nullopt,
               std::optional<T> mu_eq = std::nullopt,
@@ -583,11 +599,12 @@ struct QP
     }
     proxsuite::proxqp::dense::update_proximal_parameters(
       results, work, rho, mu_eq, mu_in);
-    proxsuite::proxqp::dense::setup(std::optional(model.H),
+    // the matrices are left unchanged
+    proxsuite::proxqp::dense::setup(std::optional<MatRef<T>>(std::nullopt),
                                     std::optional(dense::VecRef<T>(model.g)),
-                                    std::optional(model.A),
+                                    std::optional<MatRef<T>>(std::nullopt),
                                     std::optional(dense::VecRef<T>(model.b)),
-                                    std::optional(model.C),
+                                    std::optional<MatRef<T>>(std::nullopt),
                                     std::optional(dense::VecRef<T>(model.u)),
                                     std::optional(dense::VecRef<T>(model.l)),
                                     settings,
@@ -600,6 +617,188 @@ struct QP
       results.info.setup_time = work.timer.elapsed().user; // in microseconds
     }
   };
+  /*!
+   * Loads preconditioner scaling variables, e.g., exported from another QP
+   * object of the same dimensions (via its ruiz.delta and ruiz.c members).
+   * The next calls to init with compute_preconditioner set to true re-use
+   * them and skip the ruiz equilibration algorithm, until the preconditioner
+   * is re-computed by an update or disabled by an init.
+   * @param delta scaling vector (of size dim + n_eq + n_in).
+   * @param c cost scaling factor.
+   */
+  void load_preconditioner(VecRef<T> delta, T c)
+  {
+    if (model.storage == ModelStorage::OWNING) {
+      ruiz.load(delta, c);
+    } else {
+      // the scaled matrices being the only copy of the matrices, they are
+      // scaled anew with the loaded scaling variables
+      preconditioner::RuizEquilibration<T> loaded = ruiz;
+      loaded.load(delta, c);
+      proxsuite::proxqp::dense::unscale_matrices(work, ruiz);
+      ruiz = loaded;
+      proxsuite::proxqp::dense::setup_equilibration(
+        work, settings, ruiz, false);
+    }
+    work.preconditioner_loaded = true;
+    work.factorization_cache.clear();
+  }
+  /*!
+   * Saves a binary snapshot of the QP object (model, settings, preconditioner,
+   * workspace including the current factorization, and last results).
+   * @param path path of the snapshot file.
+   */
+  void save_snapshot(const std::string& path) const
+  {
+    snapshot::Writer out(
+      path, snapshot::Backend::DENSE, sizeof(T), sizeof(isize));
+    out.write_pod(model.dim);
+    out.write_pod(model.n_eq);
+    out.write_pod(model.n_in);
+    out.write_pod(model.storage);
+    out.write_pod(work.requested_kkt_mode);
+    // the deadline is a point of the steady clock of this process, which has no
+    // meaning once the snapshot is reloaded
+    Settings<T> saved_settings = settings;
+    saved_settings.deadline = std::chrono::steady_clock::time_point::max();
+    out.write_pod(saved_settings);
+    // model
+    out.write_eigen(model.H);
+    out.write_eigen(model.g);
+    out.write_eigen(model.A);
+    out.write_eigen(model.C);
+    out.write_eigen(model.b);
+    out.write_eigen(model.u);
+    out.write_eigen(model.l);
+    // preconditioner
+    out.write_eigen(ruiz.delta);
+    out.write_pod(ruiz.c);
+    // workspace
+    out.write_eigen(work.H_scaled);
+    out.write_eigen(work.g_scaled);
+    out.write_eigen(work.A_scaled);
+    out.write_eigen(work.C_scaled);
+    out.write_eigen(work.b_scaled);
+    out.write_eigen(work.u_scaled);
+    out.write_eigen(work.l_scaled);
+    out.write_eigen(work.x_prev);
+    out.write_eigen(work.y_prev);
+    out.write_eigen(work.z_prev);
+    out.write_pod(work.kkt_mode);
+    out.write_eigen(work.kkt);
+    out.write_pod(work.h_diagonal);
+    out.write_eigen(work.h_rho_inv);
+    out.write_eigen(work.band_position);
+    out.write_eigen(work.current_bijection_map);
+    out.write_eigen(work.new_bijection_map);
+    out.write_eigen(work.active_set_up);
+    out.write_eigen(work.active_set_low);
+    out.write_eigen(work.active_inequalities);
+    out.write_pod(work.primal_feasibility_rhs_1_eq);
+    out.write_pod(work.primal_feasibility_rhs_1_in_u);
+    out.write_pod(work.primal_feasibility_rhs_1_in_l);
+    out.write_pod(work.dual_feasibility_rhs_2);
+    out.write_pod(work.correction_guess_rhs_g);
+    out.write_pod(work.correction_guess_rhs_b);
+    out.write_pod(work.alpha);
+    out.write_pod(work.constraints_changed);
+    out.write_pod(work.dirty);
+    out.write_pod(work.refactorize);
+    out.write_pod(work.proximal_parameter_update);
+    out.write_pod(work.preconditioner_loaded);
+    out.write_pod(work.interior_point_ldl);
+    out.write_pod(work.n_c);
+    work.ldl.visit_storage(out);
+    work.ldl_h.visit_storage(out);
+    work.band_ldl.visit_storage(out);
+    // results
+    out.write_eigen(results.x);
+    out.write_eigen(results.y);
+    out.write_eigen(results.z);
+    out.write_vec(results.active_constraints);
+    out.write_pod(results.info);
+  }
+  /*!
+   * Loads a binary snapshot saved by save_snapshot, so that the QP object is
+   * ready to be solved without executing anew the preconditioner and the
+   * factorization of the setup. The QP object is resized to the dimensions of
+   * the snapshot if needed.
+   * @param path path of the snapshot file.
+   */
+  void load_snapshot(const std::string& path)
+  {
+    snapshot::Reader in(
+      path, snapshot::Backend::DENSE, sizeof(T), sizeof(isize));
+    isize dim = in.read_pod<isize>();
+    isize n_eq = in.read_pod<isize>();
+    isize n_in = in.read_pod<isize>();
+    ModelStorage storage = in.read_pod<ModelStorage>();
+    KktMode kkt_mode = in.read_pod<KktMode>();
+    if (dim != model.dim || n_eq != model.n_eq || n_in != model.n_in ||
+        storage != model.storage || kkt_mode != work.requested_kkt_mode) {
+      *this = QP(dim, n_eq, n_in, storage, kkt_mode);
+    }
+    settings = in.read_pod<Settings<T>>();
+    // model
+    in.read_eigen(model.H);
+    in.read_eigen(model.g);
+    in.read_eigen(model.A);
+    in.read_eigen(model.C);
+    in.read_eigen(model.b);
+    in.read_eigen(model.u);
+    in.read_eigen(model.l);
+    // preconditioner
+    in.read_eigen(ruiz.delta);
+    ruiz.c = in.read_pod<T>();
+    // workspace
+    in.read_eigen(work.H_scaled);
+    in.read_eigen(work.g_scaled);
+    in.read_eigen(work.A_scaled);
+    in.read_eigen(work.C_scaled);
+    in.read_eigen(work.b_scaled);
+    in.read_eigen(work.u_scaled);
+    in.read_eigen(work.l_scaled);
+    in.read_eigen(work.x_prev);
+    in.read_eigen(work.y_prev);
+    in.read_eigen(work.z_prev);
+    work.kkt_mode = in.read_pod<KktMode>();
+    in.read_eigen(work.kkt);
+    work.h_diagonal = in.read_pod<bool>();
+    in.read_eigen(work.h_rho_inv);
+    in.read_eigen(work.band_position);
+    in.read_eigen(work.current_bijection_map);
+    in.read_eigen(work.new_bijection_map);
+    in.read_eigen(work.active_set_up);
+    in.read_eigen(work.active_set_low);
+    in.read_eigen(work.active_inequalities);
+    work.primal_feasibility_rhs_1_eq = in.read_pod<T>();
+    work.primal_feasibility_rhs_1_in_u = in.read_pod<T>();
+    work.primal_feasibility_rhs_1_in_l = in.read_pod<T>();
+    work.dual_feasibility_rhs_2 = in.read_pod<T>();
+    work.correction_guess_rhs_g = in.read_pod<T>();
+    work.correction_guess_rhs_b = in.read_pod<T>();
+    work.alpha = in.read_pod<T>();
+    work.constraints_changed = in.read_pod<bool>();
+    work.dirty = in.read_pod<bool>();
+    work.refactorize = in.read_pod<bool>();
+    work.proximal_parameter_update = in.read_pod<bool>();
+    work.preconditioner_loaded = in.read_pod<bool>();
+    work.interior_point_ldl = in.read_pod<bool>();
+    work.n_c = in.read_pod<isize>();
+    work.ldl.visit_storage_mut(in);
+    work.ldl_h.visit_storage_mut(in);
+    work.band_ldl.visit_storage_mut(in);
+    if (work.kkt_mode == KktMode::DUAL && !work.h_diagonal) {
+      reserve_dual_kkt_dense_hessian(work);
+    }
+    // results
+    in.read_eigen(results.x);
+    in.read_eigen(results.y);
+    in.read_eigen(results.z);
+    in.read_vec(results.active_constraints);
+    results.info = in.read_pod<Info<T>>();
+    work.factorization_cache.clear();
+  }
   /*!
    * Solves the QP problem using PRXOQP algorithm.
    */
@@ -612,6 +811,23 @@ struct QP
       work,
       ruiz);
   };
+  /*!
+   * Solves the QP problem using PROXQP algorithm, calling an observer at each
+   * outer iteration.
+   * @param observer callable receiving the IterationRecord of each outer
+   * iteration (e.g., a RingBufferObserver).
+   */
+  template<typename Observer>
+  void solve(Observer&& observer)
+  {
+    qp_solve( //
+      settings,
+      model,
+      results,
+      work,
+      ruiz,
+      observer);
+  };
   /*!
    * Solves the QP problem using PROXQP algorithm using a warm start.
    * @param x primal warm start.
@@ -630,13 +846,63 @@ struct QP
       work,
       ruiz);
   };
+  /*!
+   * Starts a step-wise solve of the QP problem, whose outer iterations are run
+   * by calls to step() until is_done(). Several QP objects can hence be solved
+   * in an interleaved way (e.g., by a scheduler giving priority to the solves
+   * closest to their deadline). The results are only meaningful once the
+   * solve is done, and begin_solve() must be called again after an update of
+   * the model.
+   */
+  void begin_solve()
+  {
+    qp_solve_begin( //
+      settings,
+      model,
+      results,
+      work,
+      ruiz);
+  };
+  /*!
+   * Runs iterations of the solve started by begin_solve(), until it is done
+   * or max_inner_iters inner iterations have been run. A step may stop in the
+   * middle of an outer iteration, which the next step then resumes.
+   * @param max_inner_iters number of inner iterations after which the step
+   * returns (at least one is run).
+   * @return true once the solve is done.
+   */
+  bool step(isize max_inner_iters)
+  {
+    return qp_solve_step( //
+      settings,
+      model,
+      results,
+      work,
+      ruiz,
+      max_inner_iters);
+  };
+  /*!
+   * Returns whether the solve started by begin_solve() is done (or whether no
+   * step-wise solve was started).
+   */
+  bool is_done() const { return work.solve_state.done; }
+  /*!
+   * Returns the cache of the factorizations computed at the start of the
+   * solves (see Settings::factorization_cache_max_bytes), e.g., for its hit
+   * and miss statistics.
+   */
+  const FactorizationCache<T, CachedFactorization<T>>& factorization_cache()
+    const
+  {
+    return work.factorization_cache;
+  }
   /*!
    * Clean-ups solver's results and workspace.
    */
   void cleanup()
   {
     results.cleanup();
-    work.cleanup();
+    work.cleanup(model.storage == ModelStorage::NON_OWNING);
   }
 };
 /*!
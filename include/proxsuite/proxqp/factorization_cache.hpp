@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file factorization_cache.hpp
+ */
+#ifndef PROXSUITE_QP_FACTORIZATION_CACHE_HPP
+#define PROXSUITE_QP_FACTORIZATION_CACHE_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "proxsuite/proxqp/sparse/fwd.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+///
+/// @brief Bounded cache of factorizations of the KKT matrix, keyed by the
+/// active set and the proximal parameters they were computed with.
+///
+/*!
+ * When a QP object is solved repeatedly with the same matrices and warm
+ * started from its previous solution (e.g., in receding-horizon control), the
+ * same few active sets recur from one solve to the next. The factorization
+ * computed at the start of a solve, with the inequalities active at the
+ * initial guess, is kept in the cache, and restored by the next solves
+ * starting from the same active set with the same proximal parameters instead
+ * of being computed anew.
+ *
+ * The entries are only valid for the scaled matrices they were computed with:
+ * the QP objects clear the cache when their matrices or their preconditioner
+ * change. When an insertion exceeds the memory cap, the least recently used
+ * entries are evicted.
+ */
+template<typename T, typename Factorization>
+struct FactorizationCache
+{
+  FactorizationCache()
+    : m_bytes(0)
+    , m_clock(0)
+    , m_hits(0)
+    , m_misses(0)
+  {
+  }
+  /*!
+   * Returns the cached factorization of the active set with the given
+   * proximal parameters (counting a hit), or nullptr (counting a miss).
+   * @param active active set, indexable by the inequality constraints.
+   * @param n_in number of inequality constraints.
+   * @param rho primal proximal parameter.
+   * @param mu_eq dual equality constrained proximal parameter.
+   * @param mu_in dual inequality constrained proximal parameter.
+   */
+  template<typename ActiveSet>
+  Factorization const* find(ActiveSet const& active,
+                            sparse::isize n_in,
+                            T rho,
+                            T mu_eq,
+                            T mu_in)
+  {
+    pack(active, n_in);
+    for (Entry& entry : m_entries) {
+      if (entry.rho == rho && entry.mu_eq == mu_eq && entry.mu_in == mu_in &&
+          entry.active_set == m_key) {
+        entry.last_use = ++m_clock;
+        ++m_hits;
+        return &entry.factorization;
+      }
+    }
+    ++m_misses;
+    return nullptr;
+  }
+  /*!
+   * Inserts the factorization of the active set with the given proximal
+   * parameters, evicting the least recently used entries while the cache
+   * exceeds max_bytes. Nothing is inserted if the entry alone exceeds it.
+   * @param bytes memory used by the factorization.
+   * @param max_bytes memory cap of the cache.
+   * @param fill callable copying the current factorization into the
+   * Factorization object it receives.
+   */
+  template<typename ActiveSet, typename Fill>
+  void insert(ActiveSet const& active,
+              sparse::isize n_in,
+              T rho,
+              T mu_eq,
+              T mu_in,
+              sparse::isize bytes,
+              sparse::isize max_bytes,
+              Fill&& fill)
+  {
+    pack(active, n_in);
+    bytes += sparse::isize(m_key.size() * sizeof(std::uint64_t));
+    if (bytes > max_bytes) {
+      return;
+    }
+    while (m_bytes + bytes > max_bytes) {
+      evict_least_recently_used();
+    }
+    Entry entry;
+    entry.active_set = m_key;
+    entry.rho = rho;
+    entry.mu_eq = mu_eq;
+    entry.mu_in = mu_in;
+    entry.bytes = bytes;
+    entry.last_use = ++m_clock;
+    fill(entry.factorization);
+    m_entries.push_back(std::move(entry));
+    m_bytes += bytes;
+  }
+  /*!
+   * Removes all the entries (the statistics are kept).
+   */
+  void clear()
+  {
+    m_entries.clear();
+    m_bytes = 0;
+  }
+  // number of entries
+  sparse::isize size() const { return sparse::isize(m_entries.size()); }
+  // memory used by the entries
+  sparse::isize bytes() const { return m_bytes; }
+  // number of lookups which found a factorization, resp. did not
+  sparse::isize hits() const { return m_hits; }
+  sparse::isize misses() const { return m_misses; }
+
+private:
+  struct Entry
+  {
+    std::vector<std::uint64_t> active_set; // one bit per inequality
+    T rho;
+    T mu_eq;
+    T mu_in;
+    sparse::isize bytes;
+    std::uint64_t last_use;
+    Factorization factorization;
+  };
+
+  template<typename ActiveSet>
+  void pack(ActiveSet const& active, sparse::isize n_in)
+  {
+    m_key.assign(std::size_t((n_in + 63) / 64), 0);
+    for (sparse::isize i = 0; i < n_in; ++i) {
+      if (active[i]) {
+        m_key[std::size_t(i / 64)] |= std::uint64_t(1) << (i % 64);
+      }
+    }
+  }
+  void evict_least_recently_used()
+  {
+    std::size_t lru = 0;
+    for (std::size_t k = 1; k < m_entries.size(); ++k) {
+      if (m_entries[k].last_use < m_entries[lru].last_use) {
+        lru = k;
+      }
+    }
+    m_bytes -= m_entries[lru].bytes;
+    if (lru + 1 != m_entries.size()) {
+      m_entries[lru] = std::move(m_entries.back());
+    }
+    m_entries.pop_back();
+  }
+
+  std::vector<Entry> m_entries;
+  std::vector<std::uint64_t> m_key; // packed active set of the last lookup
+  sparse::isize m_bytes;
+  std::uint64_t m_clock;
+  sparse::isize m_hits;
+  sparse::isize m_misses;
+};
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_FACTORIZATION_CACHE_HPP */
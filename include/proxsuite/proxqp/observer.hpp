@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file observer.hpp
+ */
+#ifndef PROXSUITE_QP_OBSERVER_HPP
+#define PROXSUITE_QP_OBSERVER_HPP
+
+#include <type_traits>
+#include <vector>
+#include "proxsuite/proxqp/results.hpp"
+#include "proxsuite/proxqp/timings.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+///
+/// @brief State of the solver at the start of an outer iteration.
+///
+/*!
+ * The residuals are computed on the unscaled problem, before the convergence
+ * check of the iteration. The phase timings are cumulated since the start of
+ * the setup (or of the solve, see PhaseTimings).
+ */
+template<typename T>
+struct IterationRecord
+{
+  sparse::isize iter;       // outer iteration, starting from zero
+  sparse::isize iter_inner; // inner iterations performed so far
+  T pri_res;
+  T dua_res;
+  T mu_eq;
+  T mu_in;
+  T rho;
+  sparse::isize n_active; // number of active inequality constraints
+  T alpha;                // last step size of the inner loop
+  PhaseTimings<T> phase_timings;
+};
+/*!
+ * Builds the record of an outer iteration.
+ * @param iter outer iteration.
+ * @param pri_res primal residual.
+ * @param dua_res dual residual.
+ * @param info solver statistics.
+ * @param n_active number of active inequality constraints.
+ * @param alpha last step size of the inner loop.
+ */
+template<typename T>
+IterationRecord<T>
+make_iteration_record(sparse::isize iter,
+                      T pri_res,
+                      T dua_res,
+                      Info<T> const& info,
+                      sparse::isize n_active,
+                      T alpha)
+{
+  IterationRecord<T> record;
+  record.iter = iter;
+  record.iter_inner = info.iter;
+  record.pri_res = pri_res;
+  record.dua_res = dua_res;
+  record.mu_eq = info.mu_eq;
+  record.mu_in = info.mu_in;
+  record.rho = info.rho;
+  record.n_active = n_active;
+  record.alpha = alpha;
+  record.phase_timings = info.phase_timings;
+  return record;
+}
+
+///
+/// @brief Observer of the solvers doing nothing (the default one).
+///
+/*!
+ * An observer is any callable taking an IterationRecord, called once per
+ * outer iteration by dense::qp_solve and sparse::qp_solve. With this one, the
+ * records are not even built.
+ */
+struct NullObserver
+{
+  template<typename T>
+  void operator()(IterationRecord<T> const& /*record*/) const noexcept
+  {
+  }
+};
+/*!
+ * Whether the solvers call an observer of the given type.
+ */
+template<typename Observer>
+constexpr bool
+is_observing()
+{
+  return !std::is_same<typename std::decay<Observer>::type,
+                       NullObserver>::value;
+}
+
+///
+/// @brief Observer keeping the records of the last outer iterations.
+///
+/*!
+ * The records are stored in a circular buffer allocated at construction, so
+ * that observing a solve does not allocate. It is not cleared between solves.
+ */
+template<typename T>
+struct RingBufferObserver
+{
+  /*!
+   * Constructor.
+   * @param capacity number of records kept.
+   */
+  explicit RingBufferObserver(sparse::isize capacity)
+    : records(std::size_t(capacity > 0 ? capacity : 1))
+    , head(0)
+    , n_records(0)
+  {
+  }
+
+  void operator()(IterationRecord<T> const& record)
+  {
+    records[std::size_t(head)] = record;
+    head = (head + 1) % capacity();
+    ++n_records;
+  }
+  /*!
+   * Number of records kept.
+   */
+  sparse::isize size() const
+  {
+    return n_records < capacity() ? n_records : capacity();
+  }
+  sparse::isize capacity() const { return sparse::isize(records.size()); }
+  /*!
+   * Number of records received since the construction or the last clear,
+   * including the overwritten ones.
+   */
+  sparse::isize total() const { return n_records; }
+  /*!
+   * Record kept at the given position, from the oldest (0) to the most recent
+   * (size() - 1).
+   */
+  IterationRecord<T> const& operator[](sparse::isize k) const
+  {
+    sparse::isize first = n_records < capacity() ? 0 : head;
+    return records[std::size_t((first + k) % capacity())];
+  }
+  IterationRecord<T> const& back() const { return (*this)[size() - 1]; }
+  void clear()
+  {
+    head = 0;
+    n_records = 0;
+  }
+
+private:
+  std::vector<IterationRecord<T>> records;
+  sparse::isize head;
+  sparse::isize n_records;
+};
+
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_OBSERVER_HPP */
@@ -0,0 +1,653 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file presolve.hpp
+ */
+#ifndef PROXSUITE_QP_PRESOLVE_HPP
+#define PROXSUITE_QP_PRESOLVE_HPP
+
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <proxsuite/linalg/veg/internal/macros.hpp>
+#include "proxsuite/proxqp/dense/fwd.hpp"
+#include "proxsuite/proxqp/sparse/fwd.hpp"
+#include "proxsuite/proxqp/results.hpp"
+#include "proxsuite/proxqp/timings.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+///
+/// @brief Statistics of the reductions performed by a presolve.
+///
+struct PresolveInfo
+{
+  isize free_rows;      // inequalities with infinite bounds
+  isize empty_rows;     // feasible constraints without any variable
+  isize equalities;     // inequalities with l == u moved to the equalities
+  isize merged_bounds;  // singleton inequalities merged with another one
+  isize fixed_vars;     // variables fixed by a singleton equality
+  isize empty_cols;     // variables appearing in no constraint
+  isize passes;         // number of passes over the problem
+  double presolve_time; // in microseconds
+};
+///
+/// @brief Presolve and postsolve of a QP problem.
+///
+/*!
+ * Reduces the problem
+ *
+ *   min 1/2 x^T H x + g^T x  s.t.  A x = b,  l <= C x <= u
+ *
+ * before it is given to a dense or a sparse QP object, by repeating the
+ * following reductions until none applies:
+ * - inequalities with l <= -1e20 and u >= 1e20 are removed,
+ * - constraints without any variable are removed when they are satisfied,
+ * - inequalities with l == u are moved to the equalities,
+ * - equalities with a single variable fix this variable, which is removed,
+ * - inequalities with a single variable (i.e., bounds) on the same variable
+ *   are merged into the tightest one,
+ * - variables appearing in no constraint and coupled to no other variable in
+ *   H are set to their optimal value and removed.
+ *
+ * H is given entirely (and not only one of its triangular parts), as for
+ * QP::init. postsolve restores the primal and dual solutions of the original
+ * problem from the ones of the reduced problem.
+ *
+ * Example:
+ * \code
+ * Presolve<double> presolve;
+ * presolve.run(H, g, A, b, C, u, l);
+ * dense::QP<double> qp(presolve.dim, presolve.n_eq, presolve.n_in);
+ * qp.init(presolve.H.toDense(), presolve.g, presolve.A.toDense(), presolve.b,
+ *         presolve.C.toDense(), presolve.u, presolve.l);
+ * qp.solve();
+ * presolve.postsolve(qp.results);
+ * \endcode
+ */
+template<typename T>
+struct Presolve
+{
+  using SparseMat = Eigen::SparseMatrix<T, Eigen::ColMajor, isize>;
+  using SparseMatRowMajor = Eigen::SparseMatrix<T, Eigen::RowMajor, isize>;
+  using Vec = dense::Vec<T>;
+  using VecISize = dense::VecISize;
+
+  ///// reduced problem
+  isize dim;
+  isize n_eq;
+  isize n_in;
+  SparseMat H;
+  Vec g;
+  SparseMat A;
+  Vec b;
+  SparseMat C;
+  Vec u;
+  Vec l;
+  T objective_offset; // objective of the removed variables
+
+  PresolveInfo info;
+
+  ///// postsolve
+  isize dim_original;
+  isize n_eq_original;
+  isize n_in_original;
+  VecISize col_map; // original index of the reduced variables
+  VecISize eq_map;  // original row (eq, then in) of the reduced equalities
+  VecISize in_map;  // original row of the reduced inequalities
+  Vec x_removed;    // values of the removed variables
+
+  Presolve()
+    : dim(0)
+    , n_eq(0)
+    , n_in(0)
+    , objective_offset(0)
+    , info{}
+    , dim_original(0)
+    , n_eq_original(0)
+    , n_in_original(0)
+  {
+  }
+  /*!
+   * Presolves a QP problem given with dense matrices.
+   * @param H quadratic cost.
+   * @param g linear cost.
+   * @param A equality constraint matrix.
+   * @param b equality constraint vector.
+   * @param C inequality constraint matrix.
+   * @param u upper inequality constraint vector.
+   * @param l lower inequality constraint vector.
+   */
+  void run(dense::MatRef<T> H_,
+           dense::VecRef<T> g_,
+           dense::MatRef<T> A_,
+           dense::VecRef<T> b_,
+           dense::MatRef<T> C_,
+           dense::VecRef<T> u_,
+           dense::VecRef<T> l_)
+  {
+    run_impl(
+      H_.sparseView(), g_, A_.sparseView(), b_, C_.sparseView(), u_, l_);
+  }
+  /*!
+   * Presolves a QP problem given with sparse matrices.
+   * @param H quadratic cost.
+   * @param g linear cost.
+   * @param A equality constraint matrix.
+   * @param b equality constraint vector.
+   * @param C inequality constraint matrix.
+   * @param u upper inequality constraint vector.
+   * @param l lower inequality constraint vector.
+   */
+  template<typename I>
+  void run(sparse::SparseMat<T, I> const& H_,
+           sparse::VecRef<T> g_,
+           sparse::SparseMat<T, I> const& A_,
+           sparse::VecRef<T> b_,
+           sparse::SparseMat<T, I> const& C_,
+           sparse::VecRef<T> u_,
+           sparse::VecRef<T> l_)
+  {
+    run_impl(SparseMat(H_), g_, SparseMat(A_), b_, SparseMat(C_), u_, l_);
+  }
+  /*!
+   * Restores the solution of the original problem.
+   * @param x primal solution of the reduced problem.
+   * @param y equality multipliers of the reduced problem.
+   * @param z inequality multipliers of the reduced problem.
+   * @param x_out primal solution of the original problem.
+   * @param y_out equality multipliers of the original problem.
+   * @param z_out inequality multipliers of the original problem.
+   */
+  void postsolve(dense::VecRef<T> x,
+                 dense::VecRef<T> y,
+                 dense::VecRef<T> z,
+                 Vec& x_out,
+                 Vec& y_out,
+                 Vec& z_out) const
+  {
+    PROXSUITE_CHECK_ARGUMENT_SIZE(
+      x.rows(), dim, "the dimension of x is not the reduced one.");
+    PROXSUITE_CHECK_ARGUMENT_SIZE(
+      y.rows(), n_eq, "the dimension of y is not the reduced one.");
+    PROXSUITE_CHECK_ARGUMENT_SIZE(
+      z.rows(), n_in, "the dimension of z is not the reduced one.");
+
+    x_out = x_removed;
+    for (isize k = 0; k < dim; ++k) {
+      x_out(col_map(k)) = x(k);
+    }
+    Vec w = Vec::Zero(n_eq_original + n_in_original);
+    for (isize k = 0; k < n_eq; ++k) {
+      w(eq_map(k)) = y(k);
+    }
+    for (isize k = 0; k < n_in; ++k) {
+      w(in_map(k)) = z(k);
+    }
+
+    // the multipliers of the removed rows are recovered in the reverse order
+    // of the reductions
+    for (auto it = ops.rbegin(); it != ops.rend(); ++it) {
+      isize j = it->col;
+      if (it->kind == Op::FIX) {
+        // stationarity of the lagrangian wrt the fixed variable
+        T s = g_original(j) + H_original.col(j).dot(x_out);
+        T a = 0;
+        for (typename SparseMat::InnerIterator e(A_original, j); e; ++e) {
+          if (e.index() == it->row) {
+            a = e.value();
+          } else {
+            s += e.value() * w(e.index());
+          }
+        }
+        for (typename SparseMat::InnerIterator e(C_original, j); e; ++e) {
+          isize row = n_eq_original + e.index();
+          if (row == it->row) {
+            a = e.value();
+          } else {
+            s += e.value() * w(row);
+          }
+        }
+        w(it->row) = -s / a;
+      } else {
+        // the multiplier of the merged bound goes to the row giving the
+        // active side
+        T t = coefficient(it->row, j) * w(it->row);
+        w(it->row) = 0;
+        isize provider = t > 0 ? it->upper : it->lower;
+        if (t != 0 && provider >= 0) {
+          w(provider) += t / coefficient(provider, j);
+        } else {
+          w(it->row) = t / coefficient(it->row, j);
+        }
+      }
+    }
+    y_out = w.head(n_eq_original);
+    z_out = w.tail(n_in_original);
+  }
+  /*!
+   * Replaces the solution of the reduced problem stored in the results by the
+   * one of the original problem, and adds the objective of the removed
+   * variables.
+   * @param results results of the QP object solving the reduced problem.
+   */
+  void postsolve(Results<T>& results) const
+  {
+    Vec x_out;
+    Vec y_out;
+    Vec z_out;
+    postsolve(results.x, results.y, results.z, x_out, y_out, z_out);
+    results.x = std::move(x_out);
+    results.y = std::move(y_out);
+    results.z = std::move(z_out);
+    results.info.objValue += objective_offset;
+  }
+
+private:
+  struct Op
+  {
+    enum Kind
+    {
+      FIX,  // col fixed by the equality row
+      MERGE // bounds on col merged into row, from the rows lower and upper
+    } kind;
+    isize col;
+    isize row;
+    isize lower;
+    isize upper;
+  };
+  std::vector<Op> ops;
+  SparseMat H_original;
+  Vec g_original;
+  SparseMat A_original;
+  SparseMat C_original;
+  SparseMatRowMajor A_rows;
+  SparseMatRowMajor C_rows;
+
+  static bool is_infinite(T v) { return std::abs(v) >= T(1.E20); }
+
+  T coefficient(isize row, isize j) const
+  {
+    return row < n_eq_original ? A_rows.coeff(row, j)
+                               : C_rows.coeff(row - n_eq_original, j);
+  }
+
+  void run_impl(SparseMat H_,
+                dense::VecRef<T> g_,
+                SparseMat A_,
+                dense::VecRef<T> b_,
+                SparseMat C_,
+                dense::VecRef<T> u_,
+                dense::VecRef<T> l_)
+  {
+    Timer<T> timer;
+    timer.start();
+
+    isize n = H_.rows();
+    isize m_eq = A_.rows();
+    isize m_in = C_.rows();
+    isize m = m_eq + m_in;
+    dim_original = n;
+    n_eq_original = m_eq;
+    n_in_original = m_in;
+    H_.prune(T(0));
+    A_.prune(T(0));
+    C_.prune(T(0));
+    H_original = std::move(H_);
+    g_original = g_;
+    A_original = std::move(A_);
+    C_original = std::move(C_);
+    A_rows = A_original;
+    C_rows = C_original;
+    ops.clear();
+    info = PresolveInfo{};
+    objective_offset = 0;
+
+    // rows are indexed as the equalities followed by the inequalities
+    std::vector<bool> row_active(std::size_t(m), true);
+    std::vector<bool> row_eq(std::size_t(m), false);
+    std::vector<bool> col_active(std::size_t(n), true);
+    std::vector<isize> row_count(std::size_t(m), 0);
+    std::vector<isize> col_count(std::size_t(n), 0);
+    std::vector<isize> h_count(std::size_t(n), 0); // off diagonal entries
+    Vec lo(m);
+    Vec hi(m);
+    lo.head(m_eq) = b_;
+    hi.head(m_eq) = b_;
+    lo.tail(m_in) = l_;
+    hi.tail(m_in) = u_;
+    g = g_;
+    x_removed.setZero(n);
+
+    for (isize i = 0; i < m_eq; ++i) {
+      row_eq[std::size_t(i)] = true;
+    }
+    for (isize j = 0; j < n; ++j) {
+      for (typename SparseMat::InnerIterator e(A_original, j); e; ++e) {
+        ++row_count[std::size_t(e.index())];
+        ++col_count[std::size_t(j)];
+      }
+      for (typename SparseMat::InnerIterator e(C_original, j); e; ++e) {
+        ++row_count[std::size_t(m_eq + e.index())];
+        ++col_count[std::size_t(j)];
+      }
+      for (typename SparseMat::InnerIterator e(H_original, j); e; ++e) {
+        if (e.index() != j) {
+          ++h_count[std::size_t(j)];
+        }
+      }
+    }
+
+    auto remove_row = [&](isize row) {
+      row_active[std::size_t(row)] = false;
+      if (row < m_eq) {
+        for (typename SparseMatRowMajor::InnerIterator e(A_rows, row); e; ++e) {
+          --col_count[std::size_t(e.index())];
+        }
+      } else {
+        for (typename SparseMatRowMajor::InnerIterator e(C_rows, row - m_eq);
+             e;
+             ++e) {
+          --col_count[std::size_t(e.index())];
+        }
+      }
+    };
+    // first active variable of a row, with its coefficient
+    auto first_entry = [&](isize row) -> std::pair<isize, T> {
+      if (row < m_eq) {
+        for (typename SparseMatRowMajor::InnerIterator e(A_rows, row); e; ++e) {
+          if (col_active[std::size_t(e.index())]) {
+            return { isize(e.index()), e.value() };
+          }
+        }
+      } else {
+        for (typename SparseMatRowMajor::InnerIterator e(C_rows, row - m_eq);
+             e;
+             ++e) {
+          if (col_active[std::size_t(e.index())]) {
+            return { isize(e.index()), e.value() };
+          }
+        }
+      }
+      return { -1, T(0) };
+    };
+    auto remove_col = [&](isize j, T value) {
+      col_active[std::size_t(j)] = false;
+      x_removed(j) = value;
+      T h_jj = 0;
+      for (typename SparseMat::InnerIterator e(H_original, j); e; ++e) {
+        isize i = e.index();
+        if (i == j) {
+          h_jj = e.value();
+        } else if (col_active[std::size_t(i)]) {
+          g(i) += e.value() * value;
+          --h_count[std::size_t(i)];
+        }
+      }
+      objective_offset += g(j) * value + T(0.5) * h_jj * value * value;
+      auto shift_row = [&](isize row, T a) {
+        --row_count[std::size_t(row)];
+        if (!is_infinite(lo(row))) {
+          lo(row) -= a * value;
+        }
+        if (!is_infinite(hi(row))) {
+          hi(row) -= a * value;
+        }
+      };
+      for (typename SparseMat::InnerIterator e(A_original, j); e; ++e) {
+        shift_row(e.index(), e.value());
+      }
+      for (typename SparseMat::InnerIterator e(C_original, j); e; ++e) {
+        shift_row(m_eq + e.index(), e.value());
+      }
+    };
+
+    std::vector<std::pair<isize, isize>> singletons; // (variable, row)
+    bool changed = true;
+    while (changed && info.passes < 32) {
+      changed = false;
+      ++info.passes;
+
+      for (isize row = 0; row < m; ++row) {
+        if (!row_active[std::size_t(row)]) {
+          continue;
+        }
+        bool eq = row_eq[std::size_t(row)];
+        if (!eq && is_infinite(lo(row)) && is_infinite(hi(row)) &&
+            lo(row) < 0 && hi(row) > 0) {
+          remove_row(row);
+          ++info.free_rows;
+          changed = true;
+        } else if (row_count[std::size_t(row)] == 0) {
+          // kept when infeasible, for the solver to report it
+          if (lo(row) <= T(0) && hi(row) >= T(0)) {
+            remove_row(row);
+            ++info.empty_rows;
+            changed = true;
+          }
+        } else if (!eq && lo(row) == hi(row)) {
+          row_eq[std::size_t(row)] = true;
+          ++info.equalities;
+          changed = true;
+        } else if (eq && row_count[std::size_t(row)] == 1) {
+          std::pair<isize, T> entry = first_entry(row);
+          remove_row(row);
+          remove_col(entry.first, lo(row) / entry.second);
+          ops.push_back(Op{ Op::FIX, entry.first, row, -1, -1 });
+          ++info.fixed_vars;
+          changed = true;
+        }
+      }
+
+      // bounds on the same variable
+      singletons.clear();
+      for (isize row = m_eq; row < m; ++row) {
+        if (row_active[std::size_t(row)] && !row_eq[std::size_t(row)] &&
+            row_count[std::size_t(row)] == 1) {
+          singletons.push_back({ first_entry(row).first, row });
+        }
+      }
+      std::sort(singletons.begin(), singletons.end());
+      for (std::size_t begin = 0; begin < singletons.size();) {
+        std::size_t end = begin + 1;
+        while (end < singletons.size() &&
+               singletons[end].first == singletons[begin].first) {
+          ++end;
+        }
+        if (end - begin > 1) {
+          changed |= merge_bounds(singletons.data() + begin,
+                                  isize(end - begin),
+                                  lo,
+                                  hi,
+                                  row_eq,
+                                  remove_row);
+        }
+        begin = end;
+      }
+
+      for (isize j = 0; j < n; ++j) {
+        if (!col_active[std::size_t(j)] || col_count[std::size_t(j)] != 0 ||
+            h_count[std::size_t(j)] != 0) {
+          continue;
+        }
+        T h_jj = H_original.coeff(j, j);
+        if (h_jj > T(0)) {
+          remove_col(j, -g(j) / h_jj);
+        } else if (h_jj == T(0) && g(j) == T(0)) {
+          remove_col(j, T(0));
+        } else {
+          continue; // unbounded or nonconvex, left to the solver
+        }
+        ++info.empty_cols;
+        changed = true;
+      }
+    }
+
+    build_reduced_problem(row_active, row_eq, col_active, lo, hi);
+    timer.stop();
+    info.presolve_time = timer.elapsed().user;
+  }
+
+  template<typename RemoveRow>
+  bool merge_bounds(std::pair<isize, isize> const* rows,
+                    isize count,
+                    Vec& lo,
+                    Vec& hi,
+                    std::vector<bool>& row_eq,
+                    RemoveRow& remove_row)
+  {
+    isize j = rows[0].first;
+    isize kept = rows[0].second;
+    // tightest bounds on x_j, with the rows giving them
+    T const inf = std::numeric_limits<T>::infinity();
+    T x_lo = -inf;
+    T x_hi = inf;
+    isize lower = -1;
+    isize upper = -1;
+    for (isize k = 0; k < count; ++k) {
+      isize row = rows[k].second;
+      T a = coefficient(row, j);
+      T row_lo;
+      T row_hi;
+      if (a > 0) {
+        row_lo = is_infinite(lo(row)) ? -inf : lo(row) / a;
+        row_hi = is_infinite(hi(row)) ? inf : hi(row) / a;
+      } else {
+        row_lo = is_infinite(hi(row)) ? -inf : hi(row) / a;
+        row_hi = is_infinite(lo(row)) ? inf : lo(row) / a;
+      }
+      if (row_lo > x_lo) {
+        x_lo = row_lo;
+        lower = row;
+      }
+      if (row_hi < x_hi) {
+        x_hi = row_hi;
+        upper = row;
+      }
+    }
+    if (x_lo > x_hi) {
+      return false; // infeasible, left to the solver
+    }
+
+    T a = coefficient(kept, j);
+    T kept_lo;
+    T kept_hi;
+    if (a > 0) {
+      kept_lo = lower >= 0 ? a * x_lo : lo(kept);
+      kept_hi = upper >= 0 ? a * x_hi : hi(kept);
+    } else {
+      kept_lo = upper >= 0 ? a * x_hi : lo(kept);
+      kept_hi = lower >= 0 ? a * x_lo : hi(kept);
+    }
+    lo(kept) = kept_lo;
+    hi(kept) = kept_hi;
+    for (isize k = 1; k < count; ++k) {
+      remove_row(rows[k].second);
+    }
+    if (x_lo == x_hi) {
+      row_eq[std::size_t(kept)] = true;
+      ++info.equalities;
+    }
+    ops.push_back(Op{ Op::MERGE, j, kept, lower, upper });
+    info.merged_bounds += count - 1;
+    return true;
+  }
+
+  void build_reduced_problem(std::vector<bool> const& row_active,
+                             std::vector<bool> const& row_eq,
+                             std::vector<bool> const& col_active,
+                             Vec const& lo,
+                             Vec const& hi)
+  {
+    isize n = dim_original;
+    isize m = n_eq_original + n_in_original;
+
+    VecISize new_col = VecISize::Constant(n, -1);
+    dim = 0;
+    for (isize j = 0; j < n; ++j) {
+      if (col_active[std::size_t(j)]) {
+        new_col(j) = dim++;
+      }
+    }
+    n_eq = 0;
+    n_in = 0;
+    for (isize row = 0; row < m; ++row) {
+      if (row_active[std::size_t(row)]) {
+        if (row_eq[std::size_t(row)]) {
+          ++n_eq;
+        } else {
+          ++n_in;
+        }
+      }
+    }
+    col_map.resize(dim);
+    eq_map.resize(n_eq);
+    in_map.resize(n_in);
+    for (isize j = 0; j < n; ++j) {
+      if (new_col(j) >= 0) {
+        col_map(new_col(j)) = j;
+      }
+    }
+
+    g = Vec(g(col_map));
+    b.resize(n_eq);
+    u.resize(n_in);
+    l.resize(n_in);
+    std::vector<Eigen::Triplet<T, isize>> eq_entries;
+    std::vector<Eigen::Triplet<T, isize>> in_entries;
+    isize k_eq = 0;
+    isize k_in = 0;
+    for (isize row = 0; row < m; ++row) {
+      if (!row_active[std::size_t(row)]) {
+        continue;
+      }
+      bool eq = row_eq[std::size_t(row)];
+      isize k = eq ? k_eq : k_in;
+      auto& entries = eq ? eq_entries : in_entries;
+      auto add_entries = [&](SparseMatRowMajor const& mat, isize i) {
+        for (typename SparseMatRowMajor::InnerIterator e(mat, i); e; ++e) {
+          if (new_col(e.index()) >= 0) {
+            entries.emplace_back(k, new_col(e.index()), e.value());
+          }
+        }
+      };
+      if (row < n_eq_original) {
+        add_entries(A_rows, row);
+      } else {
+        add_entries(C_rows, row - n_eq_original);
+      }
+      if (eq) {
+        eq_map(k_eq) = row;
+        b(k_eq++) = lo(row);
+      } else {
+        in_map(k_in) = row;
+        l(k_in) = lo(row);
+        u(k_in++) = hi(row);
+      }
+    }
+    A.resize(n_eq, dim);
+    A.setFromTriplets(eq_entries.begin(), eq_entries.end());
+    C.resize(n_in, dim);
+    C.setFromTriplets(in_entries.begin(), in_entries.end());
+
+    std::vector<Eigen::Triplet<T, isize>> h_entries;
+    for (isize k = 0; k < dim; ++k) {
+      for (typename SparseMat::InnerIterator e(H_original, col_map(k)); e;
+           ++e) {
+        if (new_col(e.index()) >= 0) {
+          h_entries.emplace_back(new_col(e.index()), k, e.value());
+        }
+      }
+    }
+    H.resize(dim, dim);
+    H.setFromTriplets(h_entries.begin(), h_entries.end());
+  }
+};
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_PRESOLVE_HPP */
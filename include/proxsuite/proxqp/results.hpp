@@ -11,6 +11,7 @@
 #include <proxsuite/linalg/veg/type_traits/core.hpp>
 #include <proxsuite/linalg/veg/vec.hpp>
 #include "proxsuite/proxqp/status.hpp"
+#include "proxsuite/proxqp/timings.hpp"
 #include "proxsuite/proxqp/sparse/fwd.hpp"
 
 namespace proxsuite {
@@ -39,6 +40,8 @@ struct Info
   sparse::isize mu_updates;
   sparse::isize rho_updates;
   QPSolverOutput status;
+  // true if the solution is the one of a polishing step (see Settings::polish)
+  bool polished;
 
   //// timings
   T setup_time;
@@ -47,6 +50,9 @@ struct Info
   T objValue;
   T pri_res;
   T dua_res;
+
+  //// cumulative timings of the phases of the last setup and solve
+  PhaseTimings<T> phase_timings;
 };
 ///
 /// @brief This class stores all the results of PROXQP solvers with sparse and
@@ -95,6 +101,7 @@ struct Results
     info.iter_ext = 0;
     info.mu_updates = 0;
     info.rho_updates = 0;
+    info.polished = false;
     info.run_time = 0;
     info.setup_time = 0;
     info.solve_time = 0;
@@ -102,6 +109,7 @@ struct Results
     info.pri_res = 0.;
     info.dua_res = 0.;
     info.status = QPSolverOutput::PROXQP_MAX_ITER_REACHED;
+    info.phase_timings.clear();
   }
   /*!
    * cleanups the Result variables and set the info variables to their initial
@@ -124,6 +132,7 @@ struct Results
     info.iter_ext = 0;
     info.mu_updates = 0;
     info.rho_updates = 0;
+    info.polished = false;
     info.pri_res = 0.;
     info.dua_res = 0.;
     info.status = QPSolverOutput::PROXQP_MAX_ITER_REACHED;
@@ -8,6 +8,8 @@
 #define PROXSUITE_QP_SETTINGS_HPP
 
 #include <Eigen/Core>
+#include <chrono>
+#include <limits>
 #include <proxsuite/proxqp/status.hpp>
 #include <proxsuite/proxqp/dense/views.hpp>
 #include <proxsuite/proxqp/sparse/fwd.hpp>
@@ -63,6 +65,23 @@ struct Settings
   T eps_primal_inf;
   T eps_dual_inf;
   bool bcl_update;
+
+  bool decompose_separable_blocks;
+  isize nb_threads;
+
+  bool polish;
+  T polish_eps_abs;
+  isize polish_refine_iter;
+
+  bool anderson_acceleration;
+  isize anderson_memory;
+
+  SolverMethod method;
+
+  T time_limit;
+  std::chrono::steady_clock::time_point deadline;
+
+  isize factorization_cache_max_bytes;
   /*!
    * Default constructor.
    * @param alpha_bcl_ alpha parameter of the BCL algorithm.
@@ -113,6 +132,46 @@ struct Settings
    * @param bcl_update_ if set to true, BCL strategy is used for calibrating
    * mu_eq and mu_in. If set to false, a strategy developped by Martinez & al is
    * used.
+   * @param decompose_separable_blocks_ if set to true, the sparse solver solves
+   * the blocks of a block separable problem (i.e., the connected components of
+   * its KKT matrix) as independent QP problems.
+   * @param nb_threads_ number of threads solving the blocks of a block
+   * separable problem (if set to 0, the number of concurrent threads supported
+   * by the hardware). It is only used when proxsuite is built with
+   * multithreading support (BUILD_WITH_MULTITHREADING), the blocks being
+   * solved one after the other otherwise.
+   * @param polish_ if set to true, the solver polishes its iterates once their
+   * residuals are below polish_eps_abs: the equality constrained QP problem of
+   * the active set is solved with the current factorization, and its solution
+   * is kept if it reduces the residuals.
+   * @param polish_eps_abs_ residual level from which the polishing is tried
+   * (divided by 100 after each polishing step).
+   * @param polish_refine_iter_ maximal number of iterative refinement steps of
+   * the polishing, against the unregularized KKT matrix.
+   * @param anderson_acceleration_ if set to true, the outer iterates are
+   * extrapolated by Anderson acceleration while the proximal parameters are
+   * constant. An extrapolated iterate is only kept if it increases neither the
+   * primal nor the dual residual.
+   * @param anderson_memory_ maximal number of previous outer iterations used by
+   * the Anderson acceleration.
+   * @param method_ algorithm solving the QP problem: the proximal augmented
+   * Lagrangian method of PROXQP, or a primal-dual interior-point method, which
+   * is more robust on problems with many active inequality constraints. The
+   * settings specific to the outer and inner loops of PROXQP (BCL, polishing,
+   * Anderson acceleration) are ignored by the interior-point method.
+   * @param time_limit_ maximal duration of a solve, in microseconds. When it
+   * is exceeded, the solver returns the best iterate met so far (with respect
+   * to its largest primal or dual residual), with the status
+   * PROXQP_TIME_LIMIT_REACHED.
+   * @param deadline_ absolute deadline of the solves, combined with
+   * time_limit_.
+   * @param factorization_cache_max_bytes_ memory cap of the cache of the
+   * factorizations computed at the start of the solves, keyed by their active
+   * set and proximal parameters, which are restored by the next solves
+   * starting from the same active set instead of being computed anew (if set
+   * to 0, no factorization is cached). The dense backend only caches the
+   * factorizations of the AUGMENTED mode, and the sparse one those of its
+   * sparse LDLT.
    */
 
   Settings(T alpha_bcl_ = 0.1,
@@ -146,7 +205,19 @@ struct Settings
            T preconditioner_accuracy_ = 1.e-3,
            T eps_primal_inf_ = 1.E-4,
            T eps_dual_inf_ = 1.E-4,
-           bool bcl_update_ = true)
+           bool bcl_update_ = true,
+           bool decompose_separable_blocks_ = false,
+           isize nb_threads_ = 0,
+           bool polish_ = false,
+           T polish_eps_abs_ = 1.e-5,
+           isize polish_refine_iter_ = 25,
+           bool anderson_acceleration_ = false,
+           isize anderson_memory_ = 5,
+           SolverMethod method_ = SolverMethod::PROXQP,
+           T time_limit_ = std::numeric_limits<T>::infinity(),
+           std::chrono::steady_clock::time_point deadline_ =
+             std::chrono::steady_clock::time_point::max(),
+           isize factorization_cache_max_bytes_ = 0)
     : alpha_bcl(alpha_bcl_)
     , beta_bcl(beta_bcl_)
     , refactor_dual_feasibility_threshold(refactor_dual_feasibility_threshold_)
@@ -178,6 +249,17 @@ struct Settings
     , eps_primal_inf(eps_primal_inf_)
     , eps_dual_inf(eps_dual_inf_)
     , bcl_update(bcl_update_)
+    , decompose_separable_blocks(decompose_separable_blocks_)
+    , nb_threads(nb_threads_)
+    , polish(polish_)
+    , polish_eps_abs(polish_eps_abs_)
+    , polish_refine_iter(polish_refine_iter_)
+    , anderson_acceleration(anderson_acceleration_)
+    , anderson_memory(anderson_memory_)
+    , method(method_)
+    , time_limit(time_limit_)
+    , deadline(deadline_)
+    , factorization_cache_max_bytes(factorization_cache_max_bytes_)
   {
   }
 };
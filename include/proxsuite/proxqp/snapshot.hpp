@@ -0,0 +1,212 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file snapshot.hpp
+ */
+#ifndef PROXSUITE_QP_SNAPSHOT_HPP
+#define PROXSUITE_QP_SNAPSHOT_HPP
+
+#include <Eigen/Core>
+#include <proxsuite/linalg/veg/vec.hpp>
+#include <proxsuite/proxqp/dense/views.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+namespace proxsuite {
+namespace proxqp {
+namespace snapshot {
+///
+/// @brief Binary snapshot format of an initialized QP object.
+///
+/*!
+ * The file starts with a header identifying the backend and the scalar and
+ * index types it was written with. The payload is a raw dump of the QP object
+ * state (native endianness), hence a snapshot is meant to be reloaded by a
+ * binary built with the same ProxSuite version on the same architecture.
+ */
+static constexpr char magic[8] = { 'P', 'R', 'O', 'X', 'Q', 'P', 'S', 'N' };
+static constexpr std::uint32_t format_version = 17;
+
+enum struct Backend : std::uint32_t
+{
+  DENSE = 0,
+  SPARSE = 1,
+};
+
+struct Header
+{
+  char magic[8];
+  std::uint32_t version;
+  Backend backend;
+  std::uint32_t scalar_size;
+  std::uint32_t index_size;
+};
+/*!
+ * Writes the state of a QP object to a binary snapshot file.
+ */
+struct Writer
+{
+  std::ofstream out;
+  /*!
+   * Opens the snapshot file and writes its header.
+   * @param path path of the snapshot file.
+   * @param backend backend of the QP object.
+   * @param scalar_size size of the scalar type of the QP object.
+   * @param index_size size of the index type of the QP object.
+   */
+  Writer(std::string const& path,
+         Backend backend,
+         std::uint32_t scalar_size,
+         std::uint32_t index_size)
+    : out(path, std::ios::binary | std::ios::trunc)
+  {
+    PROXSUITE_THROW_PRETTY(!out,
+                           std::runtime_error,
+                           "the snapshot file " << path
+                                                << " could not be opened.");
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = format_version;
+    header.backend = backend;
+    header.scalar_size = scalar_size;
+    header.index_size = index_size;
+    write_pod(header);
+  }
+
+  void write_bytes(void const* ptr, isize n_bytes)
+  {
+    out.write(static_cast<char const*>(ptr), std::streamsize(n_bytes));
+    PROXSUITE_THROW_PRETTY(!out,
+                           std::runtime_error,
+                           "writing the snapshot file failed.");
+  }
+  template<typename T>
+  void write_pod(T const& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can be written as is.");
+    write_bytes(&value, isize(sizeof(T)));
+  }
+  template<typename Derived>
+  void write_eigen(Eigen::PlainObjectBase<Derived> const& mat)
+  {
+    using Scalar = typename Derived::Scalar;
+    write_pod(isize(mat.rows()));
+    write_pod(isize(mat.cols()));
+    write_bytes(mat.data(), isize(sizeof(Scalar)) * mat.size());
+  }
+  template<typename T>
+  void write_array(T const* ptr, isize len)
+  {
+    write_pod(len);
+    write_bytes(ptr, isize(sizeof(T)) * len);
+  }
+  template<typename T, typename A>
+  void write_vec(proxsuite::linalg::veg::Vec<T, A> const& vec)
+  {
+    write_array(vec.ptr(), vec.len());
+  }
+  // overloads used for visiting the storage of the linear solvers
+  template<typename T, typename A>
+  void operator()(proxsuite::linalg::veg::Vec<T, A> const& vec)
+  {
+    write_vec(vec);
+  }
+  void operator()(isize value) { write_pod(value); }
+};
+/*!
+ * Reads the state of a QP object from a binary snapshot file. The data is read
+ * directly into the storage of the QP object, without intermediary buffers.
+ */
+struct Reader
+{
+  std::ifstream in;
+  /*!
+   * Opens the snapshot file and checks its header.
+   * @param path path of the snapshot file.
+   * @param backend backend of the QP object.
+   * @param scalar_size size of the scalar type of the QP object.
+   * @param index_size size of the index type of the QP object.
+   */
+  Reader(std::string const& path,
+         Backend backend,
+         std::uint32_t scalar_size,
+         std::uint32_t index_size)
+    : in(path, std::ios::binary)
+  {
+    PROXSUITE_THROW_PRETTY(!in,
+                           std::runtime_error,
+                           "the snapshot file " << path
+                                                << " could not be opened.");
+    Header header = read_pod<Header>();
+    PROXSUITE_THROW_PRETTY(
+      std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+        header.version != format_version,
+      std::runtime_error,
+      "the file " << path << " is not a valid ProxQP snapshot.");
+    PROXSUITE_THROW_PRETTY(header.backend != backend,
+                           std::runtime_error,
+                           "the snapshot was written by another backend.");
+    PROXSUITE_THROW_PRETTY(header.scalar_size != scalar_size ||
+                             header.index_size != index_size,
+                           std::runtime_error,
+                           "the snapshot was written with other scalar or "
+                           "index types.");
+  }
+
+  void read_bytes(void* ptr, isize n_bytes)
+  {
+    in.read(static_cast<char*>(ptr), std::streamsize(n_bytes));
+    PROXSUITE_THROW_PRETTY(!in,
+                           std::runtime_error,
+                           "the snapshot file is truncated or corrupted.");
+  }
+  template<typename T>
+  T read_pod()
+  {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can be read as is.");
+    T value;
+    read_bytes(&value, isize(sizeof(T)));
+    return value;
+  }
+  template<typename Derived>
+  void read_eigen(Eigen::PlainObjectBase<Derived>& mat)
+  {
+    using Scalar = typename Derived::Scalar;
+    isize rows = read_pod<isize>();
+    isize cols = read_pod<isize>();
+    PROXSUITE_THROW_PRETTY(rows < 0 || cols < 0,
+                           std::runtime_error,
+                           "the snapshot file is truncated or corrupted.");
+    mat.resize(rows, cols);
+    read_bytes(mat.data(), isize(sizeof(Scalar)) * mat.size());
+  }
+  template<typename T, typename A>
+  void read_vec(proxsuite::linalg::veg::Vec<T, A>& vec)
+  {
+    isize len = read_pod<isize>();
+    PROXSUITE_THROW_PRETTY(len < 0,
+                           std::runtime_error,
+                           "the snapshot file is truncated or corrupted.");
+    vec.resize_for_overwrite(len);
+    read_bytes(vec.ptr_mut(), isize(sizeof(T)) * len);
+  }
+  // overloads used for visiting the storage of the linear solvers
+  template<typename T, typename A>
+  void operator()(proxsuite::linalg::veg::Vec<T, A>& vec)
+  {
+    read_vec(vec);
+  }
+  void operator()(isize& value) { value = read_pod<isize>(); }
+};
+
+} // namespace snapshot
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_SNAPSHOT_HPP */
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file solve_state.hpp
+ */
+#ifndef PROXSUITE_QP_SOLVE_STATE_HPP
+#define PROXSUITE_QP_SOLVE_STATE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include "proxsuite/proxqp/sparse/fwd.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+///
+/// @brief State of the outer loop of a solve, kept between the steps of a
+/// step-wise solve.
+///
+/*!
+ * A solve is started by qp_solve_begin, and its iterations are run by calls to
+ * qp_solve_step until it is done. The iterates and the proximal parameters are
+ * kept in the results, and the factorization in the workspace: the state only
+ * holds the scalars of the outer loop, and the position of the inner loop when
+ * a step returns in the middle of it.
+ */
+template<typename T>
+struct SolveState
+{
+  bool initialized; // whether the factorization and initial guess are set
+  bool done;        // whether the solve is finished (or was never started)
+  sparse::isize iter; // next outer iteration
+
+  // accuracies of the BCL algorithm
+  T bcl_eta_ext_init;
+  T bcl_eta_ext;
+  T bcl_eta_in;
+  T eps_in_min;
+  // residual level from which the next polishing is tried
+  T polish_eps;
+  // last step size of the inner loop, for the observer
+  T last_alpha;
+
+  // whether the inner loop of the outer iteration iter is under way
+  bool in_inner_loop;
+  sparse::isize inner_iter; // next inner iteration
+  // residuals at the start of the outer iteration iter, used once its inner
+  // loop is finished
+  T primal_feasibility_lhs;
+  T dual_feasibility_lhs;
+  // whether the starting point of the interior-point method is computed
+  bool interior_point_started;
+
+  SolveState()
+    : initialized(false)
+    , done(true)
+    , iter(0)
+    , bcl_eta_ext_init(0)
+    , bcl_eta_ext(0)
+    , bcl_eta_in(0)
+    , eps_in_min(0)
+    , polish_eps(0)
+    , last_alpha(0)
+    , in_inner_loop(false)
+    , inner_iter(0)
+    , primal_feasibility_lhs(0)
+    , dual_feasibility_lhs(0)
+    , interior_point_started(false)
+  {
+  }
+  /*!
+   * Starts a solve.
+   * @param alpha_bcl alpha parameter of the BCL algorithm.
+   * @param eps_abs absolute stopping criterion of the solver.
+   * @param polish_eps_abs residual level from which the polishing is tried.
+   */
+  void start(T alpha_bcl, T eps_abs, T polish_eps_abs)
+  {
+    initialized = false;
+    done = false;
+    iter = 0;
+    bcl_eta_ext_init = std::pow(T(0.1), alpha_bcl);
+    bcl_eta_ext = bcl_eta_ext_init;
+    bcl_eta_in = T(1);
+    eps_in_min = std::min(eps_abs, T(1e-9));
+    polish_eps = polish_eps_abs;
+    last_alpha = T(0);
+    in_inner_loop = false;
+    inner_iter = 0;
+    primal_feasibility_lhs = T(0);
+    dual_feasibility_lhs = T(0);
+    interior_point_started = false;
+  }
+};
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_SOLVE_STATE_HPP */
@@ -10,6 +10,7 @@
 
 #include <proxsuite/linalg/veg/vec.hpp>
 #include <proxsuite/proxqp/sparse/fwd.hpp>
+#include <proxsuite/proxqp/trace.hpp>
 
 namespace proxsuite {
 namespace proxqp {
@@ -160,6 +161,8 @@ qp_setup(QpView<T, I> qp,
   isize n_eq = qp.AT.ncols();
   isize n_in = qp.CT.ncols();
 
+  trace::Span span("init");
+  results.info.phase_timings.clear();
   if (results.x.rows() != n) {
     results.x.resize(n);
     results.x.setZero();
@@ -182,8 +185,13 @@ qp_setup(QpView<T, I> qp,
   switch (preconditioner_status) {
     case PreconditionerStatus::EXECUTE:
       execute_preconditioner_or_not = true;
+      work.internal.preconditioner_loaded = false;
       break;
     case PreconditionerStatus::IDENTITY:
+      // discard previous scaling variables (derived or loaded)
+      precond.delta.setOnes();
+      precond.c = T(1);
+      work.internal.preconditioner_loaded = false;
       execute_preconditioner_or_not = false;
       break;
     case PreconditionerStatus::KEEP:
@@ -198,7 +206,8 @@ qp_setup(QpView<T, I> qp,
     settings,
     execute_preconditioner_or_not,
     precond,
-    P::scale_qp_in_place_req(proxsuite::linalg::veg::Tag<T>{}, n, n_eq, n_in));
+    P::scale_qp_in_place_req(proxsuite::linalg::veg::Tag<T>{}, n, n_eq, n_in),
+    results.info.phase_timings);
   switch (settings.initial_guess) { // the following is used when initiliazing
                                     // the Qp object or updating it
     case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
@@ -284,7 +293,7 @@ have_same_structure(proxsuite::linalg::sparse::MatRef<T, I> a,
  */
 template<typename T, typename I>
 void
-copy(proxsuite::linalg::sparse::MatMut<T, I> a,
+copy(proxsuite::linalg::sparse::MatValuesMut<T, I> a,
      proxsuite::linalg::sparse::MatRef<T, I> b)
 {
   // assume same sparsity structure for a and b
@@ -0,0 +1,630 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file interior_point.hpp
+ */
+
+#ifndef PROXSUITE_QP_SPARSE_INTERIOR_POINT_HPP
+#define PROXSUITE_QP_SPARSE_INTERIOR_POINT_HPP
+
+#include <proxsuite/linalg/sparse/core.hpp>
+#include <proxsuite/linalg/sparse/factorize.hpp>
+#include "proxsuite/proxqp/results.hpp"
+#include "proxsuite/proxqp/settings.hpp"
+#include "proxsuite/proxqp/observer.hpp"
+#include "proxsuite/proxqp/trace.hpp"
+#include "proxsuite/proxqp/sparse/fwd.hpp"
+#include "proxsuite/proxqp/sparse/views.hpp"
+#include "proxsuite/proxqp/sparse/model.hpp"
+#include "proxsuite/proxqp/sparse/workspace.hpp"
+#include "proxsuite/proxqp/sparse/utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace proxsuite {
+namespace proxqp {
+namespace sparse {
+namespace interior_point {
+
+/*!
+ * Returns the largest step alpha keeping v + alpha dv nonnegative (infinite
+ * if dv is nonnegative).
+ *
+ * @param v nonnegative vector.
+ * @param dv direction.
+ */
+template<typename T>
+T
+max_step(const Vec<T>& v, const Vec<T>& dv)
+{
+  T alpha = std::numeric_limits<T>::infinity();
+  for (isize i = 0; i < v.size(); ++i) {
+    if (dv[i] < T(0)) {
+      alpha = std::min(alpha, -v[i] / dv[i]);
+    }
+  }
+  return alpha;
+}
+
+/*!
+ * Solves the scaled QP problem of the workspace with a primal-dual
+ * interior-point method (Mehrotra predictor-corrector), as the dense
+ * interior-point method.
+ *
+ * With D = lambda_l / t_l + lambda_u / t_u, the Newton steps solve the
+ * quasi-definite system
+ *
+ *   [ H     A^T   C^T S        ] [dx      ]   [-r_d         ]
+ *   [ A     0     0            ] [dy      ] = [-r_p         ],
+ *   [ S C   0     -S^2 D^{-1}  ] [S^{-1}dz]   [-S D^{-1} q  ]
+ *
+ * the rows being scaled by S = min(1, D^{1/2}) so that the diagonal entries
+ * -S^2 D^{-1} lie in [-1, 0) even for the constraints far from their bounds.
+ * Its sparsity pattern is the one of the KKT matrix with all the inequality
+ * constraints of a finite bound active: its symbolic factorization is
+ * computed once, and its numerical factorization once per iteration, with a
+ * regularization increased until the factorization succeeds. The rows of the
+ * constraints without any finite bound are left out of the system. Both the
+ * predictor and the corrector steps are solved by iterative refinement
+ * against the unregularized matrix. The iterates are left scaled in results,
+ * as in the PROXQP loop.
+ *
+ * The symbolic factorization and the starting point are computed by the first
+ * call of a solve, and the iterations then resume from the iteration counter
+ * of the solve state of the workspace.
+ *
+ * @param results solver results.
+ * @param data solver model.
+ * @param settings solver settings.
+ * @param work solver workspace, whose LDLT factorization is overwritten and
+ * whose interior-point buffers are sized at the solve.
+ * @param precond preconditioner.
+ * @param qp_scaled view on the scaled QP problem.
+ * @param stack memory stack.
+ * @param budget number of iterations the call may run, decreased by the
+ * iterations run. Once it is zero, the method is suspended until the next call.
+ * @param observer callable receiving the IterationRecord of each iteration.
+ * @return true once the method is finished, false if it is suspended.
+ */
+template<typename T, typename I, typename P, typename Observer>
+bool
+step(Results<T>& results,
+     Model<T, I>& data,
+     const Settings<T>& settings,
+     Workspace<T, I>& work,
+     P& precond,
+     QpView<T, I> qp_scaled,
+     proxsuite::linalg::veg::dynstack::DynStackMut stack,
+     isize& budget,
+     Observer&& observer)
+{
+  auto zx = proxsuite::linalg::sparse::util::zero_extend;
+  isize n = data.dim;
+  isize n_eq = data.n_eq;
+  isize n_in = data.n_in;
+  isize n_tot = n + n_eq + n_in;
+  // bounds of the regularization of the Newton system, increased while its
+  // factorization breaks down (the sparse LDLT does not order its pivots by
+  // magnitude, hence a larger lower bound than in the dense backend)
+  T const regularization_min(1.E-7);
+  T const regularization_max(1.E-2);
+  // fraction of the maximal step to the boundary
+  T const step_fraction(0.99);
+
+  InteriorPointWorkspace<T>& ipm = work.internal.interior_point;
+  Vec<T>& mask_l = ipm.mask_l;
+  Vec<T>& mask_u = ipm.mask_u;
+  Vec<T>& complementarity_scale = ipm.complementarity_scale;
+  Vec<T>& t_l = ipm.t_l;
+  Vec<T>& t_u = ipm.t_u;
+  Vec<T>& lambda_l = ipm.lambda_l;
+  Vec<T>& lambda_u = ipm.lambda_u;
+  Vec<T>& r_d = ipm.r_d;
+  Vec<T>& r_p = ipm.r_p;
+  Vec<T>& r_l = ipm.r_l;
+  Vec<T>& r_u = ipm.r_u;
+  Vec<T>& r_cl = ipm.r_cl;
+  Vec<T>& r_cu = ipm.r_cu;
+  Vec<T>& d = ipm.d;
+  Vec<T>& s = ipm.s;
+  Vec<T>& q = ipm.q;
+  Vec<T>& Cx = ipm.Cx;
+  Vec<T>& Cdx = ipm.Cdx;
+  Vec<T>& dt_l = ipm.dt_l;
+  Vec<T>& dt_u = ipm.dt_u;
+  Vec<T>& dlambda_l = ipm.dlambda_l;
+  Vec<T>& dlambda_u = ipm.dlambda_u;
+  Vec<T>& rhs = ipm.rhs;
+  Vec<T>& sol = ipm.sol;
+  Vec<T>& err = ipm.err;
+  Vec<T>& work_ = ipm.work;
+  Vec<T>& diag = ipm.diag;
+  Vec<T>& kkt_values = ipm.kkt_values;
+
+  // masks of the finite sides of the inequality constraints
+  for (isize i = 0; i < n_in; ++i) {
+    mask_l[i] = data.l[i] > T(-1.E20) ? T(1) : T(0);
+    mask_u[i] = data.u[i] < T(1.E20) ? T(1) : T(0);
+  }
+  T const n_sides = mask_l.sum() + mask_u.sum();
+
+  // unscaled complementarity of each constraint per unit of the scaled one
+  // (d being used as a buffer)
+  complementarity_scale.setOnes();
+  d.setOnes();
+  precond.unscale_primal_residual_in_place_in(
+    { proxqp::from_eigen, complementarity_scale });
+  precond.unscale_dual_in_place_in({ proxqp::from_eigen, d });
+  complementarity_scale.array() *= d.array();
+  // scaled complementarity targeted once the tolerance is reached
+  T const complementarity_floor =
+    n_in > 0 ? T(0.1) * settings.eps_abs / complementarity_scale.maxCoeff()
+             : T(0);
+
+  auto H = qp_scaled.H.to_eigen();
+  auto AT = qp_scaled.AT.to_eigen();
+  auto CT = qp_scaled.CT.to_eigen();
+  auto g = qp_scaled.g.to_eigen();
+  auto b = qp_scaled.b.to_eigen();
+  auto l = qp_scaled.l.to_eigen();
+  auto u = qp_scaled.u.to_eigen();
+
+  Vec<T>& x = results.x;
+  Vec<T>& y = results.y;
+  Vec<T>& z = results.z;
+  SolveState<T>& state = work.internal.solve_state;
+  // step size of the last iteration
+  T& alpha = state.last_alpha;
+
+  // the matrix of the Newton system holds the columns of the constraints with
+  // a finite side of the KKT matrix, scaled by S in a copy of its values
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt = data.kkt_mut();
+  I* kkt_nnz_counts = work.internal.kkt_nnz_counts.ptr_mut();
+  isize kkt_nnz = 0;
+  for (usize j = 0; j < usize(n_tot); ++j) {
+    bool active = isize(j) < n + n_eq ||
+                  mask_l[isize(j) - n - n_eq] + mask_u[isize(j) - n - n_eq] >
+                    T(0);
+    kkt_nnz_counts[isize(j)] =
+      active ? I(kkt.col_end(j) - kkt.col_start(j)) : I(0);
+    kkt_nnz += isize(kkt_nnz_counts[isize(j)]);
+  }
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active = {
+    proxsuite::linalg::sparse::from_raw_parts,
+    n_tot,
+    n_tot,
+    kkt_nnz,
+    kkt.col_ptrs(),
+    kkt_nnz_counts,
+    kkt.row_indices(),
+    kkt_values.data(),
+  };
+
+  auto& ldl_data = work.internal.ldl;
+  I* perm = ldl_data.perm.ptr_mut();
+  I* perm_inv = ldl_data.perm_inv.ptr_mut();
+  I* ldl_col_ptrs = ldl_data.col_ptrs.ptr_mut();
+  T* ldl_values = ldl_data.values.ptr_mut();
+  proxsuite::linalg::sparse::MatMut<T, I> ldl = {
+    proxsuite::linalg::sparse::from_raw_parts,
+    n_tot,
+    n_tot,
+    0,
+    ldl_col_ptrs,
+    ldl_data.nnz_counts.ptr_mut(),
+    ldl_data.row_indices.ptr_mut(),
+    ldl_values,
+  };
+  // solves in place the permuted LDLT system
+  auto ldl_solve_in_place = [&](Vec<T>& v) {
+    for (isize i = 0; i < n_tot; ++i) {
+      work_[i] = v[isize(zx(perm[i]))];
+    }
+    proxsuite::linalg::sparse::dense_lsolve<T, I>(
+      { proxsuite::linalg::sparse::from_eigen, work_ }, ldl.as_const());
+    for (isize i = 0; i < n_tot; ++i) {
+      work_[i] /= ldl_values[isize(zx(ldl_col_ptrs[i]))];
+    }
+    proxsuite::linalg::sparse::dense_ltsolve<T, I>(
+      { proxsuite::linalg::sparse::from_eigen, work_ }, ldl.as_const());
+    for (isize i = 0; i < n_tot; ++i) {
+      v[i] = work_[isize(zx(perm_inv[i]))];
+    }
+  };
+
+  // solves the Newton system for the complementarity residuals r_cl and r_cu:
+  // the steps of x and y are left in sol
+  auto newton_step = [&]() {
+    PhaseTimer<T> timer(results.info.phase_timings,
+                        Phase::ITERATIVE_REFINEMENT);
+    q = (mask_l.array() * (r_cl + lambda_l.cwiseProduct(r_l)).array() /
+           t_l.array() -
+         mask_u.array() * (r_cu + lambda_u.cwiseProduct(r_u)).array() /
+           t_u.array())
+          .matrix();
+    rhs.head(n) = -r_d;
+    rhs.segment(n, n_eq) = -r_p;
+    rhs.tail(n_in) = (-s.array() * q.array() / d.array()).matrix();
+
+    sol = rhs;
+    ldl_solve_in_place(sol);
+    T prev_err_norm = std::numeric_limits<T>::infinity();
+    for (isize k = 0; k < settings.nb_iterative_refinement; ++k) {
+      // err = rhs - K_0 sol, K_0 being the unregularized matrix (whose rows
+      // of the constraints left out are replaced by the identity)
+      err.setZero();
+      detail::noalias_symhiv_add(err, kkt_active.to_eigen(), sol);
+      for (isize i = 0; i < n_in; ++i) {
+        err[n + n_eq + i] += mask_l[i] + mask_u[i] > T(0)
+                               ? -s[i] * s[i] / d[i] * sol[n + n_eq + i]
+                               : sol[n + n_eq + i];
+      }
+      err = rhs - err;
+      T err_norm = infty_norm(err);
+      if (!(err_norm < prev_err_norm) ||
+          err_norm <= std::numeric_limits<T>::epsilon() *
+                        std::max(T(1), infty_norm(rhs))) {
+        break;
+      }
+      prev_err_norm = err_norm;
+      ldl_solve_in_place(err);
+      sol += err;
+    }
+
+    Cdx.noalias() = CT.transpose() * sol.head(n);
+    // the multiplier steps of the rows of large weight (which are not scaled)
+    // are consistent with the step of z, C dx being approximated within the
+    // refinement error
+    for (isize i = 0; i < n_in; ++i) {
+      if (d[i] > T(1)) {
+        Cdx[i] = (sol[n + n_eq + i] - q[i]) / d[i];
+      }
+    }
+    dt_l = mask_l.cwiseProduct(Cdx + r_l);
+    dt_u = mask_u.cwiseProduct(r_u - Cdx);
+    dlambda_l =
+      (-mask_l.array() * (r_cl + lambda_l.cwiseProduct(dt_l)).array() /
+       t_l.array())
+        .matrix();
+    dlambda_u =
+      (-mask_u.array() * (r_cu + lambda_u.cwiseProduct(dt_u)).array() /
+       t_u.array())
+        .matrix();
+  };
+
+  // computes the residuals of the scaled problem at the current iterate and
+  // factorizes the Newton system
+  auto linearize = [&]() {
+    Cx.noalias() = CT.transpose() * x;
+    r_d = g;
+    detail::noalias_symhiv_add(r_d, H, x);
+    r_d.noalias() += AT * y;
+    // the multipliers are formed in Cdx, free until the next step, so that
+    // the product does not evaluate them in a temporary
+    Cdx = lambda_u - lambda_l;
+    r_d.noalias() += CT * Cdx;
+    r_p.noalias() = AT.transpose() * x;
+    r_p -= b;
+    r_l = mask_l.cwiseProduct(Cx - l - t_l);
+    r_u = mask_u.cwiseProduct(u - Cx - t_u);
+
+    PhaseTimer<T> timer(results.info.phase_timings, Phase::FACTORIZATION);
+    // the weights of the constraints left out are set to one, their rows
+    // being decoupled from the system
+    d = (mask_l.array() * lambda_l.array() / t_l.array() +
+         mask_u.array() * lambda_u.array() / t_u.array())
+          .cwiseMax(std::numeric_limits<T>::min())
+          .matrix();
+    for (isize i = 0; i < n_in; ++i) {
+      if (mask_l[i] + mask_u[i] == T(0)) {
+        d[i] = T(1);
+      }
+    }
+    s = d.cwiseSqrt().cwiseMin(T(1));
+    for (isize i = 0; i < n_in; ++i) {
+      usize j = usize(n + n_eq + i);
+      isize start = isize(kkt.col_start(j));
+      isize end = start + isize(kkt_nnz_counts[isize(j)]);
+      for (isize p = start; p < end; ++p) {
+        kkt_values[p] = kkt.values()[p] * s[i];
+      }
+    }
+    for (T regularization = regularization_min;; regularization *= T(100)) {
+      diag.head(n).setConstant(regularization);
+      diag.segment(n, n_eq).setConstant(-regularization);
+      for (isize i = 0; i < n_in; ++i) {
+        diag[n + n_eq + i] = mask_l[i] + mask_u[i] > T(0)
+                               ? -s[i] * s[i] / d[i] - regularization
+                               : T(1);
+      }
+      proxsuite::linalg::sparse::factorize_numeric(
+        ldl_values,
+        ldl_data.row_indices.ptr_mut(),
+        diag.data(),
+        perm,
+        ldl_col_ptrs,
+        ldl_data.etree.ptr_mut(),
+        perm_inv,
+        kkt_active.as_const(),
+        stack);
+      bool broken_down = false;
+      for (isize j = 0; j < n_tot; ++j) {
+        T pivot = ldl_values[isize(zx(ldl_col_ptrs[j]))];
+        if (!(std::abs(pivot) > T(0)) || !std::isfinite(pivot)) {
+          broken_down = true;
+          break;
+        }
+      }
+      if (!broken_down || regularization >= regularization_max) {
+        break;
+      }
+    }
+  };
+
+  if (!state.interior_point_started) {
+    kkt_values = Eigen::Map<Vec<T> const>(kkt.values(), kkt.nnz());
+    {
+      PhaseTimer<T> timer(results.info.phase_timings, Phase::FACTORIZATION);
+      proxsuite::linalg::sparse::factorize_symbolic_non_zeros(
+        ldl_data.nnz_counts.ptr_mut(),
+        ldl_data.etree.ptr_mut(),
+        perm_inv,
+        perm,
+        kkt_active.symbolic(),
+        stack);
+    }
+
+    Cx.noalias() = CT.transpose() * x;
+    // the infinite sides keep t = 1 and lambda = 0
+    t_l = (mask_l.array() > T(0))
+            .select((Cx - l).array().cwiseMax(T(1)), T(1))
+            .matrix();
+    t_u = (mask_u.array() > T(0))
+            .select((u - Cx).array().cwiseMax(T(1)), T(1))
+            .matrix();
+    lambda_l = mask_l;
+    lambda_u = mask_u;
+
+    // starting point (Mehrotra's heuristic): full affine scaling step from
+    // t = lambda = 1, whose slacks and multipliers are then shifted to be
+    // positive and of balanced products
+    linearize();
+    r_cl = t_l.cwiseProduct(lambda_l);
+    r_cu = t_u.cwiseProduct(lambda_u);
+    newton_step();
+    x += sol.head(n);
+    y += sol.segment(n, n_eq);
+    if (n_sides > T(0)) {
+      t_l += dt_l;
+      t_u += dt_u;
+      lambda_l += dlambda_l;
+      lambda_u += dlambda_u;
+      T t_min = std::numeric_limits<T>::infinity();
+      T lambda_min = std::numeric_limits<T>::infinity();
+      for (isize i = 0; i < n_in; ++i) {
+        if (mask_l[i] > T(0)) {
+          t_min = std::min(t_min, t_l[i]);
+          lambda_min = std::min(lambda_min, lambda_l[i]);
+        }
+        if (mask_u[i] > T(0)) {
+          t_min = std::min(t_min, t_u[i]);
+          lambda_min = std::min(lambda_min, lambda_u[i]);
+        }
+      }
+      T t_shift = std::max(-T(1.5) * t_min, T(0));
+      T lambda_shift = std::max(-T(1.5) * lambda_min, T(0));
+      t_l += t_shift * mask_l;
+      t_u += t_shift * mask_u;
+      lambda_l += lambda_shift * mask_l;
+      lambda_u += lambda_shift * mask_u;
+      T product = t_l.dot(lambda_l) + t_u.dot(lambda_u);
+      T t_sum = t_l.dot(mask_l) + t_u.dot(mask_u);
+      T lambda_sum = lambda_l.sum() + lambda_u.sum();
+      if (product > T(0)) {
+        t_shift = T(0.5) * product / lambda_sum;
+        lambda_shift = T(0.5) * product / t_sum;
+      } else {
+        t_shift = T(1);
+        lambda_shift = T(1);
+      }
+      t_l =
+        (mask_l.array() > T(0)).select(t_l.array() + t_shift, T(1)).matrix();
+      t_u =
+        (mask_u.array() > T(0)).select(t_u.array() + t_shift, T(1)).matrix();
+      lambda_l += lambda_shift * mask_l;
+      lambda_u += lambda_shift * mask_u;
+    }
+
+    state.interior_point_started = true;
+  }
+
+  T const primal_feasibility_rhs_1_eq = infty_norm(data.b);
+  T const primal_feasibility_rhs_1_in_u = infty_norm(data.u);
+  T const primal_feasibility_rhs_1_in_l = infty_norm(data.l);
+  T const dual_feasibility_rhs_2 = infty_norm(data.g);
+  Vec<T>& primal_residual_eq_scaled = ipm.primal_residual_eq_scaled;
+  Vec<T>& primal_residual_in_scaled_lo = ipm.primal_residual_in_scaled_lo;
+  Vec<T>& primal_residual_in_scaled_up = ipm.primal_residual_in_scaled_up;
+  Vec<T>& dual_residual_scaled = ipm.dual_residual_scaled;
+  Vec<T>& complementarity_unscaled = ipm.complementarity_unscaled;
+
+  for (; state.iter < settings.max_iter; ++state.iter) {
+    isize const iter = state.iter;
+    if (budget == 0) {
+      return false;
+    }
+    trace::Span iteration_span("interior_point_iteration", iter);
+
+    z = lambda_u - lambda_l;
+    T primal_feasibility_eq_rhs_0(0);
+    T primal_feasibility_in_rhs_0(0);
+    T dual_feasibility_rhs_0(0);
+    T dual_feasibility_rhs_1(0);
+    T dual_feasibility_rhs_3(0);
+    T primal_feasibility_lhs(0);
+    T dual_feasibility_lhs(0);
+    {
+      PhaseTimer<T> timer(results.info.phase_timings, Phase::RESIDUALS);
+      VEG_BIND(auto,
+               (pri, dua),
+               detail::unscaled_primal_dual_residual(
+                 detail::vec_mut(primal_residual_eq_scaled),
+                 detail::vec_mut(primal_residual_in_scaled_lo),
+                 detail::vec_mut(primal_residual_in_scaled_up),
+                 detail::vec_mut(dual_residual_scaled),
+                 primal_feasibility_eq_rhs_0,
+                 primal_feasibility_in_rhs_0,
+                 dual_feasibility_rhs_0,
+                 dual_feasibility_rhs_1,
+                 dual_feasibility_rhs_3,
+                 precond,
+                 data,
+                 qp_scaled,
+                 detail::vec(x),
+                 detail::vec(y),
+                 detail::vec(z),
+                 stack));
+      primal_feasibility_lhs = pri;
+      dual_feasibility_lhs = dua;
+    }
+    complementarity_unscaled =
+      (t_l.array() * lambda_l.array() + t_u.array() * lambda_u.array()) *
+      complementarity_scale.array();
+    T complementarity =
+      n_in > 0 ? complementarity_unscaled.maxCoeff() : T(0);
+    results.info.pri_res = primal_feasibility_lhs;
+    results.info.dua_res = dual_feasibility_lhs;
+    if (is_observing<Observer>()) {
+      observer(make_iteration_record(iter,
+                                     primal_feasibility_lhs,
+                                     dual_feasibility_lhs,
+                                     results.info,
+                                     isize(0),
+                                     alpha));
+    }
+    if (settings.verbose) {
+      std::cout << "\033[1;32m[interior point iteration " << iter + 1
+                << "]\033[0m" << std::endl;
+      std::cout << std::scientific << std::setw(2) << std::setprecision(2)
+                << "| primal residual=" << primal_feasibility_lhs
+                << "| dual residual=" << dual_feasibility_lhs
+                << " | complementarity=" << complementarity
+                << " | step=" << alpha << std::endl;
+    }
+
+    T rhs_pri(settings.eps_abs);
+    T rhs_dua(settings.eps_abs);
+    if (settings.eps_rel != 0) {
+      rhs_pri += settings.eps_rel * std::max({
+                                      primal_feasibility_eq_rhs_0,
+                                      primal_feasibility_in_rhs_0,
+                                      primal_feasibility_rhs_1_eq,
+                                      primal_feasibility_rhs_1_in_l,
+                                      primal_feasibility_rhs_1_in_u,
+                                    });
+      rhs_dua += settings.eps_rel * std::max({
+                                      dual_feasibility_rhs_0,
+                                      dual_feasibility_rhs_1,
+                                      dual_feasibility_rhs_2,
+                                      dual_feasibility_rhs_3,
+                                    });
+    }
+    if (primal_feasibility_lhs <= rhs_pri &&
+        dual_feasibility_lhs <= rhs_dua &&
+        complementarity <= settings.eps_abs) {
+      results.info.status = QPSolverOutput::PROXQP_SOLVED;
+      break;
+    }
+    if (!std::isfinite(primal_feasibility_lhs) ||
+        !std::isfinite(dual_feasibility_lhs)) {
+      break;
+    }
+    if (work.internal.deadline.is_set()) {
+      BestIterate<T>& best = work.internal.best;
+      best.update(x,
+                  y,
+                  z,
+                  primal_feasibility_lhs,
+                  dual_feasibility_lhs,
+                  std::max({ primal_feasibility_lhs,
+                             dual_feasibility_lhs,
+                             complementarity }));
+      if (work.internal.deadline.reached()) {
+        x = best.x;
+        y = best.y;
+        z = best.z;
+        results.info.pri_res = best.pri_res;
+        results.info.dua_res = best.dua_res;
+        results.info.status = QPSolverOutput::PROXQP_TIME_LIMIT_REACHED;
+        return true;
+      }
+    }
+    results.info.iter_ext += 1;
+    results.info.iter += 1;
+    --budget;
+
+    T mu = n_sides > T(0) ? (t_l.dot(lambda_l) + t_u.dot(lambda_u)) / n_sides
+                          : T(0);
+    linearize();
+
+    // predictor (affine scaling) step
+    r_cl = t_l.cwiseProduct(lambda_l);
+    r_cu = t_u.cwiseProduct(lambda_u);
+    newton_step();
+    T alpha_aff = std::min(
+      T(1),
+      std::min(std::min(max_step(t_l, dt_l), max_step(t_u, dt_u)),
+               std::min(max_step(lambda_l, dlambda_l),
+                        max_step(lambda_u, dlambda_u))));
+    T mu_aff =
+      n_sides > T(0)
+        ? ((t_l + alpha_aff * dt_l).dot(lambda_l + alpha_aff * dlambda_l) +
+           (t_u + alpha_aff * dt_u).dot(lambda_u + alpha_aff * dlambda_u)) /
+            n_sides
+        : T(0);
+    T sigma = mu > T(0) ? std::pow(mu_aff / mu, T(3)) : T(0);
+
+    // corrector step, centered with sigma mu (kept above a fraction of the
+    // complementarity tolerance) and with the second order term of the
+    // predictor step
+    T target = std::max(sigma * mu, complementarity_floor);
+    r_cl = (mask_l.array() * (t_l.array() * lambda_l.array() +
+                              dt_l.array() * dlambda_l.array() - target))
+             .matrix();
+    r_cu = (mask_u.array() * (t_u.array() * lambda_u.array() +
+                              dt_u.array() * dlambda_u.array() - target))
+             .matrix();
+    newton_step();
+    alpha = std::min(
+      T(1),
+      step_fraction *
+        std::min(std::min(max_step(t_l, dt_l), max_step(t_u, dt_u)),
+                 std::min(max_step(lambda_l, dlambda_l),
+                          max_step(lambda_u, dlambda_u))));
+
+    if (!sol.allFinite() || !dlambda_l.allFinite() ||
+        !dlambda_u.allFinite()) {
+      // the Newton system is too ill-conditioned: the last iterate is kept
+      break;
+    }
+    x += alpha * sol.head(n);
+    y += alpha * sol.segment(n, n_eq);
+    t_l += alpha * dt_l;
+    t_u += alpha * dt_u;
+    lambda_l += alpha * dlambda_l;
+    lambda_u += alpha * dlambda_u;
+  }
+  z = lambda_u - lambda_l;
+  return true;
+}
+
+} // namespace interior_point
+} // namespace sparse
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_SPARSE_INTERIOR_POINT_HPP */
@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file low_rank.hpp
+ */
+#ifndef PROXSUITE_QP_SPARSE_LOW_RANK_HPP
+#define PROXSUITE_QP_SPARSE_LOW_RANK_HPP
+
+#include <proxsuite/proxqp/sparse/fwd.hpp>
+#include <proxsuite/linalg/veg/internal/macros.hpp>
+#include <utility>
+
+namespace proxsuite {
+namespace proxqp {
+namespace sparse {
+///
+/// @brief Diagonal plus low rank quadratic cost H = diag(d) + F F^T.
+///
+/*!
+ * Quadratic cost of a factor model (e.g., of a portfolio optimization
+ * problem), with d of size n and F of size n x k, k being much smaller than n.
+ * It is passed to the solver without forming the dense n x n matrix H, by
+ * lifting the factor exposures v = F^T x into the problem:
+ *
+ *   min 1/2 x^T diag(d) x + 1/2 ||v||^2 + g^T x
+ *   s.t. A x = b, F^T x - v = 0, l <= C x <= u,
+ *
+ * whose matrices hold O(nk) nonzero coefficients.
+ */
+template<typename T>
+struct LowRankHessian
+{
+  Vec<T> d;
+  DMat<T> F;
+
+  LowRankHessian() = default;
+  LowRankHessian(Vec<T> d_, DMat<T> F_)
+    : d(std::move(d_))
+    , F(std::move(F_))
+  {
+    PROXSUITE_CHECK_ARGUMENT_SIZE(
+      F.rows(), d.rows(), "the row dimension of F is not the dimension of d.");
+  }
+
+  /*!
+   * Returns the dimension n of the cost.
+   */
+  auto dim() const noexcept -> isize { return d.rows(); }
+  /*!
+   * Returns the rank k of the low rank term.
+   */
+  auto rank() const noexcept -> isize { return F.cols(); }
+  /*!
+   * Returns the product H x, computed in O(nk) operations.
+   */
+  auto apply(VecRef<T> x) const -> Vec<T>
+  {
+    return (d.array() * x.array()).matrix() + F * (F.transpose() * x);
+  }
+};
+} // namespace sparse
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_SPARSE_LOW_RANK_HPP */
@@ -0,0 +1,448 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/** \file */
+#ifndef PROXSUITE_QP_SPARSE_MAPPED_QP_HPP
+#define PROXSUITE_QP_SPARSE_MAPPED_QP_HPP
+
+#include <proxsuite/proxqp/sparse/fwd.hpp>
+#include <proxsuite/proxqp/sparse/views.hpp>
+#include <proxsuite/linalg/sparse/core.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace proxsuite {
+namespace proxqp {
+namespace sparse {
+namespace detail {
+namespace mapped_qp {
+///
+/// @brief Binary compressed column format of a sparse QP problem.
+///
+/*!
+ * The file starts with a header giving the scalar and index types and the
+ * dimensions of the problem. It is followed by the kkt matrix blocks (upper
+ * triangular part of H, AT and CT) stored as one compressed column matrix of
+ * dim + n_eq + n_in columns, in the layout of the sparse::Model storage, then
+ * by the vectors g, b, l and u. Each array starts at an offset aligned on 64
+ * bytes, so that it can be read in place from a memory mapping of the file.
+ * The data is stored with the native endianness.
+ */
+static constexpr char magic[8] = { 'P', 'R', 'O', 'X', 'Q', 'P', 'C', 'S' };
+static constexpr std::uint32_t format_version = 1;
+static constexpr std::int64_t alignment = 64;
+
+struct Header
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t scalar_size;
+  std::uint32_t index_size;
+  std::uint32_t reserved;
+  std::int64_t dim;
+  std::int64_t n_eq;
+  std::int64_t n_in;
+  std::int64_t H_nnz;
+  std::int64_t A_nnz;
+  std::int64_t C_nnz;
+};
+
+enum Array
+{
+  COL_PTRS,
+  ROW_INDICES,
+  VALUES,
+  G,
+  B,
+  L,
+  U,
+  N_ARRAYS,
+};
+
+inline auto
+align(std::int64_t offset) -> std::int64_t
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+// offsets of the arrays in the file, the last one being the file size
+template<typename T, typename I>
+void
+compute_offsets(Header const& header, std::int64_t (&offsets)[N_ARRAYS + 1])
+{
+  std::int64_t n_tot = header.dim + header.n_eq + header.n_in;
+  std::int64_t nnz = header.H_nnz + header.A_nnz + header.C_nnz;
+  std::int64_t scalar_size = std::int64_t(sizeof(T));
+  std::int64_t index_size = std::int64_t(sizeof(I));
+  std::int64_t sizes[N_ARRAYS] = {
+    (n_tot + 1) * index_size,   nnz * index_size,
+    nnz * scalar_size,          header.dim * scalar_size,
+    header.n_eq * scalar_size,  header.n_in * scalar_size,
+    header.n_in * scalar_size,
+  };
+  std::int64_t offset = align(std::int64_t(sizeof(Header)));
+  for (isize k = 0; k < N_ARRAYS; ++k) {
+    offsets[k] = offset;
+    offset = align(offset + sizes[k]);
+  }
+  offsets[N_ARRAYS] = offset;
+}
+
+} // namespace mapped_qp
+} // namespace detail
+
+/*!
+ * Writes a QP problem to a binary compressed column file, which can be loaded
+ * without copying its sparsity pattern with MappedQp.
+ * @param path path of the file.
+ * @param qp view of the QP problem, with the upper triangular part of H and
+ * the transposed constraint matrices, with sorted row indices.
+ */
+template<typename T, typename I>
+void
+write_mapped_qp(std::string const& path, QpView<T, I> qp)
+{
+  namespace mapped = detail::mapped_qp;
+  isize n = qp.H.nrows();
+  isize n_eq = qp.AT.ncols();
+  isize n_in = qp.CT.ncols();
+  PROXSUITE_THROW_PRETTY(
+    qp.H.ncols() != n || qp.AT.nrows() != n || qp.CT.nrows() != n ||
+      qp.g.nrows() != n || qp.b.nrows() != n_eq || qp.l.nrows() != n_in ||
+      qp.u.nrows() != n_in,
+    std::invalid_argument,
+    "the dimensions of the QP problem are not consistent.");
+
+  mapped::Header header{};
+  std::memcpy(header.magic, mapped::magic, sizeof(mapped::magic));
+  header.version = mapped::format_version;
+  header.scalar_size = sizeof(T);
+  header.index_size = sizeof(I);
+  header.dim = n;
+  header.n_eq = n_eq;
+  header.n_in = n_in;
+  proxsuite::linalg::sparse::MatRef<T, I> blocks[3] = { qp.H, qp.AT, qp.CT };
+  std::int64_t* nnz[3] = { &header.H_nnz, &header.A_nnz, &header.C_nnz };
+  for (isize k = 0; k < 3; ++k) {
+    for (isize j = 0; j < blocks[k].ncols(); ++j) {
+      *nnz[k] += std::int64_t(blocks[k].col_end(usize(j)) -
+                              blocks[k].col_start(usize(j)));
+    }
+  }
+  std::int64_t offsets[mapped::N_ARRAYS + 1];
+  mapped::compute_offsets<T, I>(header, offsets);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  PROXSUITE_THROW_PRETTY(
+    !out, std::runtime_error, "the file " << path << " could not be opened.");
+  char const padding[mapped::alignment] = {};
+  std::int64_t pos = 0;
+  auto write_bytes = [&](void const* ptr, std::int64_t n_bytes) {
+    out.write(static_cast<char const*>(ptr), std::streamsize(n_bytes));
+    pos += n_bytes;
+  };
+  auto pad_to = [&](std::int64_t offset) {
+    write_bytes(padding, offset - pos);
+  };
+  write_bytes(&header, std::int64_t(sizeof(header)));
+
+  // column pointers of the kkt matrix
+  pad_to(offsets[mapped::COL_PTRS]);
+  I col_ptr = 0;
+  write_bytes(&col_ptr, std::int64_t(sizeof(I)));
+  for (auto const& m : blocks) {
+    for (isize j = 0; j < m.ncols(); ++j) {
+      col_ptr = I(col_ptr + I(m.col_end(usize(j)) - m.col_start(usize(j))));
+      write_bytes(&col_ptr, std::int64_t(sizeof(I)));
+    }
+  }
+  // row indices, H being upper triangular
+  pad_to(offsets[mapped::ROW_INDICES]);
+  for (isize k = 0; k < 3; ++k) {
+    auto const& m = blocks[k];
+    for (isize j = 0; j < m.ncols(); ++j) {
+      usize col_start = m.col_start(usize(j));
+      usize col_end = m.col_end(usize(j));
+      for (usize p = col_start; p < col_end; ++p) {
+        PROXSUITE_THROW_PRETTY(k == 0 && isize(m.row_indices()[p]) > j,
+                               std::invalid_argument,
+                               "H is not upper triangular.");
+      }
+      write_bytes(m.row_indices() + col_start,
+                  std::int64_t(sizeof(I) * (col_end - col_start)));
+    }
+  }
+  // values
+  pad_to(offsets[mapped::VALUES]);
+  for (auto const& m : blocks) {
+    for (isize j = 0; j < m.ncols(); ++j) {
+      usize col_start = m.col_start(usize(j));
+      usize col_end = m.col_end(usize(j));
+      write_bytes(m.values() + col_start,
+                  std::int64_t(sizeof(T) * (col_end - col_start)));
+    }
+  }
+  proxsuite::linalg::sparse::DenseVecRef<T> vecs[4] = {
+    qp.g, qp.b, qp.l, qp.u
+  };
+  for (isize k = 0; k < 4; ++k) {
+    pad_to(offsets[mapped::G + k]);
+    write_bytes(vecs[k].as_slice().ptr(),
+                std::int64_t(sizeof(T)) * vecs[k].nrows());
+  }
+  pad_to(offsets[mapped::N_ARRAYS]);
+  PROXSUITE_THROW_PRETTY(
+    !out, std::runtime_error, "writing the file " << path << " failed.");
+}
+
+///
+/// @brief QP problem read in place from a binary compressed column file.
+///
+/*!
+ * The file written by write_mapped_qp is mapped in memory (read only), so
+ * that the problem is loaded without copies: the pages of the file are read
+ * on demand by the system. A QP object initialized from it points to the
+ * sparsity pattern of the mapping, and only copies the values of the
+ * matrices, which are scaled in place by the preconditioner. On Windows, the
+ * file is read into a buffer owned by the object.
+ */
+template<typename T, typename I>
+struct MappedQp
+{
+  isize dim;
+  isize n_eq;
+  isize n_in;
+  isize H_nnz;
+  isize A_nnz;
+  isize C_nnz;
+
+  /*!
+   * Maps the file in memory and checks its content.
+   * @param path path of the file written by write_mapped_qp.
+   */
+  explicit MappedQp(std::string const& path)
+  {
+    namespace mapped = detail::mapped_qp;
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    PROXSUITE_THROW_PRETTY(fd < 0,
+                           std::runtime_error,
+                           "the file " << path << " could not be opened.");
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      PROXSUITE_THROW_PRETTY(true,
+                             std::runtime_error,
+                             "the file " << path << " is not a valid QP file.");
+    }
+    void* ptr =
+      ::mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping remains valid once the file is closed
+    ::close(fd);
+    PROXSUITE_THROW_PRETTY(ptr == MAP_FAILED,
+                           std::runtime_error,
+                           "the file " << path << " could not be mapped.");
+    data = static_cast<char const*>(ptr);
+    size = std::int64_t(st.st_size);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    PROXSUITE_THROW_PRETTY(
+      !in, std::runtime_error, "the file " << path << " could not be opened.");
+    size = std::int64_t(in.tellg());
+    buffer.resize(std::size_t((size + 7) / 8));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buffer.data()), std::streamsize(size));
+    PROXSUITE_THROW_PRETTY(
+      !in, std::runtime_error, "reading the file " << path << " failed.");
+    data = reinterpret_cast<char const*>(buffer.data());
+#endif
+    try {
+      check(path);
+    } catch (...) {
+      release();
+      throw;
+    }
+  }
+  MappedQp(MappedQp const&) = delete;
+  auto operator=(MappedQp const&) -> MappedQp& = delete;
+  MappedQp(MappedQp&& other) noexcept
+    : dim(other.dim)
+    , n_eq(other.n_eq)
+    , n_in(other.n_in)
+    , H_nnz(other.H_nnz)
+    , A_nnz(other.A_nnz)
+    , C_nnz(other.C_nnz)
+    , data(other.data)
+    , size(other.size)
+    , buffer(std::move(other.buffer))
+  {
+    std::memcpy(offsets, other.offsets, sizeof(offsets));
+    other.data = nullptr;
+    other.size = 0;
+  }
+  auto operator=(MappedQp&& other) noexcept -> MappedQp&
+  {
+    if (this != &other) {
+      release();
+      dim = other.dim;
+      n_eq = other.n_eq;
+      n_in = other.n_in;
+      H_nnz = other.H_nnz;
+      A_nnz = other.A_nnz;
+      C_nnz = other.C_nnz;
+      data = other.data;
+      size = other.size;
+      buffer = std::move(other.buffer);
+      std::memcpy(offsets, other.offsets, sizeof(offsets));
+      other.data = nullptr;
+      other.size = 0;
+    }
+    return *this;
+  }
+  ~MappedQp() { release(); }
+
+  /*!
+   * Returns the column pointers of the kkt matrix (of size
+   * dim + n_eq + n_in + 1).
+   */
+  auto kkt_col_ptrs() const noexcept -> I const*
+  {
+    return array<I>(detail::mapped_qp::COL_PTRS);
+  }
+  /*!
+   * Returns the row indices of the kkt matrix.
+   */
+  auto kkt_row_indices() const noexcept -> I const*
+  {
+    return array<I>(detail::mapped_qp::ROW_INDICES);
+  }
+  /*!
+   * Returns the values of the kkt matrix.
+   */
+  auto kkt_values() const noexcept -> T const*
+  {
+    return array<T>(detail::mapped_qp::VALUES);
+  }
+  /*!
+   * Returns a view of the QP problem, pointing to the mapped file.
+   */
+  auto view() const noexcept -> QpView<T, I>
+  {
+    namespace mapped = detail::mapped_qp;
+    using proxsuite::linalg::sparse::from_raw_parts;
+    I const* col_ptrs = kkt_col_ptrs();
+    I const* row_indices = kkt_row_indices();
+    T const* values = kkt_values();
+    return {
+      { from_raw_parts, dim, dim, H_nnz, col_ptrs, nullptr, row_indices,
+        values },
+      { from_raw_parts, array<T>(mapped::G), dim },
+      { from_raw_parts, dim, n_eq, A_nnz, col_ptrs + dim, nullptr,
+        row_indices, values },
+      { from_raw_parts, array<T>(mapped::B), n_eq },
+      { from_raw_parts, dim, n_in, C_nnz, col_ptrs + dim + n_eq, nullptr,
+        row_indices, values },
+      { from_raw_parts, array<T>(mapped::L), n_in },
+      { from_raw_parts, array<T>(mapped::U), n_in },
+    };
+  }
+
+private:
+  char const* data = nullptr;
+  std::int64_t size = 0;
+  std::int64_t offsets[detail::mapped_qp::N_ARRAYS + 1] = {};
+  // storage of the file when it can not be mapped
+  std::vector<std::uint64_t> buffer;
+
+  template<typename U>
+  auto array(isize k) const noexcept -> U const*
+  {
+    return reinterpret_cast<U const*>(data + offsets[k]);
+  }
+
+  void check(std::string const& path)
+  {
+    namespace mapped = detail::mapped_qp;
+    bool valid = size >= std::int64_t(sizeof(mapped::Header));
+    mapped::Header header{};
+    if (valid) {
+      std::memcpy(&header, data, sizeof(header));
+      valid = std::memcmp(header.magic, mapped::magic, sizeof(mapped::magic)) ==
+                0 &&
+              header.version == mapped::format_version && header.dim >= 0 &&
+              header.n_eq >= 0 && header.n_in >= 0 && header.H_nnz >= 0 &&
+              header.A_nnz >= 0 && header.C_nnz >= 0;
+    }
+    PROXSUITE_THROW_PRETTY(!valid,
+                           std::runtime_error,
+                           "the file " << path << " is not a valid QP file.");
+    PROXSUITE_THROW_PRETTY(header.scalar_size != sizeof(T) ||
+                             header.index_size != sizeof(I),
+                           std::runtime_error,
+                           "the file " << path
+                                       << " was written with other scalar or "
+                                          "index types.");
+    mapped::compute_offsets<T, I>(header, offsets);
+    PROXSUITE_THROW_PRETTY(offsets[mapped::N_ARRAYS] > size,
+                           std::runtime_error,
+                           "the file " << path << " is truncated.");
+    dim = isize(header.dim);
+    n_eq = isize(header.n_eq);
+    n_in = isize(header.n_in);
+    H_nnz = isize(header.H_nnz);
+    A_nnz = isize(header.A_nnz);
+    C_nnz = isize(header.C_nnz);
+
+    // the pattern is read by the solver without further checks
+    isize n_tot = dim + n_eq + n_in;
+    I const* col_ptrs = kkt_col_ptrs();
+    I const* row_indices = kkt_row_indices();
+    valid = col_ptrs[0] == 0 && isize(col_ptrs[dim]) == H_nnz &&
+            isize(col_ptrs[dim + n_eq]) == H_nnz + A_nnz &&
+            isize(col_ptrs[n_tot]) == H_nnz + A_nnz + C_nnz;
+    for (isize j = 0; valid && j < n_tot; ++j) {
+      isize col_start = isize(col_ptrs[j]);
+      isize col_end = isize(col_ptrs[j + 1]);
+      valid = col_start <= col_end;
+      // sorted row indices, H being upper triangular
+      isize max_row = j < dim ? j : dim - 1;
+      for (isize p = col_start; valid && p < col_end; ++p) {
+        isize i = isize(row_indices[p]);
+        valid = i >= 0 && i <= max_row &&
+                (p == col_start || isize(row_indices[p - 1]) < i);
+      }
+    }
+    PROXSUITE_THROW_PRETTY(!valid,
+                           std::runtime_error,
+                           "the sparsity pattern of the file "
+                             << path << " is not valid.");
+  }
+
+  void release() noexcept
+  {
+#ifndef _WIN32
+    if (data != nullptr) {
+      ::munmap(const_cast<char*>(data), std::size_t(size));
+    }
+#endif
+    data = nullptr;
+    size = 0;
+    buffer.clear();
+  }
+};
+
+} // namespace sparse
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_SPARSE_MAPPED_QP_HPP */
@@ -32,10 +32,11 @@ struct Model
   proxsuite::linalg::veg::Vec<I> kkt_col_ptrs;
   proxsuite::linalg::veg::Vec<I> kkt_row_indices;
   proxsuite::linalg::veg::Vec<T> kkt_values;
-
-  proxsuite::linalg::veg::Vec<I> kkt_col_ptrs_unscaled;
-  proxsuite::linalg::veg::Vec<I> kkt_row_indices_unscaled;
-  proxsuite::linalg::veg::Vec<T> kkt_values_unscaled;
+  // read-only sparsity pattern of the KKT matrix, used instead of
+  // kkt_col_ptrs and kkt_row_indices when it is not owned by the model (e.g.,
+  // when it is mapped from a file, see MappedQp)
+  I const* kkt_col_ptrs_external = nullptr;
+  I const* kkt_row_indices_external = nullptr;
 
   Eigen::Matrix<T, Eigen::Dynamic, 1> g;
   Eigen::Matrix<T, Eigen::Dynamic, 1> b;
@@ -63,79 +64,64 @@ struct Model
     l.setZero();
   }
   /*!
-   * Returns the current (scaled) KKT matrix of the problem.
+   * Returns whether the KKT matrix of the problem has been set up.
    */
-  auto kkt() const -> proxsuite::linalg::sparse::MatRef<T, I>
+  auto kkt_is_set() const -> bool
   {
-    auto n_tot = kkt_col_ptrs.len() - 1;
-    auto nnz =
-      isize(proxsuite::linalg::sparse::util::zero_extend(kkt_col_ptrs[n_tot]));
-    return {
-      proxsuite::linalg::sparse::from_raw_parts,
-      n_tot,
-      n_tot,
-      nnz,
-      kkt_col_ptrs.ptr(),
-      nullptr,
-      kkt_row_indices.ptr(),
-      kkt_values.ptr(),
-    };
+    return kkt_col_ptrs_external != nullptr || kkt_col_ptrs.len() != 0;
   }
   /*!
-   * Returns the current (scaled) KKT matrix of the problem (mutable form).
+   * Returns the column pointers of the KKT matrix, owned by the model or not.
    */
-  auto kkt_mut() -> proxsuite::linalg::sparse::MatMut<T, I>
+  auto kkt_col_ptrs_data() const -> I const*
   {
-    auto n_tot = kkt_col_ptrs.len() - 1;
-    auto nnz =
-      isize(proxsuite::linalg::sparse::util::zero_extend(kkt_col_ptrs[n_tot]));
-    return {
-      proxsuite::linalg::sparse::from_raw_parts,
-      n_tot,
-      n_tot,
-      nnz,
-      kkt_col_ptrs.ptr_mut(),
-      nullptr,
-      kkt_row_indices.ptr_mut(),
-      kkt_values.ptr_mut(),
-    };
+    return kkt_col_ptrs_external != nullptr ? kkt_col_ptrs_external
+                                            : kkt_col_ptrs.ptr();
   }
   /*!
-   * Returns the original (unscaled) KKT matrix of the problem.
+   * Returns the row indices of the KKT matrix, owned by the model or not.
    */
-  auto kkt_unscaled() const -> proxsuite::linalg::sparse::MatRef<T, I>
+  auto kkt_row_indices_data() const -> I const*
   {
-    auto n_tot = kkt_col_ptrs_unscaled.len() - 1;
-    auto nnz = isize(proxsuite::linalg::sparse::util::zero_extend(
-      kkt_col_ptrs_unscaled[n_tot]));
+    return kkt_row_indices_external != nullptr ? kkt_row_indices_external
+                                               : kkt_row_indices.ptr();
+  }
+  /*!
+   * Returns the current (scaled) KKT matrix of the problem. It is the only
+   * copy of the matrices of the problem: their original (unscaled) values are
+   * recovered from it with the scaling variables of the preconditioner.
+   */
+  auto kkt() const -> proxsuite::linalg::sparse::MatRef<T, I>
+  {
+    isize n_tot = dim + n_eq + n_in;
     return {
       proxsuite::linalg::sparse::from_raw_parts,
       n_tot,
       n_tot,
-      nnz,
-      kkt_col_ptrs_unscaled.ptr(),
+      kkt_values.len(),
+      kkt_col_ptrs_data(),
       nullptr,
-      kkt_row_indices_unscaled.ptr(),
-      kkt_values_unscaled.ptr(),
+      kkt_row_indices_data(),
+      kkt_values.ptr(),
     };
   }
   /*!
-   * Returns the original (unscaled) KKT matrix of the problem (mutable form).
+   * Returns the current (scaled) KKT matrix of the problem, with mutable
+   * values. Its sparsity pattern is read-only, as it may be stored in
+   * read-only memory when it is not owned by the model.
    */
-  auto kkt_mut_unscaled() -> proxsuite::linalg::sparse::MatMut<T, I>
+  auto kkt_mut() -> proxsuite::linalg::sparse::MatValuesMut<T, I>
   {
-    auto n_tot = kkt_col_ptrs_unscaled.len() - 1;
-    auto nnz = isize(proxsuite::linalg::sparse::util::zero_extend(
-      kkt_col_ptrs_unscaled[n_tot]));
+    isize n_tot = dim + n_eq + n_in;
     return {
       proxsuite::linalg::sparse::from_raw_parts,
       n_tot,
       n_tot,
-      nnz,
-      kkt_col_ptrs_unscaled.ptr_mut(),
+      kkt_values.len(),
+      kkt_col_ptrs_data(),
       nullptr,
-      kkt_row_indices_unscaled.ptr_mut(),
-      kkt_values_unscaled.ptr_mut(),
+      kkt_row_indices_data(),
+      kkt_values.ptr_mut(),
     };
   }
 };
@@ -29,6 +29,12 @@ struct Identity
     proxsuite::linalg::veg::dynstack::DynStackMut /*stack*/)
   {
   }
+  void unscale_matrices_in_place(
+    proxsuite::linalg::sparse::MatValuesMut<T, I> /*H*/,
+    proxsuite::linalg::sparse::MatValuesMut<T, I> /*AT*/,
+    proxsuite::linalg::sparse::MatValuesMut<T, I> /*CT*/) const
+  {
+  }
 
   // modifies variables in place
   void scale_primal_in_place(VectorViewMut<T> /*primal*/) {}
@@ -7,6 +7,7 @@
 #define PROXSUITE_QP_SPARSE_PRECOND_RUIZ_HPP
 
 #include "proxsuite/proxqp/sparse/fwd.hpp"
+#include "proxsuite/proxqp/trace.hpp"
 
 namespace proxsuite {
 namespace proxqp {
@@ -108,6 +109,37 @@ colwise_infty_norm_symlo(T* col_norm, proxsuite::linalg::sparse::MatRef<T, I> h)
   }
 }
 
+// multiplies the values of the matrix by a scalar, its sparsity pattern being
+// read-only
+template<typename T, typename I>
+void
+scale_values(proxsuite::linalg::sparse::MatValuesMut<T, I> m, T factor)
+{
+  T* mx = m.values_mut();
+  for (usize j = 0; j < usize(m.ncols()); ++j) {
+    auto col_start = m.col_start(j);
+    auto col_end = m.col_end(j);
+    for (usize p = col_start; p < col_end; ++p) {
+      mx[p] *= factor;
+    }
+  }
+}
+
+// divides the values of the matrix by a scalar
+template<typename T, typename I>
+void
+unscale_values(proxsuite::linalg::sparse::MatValuesMut<T, I> m, T factor)
+{
+  T* mx = m.values_mut();
+  for (usize j = 0; j < usize(m.ncols()); ++j) {
+    auto col_start = m.col_start(j);
+    auto col_end = m.col_end(j);
+    for (usize p = col_start; p < col_end; ++p) {
+      mx[p] /= factor;
+    }
+  }
+}
+
 template<typename T, typename I>
 auto
 ruiz_scale_qp_in_place( //
@@ -131,13 +163,13 @@ ruiz_scale_qp_in_place( //
 
   LDLT_TEMP_VEC(T, delta, n + n_eq + n_in, stack);
 
-  I* Hi = qp.H.row_indices_mut();
+  I const* Hi = qp.H.row_indices();
   T* Hx = qp.H.values_mut();
 
-  I* ATi = qp.AT.row_indices_mut();
+  I const* ATi = qp.AT.row_indices();
   T* ATx = qp.AT.values_mut();
 
-  I* CTi = qp.CT.row_indices_mut();
+  I const* CTi = qp.CT.row_indices();
   T* CTx = qp.CT.values_mut();
 
   T const machine_eps = std::numeric_limits<T>::epsilon();
@@ -148,6 +180,7 @@ ruiz_scale_qp_in_place( //
     } else {
       ++iter;
     }
+    trace::Span span("ruiz_iteration", iter);
 
     // norm_infty of each column of A (resp. C), i.e.,
     // each row of AT (resp. CT)
@@ -312,7 +345,7 @@ ruiz_scale_qp_in_place( //
     gamma = 1 / std::max(avg, T(1));
 
     qp.g.to_eigen() *= gamma;
-    qp.H.to_eigen() *= gamma;
+    scale_values(qp.H, gamma);
 
     S.array() *= delta.array();
     c *= gamma;
@@ -349,6 +382,25 @@ struct RuizEquilibration
   {
     delta.setOnes();
   }
+  /*!
+   * Loads scaling variables derived previously (e.g., by another equilibrator
+   * of the same dimensions), so that they can be applied without executing
+   * anew the ruiz equilibration algorithm.
+   * @param delta_ scaling vector (of size n + n_eq + n_in).
+   * @param c_ cost scaling factor.
+   */
+  void load(VecRef<T> delta_, T c_)
+  {
+    PROXSUITE_THROW_PRETTY(delta_.rows() != delta.rows(),
+                           std::invalid_argument,
+                           "the dimension of the scaling vector delta is not "
+                           "valid.");
+    PROXSUITE_THROW_PRETTY(!(c_ > T(0)) || !(delta_.array() > T(0)).all(),
+                           std::invalid_argument,
+                           "the scaling variables should be positive.");
+    delta = delta_;
+    c = c_;
+  }
 
   static auto scale_qp_in_place_req(proxsuite::linalg::veg::Tag<T> tag,
                                     isize n,
@@ -381,13 +433,13 @@ struct RuizEquilibration
       isize n_eq = qp.AT.ncols();
       isize n_in = qp.CT.ncols();
 
-      I* Hi = qp.H.row_indices_mut();
+      I const* Hi = qp.H.row_indices();
       T* Hx = qp.H.values_mut();
 
-      I* ATi = qp.AT.row_indices_mut();
+      I const* ATi = qp.AT.row_indices();
       T* ATx = qp.AT.values_mut();
 
-      I* CTi = qp.CT.row_indices_mut();
+      I const* CTi = qp.CT.row_indices();
       T* CTx = qp.CT.values_mut();
 
       // normalize A
@@ -471,7 +523,108 @@ struct RuizEquilibration
       qp.u.to_eigen().array() *= delta.tail(n_in).array();
 
       qp.g.to_eigen() *= c;
-      qp.H.to_eigen() *= c;
+      detail::scale_values(qp.H, c);
+    }
+  }
+  /*!
+   * Unscales the matrices of a qp in place, using the current equilibrator
+   * scaling variables.
+   * @param H upper triangular part of the hessian (unscaled in place).
+   * @param AT transposed equality constraint matrix (unscaled in place).
+   * @param CT transposed inequality constraint matrix (unscaled in place).
+   */
+  void unscale_matrices_in_place(
+    proxsuite::linalg::sparse::MatValuesMut<T, I> H,
+    proxsuite::linalg::sparse::MatValuesMut<T, I> AT,
+    proxsuite::linalg::sparse::MatValuesMut<T, I> CT) const
+  {
+    using proxsuite::linalg::sparse::util::zero_extend;
+    isize n = H.nrows();
+    isize n_eq = AT.ncols();
+    isize n_in = CT.ncols();
+
+    I const* Hi = H.row_indices();
+    T* Hx = H.values_mut();
+
+    I const* ATi = AT.row_indices();
+    T* ATx = AT.values_mut();
+
+    I const* CTi = CT.row_indices();
+    T* CTx = CT.values_mut();
+
+    // unscale A
+    for (usize j = 0; j < usize(n_eq); ++j) {
+      usize col_start = AT.col_start(j);
+      usize col_end = AT.col_end(j);
+
+      T delta_j = delta(n + isize(j));
+
+      for (usize p = col_start; p < col_end; ++p) {
+        usize i = zero_extend(ATi[p]);
+        T& aji = ATx[p];
+        T delta_i = delta(isize(i));
+        aji = aji / (delta_i * delta_j);
+      }
+    }
+
+    // unscale C
+    for (usize j = 0; j < usize(n_in); ++j) {
+      usize col_start = CT.col_start(j);
+      usize col_end = CT.col_end(j);
+
+      T delta_j = delta(n + n_eq + isize(j));
+
+      for (usize p = col_start; p < col_end; ++p) {
+        usize i = zero_extend(CTi[p]);
+        T& cji = CTx[p];
+        T delta_i = delta(isize(i));
+        cji = cji / (delta_i * delta_j);
+      }
+    }
+
+    // unscale H
+    detail::unscale_values(H, c);
+    switch (sym) {
+      case Symmetry::LOWER: {
+        for (usize j = 0; j < usize(n); ++j) {
+          usize col_start = H.col_start(j);
+          usize col_end = H.col_end(j);
+          T delta_j = delta(isize(j));
+
+          if (col_end > col_start) {
+            usize p = col_end;
+            while (true) {
+              --p;
+              usize i = zero_extend(Hi[p]);
+              if (i < j) {
+                break;
+              }
+              Hx[p] = Hx[p] / (delta_j * delta(isize(i)));
+
+              if (p <= col_start) {
+                break;
+              }
+            }
+          }
+        }
+        break;
+      }
+      case Symmetry::UPPER: {
+        for (usize j = 0; j < usize(n); ++j) {
+          usize col_start = H.col_start(j);
+          usize col_end = H.col_end(j);
+          T delta_j = delta(isize(j));
+
+          for (usize p = col_start; p < col_end; ++p) {
+            usize i = zero_extend(Hi[p]);
+            if (i > j) {
+              break;
+            }
+            Hx[p] = Hx[p] / (delta_j * delta(isize(i)));
+          }
+        }
+        break;
+      }
     }
   }
 
@@ -0,0 +1,673 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/** \file */
+#ifndef PROXSUITE_QP_SPARSE_QPS_HPP
+#define PROXSUITE_QP_SPARSE_QPS_HPP
+
+#include <proxsuite/proxqp/sparse/fwd.hpp>
+#include <proxsuite/linalg/sparse/core.hpp>
+#include <proxsuite/linalg/veg/vec.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace proxsuite {
+namespace proxqp {
+namespace sparse {
+///
+/// @brief QP problem read from a QPS file.
+///
+/*!
+ * The matrices are stored in compressed column format, in the layout used by
+ * the sparse solver (upper triangular part of H, transposed constraint
+ * matrices), so that they can be given as views to QP::init without copies.
+ * The bounds on the variables are appended as the last rows of C.
+ */
+template<typename T, typename I>
+struct QpsModel
+{
+  std::string name;
+  isize dim;
+  isize n_eq;
+  isize n_in;
+
+  SparseMat<T, I> H;
+  SparseMat<T, I> AT;
+  SparseMat<T, I> CT;
+
+  Vec<T> g;
+  Vec<T> b;
+  Vec<T> u;
+  Vec<T> l;
+
+  T objective_constant;
+
+  auto H_view() const -> proxsuite::linalg::sparse::MatRef<T, I>
+  {
+    return { proxsuite::linalg::sparse::from_eigen, H };
+  }
+  auto AT_view() const -> proxsuite::linalg::sparse::MatRef<T, I>
+  {
+    return { proxsuite::linalg::sparse::from_eigen, AT };
+  }
+  auto CT_view() const -> proxsuite::linalg::sparse::MatRef<T, I>
+  {
+    return { proxsuite::linalg::sparse::from_eigen, CT };
+  }
+};
+
+namespace detail {
+namespace qps {
+
+enum struct Section
+{
+  NONE,
+  ROWS,
+  COLUMNS,
+  RHS,
+  RANGES,
+  BOUNDS,
+  QUADOBJ,
+  QMATRIX,
+  OBJSENSE,
+  SKIPPED,
+};
+
+enum struct RowType : unsigned char
+{
+  OBJECTIVE,
+  FREE,
+  EQ,
+  LE,
+  GE,
+};
+
+static constexpr isize max_tokens = 6;
+
+// splits the line in place into its whitespace separated tokens
+inline auto
+tokenize(std::string& line, char* (&tokens)[max_tokens]) -> isize
+{
+  isize n_tokens = 0;
+  char* ptr = &line[0];
+  char* end = ptr + line.size();
+  while (ptr < end) {
+    while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r')) {
+      ++ptr;
+    }
+    if (ptr == end) {
+      break;
+    }
+    PROXSUITE_THROW_PRETTY(n_tokens == max_tokens,
+                           std::runtime_error,
+                           "too many fields in the QPS line: " << line);
+    tokens[n_tokens] = ptr;
+    ++n_tokens;
+    while (ptr < end && *ptr != ' ' && *ptr != '\t' && *ptr != '\r') {
+      ++ptr;
+    }
+    *ptr = '\0';
+    ++ptr;
+  }
+  return n_tokens;
+}
+
+template<typename T>
+auto
+parse_value(char const* token) -> T
+{
+  char* end = nullptr;
+  double value = std::strtod(token, &end);
+  PROXSUITE_THROW_PRETTY(end == token || *end != '\0',
+                         std::runtime_error,
+                         "invalid numerical value in the QPS file: " << token);
+  return T(value);
+}
+
+inline auto
+find_index(std::unordered_map<std::string, isize> const& names,
+           char const* name) -> isize
+{
+  auto it = names.find(name);
+  PROXSUITE_THROW_PRETTY(it == names.end(),
+                         std::runtime_error,
+                         "unknown row or column name in the QPS file: "
+                           << name);
+  return it->second;
+}
+
+// resizes the vector, the new elements being set to value
+template<typename T>
+void
+resize_with(proxsuite::linalg::veg::Vec<T>& vec, isize n, T value)
+{
+  isize old_len = vec.len();
+  vec.resize(n);
+  for (isize k = old_len; k < n; ++k) {
+    vec[k] = value;
+  }
+}
+
+inline auto
+section_of(char const* keyword) -> Section
+{
+  struct
+  {
+    char const* keyword;
+    Section section;
+  } const sections[] = {
+    { "ROWS", Section::ROWS },         { "COLUMNS", Section::COLUMNS },
+    { "RHS", Section::RHS },           { "RANGES", Section::RANGES },
+    { "BOUNDS", Section::BOUNDS },     { "QUADOBJ", Section::QUADOBJ },
+    { "QSECTION", Section::QMATRIX },  { "QMATRIX", Section::QMATRIX },
+    { "OBJSENSE", Section::OBJSENSE },
+  };
+  for (auto const& s : sections) {
+    if (std::strcmp(keyword, s.keyword) == 0) {
+      return s.section;
+    }
+  }
+  return Section::SKIPPED;
+}
+
+} // namespace qps
+} // namespace detail
+
+/*!
+ * Reads a QP problem from a stream in the (free) QPS format, i.e., the MPS
+ * format extended with a QUADOBJ (or QMATRIX) section for the hessian. The
+ * problem is read in a single pass, the entries being stored once in a
+ * compressed format and then transposed into the matrices of the model.
+ *
+ * The data lines must be indented, the names must not contain spaces. The
+ * first N row is the objective, the other ones are ignored. The objective
+ * constant is the opposite of the right hand side of the objective row.
+ * The default bounds of the variables are [0, +inf), an UP bound with a
+ * negative value and a zero lower bound makes the variable unbounded below.
+ * The integrality markers are ignored. The entries of the quadratic objective
+ * may be given in any order, and by either of their triangular parts.
+ * @param in input stream.
+ */
+template<typename T, typename I>
+auto
+read_qps(std::istream& in) -> QpsModel<T, I>
+{
+  using namespace detail::qps;
+  using proxsuite::linalg::veg::Vec;
+  T const inf = std::numeric_limits<T>::infinity();
+
+  QpsModel<T, I> qps;
+  qps.objective_constant = T(0);
+  bool maximize = false;
+
+  std::unordered_map<std::string, isize> row_names;
+  std::unordered_map<std::string, isize> col_names;
+  Vec<RowType> row_types;
+  Vec<T> rhs;
+  Vec<T> ranges;
+  Vec<bool> has_range;
+  isize obj_row = -1;
+
+  // A is stored by columns (i.e., by variables) as they are read
+  Vec<I> A_col_nnz;
+  Vec<I> A_row_indices;
+  Vec<T> A_values;
+  Vec<T> g;
+  std::string last_col;
+
+  // the entries of the upper triangular part of H are stored as they are read
+  Vec<I> H_row_indices;
+  Vec<I> H_col_indices;
+  Vec<T> H_values;
+
+  Vec<T> lb;
+  Vec<T> ub;
+
+  Section section = Section::NONE;
+  std::string line;
+  char* tokens[max_tokens];
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '*') {
+      continue;
+    }
+    bool header = line[0] != ' ' && line[0] != '\t';
+    isize n_tokens = tokenize(line, tokens);
+    if (n_tokens == 0) {
+      continue;
+    }
+    if (header) {
+      if (std::strcmp(tokens[0], "ENDATA") == 0) {
+        break;
+      }
+      if (std::strcmp(tokens[0], "NAME") == 0) {
+        qps.name = n_tokens > 1 ? tokens[1] : "";
+        section = Section::NONE;
+        continue;
+      }
+      section = section_of(tokens[0]);
+      if (std::strcmp(tokens[0], "QSECTION") == 0 && n_tokens > 1 &&
+          find_index(row_names, tokens[1]) != obj_row) {
+        // the quadratic constraints are not supported
+        section = Section::SKIPPED;
+      }
+      if (section == Section::OBJSENSE && n_tokens > 1) {
+        maximize = std::strncmp(tokens[1], "MAX", 3) == 0;
+      }
+      if (section == Section::BOUNDS) {
+        resize_with(lb, A_col_nnz.len(), T(0));
+        resize_with(ub, A_col_nnz.len(), inf);
+      }
+      continue;
+    }
+
+    switch (section) {
+      case Section::ROWS: {
+        RowType type;
+        switch (tokens[0][0]) {
+          case 'N':
+            type = obj_row < 0 ? RowType::OBJECTIVE : RowType::FREE;
+            break;
+          case 'E':
+            type = RowType::EQ;
+            break;
+          case 'L':
+            type = RowType::LE;
+            break;
+          case 'G':
+            type = RowType::GE;
+            break;
+          default:
+            PROXSUITE_THROW_PRETTY(true,
+                                   std::runtime_error,
+                                   "invalid row type in the QPS file: "
+                                     << tokens[0]);
+        }
+        PROXSUITE_THROW_PRETTY(n_tokens < 2,
+                               std::runtime_error,
+                               "missing row name in the QPS file.");
+        isize r = row_types.len();
+        if (type == RowType::OBJECTIVE) {
+          obj_row = r;
+        }
+        PROXSUITE_THROW_PRETTY(!row_names.emplace(tokens[1], r).second,
+                               std::runtime_error,
+                               "duplicate row name in the QPS file: "
+                                 << tokens[1]);
+        row_types.push(type);
+        rhs.push(T(0));
+        ranges.push(T(0));
+        has_range.push(false);
+        break;
+      }
+      case Section::COLUMNS: {
+        if (n_tokens >= 3 && std::strcmp(tokens[1], "'MARKER'") == 0) {
+          break;
+        }
+        PROXSUITE_THROW_PRETTY(n_tokens != 3 && n_tokens != 5,
+                               std::runtime_error,
+                               "invalid COLUMNS line in the QPS file.");
+        if (last_col != tokens[0]) {
+          PROXSUITE_THROW_PRETTY(
+            !col_names.emplace(tokens[0], A_col_nnz.len()).second,
+            std::runtime_error,
+            "the entries of the column " << tokens[0]
+                                         << " are not contiguous in the QPS "
+                                            "file.");
+          last_col = tokens[0];
+          A_col_nnz.push(I(0));
+          g.push(T(0));
+        }
+        isize j = A_col_nnz.len() - 1;
+        for (isize k = 1; k + 1 < n_tokens; k += 2) {
+          isize r = find_index(row_names, tokens[k]);
+          T value = parse_value<T>(tokens[k + 1]);
+          switch (row_types[r]) {
+            case RowType::OBJECTIVE:
+              g[j] += value;
+              break;
+            case RowType::FREE:
+              break;
+            default:
+              A_row_indices.push(I(r));
+              A_values.push(value);
+              A_col_nnz[j] += I(1);
+          }
+        }
+        break;
+      }
+      case Section::RHS:
+      case Section::RANGES: {
+        // the name of the vector is optional
+        for (isize k = n_tokens % 2; k + 1 < n_tokens; k += 2) {
+          isize r = find_index(row_names, tokens[k]);
+          T value = parse_value<T>(tokens[k + 1]);
+          if (section == Section::RHS) {
+            rhs[r] = value;
+          } else {
+            ranges[r] = value;
+            has_range[r] = true;
+          }
+        }
+        break;
+      }
+      case Section::BOUNDS: {
+        char const* type = tokens[0];
+        bool has_value = !(std::strcmp(type, "FR") == 0 ||
+                           std::strcmp(type, "MI") == 0 ||
+                           std::strcmp(type, "PL") == 0 ||
+                           std::strcmp(type, "BV") == 0);
+        // the name of the bound vector is optional
+        isize k = (n_tokens == 4 || (!has_value && n_tokens == 3)) ? 2 : 1;
+        PROXSUITE_THROW_PRETTY(
+          k >= n_tokens || (has_value && k + 1 >= n_tokens),
+          std::runtime_error,
+          "invalid BOUNDS line in the QPS file.");
+        isize j = find_index(col_names, tokens[k]);
+        T value = has_value ? parse_value<T>(tokens[k + 1]) : T(0);
+        if (std::strcmp(type, "UP") == 0 || std::strcmp(type, "UI") == 0) {
+          ub[j] = value;
+          if (value < T(0) && lb[j] == T(0)) {
+            lb[j] = -inf;
+          }
+        } else if (std::strcmp(type, "LO") == 0 ||
+                   std::strcmp(type, "LI") == 0) {
+          lb[j] = value;
+        } else if (std::strcmp(type, "FX") == 0) {
+          lb[j] = value;
+          ub[j] = value;
+        } else if (std::strcmp(type, "FR") == 0) {
+          lb[j] = -inf;
+          ub[j] = inf;
+        } else if (std::strcmp(type, "MI") == 0) {
+          lb[j] = -inf;
+        } else if (std::strcmp(type, "PL") == 0) {
+          ub[j] = inf;
+        } else if (std::strcmp(type, "BV") == 0) {
+          lb[j] = T(0);
+          ub[j] = T(1);
+        } else {
+          PROXSUITE_THROW_PRETTY(true,
+                                 std::runtime_error,
+                                 "invalid bound type in the QPS file: "
+                                   << type);
+        }
+        break;
+      }
+      case Section::QUADOBJ:
+      case Section::QMATRIX: {
+        PROXSUITE_THROW_PRETTY(n_tokens != 3,
+                               std::runtime_error,
+                               "invalid quadratic objective line in the QPS "
+                               "file.");
+        isize i = find_index(col_names, tokens[0]);
+        isize j = find_index(col_names, tokens[1]);
+        if (j < i) {
+          if (section == Section::QMATRIX) {
+            // both triangular parts are given, only the upper one is kept
+            break;
+          }
+          std::swap(i, j);
+        }
+        H_row_indices.push(I(i));
+        H_col_indices.push(I(j));
+        H_values.push(parse_value<T>(tokens[2]));
+        break;
+      }
+      case Section::OBJSENSE: {
+        maximize = std::strncmp(tokens[0], "MAX", 3) == 0;
+        break;
+      }
+      case Section::SKIPPED:
+        break;
+      case Section::NONE:
+        PROXSUITE_THROW_PRETTY(true,
+                               std::runtime_error,
+                               "data line outside of a section in the QPS "
+                               "file.");
+    }
+  }
+  PROXSUITE_THROW_PRETTY(in.bad(),
+                         std::runtime_error,
+                         "reading the QPS file failed.");
+  PROXSUITE_THROW_PRETTY(obj_row < 0,
+                         std::runtime_error,
+                         "the QPS file has no objective row.");
+
+  isize n = A_col_nnz.len();
+  isize n_rows = row_types.len();
+  resize_with(lb, n, T(0));
+  resize_with(ub, n, inf);
+
+  // dispatches the rows between the equality and the inequality constraints,
+  // the ranged equality rows being inequalities
+  Vec<isize> col_of;
+  Vec<bool> is_eq;
+  resize_with(col_of, n_rows, isize(-1));
+  is_eq.resize(n_rows);
+  isize n_eq = 0;
+  isize n_in = 0;
+  for (isize r = 0; r < n_rows; ++r) {
+    RowType type = row_types[r];
+    if (type == RowType::OBJECTIVE || type == RowType::FREE) {
+      continue;
+    }
+    if (type == RowType::EQ && !has_range[r]) {
+      is_eq[r] = true;
+      col_of[r] = n_eq++;
+    } else {
+      col_of[r] = n_in++;
+    }
+  }
+  isize n_rows_in = n_in;
+  for (isize j = 0; j < n; ++j) {
+    if (lb[j] > -inf || ub[j] < inf) {
+      ++n_in;
+    }
+  }
+
+  qps.dim = n;
+  qps.n_eq = n_eq;
+  qps.n_in = n_in;
+  qps.g = Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1> const>(g.ptr(), n);
+  qps.b.resize(n_eq);
+  qps.l.resize(n_in);
+  qps.u.resize(n_in);
+  qps.objective_constant = -rhs[obj_row];
+  for (isize r = 0; r < n_rows; ++r) {
+    if (col_of[r] < 0) {
+      continue;
+    }
+    isize k = col_of[r];
+    T range = std::abs(ranges[r]);
+    if (is_eq[r]) {
+      qps.b[k] = rhs[r];
+      continue;
+    }
+    switch (row_types[r]) {
+      case RowType::EQ:
+        qps.l[k] = ranges[r] < T(0) ? rhs[r] - range : rhs[r];
+        qps.u[k] = ranges[r] < T(0) ? rhs[r] : rhs[r] + range;
+        break;
+      case RowType::LE:
+        qps.l[k] = has_range[r] ? rhs[r] - range : -inf;
+        qps.u[k] = rhs[r];
+        break;
+      default:
+        qps.l[k] = rhs[r];
+        qps.u[k] = has_range[r] ? rhs[r] + range : inf;
+    }
+  }
+
+  PROXSUITE_THROW_PRETTY(
+    A_values.len() + n > isize(std::numeric_limits<I>::max()) ||
+      H_values.len() > isize(std::numeric_limits<I>::max()),
+    std::runtime_error,
+    "the number of entries of the QPS file overflows the index type.");
+
+  // counts the entries of the columns of AT and CT, then transposes A
+  Vec<I> pos;
+  pos.resize(n_rows);
+  for (isize p = 0; p < A_row_indices.len(); ++p) {
+    pos[isize(A_row_indices[p])] += I(1);
+  }
+  qps.AT.resize(n, n_eq);
+  qps.CT.resize(n, n_in);
+  I* AT_col_ptrs = qps.AT.outerIndexPtr();
+  I* CT_col_ptrs = qps.CT.outerIndexPtr();
+  AT_col_ptrs[0] = I(0);
+  CT_col_ptrs[0] = I(0);
+  for (isize r = 0; r < n_rows; ++r) {
+    if (col_of[r] < 0) {
+      continue;
+    }
+    I* col_ptrs = is_eq[r] ? AT_col_ptrs : CT_col_ptrs;
+    isize k = col_of[r];
+    col_ptrs[k + 1] = I(col_ptrs[k] + pos[r]);
+    pos[r] = col_ptrs[k];
+  }
+  {
+    isize k = n_rows_in;
+    for (isize j = 0; j < n; ++j) {
+      if (lb[j] > -inf || ub[j] < inf) {
+        CT_col_ptrs[k + 1] = I(CT_col_ptrs[k] + 1);
+        ++k;
+      }
+    }
+  }
+  qps.AT.resizeNonZeros(isize(AT_col_ptrs[n_eq]));
+  qps.CT.resizeNonZeros(isize(CT_col_ptrs[n_in]));
+  {
+    // both matrices are filled in one pass over A
+    I* AT_rows = qps.AT.innerIndexPtr();
+    T* AT_values = qps.AT.valuePtr();
+    I* CT_rows = qps.CT.innerIndexPtr();
+    T* CT_values = qps.CT.valuePtr();
+    isize p = 0;
+    for (isize j = 0; j < n; ++j) {
+      isize p_end = p + isize(A_col_nnz[j]);
+      for (; p < p_end; ++p) {
+        isize r = isize(A_row_indices[p]);
+        isize q = isize(pos[r]);
+        if (is_eq[r]) {
+          AT_rows[q] = I(j);
+          AT_values[q] = A_values[p];
+        } else {
+          CT_rows[q] = I(j);
+          CT_values[q] = A_values[p];
+        }
+        pos[r] = I(q + 1);
+      }
+    }
+    // the bounds on the variables
+    isize k = n_rows_in;
+    for (isize j = 0; j < n; ++j) {
+      if (lb[j] > -inf || ub[j] < inf) {
+        isize q = isize(CT_col_ptrs[k]);
+        CT_rows[q] = I(j);
+        CT_values[q] = T(1);
+        qps.l[k] = lb[j];
+        qps.u[k] = ub[j];
+        ++k;
+      }
+    }
+  }
+  // the storage of A is released before assembling H
+  A_row_indices = Vec<I>{};
+  A_values = Vec<T>{};
+
+  // the entries of H, which may come in any order, are sorted by rows, then
+  // the rows of its upper triangular part are transposed into its columns, so
+  // that the row indices of each column are sorted
+  isize H_nnz = H_values.len();
+  Vec<I> H_row_nnz;
+  Vec<I> H_pos;
+  H_row_nnz.resize(n);
+  H_pos.resize(n);
+  for (isize p = 0; p < H_nnz; ++p) {
+    H_row_nnz[isize(H_row_indices[p])] += I(1);
+  }
+  for (isize i = 0, q = 0; i < n; ++i) {
+    H_pos[i] = I(q);
+    q += isize(H_row_nnz[i]);
+  }
+  {
+    Vec<I> by_rows_col_indices;
+    Vec<T> by_rows_values;
+    by_rows_col_indices.resize(H_nnz);
+    by_rows_values.resize(H_nnz);
+    for (isize p = 0; p < H_nnz; ++p) {
+      isize i = isize(H_row_indices[p]);
+      isize q = isize(H_pos[i]);
+      by_rows_col_indices[q] = H_col_indices[p];
+      by_rows_values[q] = H_values[p];
+      H_pos[i] = I(q + 1);
+    }
+    H_row_indices = Vec<I>{};
+    H_col_indices = std::move(by_rows_col_indices);
+    H_values = std::move(by_rows_values);
+  }
+  for (isize j = 0; j < n; ++j) {
+    H_pos[j] = I(0);
+  }
+  for (isize p = 0; p < H_nnz; ++p) {
+    H_pos[isize(H_col_indices[p])] += I(1);
+  }
+  qps.H.resize(n, n);
+  I* H_col_ptrs = qps.H.outerIndexPtr();
+  H_col_ptrs[0] = I(0);
+  for (isize j = 0; j < n; ++j) {
+    H_col_ptrs[j + 1] = I(H_col_ptrs[j] + H_pos[j]);
+    H_pos[j] = H_col_ptrs[j];
+  }
+  qps.H.resizeNonZeros(isize(H_col_ptrs[n]));
+  {
+    I* H_rows = qps.H.innerIndexPtr();
+    T* H_values_out = qps.H.valuePtr();
+    isize p = 0;
+    for (isize i = 0; i < n; ++i) {
+      isize p_end = p + isize(H_row_nnz[i]);
+      for (; p < p_end; ++p) {
+        isize j = isize(H_col_indices[p]);
+        isize q = isize(H_pos[j]);
+        H_rows[q] = I(i);
+        H_values_out[q] = H_values[p];
+        H_pos[j] = I(q + 1);
+      }
+    }
+  }
+
+  if (maximize) {
+    qps.g = -qps.g;
+    qps.H = -qps.H;
+    qps.objective_constant = -qps.objective_constant;
+  }
+  return qps;
+}
+
+/*!
+ * Reads a QP problem from a file in the (free) QPS format.
+ * @param path path of the QPS file.
+ */
+template<typename T, typename I>
+auto
+read_qps(std::string const& path) -> QpsModel<T, I>
+{
+  std::ifstream in(path);
+  PROXSUITE_THROW_PRETTY(!in,
+                         std::runtime_error,
+                         "the QPS file " << path << " could not be opened.");
+  return read_qps<T, I>(in);
+}
+
+} // namespace sparse
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_SPARSE_QPS_HPP */
@@ -16,16 +16,20 @@
 #include <proxsuite/proxqp/settings.hpp>
 #include <proxsuite/linalg/veg/vec.hpp>
 #include "proxsuite/proxqp/results.hpp"
+#include "proxsuite/proxqp/observer.hpp"
+#include "proxsuite/proxqp/trace.hpp"
 #include "proxsuite/proxqp/sparse/fwd.hpp"
 #include "proxsuite/proxqp/sparse/views.hpp"
 #include "proxsuite/proxqp/sparse/model.hpp"
 #include "proxsuite/proxqp/sparse/workspace.hpp"
 #include "proxsuite/proxqp/sparse/utils.hpp"
+#include "proxsuite/proxqp/sparse/interior_point.hpp"
 #include "proxsuite/proxqp/sparse/preconditioner/ruiz.hpp"
 #include "proxsuite/proxqp/sparse/preconditioner/identity.hpp"
 
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <Eigen/IterativeLinearSolvers>
 #include <unsupported/Eigen/IterativeSolvers>
 
@@ -101,7 +105,7 @@ ldl_iter_solve_noalias(
   I* ldl_col_ptrs,
   I const* perm_inv,
   Settings<T> const& settings,
-  proxsuite::linalg::sparse::MatMut<T, I> kkt_active,
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active,
   proxsuite::linalg::veg::SliceMut<bool> active_constraints)
 {
   auto rhs_e = rhs.to_eigen();
@@ -205,7 +209,7 @@ ldl_solve_in_place(
   I* ldl_col_ptrs,
   I const* perm_inv,
   Settings<T> const& settings,
-  proxsuite::linalg::sparse::MatMut<T, I> kkt_active,
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active,
   proxsuite::linalg::veg::SliceMut<bool> active_constraints)
 {
   LDLT_TEMP_VEC_UNINIT(T, tmp, n_tot, stack);
@@ -291,7 +295,7 @@ reconstruction_error(proxsuite::linalg::sparse::MatMut<T, I> ldl,
                      Results<T> const& results,
                      Model<T, I> const& data,
                      isize n_tot,
-                     proxsuite::linalg::sparse::MatMut<T, I> kkt_active,
+                     proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active,
                      proxsuite::linalg::veg::SliceMut<bool> active_constraints)
   -> DMat<T>
 {
@@ -320,7 +324,109 @@ struct PrimalDualGradResult
 };
 
 /*!
- * Executes the PROXQP algorithm.
+ * Factorizes the regularized KKT matrix with the inequalities active at the
+ * initial guess. With the sparse LDLT, the factorization is restored from the
+ * factorization cache when it was already computed for the same active set
+ * and proximal parameters (see Settings::factorization_cache_max_bytes).
+ *
+ * @param work solver workspace.
+ * @param results solver results.
+ * @param kkt_active active part of the KKT matrix.
+ * @param active_constraints active set of the initial guess.
+ * @param data QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param settings solver settings.
+ * @param stack memory stack of the workspace.
+ * @param xtag tag of the scalar type.
+ */
+template<typename T, typename I>
+void
+setup_active_set_factorization(
+  Workspace<T, I>& work,
+  Results<T> const& results,
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active,
+  proxsuite::linalg::veg::SliceMut<bool> active_constraints,
+  Model<T, I> const& data,
+  const Settings<T>& settings,
+  proxsuite::linalg::veg::dynstack::DynStackMut stack,
+  proxsuite::linalg::veg::Tag<T>& xtag)
+{
+  namespace util = proxsuite::linalg::sparse::util;
+  auto zx = util::zero_extend;
+
+  isize max_bytes = settings.factorization_cache_max_bytes;
+  bool cached = max_bytes > 0 && work.internal.do_ldlt;
+  isize n_tot = kkt_active.ncols();
+  isize n_in = data.n_in;
+  T rho = results.info.rho;
+  T mu_eq = results.info.mu_eq;
+  T mu_in = results.info.mu_in;
+  auto& cache = work.internal.factorization_cache;
+  auto& ldl = work.internal.ldl;
+  I const* col_ptrs = ldl.col_ptrs.ptr();
+  if (cached) {
+    CachedFactorization<T, I> const* entry =
+      cache.find(active_constraints.as_const(), n_in, rho, mu_eq, mu_in);
+    if (entry != nullptr) {
+      std::copy_n(entry->etree.ptr(), n_tot, ldl.etree.ptr_mut());
+      std::copy_n(entry->nnz_counts.ptr(), n_tot, ldl.nnz_counts.ptr_mut());
+      isize pos = 0;
+      for (isize j = 0; j < n_tot; ++j) {
+        isize start = isize(zx(col_ptrs[j]));
+        isize len = isize(zx(entry->nnz_counts[j]));
+        std::copy_n(entry->row_indices.ptr() + pos,
+                    len,
+                    ldl.row_indices.ptr_mut() + start);
+        std::copy_n(
+          entry->values.ptr() + pos, len, ldl.values.ptr_mut() + start);
+        pos += len;
+      }
+      return;
+    }
+  }
+  sparse::refactorize<T, I>(
+    work, results, kkt_active, active_constraints, data, stack, xtag);
+  if (cached) {
+    I const* nnz_counts = ldl.nnz_counts.ptr();
+    isize nnz = 0;
+    for (isize j = 0; j < n_tot; ++j) {
+      nnz += isize(zx(nnz_counts[j]));
+    }
+    isize bytes = nnz * isize(sizeof(T) + sizeof(I)) +
+                  2 * n_tot * isize(sizeof(I));
+    cache.insert(active_constraints.as_const(),
+                 n_in,
+                 rho,
+                 mu_eq,
+                 mu_in,
+                 bytes,
+                 max_bytes,
+                 [&](CachedFactorization<T, I>& entry) {
+                   entry.etree.resize_for_overwrite(n_tot);
+                   entry.nnz_counts.resize_for_overwrite(n_tot);
+                   entry.row_indices.resize_for_overwrite(nnz);
+                   entry.values.resize_for_overwrite(nnz);
+                   std::copy_n(ldl.etree.ptr(), n_tot, entry.etree.ptr_mut());
+                   std::copy_n(nnz_counts, n_tot, entry.nnz_counts.ptr_mut());
+                   isize pos = 0;
+                   for (isize j = 0; j < n_tot; ++j) {
+                     isize start = isize(zx(col_ptrs[j]));
+                     isize len = isize(zx(nnz_counts[j]));
+                     std::copy_n(ldl.row_indices.ptr() + start,
+                                 len,
+                                 entry.row_indices.ptr_mut() + pos);
+                     std::copy_n(ldl.values.ptr() + start,
+                                 len,
+                                 entry.values.ptr_mut() + pos);
+                     pos += len;
+                   }
+                 });
+  }
+}
+/*!
+ * Starts a solve: sets up the scaled vectors of the model. The factorization
+ * and the initial guess are set by the first call to qp_solve_step, which then
+ * runs the iterations.
  *
  * @param work solver workspace.
  * @param model QP problem model as defined by the user (without any scaling
@@ -331,49 +437,23 @@ struct PrimalDualGradResult
  */
 template<typename T, typename I, typename P>
 void
-qp_solve(Results<T>& results,
-         Model<T, I>& data,
-         const Settings<T>& settings,
-         Workspace<T, I>& work,
-         P& precond)
+qp_solve_begin(Results<T>& results,
+               Model<T, I>& data,
+               const Settings<T>& settings,
+               Workspace<T, I>& work,
+               P& precond)
 {
   if (settings.compute_timings) {
     work.timer.stop();
     work.timer.start();
   }
+  work.internal.deadline.start(settings.time_limit, settings.deadline);
 
   if (work.internal
         .dirty) // the following is used when a solve has already been executed
                 // (and without any intermediary model update)
   {
-    proxsuite::linalg::sparse::MatMut<T, I> kkt_unscaled =
-      data.kkt_mut_unscaled();
-
-    auto kkt_top_n_rows = detail::top_rows_mut_unchecked(
-      proxsuite::linalg::veg::unsafe, kkt_unscaled, data.dim);
-
-    proxsuite::linalg::sparse::MatMut<T, I> H_unscaled =
-      detail::middle_cols_mut(kkt_top_n_rows, 0, data.dim, data.H_nnz);
-
-    proxsuite::linalg::sparse::MatMut<T, I> AT_unscaled =
-      detail::middle_cols_mut(kkt_top_n_rows, data.dim, data.n_eq, data.A_nnz);
-
-    proxsuite::linalg::sparse::MatMut<T, I> CT_unscaled =
-      detail::middle_cols_mut(
-        kkt_top_n_rows, data.dim + data.n_eq, data.n_in, data.C_nnz);
-
-    SparseMat<T, I> H_triu =
-      H_unscaled.to_eigen().template triangularView<Eigen::Upper>();
-    sparse::QpView<T, I> qp = {
-      { proxsuite::linalg::sparse::from_eigen, H_triu },
-      { proxsuite::linalg::sparse::from_eigen, data.g },
-      { proxsuite::linalg::sparse::from_eigen, AT_unscaled.to_eigen() },
-      { proxsuite::linalg::sparse::from_eigen, data.b },
-      { proxsuite::linalg::sparse::from_eigen, CT_unscaled.to_eigen() },
-      { proxsuite::linalg::sparse::from_eigen, data.l },
-      { proxsuite::linalg::sparse::from_eigen, data.u }
-    };
-
+    results.info.phase_timings.clear();
     switch (settings.initial_guess) { // the following is used when one solve
                                       // has already been executed
       case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
@@ -419,15 +499,31 @@ qp_solve(Results<T>& results,
         break;
       }
     }
-    work.setup_impl(
-      qp,
-      data,
-      settings,
-      false,
-      precond,
-      P::scale_qp_in_place_req(
-        proxsuite::linalg::veg::Tag<T>{}, data.dim, data.n_eq, data.n_in));
-
+    // the scaled matrices of the kkt are left unchanged by a solve: only the
+    // scaled vectors are set anew from the model (without any allocation)
+    PhaseTimer<T> timer(results.info.phase_timings, Phase::EQUILIBRATION);
+    auto& internal = work.internal;
+    internal.g_scaled = data.g;
+    internal.b_scaled = data.b;
+    internal.u_scaled =
+      (data.u.array() <= T(1.E20))
+        .select(data.u,
+                Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(data.n_in).array() +
+                  T(1.E20));
+    internal.l_scaled =
+      (data.l.array() >= T(-1.E20))
+        .select(data.l,
+                Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(data.n_in).array() -
+                  T(1.E20));
+    precond.scale_dual_residual_in_place(
+      { proxsuite::proxqp::from_eigen, internal.g_scaled });
+    precond.scale_primal_residual_in_place_eq(
+      { proxsuite::proxqp::from_eigen, internal.b_scaled });
+    precond.scale_primal_residual_in_place_in(
+      { proxsuite::proxqp::from_eigen, internal.u_scaled });
+    precond.scale_primal_residual_in_place_in(
+      { proxsuite::proxqp::from_eigen, internal.l_scaled });
+    internal.dirty = false;
   } else {
     // the following is used for a first solve after initializing or updating
     // the Qp object
@@ -475,6 +571,173 @@ qp_solve(Results<T>& results,
   if (settings.verbose) {
     sparse::print_setup_header(settings, results, data);
   }
+  work.internal.solve_state.start(
+    settings.alpha_bcl, settings.eps_abs, settings.polish_eps_abs);
+  if (settings.compute_timings) {
+    work.timer.stop();
+  }
+}
+/*!
+ * Finishes a solve: unscales the results, computes the objective value and
+ * prints the statistics of the solve.
+ *
+ * @param results solver results.
+ * @param data QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param settings solver settings.
+ * @param work solver workspace.
+ * @param precond preconditioner.
+ * @param qp_scaled view on the scaled QP problem.
+ * @param stack memory stack.
+ */
+template<typename T, typename I, typename P>
+void
+qp_solve_end(Results<T>& results,
+             Model<T, I>& data,
+             const Settings<T>& settings,
+             Workspace<T, I>& work,
+             P& precond,
+             QpView<T, I> qp_scaled,
+             proxsuite::linalg::veg::dynstack::DynStackMut stack)
+{
+  Vec<T>& x = results.x;
+  Vec<T>& y = results.y;
+  Vec<T>& z = results.z;
+  LDLT_TEMP_VEC_UNINIT(T, tmp, data.dim, stack);
+  tmp.setZero();
+  detail::noalias_symhiv_add(tmp, qp_scaled.H.to_eigen(), x);
+  precond.unscale_dual_residual_in_place({ proxqp::from_eigen, tmp });
+
+  precond.unscale_primal_in_place({ proxqp::from_eigen, x });
+  precond.unscale_dual_in_place_eq({ proxqp::from_eigen, y });
+  precond.unscale_dual_in_place_in({ proxqp::from_eigen, z });
+  tmp *= 0.5;
+  tmp += data.g;
+  results.info.objValue = (tmp).dot(x);
+
+  if (settings.compute_timings) {
+    results.info.solve_time = work.timer.elapsed().user; // in nanoseconds
+    results.info.run_time = results.info.solve_time + results.info.setup_time;
+    if (settings.verbose) {
+      std::cout << "-------------------SOLVER STATISTICS-------------------"
+                << std::endl;
+      std::cout << "outer iter:   " << results.info.iter_ext << std::endl;
+      std::cout << "total iter:   " << results.info.iter << std::endl;
+      std::cout << "mu updates:   " << results.info.mu_updates << std::endl;
+      std::cout << "rho updates:  " << results.info.rho_updates << std::endl;
+      std::cout << "objective:    " << results.info.objValue << std::endl;
+      switch (results.info.status) {
+        case QPSolverOutput::PROXQP_SOLVED: {
+          std::cout << "status:       "
+                    << "Solved" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
+          std::cout << "status:       "
+                    << "Maximum number of iterations reached" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Primal infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Dual infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_TIME_LIMIT_REACHED: {
+          std::cout << "status:       "
+                    << "Time limit reached" << std::endl;
+          break;
+        }
+      }
+      std::cout << "run time:     " << results.info.solve_time << std::endl;
+      std::cout << "--------------------------------------------------------"
+                << std::endl;
+    }
+  } else {
+    if (settings.verbose) {
+      std::cout << "-------------------SOLVER STATISTICS-------------------"
+                << std::endl;
+      std::cout << "outer iter:   " << results.info.iter_ext << std::endl;
+      std::cout << "total iter:   " << results.info.iter << std::endl;
+      std::cout << "mu updates:   " << results.info.mu_updates << std::endl;
+      std::cout << "rho updates:  " << results.info.rho_updates << std::endl;
+      std::cout << "objective:    " << results.info.objValue << std::endl;
+      switch (results.info.status) {
+        case QPSolverOutput::PROXQP_SOLVED: {
+          std::cout << "status:       "
+                    << "Solved." << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
+          std::cout << "status:       "
+                    << "Maximum number of iterations reached" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Primal infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
+          std::cout << "status:       "
+                    << "Dual infeasible" << std::endl;
+          break;
+        }
+        case QPSolverOutput::PROXQP_TIME_LIMIT_REACHED: {
+          std::cout << "status:       "
+                    << "Time limit reached" << std::endl;
+          break;
+        }
+      }
+      std::cout << "--------------------------------------------------------"
+                << std::endl;
+    }
+  }
+
+  work.set_dirty();
+  work.internal.solve_state.done = true;
+}
+/*!
+ * Runs iterations of a solve started by qp_solve_begin, until the solve is
+ * finished or max_inner_iters inner iterations (Newton steps of PROXQP, or
+ * iterations of the interior-point method) have been run by the call. A step
+ * may return in the middle of an outer iteration, whose inner loop is then
+ * resumed by the next step. Once the solve is finished, the results are
+ * unscaled.
+ *
+ * @param work solver workspace.
+ * @param model QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param settings solver settings.
+ * @param results solver results.
+ * @param precond preconditioner.
+ * @param max_inner_iters number of inner iterations after which the step
+ * returns (at least one is run).
+ * @param observer callable receiving the IterationRecord of each outer
+ * iteration (by default, nothing is recorded).
+ * @return true once the solve is finished.
+ */
+template<typename T, typename I, typename P, typename Observer = NullObserver>
+bool
+qp_solve_step(Results<T>& results,
+              Model<T, I>& data,
+              const Settings<T>& settings,
+              Workspace<T, I>& work,
+              P& precond,
+              isize max_inner_iters,
+              Observer&& observer = Observer{})
+{
+  SolveState<T>& state = work.internal.solve_state;
+  if (state.done) {
+    return true;
+  }
+  if (settings.compute_timings) {
+    work.timer.resume();
+  }
   using namespace proxsuite::linalg::veg::literals;
   namespace util = proxsuite::linalg::sparse::util;
   auto zx = util::zero_extend;
@@ -490,18 +753,18 @@ qp_solve(Results<T>& results,
   VectorViewMut<T> y{ proxqp::from_eigen, results.y };
   VectorViewMut<T> z{ proxqp::from_eigen, results.z };
 
-  proxsuite::linalg::sparse::MatMut<T, I> kkt = data.kkt_mut();
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt = data.kkt_mut();
 
   auto kkt_top_n_rows =
     detail::top_rows_mut_unchecked(proxsuite::linalg::veg::unsafe, kkt, n);
 
-  proxsuite::linalg::sparse::MatMut<T, I> H_scaled =
+  proxsuite::linalg::sparse::MatValuesMut<T, I> H_scaled =
     detail::middle_cols_mut(kkt_top_n_rows, 0, n, data.H_nnz);
 
-  proxsuite::linalg::sparse::MatMut<T, I> AT_scaled =
+  proxsuite::linalg::sparse::MatValuesMut<T, I> AT_scaled =
     detail::middle_cols_mut(kkt_top_n_rows, n, n_eq, data.A_nnz);
 
-  proxsuite::linalg::sparse::MatMut<T, I> CT_scaled =
+  proxsuite::linalg::sparse::MatValuesMut<T, I> CT_scaled =
     detail::middle_cols_mut(kkt_top_n_rows, n + n_eq, n_in, data.C_nnz);
 
   auto& g_scaled_e = work.internal.g_scaled;
@@ -549,106 +812,116 @@ qp_solve(Results<T>& results,
 
   auto& iterative_solver = *work.internal.matrix_free_solver.get();
   isize C_active_nnz = 0;
-  switch (settings.initial_guess) {
-    case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
-      // H and A are always active
-      for (usize j = 0; j < usize(n + n_eq); ++j) {
-        kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
-      }
-      // ineq constraints initially inactive
-      for (isize j = 0; j < n_in; ++j) {
-        kkt_nnz_counts[n + n_eq + j] = 0;
-        results.active_constraints[j] = false;
-      }
-      break;
+  if (state.initialized) {
+    // active set of the previous step
+    for (isize j = 0; j < n_in; ++j) {
+      C_active_nnz += isize(zx(kkt_nnz_counts[n + n_eq + j]));
     }
-    case InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT: {
-      // keep solutions + restart workspace and results except rho and mu : done
-      // in setup
-
-      // H and A are always active
-      for (usize j = 0; j < usize(n + n_eq); ++j) {
-        kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
-      }
-      // keep constraints inactive from previous solution
-      for (isize j = 0; j < n_in; ++j) {
-        if (results.z(j) != 0) {
-          kkt_nnz_counts[n + n_eq + j] = I(kkt.col_end(usize(n + n_eq + j)) -
-                                           kkt.col_start(usize(n + n_eq + j)));
-          results.active_constraints[j] = true;
-          C_active_nnz += kkt_nnz_counts[n + n_eq + j];
-        } else {
+  } else {
+    switch (settings.initial_guess) {
+      case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
+        // H and A are always active
+        for (usize j = 0; j < usize(n + n_eq); ++j) {
+          kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
+        }
+        // ineq constraints initially inactive
+        for (isize j = 0; j < n_in; ++j) {
           kkt_nnz_counts[n + n_eq + j] = 0;
           results.active_constraints[j] = false;
         }
+        break;
       }
-      break;
-    }
-    case InitialGuessStatus::NO_INITIAL_GUESS: {
-      // already set to zero in the setup
-      // H and A are always active
-      for (usize j = 0; j < usize(n + n_eq); ++j) {
-        kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
-      }
-      // ineq constraints initially inactive
-      for (isize j = 0; j < n_in; ++j) {
-        kkt_nnz_counts[n + n_eq + j] = 0;
-        results.active_constraints[j] = false;
-      }
-      break;
-    }
-    case InitialGuessStatus::WARM_START: {
-      // keep previous solution
+      case InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT: {
+        // keep solutions + restart workspace and results except rho and mu :
+        // done in setup
 
-      // H and A are always active
-      for (usize j = 0; j < usize(n + n_eq); ++j) {
-        kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
+        // H and A are always active
+        for (usize j = 0; j < usize(n + n_eq); ++j) {
+          kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
+        }
+        // keep constraints inactive from previous solution
+        for (isize j = 0; j < n_in; ++j) {
+          if (results.z(j) != 0) {
+            kkt_nnz_counts[n + n_eq + j] =
+              I(kkt.col_end(usize(n + n_eq + j)) -
+                kkt.col_start(usize(n + n_eq + j)));
+            results.active_constraints[j] = true;
+            C_active_nnz += kkt_nnz_counts[n + n_eq + j];
+          } else {
+            kkt_nnz_counts[n + n_eq + j] = 0;
+            results.active_constraints[j] = false;
+          }
+        }
+        break;
       }
-      // keep constraints inactive from previous solution
-      for (isize j = 0; j < n_in; ++j) {
-        if (results.z(j) != 0) {
-          kkt_nnz_counts[n + n_eq + j] = I(kkt.col_end(usize(n + n_eq + j)) -
-                                           kkt.col_start(usize(n + n_eq + j)));
-          results.active_constraints[j] = true;
-          C_active_nnz += kkt_nnz_counts[n + n_eq + j];
-
-        } else {
+      case InitialGuessStatus::NO_INITIAL_GUESS: {
+        // already set to zero in the setup
+        // H and A are always active
+        for (usize j = 0; j < usize(n + n_eq); ++j) {
+          kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
+        }
+        // ineq constraints initially inactive
+        for (isize j = 0; j < n_in; ++j) {
           kkt_nnz_counts[n + n_eq + j] = 0;
           results.active_constraints[j] = false;
         }
+        break;
       }
-      break;
-    }
-    case InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT: {
-      // keep workspace and results solutions except statistics
-      // H and A are always active
-      for (usize j = 0; j < usize(n + n_eq); ++j) {
-        kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
+      case InitialGuessStatus::WARM_START: {
+        // keep previous solution
+
+        // H and A are always active
+        for (usize j = 0; j < usize(n + n_eq); ++j) {
+          kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
+        }
+        // keep constraints inactive from previous solution
+        for (isize j = 0; j < n_in; ++j) {
+          if (results.z(j) != 0) {
+            kkt_nnz_counts[n + n_eq + j] =
+              I(kkt.col_end(usize(n + n_eq + j)) -
+                kkt.col_start(usize(n + n_eq + j)));
+            results.active_constraints[j] = true;
+            C_active_nnz += kkt_nnz_counts[n + n_eq + j];
+
+          } else {
+            kkt_nnz_counts[n + n_eq + j] = 0;
+            results.active_constraints[j] = false;
+          }
+        }
+        break;
       }
-      // keep constraints inactive from previous solution
-      for (isize j = 0; j < n_in; ++j) {
-        if (results.z(j) != 0) {
-          kkt_nnz_counts[n + n_eq + j] = I(kkt.col_end(usize(n + n_eq + j)) -
-                                           kkt.col_start(usize(n + n_eq + j)));
-          results.active_constraints[j] = true;
-          C_active_nnz += kkt_nnz_counts[n + n_eq + j];
-        } else {
-          kkt_nnz_counts[n + n_eq + j] = 0;
-          results.active_constraints[j] = false;
+      case InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT: {
+        // keep workspace and results solutions except statistics
+        // H and A are always active
+        for (usize j = 0; j < usize(n + n_eq); ++j) {
+          kkt_nnz_counts[isize(j)] = I(kkt.col_end(j) - kkt.col_start(j));
         }
+        // keep constraints inactive from previous solution
+        for (isize j = 0; j < n_in; ++j) {
+          if (results.z(j) != 0) {
+            kkt_nnz_counts[n + n_eq + j] =
+              I(kkt.col_end(usize(n + n_eq + j)) -
+                kkt.col_start(usize(n + n_eq + j)));
+            results.active_constraints[j] = true;
+            C_active_nnz += kkt_nnz_counts[n + n_eq + j];
+          } else {
+            kkt_nnz_counts[n + n_eq + j] = 0;
+            results.active_constraints[j] = false;
+          }
+        }
+        break;
       }
-      break;
     }
   }
 
-  proxsuite::linalg::sparse::MatMut<T, I> kkt_active = {
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active = {
     proxsuite::linalg::sparse::from_raw_parts,
     n_tot,
     n_tot,
     data.H_nnz + data.A_nnz + C_active_nnz,
-    kkt.col_ptrs_mut(),
+    kkt.col_ptrs(),
     kkt_nnz_counts,
-    kkt.row_indices_mut(),
+    kkt.row_indices(),
     kkt.values_mut(),
   };
 
@@ -670,66 +943,126 @@ qp_solve(Results<T>& results,
     ldl_values,
   };
 
-  T bcl_eta_ext_init = pow(T(0.1), settings.alpha_bcl);
-  T bcl_eta_ext = bcl_eta_ext_init;
-  T bcl_eta_in(1);
-  T eps_in_min = std::min(settings.eps_abs, T(1e-9));
+  T& bcl_eta_ext_init = state.bcl_eta_ext_init;
+  T& bcl_eta_ext = state.bcl_eta_ext;
+  T& bcl_eta_in = state.bcl_eta_in;
+  T& eps_in_min = state.eps_in_min;
+  T& polish_eps = state.polish_eps;
+  // last step size of the inner loop, for the observer
+  T& last_alpha = state.last_alpha;
 
   auto x_e = x.to_eigen();
   auto y_e = y.to_eigen();
   auto z_e = z.to_eigen();
-  sparse::refactorize<T, I>(
-    work, results, kkt_active, active_constraints, data, stack, xtag);
-  switch (settings.initial_guess) {
-    case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
-      LDLT_TEMP_VEC_UNINIT(T, rhs, n_tot, stack);
-      LDLT_TEMP_VEC_UNINIT(T, no_guess, 0, stack);
-
-      rhs.head(n) = -g_scaled_e;
-      rhs.segment(n, n_eq) = b_scaled_e;
-      rhs.segment(n + n_eq, n_in).setZero();
-
-      ldl_solve_in_place({ proxqp::from_eigen, rhs },
-                         { proxqp::from_eigen, no_guess },
-                         results,
-                         data,
-                         n_tot,
-                         ldl,
-                         iterative_solver,
-                         do_ldlt,
-                         stack,
-                         ldl_values,
-                         perm,
-                         ldl_col_ptrs,
-                         perm_inv,
-                         settings,
-                         kkt_active,
-                         active_constraints);
-      x_e = rhs.head(n);
-      y_e = rhs.segment(n, n_eq);
-      z_e = rhs.segment(n + n_eq, n_in);
-      break;
+  AndersonAcceleration<T>& anderson = work.internal.anderson;
+  // the interior-point method requires the sparse LDLT factorization: with
+  // the matrix free solver, PROXQP is used instead
+  bool use_interior_point =
+    settings.method == SolverMethod::INTERIOR_POINT && do_ldlt;
+  if (!state.initialized) {
+    {
+      PhaseTimer<T> timer(results.info.phase_timings, Phase::FACTORIZATION);
+      trace::Span span("setup_factorization");
+      sparse::setup_active_set_factorization<T, I>(work,
+                                                   results,
+                                                   kkt_active,
+                                                   active_constraints,
+                                                   data,
+                                                   settings,
+                                                   stack,
+                                                   xtag);
     }
-    case InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT: {
-      // keep solutions but restart workspace and results
-      break;
+    switch (settings.initial_guess) {
+      case InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS: {
+        LDLT_TEMP_VEC_UNINIT(T, rhs, n_tot, stack);
+        LDLT_TEMP_VEC_UNINIT(T, no_guess, 0, stack);
+
+        rhs.head(n) = -g_scaled_e;
+        rhs.segment(n, n_eq) = b_scaled_e;
+        rhs.segment(n + n_eq, n_in).setZero();
+
+        PhaseTimer<T> timer(results.info.phase_timings,
+                            Phase::ITERATIVE_REFINEMENT);
+        trace::Span span("iterative_refinement");
+        ldl_solve_in_place({ proxqp::from_eigen, rhs },
+                           { proxqp::from_eigen, no_guess },
+                           results,
+                           data,
+                           n_tot,
+                           ldl,
+                           iterative_solver,
+                           do_ldlt,
+                           stack,
+                           ldl_values,
+                           perm,
+                           ldl_col_ptrs,
+                           perm_inv,
+                           settings,
+                           kkt_active,
+                           active_constraints);
+        x_e = rhs.head(n);
+        y_e = rhs.segment(n, n_eq);
+        z_e = rhs.segment(n + n_eq, n_in);
+        break;
+      }
+      case InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT: {
+        // keep solutions but restart workspace and results
+        break;
+      }
+      case InitialGuessStatus::NO_INITIAL_GUESS: {
+        // already set to zero in the setup
+        break;
+      }
+      case InitialGuessStatus::WARM_START: {
+        // keep previous solution
+        break;
+      }
+      case InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT: {
+        // keep workspace and results solutions except statistics
+        break;
+      }
     }
-    case InitialGuessStatus::NO_INITIAL_GUESS: {
-      // already set to zero in the setup
-      break;
+    if (settings.anderson_acceleration) {
+      anderson.resize(n_tot, settings.anderson_memory);
     }
-    case InitialGuessStatus::WARM_START: {
-      // keep previous solution
-      break;
+    if (work.internal.deadline.is_set()) {
+      work.internal.best.resize(n, n_eq, n_in);
     }
-    case InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT: {
-      // keep workspace and results solutions except statistics
-      break;
+    if (use_interior_point) {
+      work.internal.interior_point.resize(n, n_eq, n_in, kkt.nnz());
+    } else {
+      work.internal.outer_iteration.resize(n, n_eq, n_in);
+    }
+    state.initialized = true;
+  }
+  // a step runs at most max_inner_iters Newton steps (and at least one, so
+  // that the solve makes progress)
+  isize budget = std::max(max_inner_iters, isize(1));
+  if (use_interior_point) {
+    if (!interior_point::step(results,
+                              data,
+                              settings,
+                              work,
+                              precond,
+                              qp_scaled.as_const(),
+                              stack,
+                              budget,
+                              observer)) {
+      // the interior-point method is resumed by the next step
+      if (settings.compute_timings) {
+        work.timer.stop();
+      }
+      return false;
     }
+    qp_solve_end(
+      results, data, settings, work, precond, qp_scaled.as_const(), stack);
+    return true;
   }
-  for (isize iter = 0; iter < settings.max_iter; ++iter) {
+  OuterIteration<T>& outer = work.internal.outer_iteration;
+  for (; state.iter < settings.max_iter; ++state.iter) {
+    isize const iter = state.iter;
+    trace::Span iteration_span("outer_iteration", iter);
 
-    results.info.iter_ext += 1;
     if (iter == settings.max_iter) {
       break;
     }
@@ -746,11 +1079,20 @@ qp_solve(Results<T>& results,
       T dual_feasibility_rhs_1(0);
       T dual_feasibility_rhs_3(0);
 
-      LDLT_TEMP_VEC_UNINIT(T, primal_residual_eq_scaled, n_eq, stack);
-      LDLT_TEMP_VEC_UNINIT(T, primal_residual_in_scaled_lo, n_in, stack);
-      LDLT_TEMP_VEC_UNINIT(T, primal_residual_in_scaled_up, n_in, stack);
-
-      LDLT_TEMP_VEC_UNINIT(T, dual_residual_scaled, n, stack);
+      auto primal_residual_eq_scaled =
+        detail::vec_mut(outer.primal_residual_eq_scaled);
+      auto primal_residual_in_scaled_lo =
+        detail::vec_mut(outer.primal_residual_in_scaled_lo);
+      auto primal_residual_in_scaled_up =
+        detail::vec_mut(outer.primal_residual_in_scaled_up);
+      auto dual_residual_scaled = detail::vec_mut(outer.dual_residual_scaled);
+      auto x_prev_e = detail::vec_mut(outer.x_prev);
+      auto y_prev_e = detail::vec_mut(outer.y_prev);
+      auto z_prev_e = detail::vec_mut(outer.z_prev);
+      auto dw_prev = detail::vec_mut(outer.dw_prev);
+      // residuals at the start of the outer iteration
+      T& primal_feasibility_lhs = state.primal_feasibility_lhs;
+      T& dual_feasibility_lhs = state.dual_feasibility_lhs;
 
       // vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv
       auto is_primal_feasible = [&](T primal_feasibility_lhs) -> bool {
@@ -781,101 +1123,256 @@ qp_solve(Results<T>& results,
       };
       // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
 
-      VEG_BIND( // ?
-        auto,
-        (primal_feasibility_lhs, dual_feasibility_lhs),
-        detail::unscaled_primal_dual_residual(primal_residual_eq_scaled,
-                                              primal_residual_in_scaled_lo,
-                                              primal_residual_in_scaled_up,
-                                              dual_residual_scaled,
-                                              primal_feasibility_eq_rhs_0,
-                                              primal_feasibility_in_rhs_0,
-                                              dual_feasibility_rhs_0,
-                                              dual_feasibility_rhs_1,
-                                              dual_feasibility_rhs_3,
-                                              precond,
-                                              data,
-                                              qp_scaled.as_const(),
-                                              detail::vec(x_e),
-                                              detail::vec(y_e),
-                                              detail::vec(z_e),
-                                              stack));
-      /*put in debug mode
-      if (settings.verbose) {
-              std::cout << "-------- outer iteration: " << iter << " primal
-      residual "
-                                                      << primal_feasibility_lhs
-      << " dual residual "
-                                                      << dual_feasibility_lhs <<
-      " mu_in " << results.info.mu_in
-                                                      << " bcl_eta_ext " <<
-      bcl_eta_ext << " bcl_eta_in "
-                                                      << bcl_eta_in <<
-      std::endl;
-      }
-      */
-      if (settings.verbose) {
-        LDLT_TEMP_VEC_UNINIT(T, tmp, n, stack);
-        tmp.setZero();
-        detail::noalias_symhiv_add(tmp, qp_scaled.H.to_eigen(), x_e);
-        precond.unscale_dual_residual_in_place({ proxqp::from_eigen, tmp });
-
-        precond.unscale_primal_in_place({ proxqp::from_eigen, x_e });
-        precond.unscale_dual_in_place_eq({ proxqp::from_eigen, y_e });
-        precond.unscale_dual_in_place_in({ proxqp::from_eigen, z_e });
-        tmp *= 0.5;
-        tmp += data.g;
-        results.info.objValue = (tmp).dot(x_e);
-        std::cout << "\033[1;32m[outer iteration " << iter + 1 << "]\033[0m"
-                  << std::endl;
-        std::cout << std::scientific << std::setw(2) << std::setprecision(2)
-                  << "| primal residual=" << primal_feasibility_lhs
-                  << "| dual residual=" << dual_feasibility_lhs
-                  << " | mu_in=" << results.info.mu_in
-                  << " | rho=" << results.info.rho << std::endl;
-        results.info.pri_res = primal_feasibility_lhs;
-        results.info.dua_res = dual_feasibility_lhs;
-        precond.scale_primal_in_place(VectorViewMut<T>{ from_eigen, x_e });
-        precond.scale_dual_in_place_eq(VectorViewMut<T>{ from_eigen, y_e });
-        precond.scale_dual_in_place_in(VectorViewMut<T>{ from_eigen, z_e });
-      }
-      if (is_primal_feasible(primal_feasibility_lhs) &&
-          is_dual_feasible(dual_feasibility_lhs)) {
-        results.info.pri_res = primal_feasibility_lhs;
-        results.info.dua_res = dual_feasibility_lhs;
-        results.info.status = QPSolverOutput::PROXQP_SOLVED;
-        break;
-      }
+      auto unscaled_primal_dual_residual = [&]() {
+        PhaseTimer<T> timer(results.info.phase_timings, Phase::RESIDUALS);
+        return detail::unscaled_primal_dual_residual(
+          primal_residual_eq_scaled,
+          primal_residual_in_scaled_lo,
+          primal_residual_in_scaled_up,
+          dual_residual_scaled,
+          primal_feasibility_eq_rhs_0,
+          primal_feasibility_in_rhs_0,
+          dual_feasibility_rhs_0,
+          dual_feasibility_rhs_1,
+          dual_feasibility_rhs_3,
+          precond,
+          data,
+          qp_scaled.as_const(),
+          detail::vec(x_e),
+          detail::vec(y_e),
+          detail::vec(z_e),
+          stack);
+      };
+      // vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv
+      // solves the equality constrained QP problem of the active set (each
+      // active inequality constraint being set to the bound of the sign of
+      // its multiplier) with the current factorization, by iterative
+      // refinement against the unregularized KKT matrix. The polished iterate
+      // is kept if its multipliers have the signs of their bounds and if it
+      // reduces the residuals.
+      auto polish = [&]() -> bool {
+        PhaseTimer<T> timer(results.info.phase_timings, Phase::POLISH);
+        trace::Span span("polish");
+        LDLT_TEMP_VEC_UNINIT(T, rhs, n_tot, stack);
+        LDLT_TEMP_VEC(T, sol, n_tot, stack);
+        LDLT_TEMP_VEC_UNINIT(T, err, n_tot, stack);
+
+        auto CT_e = CT_scaled.to_eigen();
+        rhs.head(n) = -g_scaled_e;
+        rhs.segment(n, n_eq) = b_scaled_e;
+        for (isize i = 0; i < n_in; ++i) {
+          if (!active_constraints[i]) {
+            rhs(n + n_eq + i) = 0;
+            continue;
+          }
+          T c_i = CT_e.col(i).dot(x_e);
+          bool upper = z_e(i) > 0 || (z_e(i) == 0 && u_scaled_e(i) - c_i <=
+                                                       c_i - l_scaled_e(i));
+          rhs(n + n_eq + i) = upper ? u_scaled_e(i) : l_scaled_e(i);
+        }
 
-      LDLT_TEMP_VEC_UNINIT(T, x_prev_e, n, stack);
-      LDLT_TEMP_VEC_UNINIT(T, y_prev_e, n_eq, stack);
-      LDLT_TEMP_VEC_UNINIT(T, z_prev_e, n_in, stack);
-      LDLT_TEMP_VEC(T, dw_prev, n_tot, stack);
+        err = rhs;
+        T prev_err_norm = std::numeric_limits<T>::infinity();
+        for (isize it = 0; it < settings.polish_refine_iter; ++it) {
+          T err_norm = infty_norm(err);
+          if (err_norm > prev_err_norm / T(2)) {
+            break;
+          }
+          prev_err_norm = err_norm;
+          ldl_solve({ proxqp::from_eigen, err },
+                    { proxqp::from_eigen, err },
+                    n_tot,
+                    ldl,
+                    iterative_solver,
+                    do_ldlt,
+                    stack,
+                    ldl_values,
+                    perm,
+                    ldl_col_ptrs,
+                    perm_inv);
+          sol += err;
+
+          // err = rhs - K sol, with the unregularized KKT matrix K (whose
+          // rows of the inactive constraints are replaced by the identity)
+          err = -rhs;
+          detail::noalias_symhiv_add(err, kkt_active.to_eigen(), sol);
+          for (isize i = 0; i < n_in; ++i) {
+            if (!active_constraints[i]) {
+              err(n + n_eq + i) += sol(n + n_eq + i);
+            }
+          }
+          err = -err;
+        }
 
-      x_prev_e = x_e;
-      y_prev_e = y_e;
-      z_prev_e = z_e;
+        // the multipliers must have the signs of their bounds
+        for (isize i = 0; i < n_in; ++i) {
+          if (active_constraints[i]) {
+            T z_i = sol(n + n_eq + i);
+            T bound = rhs(n + n_eq + i);
+            if ((z_i > 0 && bound != u_scaled_e(i)) ||
+                (z_i < 0 && bound != l_scaled_e(i))) {
+              return false;
+            }
+          }
+        }
 
-      // Cx + 1/mu_in * z_prev
-      primal_residual_in_scaled_up += results.info.mu_in * z_prev_e;
-      primal_residual_in_scaled_lo = primal_residual_in_scaled_up;
+        LDLT_TEMP_VEC_UNINIT(T, x_save, n, stack);
+        LDLT_TEMP_VEC_UNINIT(T, y_save, n_eq, stack);
+        LDLT_TEMP_VEC_UNINIT(T, z_save, n_in, stack);
+        x_save = x_e;
+        y_save = y_e;
+        z_save = z_e;
+        x_e = sol.head(n);
+        y_e = sol.segment(n, n_eq);
+        z_e = sol.segment(n + n_eq, n_in);
+
+        VEG_BIND(auto,
+                 (primal_feasibility_lhs_new, dual_feasibility_lhs_new),
+                 unscaled_primal_dual_residual());
+        if (std::max(primal_feasibility_lhs_new, dual_feasibility_lhs_new) <
+            std::max(primal_feasibility_lhs, dual_feasibility_lhs)) {
+          primal_feasibility_lhs = primal_feasibility_lhs_new;
+          dual_feasibility_lhs = dual_feasibility_lhs_new;
+          return true;
+        }
+        x_e = x_save;
+        y_e = y_save;
+        z_e = z_save;
+        unscaled_primal_dual_residual();
+        return false;
+      };
+      // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+      if (!state.in_inner_loop) {
+        results.info.iter_ext += 1;
+        {
+          VEG_BIND(auto,
+                   (primal_feasibility_lhs_0, dual_feasibility_lhs_0),
+                   unscaled_primal_dual_residual());
+          primal_feasibility_lhs = primal_feasibility_lhs_0;
+          dual_feasibility_lhs = dual_feasibility_lhs_0;
+        }
+        if (settings.polish &&
+            std::max(primal_feasibility_lhs, dual_feasibility_lhs) <=
+              polish_eps &&
+            std::max(primal_feasibility_lhs, dual_feasibility_lhs) >
+              settings.eps_abs) {
+          // the next polishing is tried on a more accurate active set
+          polish_eps /= T(100);
+          results.info.polished = polish();
+        }
+        if (is_observing<Observer>()) {
+          isize n_active = 0;
+          for (isize i = 0; i < n_in; ++i) {
+            n_active += isize(active_constraints[i]);
+          }
+          observer(make_iteration_record(iter,
+                                         primal_feasibility_lhs,
+                                         dual_feasibility_lhs,
+                                         results.info,
+                                         n_active,
+                                         last_alpha));
+        }
+        /*put in debug mode
+        if (settings.verbose) {
+                std::cout << "-------- outer iteration: " << iter << " primal
+        residual "
+                                                        << primal_feasibility_lhs
+        << " dual residual "
+                                                        << dual_feasibility_lhs <<
+        " mu_in " << results.info.mu_in
+                                                        << " bcl_eta_ext " <<
+        bcl_eta_ext << " bcl_eta_in "
+                                                        << bcl_eta_in <<
+        std::endl;
+        }
+        */
+        if (settings.verbose) {
+          LDLT_TEMP_VEC_UNINIT(T, tmp, n, stack);
+          tmp.setZero();
+          detail::noalias_symhiv_add(tmp, qp_scaled.H.to_eigen(), x_e);
+          precond.unscale_dual_residual_in_place({ proxqp::from_eigen, tmp });
+
+          precond.unscale_primal_in_place({ proxqp::from_eigen, x_e });
+          precond.unscale_dual_in_place_eq({ proxqp::from_eigen, y_e });
+          precond.unscale_dual_in_place_in({ proxqp::from_eigen, z_e });
+          tmp *= 0.5;
+          tmp += data.g;
+          results.info.objValue = (tmp).dot(x_e);
+          std::cout << "\033[1;32m[outer iteration " << iter + 1 << "]\033[0m"
+                    << std::endl;
+          std::cout << std::scientific << std::setw(2) << std::setprecision(2)
+                    << "| primal residual=" << primal_feasibility_lhs
+                    << "| dual residual=" << dual_feasibility_lhs
+                    << " | mu_in=" << results.info.mu_in
+                    << " | rho=" << results.info.rho << std::endl;
+          results.info.pri_res = primal_feasibility_lhs;
+          results.info.dua_res = dual_feasibility_lhs;
+          precond.scale_primal_in_place(VectorViewMut<T>{ from_eigen, x_e });
+          precond.scale_dual_in_place_eq(VectorViewMut<T>{ from_eigen, y_e });
+          precond.scale_dual_in_place_in(VectorViewMut<T>{ from_eigen, z_e });
+        }
+        if (is_primal_feasible(primal_feasibility_lhs) &&
+            is_dual_feasible(dual_feasibility_lhs)) {
+          results.info.pri_res = primal_feasibility_lhs;
+          results.info.dua_res = dual_feasibility_lhs;
+          results.info.status = QPSolverOutput::PROXQP_SOLVED;
+          break;
+        }
+        if (work.internal.deadline.is_set()) {
+          BestIterate<T>& best = work.internal.best;
+          best.update(x_e,
+                      y_e,
+                      z_e,
+                      primal_feasibility_lhs,
+                      dual_feasibility_lhs,
+                      std::max(primal_feasibility_lhs, dual_feasibility_lhs));
+          if (work.internal.deadline.reached()) {
+            x_e = best.x;
+            y_e = best.y;
+            z_e = best.z;
+            results.info.pri_res = best.pri_res;
+            results.info.dua_res = best.dua_res;
+            results.info.status = QPSolverOutput::PROXQP_TIME_LIMIT_REACHED;
+            break;
+          }
+        }
+
+        x_prev_e = x_e;
+        y_prev_e = y_e;
+        z_prev_e = z_e;
+        dw_prev.setZero();
 
-      // Cx - l + 1/mu_in * z_prev
-      primal_residual_in_scaled_lo -= l_scaled_e;
+        // Cx + 1/mu_in * z_prev
+        primal_residual_in_scaled_up += results.info.mu_in * z_prev_e;
+        primal_residual_in_scaled_lo = primal_residual_in_scaled_up;
 
-      // Cx - u + 1/mu_in * z_prev
-      primal_residual_in_scaled_up -= u_scaled_e;
+        // Cx - l + 1/mu_in * z_prev
+        primal_residual_in_scaled_lo -= l_scaled_e;
+
+        // Cx - u + 1/mu_in * z_prev
+        primal_residual_in_scaled_up -= u_scaled_e;
+        state.in_inner_loop = true;
+        state.inner_iter = 0;
+      }
 
       // vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv
-      auto primal_dual_newton_semi_smooth = [&]() -> void {
-        for (isize iter_inner = 0; iter_inner < settings.max_iter_in;
-             ++iter_inner) {
+      // runs Newton steps while the budget of the step allows it, and
+      // returns whether the loop is finished (or else suspended, and resumed
+      // by the next step from state.inner_iter)
+      auto primal_dual_newton_semi_smooth = [&]() -> bool {
+        isize& iter_inner = state.inner_iter;
+        for (; iter_inner < settings.max_iter_in; ++iter_inner) {
+          trace::Span newton_span("newton_step", iter_inner);
           LDLT_TEMP_VEC_UNINIT(T, dw, n_tot, stack);
 
           if (iter_inner == settings.max_iter_in - 1) {
             results.info.iter += settings.max_iter_in;
             break;
           }
+          if (budget == 0) {
+            return false;
+          }
+          --budget;
 
           // primal_dual_semi_smooth_newton_step
           {
@@ -890,6 +1387,9 @@ qp_solve(Results<T>& results,
 
             // active set change
             if (n_in > 0) {
+              PhaseTimer<T> timer(results.info.phase_timings,
+                                  Phase::ACTIVE_SET_UPDATE);
+              trace::Span span("active_set_change");
               bool removed = false;
               bool added = false;
 
@@ -942,6 +1442,8 @@ qp_solve(Results<T>& results,
 
               if (!do_ldlt) {
                 if (removed || added) {
+                  PhaseTimer<T> timer(results.info.phase_timings,
+                                      Phase::REFACTORIZATION);
                   refactorize(work,
                               results,
                               kkt_active,
@@ -969,6 +1471,9 @@ qp_solve(Results<T>& results,
               }
             }
 
+            PhaseTimer<T> timer(results.info.phase_timings,
+                                Phase::ITERATIVE_REFINEMENT);
+            trace::Span span("iterative_refinement");
             ldl_solve_in_place(
               { proxqp::from_eigen, rhs },
               { proxqp::from_eigen,
@@ -1007,6 +1512,7 @@ qp_solve(Results<T>& results,
           T alpha = 1;
           // primal dual line search
           if (n_in > 0) {
+            PhaseTimer<T> timer(results.info.phase_timings, Phase::LINE_SEARCH);
             auto primal_dual_gradient_norm =
               [&](T alpha_cur) -> PrimalDualGradResult<T> {
               LDLT_TEMP_VEC_UNINIT(T, Cdx_active, n_in, stack);
@@ -1118,9 +1624,10 @@ qp_solve(Results<T>& results,
               alpha = -res.b / res.a;
             }
           }
+          last_alpha = alpha;
           if (alpha * infty_norm(dw) < T(1e-11) && iter_inner > 0) {
             results.info.iter += iter_inner + 1;
-            return;
+            return true;
           }
 
           x_e += alpha * dx;
@@ -1158,7 +1665,7 @@ qp_solve(Results<T>& results,
           }
           if (err_in <= bcl_eta_in) {
             results.info.iter += iter_inner + 1;
-            return;
+            return true;
           }
 
           // compute primal and dual infeasibility criteria
@@ -1190,11 +1697,25 @@ qp_solve(Results<T>& results,
             dw_prev = dw;
             break;
           }
+          if (work.internal.deadline.reached()) {
+            // the outer loop returns the best iterate
+            results.info.iter += iter_inner + 1;
+            return true;
+          }
         }
+        return true;
       };
       // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
 
-      primal_dual_newton_semi_smooth();
+      if (!primal_dual_newton_semi_smooth()) {
+        // the inner loop is resumed by the next step
+        if (settings.compute_timings) {
+          work.timer.stop();
+        }
+        return false;
+      }
+      state.in_inner_loop = false;
+      results.info.polished = false;
       if (results.info.status == QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE ||
           results.info.status == QPSolverOutput::PROXQP_DUAL_INFEASIBLE) {
         // certificate of infeasibility
@@ -1203,28 +1724,24 @@ qp_solve(Results<T>& results,
         results.z = dw_prev.tail(data.n_in);
         break;
       }
+      if (work.internal.deadline.reached()) {
+        // the inner iterate is not checked: the best iterate is returned, and
+        // the proximal parameters are not updated (nor the factorization)
+        BestIterate<T> const& best = work.internal.best;
+        x_e = best.x;
+        y_e = best.y;
+        z_e = best.z;
+        results.info.pri_res = best.pri_res;
+        results.info.dua_res = best.dua_res;
+        results.info.status = QPSolverOutput::PROXQP_TIME_LIMIT_REACHED;
+        break;
+      }
       // VEG bind : met le résultat tuple de unscaled_primal_dual_residual dans
       // (primal_feasibility_lhs_new, dual_feasibility_lhs_new) en guessant leur
       // type via auto
-      VEG_BIND(
-        auto,
-        (primal_feasibility_lhs_new, dual_feasibility_lhs_new),
-        detail::unscaled_primal_dual_residual(primal_residual_eq_scaled,
-                                              primal_residual_in_scaled_lo,
-                                              primal_residual_in_scaled_up,
-                                              dual_residual_scaled,
-                                              primal_feasibility_eq_rhs_0,
-                                              primal_feasibility_in_rhs_0,
-                                              dual_feasibility_rhs_0,
-                                              dual_feasibility_rhs_1,
-                                              dual_feasibility_rhs_3,
-                                              precond,
-                                              data,
-                                              qp_scaled.as_const(),
-                                              detail::vec(x_e),
-                                              detail::vec(y_e),
-                                              detail::vec(z_e),
-                                              stack));
+      VEG_BIND(auto,
+               (primal_feasibility_lhs_new, dual_feasibility_lhs_new),
+               unscaled_primal_dual_residual());
 
       if (is_primal_feasible(primal_feasibility_lhs_new) &&
           is_dual_feasible(dual_feasibility_lhs_new)) {
@@ -1263,25 +1780,9 @@ qp_solve(Results<T>& results,
       // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
       bcl_update();
 
-      VEG_BIND(
-        auto,
-        (_, dual_feasibility_lhs_new_2),
-        detail::unscaled_primal_dual_residual(primal_residual_eq_scaled,
-                                              primal_residual_in_scaled_lo,
-                                              primal_residual_in_scaled_up,
-                                              dual_residual_scaled,
-                                              primal_feasibility_eq_rhs_0,
-                                              primal_feasibility_in_rhs_0,
-                                              dual_feasibility_rhs_0,
-                                              dual_feasibility_rhs_1,
-                                              dual_feasibility_rhs_3,
-                                              precond,
-                                              data,
-                                              qp_scaled.as_const(),
-                                              detail::vec(x_e),
-                                              detail::vec(y_e),
-                                              detail::vec(z_e),
-                                              stack));
+      VEG_BIND(auto,
+               (_, dual_feasibility_lhs_new_2),
+               unscaled_primal_dual_residual());
       proxsuite::linalg::veg::unused(_);
 
       if (primal_feasibility_lhs_new >= primal_feasibility_lhs && //
@@ -1292,12 +1793,62 @@ qp_solve(Results<T>& results,
         new_bcl_mu_in_inv = settings.cold_reset_mu_in_inv;
         new_bcl_mu_eq_inv = settings.cold_reset_mu_eq_inv;
       }
+
+      // vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv
+      // Anderson acceleration of the outer loop (see AndersonAcceleration):
+      // the extrapolated iterate is kept if it increases neither the primal
+      // nor the dual residual (otherwise, the memory is cleared)
+      auto anderson_step = [&]() -> bool {
+        anderson.set_parameters(
+          results.info.mu_eq, results.info.mu_in, results.info.rho);
+        if (new_bcl_mu_eq != results.info.mu_eq ||
+            new_bcl_mu_in != results.info.mu_in) {
+          // the next outer iteration solves another proximal subproblem
+          anderson.reset();
+          return false;
+        }
+
+        anderson.w.head(n) = x_prev_e;
+        anderson.w.segment(n, n_eq) = y_prev_e;
+        anderson.w.tail(n_in) = z_prev_e;
+        anderson.g.head(n) = x_e;
+        anderson.g.segment(n, n_eq) = y_e;
+        anderson.g.tail(n_in) = z_e;
+        if (!anderson.step(T(1.e-10))) {
+          return false;
+        }
+        x_e = anderson.w.head(n);
+        y_e = anderson.w.segment(n, n_eq);
+        z_e = anderson.w.tail(n_in);
+
+        VEG_BIND(auto,
+                 (primal_feasibility_lhs_acc, dual_feasibility_lhs_acc),
+                 unscaled_primal_dual_residual());
+        if (primal_feasibility_lhs_acc <= primal_feasibility_lhs_new &&
+            dual_feasibility_lhs_acc <= dual_feasibility_lhs_new_2) {
+          return true;
+        }
+
+        // the residuals are computed again at the start of the next outer
+        // iteration
+        x_e = anderson.g.head(n);
+        y_e = anderson.g.segment(n, n_eq);
+        z_e = anderson.g.tail(n_in);
+        anderson.reset();
+        return false;
+      };
+      // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+      if (settings.anderson_acceleration) {
+        anderson_step();
+      }
     }
     if (results.info.mu_in != new_bcl_mu_in ||
         results.info.mu_eq != new_bcl_mu_eq) {
       {
         ++results.info.mu_updates;
       }
+      PhaseTimer<T> timer(results.info.phase_timings, Phase::REFACTORIZATION);
+      trace::Span span("mu_update");
       /*
       refactorize(
                       work,
@@ -1338,92 +1889,41 @@ qp_solve(Results<T>& results,
     results.info.mu_eq_inv = new_bcl_mu_eq_inv;
     results.info.mu_in_inv = new_bcl_mu_in_inv;
   }
-  LDLT_TEMP_VEC_UNINIT(T, tmp, n, stack);
-  tmp.setZero();
-  detail::noalias_symhiv_add(tmp, qp_scaled.H.to_eigen(), x_e);
-  precond.unscale_dual_residual_in_place({ proxqp::from_eigen, tmp });
-
-  precond.unscale_primal_in_place({ proxqp::from_eigen, x_e });
-  precond.unscale_dual_in_place_eq({ proxqp::from_eigen, y_e });
-  precond.unscale_dual_in_place_in({ proxqp::from_eigen, z_e });
-  tmp *= 0.5;
-  tmp += data.g;
-  results.info.objValue = (tmp).dot(x_e);
-
-  if (settings.compute_timings) {
-    results.info.solve_time = work.timer.elapsed().user; // in nanoseconds
-    results.info.run_time = results.info.solve_time + results.info.setup_time;
-    if (settings.verbose) {
-      std::cout << "-------------------SOLVER STATISTICS-------------------"
-                << std::endl;
-      std::cout << "outer iter:   " << results.info.iter_ext << std::endl;
-      std::cout << "total iter:   " << results.info.iter << std::endl;
-      std::cout << "mu updates:   " << results.info.mu_updates << std::endl;
-      std::cout << "rho updates:  " << results.info.rho_updates << std::endl;
-      std::cout << "objective:    " << results.info.objValue << std::endl;
-      switch (results.info.status) {
-        case QPSolverOutput::PROXQP_SOLVED: {
-          std::cout << "status:       "
-                    << "Solved" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
-          std::cout << "status:       "
-                    << "Maximum number of iterations reached" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Primal infeasible" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Dual infeasible" << std::endl;
-          break;
-        }
-      }
-      std::cout << "run time:     " << results.info.solve_time << std::endl;
-      std::cout << "--------------------------------------------------------"
-                << std::endl;
-    }
-  } else {
-    if (settings.verbose) {
-      std::cout << "-------------------SOLVER STATISTICS-------------------"
-                << std::endl;
-      std::cout << "outer iter:   " << results.info.iter_ext << std::endl;
-      std::cout << "total iter:   " << results.info.iter << std::endl;
-      std::cout << "mu updates:   " << results.info.mu_updates << std::endl;
-      std::cout << "rho updates:  " << results.info.rho_updates << std::endl;
-      std::cout << "objective:    " << results.info.objValue << std::endl;
-      switch (results.info.status) {
-        case QPSolverOutput::PROXQP_SOLVED: {
-          std::cout << "status:       "
-                    << "Solved." << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_MAX_ITER_REACHED: {
-          std::cout << "status:       "
-                    << "Maximum number of iterations reached" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_PRIMAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Primal infeasible" << std::endl;
-          break;
-        }
-        case QPSolverOutput::PROXQP_DUAL_INFEASIBLE: {
-          std::cout << "status:       "
-                    << "Dual infeasible" << std::endl;
-          break;
-        }
-      }
-      std::cout << "--------------------------------------------------------"
-                << std::endl;
-    }
-  }
-
-  work.set_dirty();
+  qp_solve_end(
+    results, data, settings, work, precond, qp_scaled.as_const(), stack);
+  return true;
+}
+/*!
+ * Executes the PROXQP algorithm, or the interior-point method if so set by
+ * settings.method.
+ *
+ * @param work solver workspace.
+ * @param model QP problem model as defined by the user (without any scaling
+ * performed).
+ * @param settings solver settings.
+ * @param results solver results.
+ * @param precond preconditioner.
+ * @param observer callable receiving the IterationRecord of each outer
+ * iteration (by default, nothing is recorded).
+ */
+template<typename T, typename I, typename P, typename Observer = NullObserver>
+void
+qp_solve(Results<T>& results,
+         Model<T, I>& data,
+         const Settings<T>& settings,
+         Workspace<T, I>& work,
+         P& precond,
+         Observer&& observer = Observer{})
+{
+  trace::Span span("solve");
+  qp_solve_begin(results, data, settings, work, precond);
+  qp_solve_step(results,
+                data,
+                settings,
+                work,
+                precond,
+                std::numeric_limits<isize>::max(),
+                observer);
 }
 } // namespace sparse
 } // namespace proxqp
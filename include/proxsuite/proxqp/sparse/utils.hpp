@@ -397,10 +397,10 @@ middle_cols(proxsuite::linalg::sparse::MatRef<T, I> mat,
 
 template<typename T, typename I>
 auto
-middle_cols_mut(proxsuite::linalg::sparse::MatMut<T, I> mat,
+middle_cols_mut(proxsuite::linalg::sparse::MatValuesMut<T, I> mat,
                 isize start,
                 isize ncols,
-                isize nnz) -> proxsuite::linalg::sparse::MatMut<T, I>
+                isize nnz) -> proxsuite::linalg::sparse::MatValuesMut<T, I>
 {
   VEG_ASSERT(start <= mat.ncols());
   VEG_ASSERT(ncols <= mat.ncols() - start);
@@ -409,9 +409,9 @@ middle_cols_mut(proxsuite::linalg::sparse::MatMut<T, I> mat,
     mat.nrows(),
     ncols,
     nnz,
-    mat.col_ptrs_mut() + start,
+    mat.col_ptrs() + start,
     mat.is_compressed() ? nullptr : (mat.nnz_per_col_mut() + start),
-    mat.row_indices_mut(),
+    mat.row_indices(),
     mat.values_mut(),
   };
 }
@@ -438,8 +438,9 @@ top_rows_unchecked(proxsuite::linalg::veg::Unsafe /*unsafe*/,
 template<typename T, typename I>
 auto
 top_rows_mut_unchecked(proxsuite::linalg::veg::Unsafe /*unsafe*/,
-                       proxsuite::linalg::sparse::MatMut<T, I> mat,
-                       isize nrows) -> proxsuite::linalg::sparse::MatMut<T, I>
+                       proxsuite::linalg::sparse::MatValuesMut<T, I> mat,
+                       isize nrows)
+  -> proxsuite::linalg::sparse::MatValuesMut<T, I>
 {
   VEG_ASSERT(nrows <= mat.nrows());
   return {
@@ -447,12 +448,100 @@ top_rows_mut_unchecked(proxsuite::linalg::veg::Unsafe /*unsafe*/,
     nrows,
     mat.ncols(),
     mat.nnz(),
-    mat.col_ptrs_mut(),
+    mat.col_ptrs(),
     mat.nnz_per_col_mut(),
-    mat.row_indices_mut(),
+    mat.row_indices(),
     mat.values_mut(),
   };
 }
+/*!
+ * Returns a view of the QP problem stored in the model: its matrices are the
+ * (scaled) blocks of the KKT matrix, i.e., the upper triangular part of H, AT
+ * and CT, and its vectors are the (unscaled) vectors of the model.
+ *
+ * @param data solver's model.
+ */
+template<typename T, typename I>
+auto
+model_qp_view_mut(Model<T, I>& data) -> QpViewMut<T, I>
+{
+  proxsuite::linalg::sparse::MatValuesMut<T, I> kkt = data.kkt_mut();
+  auto kkt_top_n_rows =
+    top_rows_mut_unchecked(proxsuite::linalg::veg::unsafe, kkt, data.dim);
+  return {
+    middle_cols_mut(kkt_top_n_rows, 0, data.dim, data.H_nnz),
+    { proxsuite::linalg::sparse::from_eigen, data.g },
+    middle_cols_mut(kkt_top_n_rows, data.dim, data.n_eq, data.A_nnz),
+    { proxsuite::linalg::sparse::from_eigen, data.b },
+    middle_cols_mut(
+      kkt_top_n_rows, data.dim + data.n_eq, data.n_in, data.C_nnz),
+    { proxsuite::linalg::sparse::from_eigen, data.l },
+    { proxsuite::linalg::sparse::from_eigen, data.u },
+  };
+}
+/*!
+ * Labels the connected components of the graph of the KKT matrix, whose
+ * vertices are its rows (the variables, then the constraints) and whose edges
+ * are its off-diagonal non zero entries. Two variables in distinct components
+ * are coupled neither by H nor by a constraint, hence each component is a QP
+ * problem which can be solved independently. The components are numbered in
+ * the order of their first row.
+ *
+ * @param component output component of each row of the KKT matrix.
+ * @param kkt symbolic structure of the upper triangular part of the KKT
+ * matrix.
+ * @return the number of components.
+ */
+template<typename I>
+auto
+kkt_connected_components(I* component,
+                         proxsuite::linalg::sparse::SymbolicMatRef<I> kkt)
+  -> isize
+{
+  using proxsuite::linalg::sparse::util::zero_extend;
+  isize n_tot = kkt.ncols();
+  I const* ki = kkt.row_indices();
+
+  // union-find forest stored in component, the root of a tree being its
+  // smallest row
+  auto find = [&](isize i) -> isize {
+    while (isize(zero_extend(component[i])) != i) {
+      // path halving
+      component[i] = component[isize(zero_extend(component[i]))];
+      i = isize(zero_extend(component[i]));
+    }
+    return i;
+  };
+  for (isize i = 0; i < n_tot; ++i) {
+    component[i] = I(i);
+  }
+  for (usize j = 0; j < usize(n_tot); ++j) {
+    usize col_start = kkt.col_start(j);
+    usize col_end = kkt.col_end(j);
+    for (usize p = col_start; p < col_end; ++p) {
+      isize root_i = find(isize(zero_extend(ki[p])));
+      isize root_j = find(isize(j));
+      if (root_i < root_j) {
+        component[root_j] = I(root_i);
+      } else if (root_j < root_i) {
+        component[root_i] = I(root_j);
+      }
+    }
+  }
+
+  // each row points to its root, which is then relabeled by the number of the
+  // component (a root being smaller than the rows of its tree, it is
+  // relabeled before them)
+  for (isize i = 0; i < n_tot; ++i) {
+    component[i] = I(find(i));
+  }
+  isize n_components = 0;
+  for (isize i = 0; i < n_tot; ++i) {
+    isize root = isize(zero_extend(component[i]));
+    component[i] = root == i ? I(n_components++) : component[root];
+  }
+  return n_components;
+}
 /*!
  * Check whether the global primal infeasibility criterion is satisfied.
  *
@@ -675,9 +764,9 @@ unscaled_primal_dual_residual(
     { proxqp::from_eigen, primal_residual_in_scaled_up });
   primal_feasibility_in_rhs_0 = infty_norm(primal_residual_in_scaled_up);
 
-  auto b = data.b;
-  auto l = data.l;
-  auto u = data.u;
+  auto const& b = data.b;
+  auto const& l = data.l;
+  auto const& u = data.u;
   primal_residual_in_scaled_lo =
     positive_part(primal_residual_in_scaled_up - u) +
     negative_part(primal_residual_in_scaled_up - l);
@@ -39,11 +39,11 @@ struct QpView
 template<typename T, typename I>
 struct QpViewMut
 {
-  proxsuite::linalg::sparse::MatMut<T, I> H;
+  proxsuite::linalg::sparse::MatValuesMut<T, I> H;
   proxsuite::linalg::sparse::DenseVecMut<T> g;
-  proxsuite::linalg::sparse::MatMut<T, I> AT;
+  proxsuite::linalg::sparse::MatValuesMut<T, I> AT;
   proxsuite::linalg::sparse::DenseVecMut<T> b;
-  proxsuite::linalg::sparse::MatMut<T, I> CT;
+  proxsuite::linalg::sparse::MatValuesMut<T, I> CT;
   proxsuite::linalg::sparse::DenseVecMut<T> l;
   proxsuite::linalg::sparse::DenseVecMut<T> u;
 
@@ -12,7 +12,12 @@
 #include <proxsuite/linalg/sparse/update.hpp>
 #include <proxsuite/linalg/sparse/rowmod.hpp>
 #include <proxsuite/proxqp/timings.hpp>
+#include <proxsuite/proxqp/trace.hpp>
 #include <proxsuite/proxqp/settings.hpp>
+#include <proxsuite/proxqp/anderson.hpp>
+#include <proxsuite/proxqp/time_limit.hpp>
+#include <proxsuite/proxqp/solve_state.hpp>
+#include <proxsuite/proxqp/factorization_cache.hpp>
 #include <proxsuite/proxqp/dense/views.hpp>
 #include <proxsuite/linalg/veg/vec.hpp>
 #include "proxsuite/proxqp/sparse/views.hpp"
@@ -40,12 +45,13 @@ template<typename T, typename I>
 void
 refactorize(Workspace<T, I>& work,
             Results<T> const& results,
-            proxsuite::linalg::sparse::MatMut<T, I> kkt_active,
+            proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active,
             proxsuite::linalg::veg::SliceMut<bool> active_constraints,
             Model<T, I> const& data,
             proxsuite::linalg::veg::dynstack::DynStackMut stack,
             proxsuite::linalg::veg::Tag<T>& xtag)
 {
+  trace::Span span("refactorize");
   isize n_tot = kkt_active.nrows();
   T mu_eq_neg = -results.info.mu_eq;
   T mu_in_neg = -results.info.mu_in;
@@ -113,6 +119,153 @@ struct Ldlt
   proxsuite::linalg::veg::Vec<I> row_indices;
   proxsuite::linalg::veg::Vec<T> values;
 };
+/*!
+ * Sparse LDLT factorization kept by the factorization cache. The columns only
+ * keep their nonzero entries, the column pointers and the permutation being
+ * the ones of the symbolic factorization of the setup.
+ */
+template<typename T, typename I>
+struct CachedFactorization
+{
+  proxsuite::linalg::veg::Vec<I> etree;
+  proxsuite::linalg::veg::Vec<I> nnz_counts;
+  proxsuite::linalg::veg::Vec<I> row_indices;
+  proxsuite::linalg::veg::Vec<T> values;
+};
+/*!
+ * Vectors of the current outer iteration of PROXQP, sized at the solve: the
+ * scaled residuals updated by its inner loop, the previous iterate and the
+ * step kept as infeasibility certificate. They live in the workspace so that a
+ * step can return in the middle of the inner loop.
+ */
+template<typename T>
+struct OuterIteration
+{
+  Vec<T> primal_residual_eq_scaled;
+  Vec<T> primal_residual_in_scaled_lo;
+  Vec<T> primal_residual_in_scaled_up;
+  Vec<T> dual_residual_scaled;
+  Vec<T> x_prev;
+  Vec<T> y_prev;
+  Vec<T> z_prev;
+  Vec<T> dw_prev;
+
+  /*!
+   * Allocates the vectors, when their dimensions change.
+   * @param n primal variable dimension.
+   * @param n_eq number of equality constraints.
+   * @param n_in number of inequality constraints.
+   */
+  void resize(isize n, isize n_eq, isize n_in)
+  {
+    primal_residual_eq_scaled.resize(n_eq);
+    primal_residual_in_scaled_lo.resize(n_in);
+    primal_residual_in_scaled_up.resize(n_in);
+    dual_residual_scaled.resize(n);
+    x_prev.resize(n);
+    y_prev.resize(n_eq);
+    z_prev.resize(n_in);
+    dw_prev.resize(n + n_eq + n_in);
+  }
+};
+/*!
+ * Iterates and buffers of the interior-point method, sized at the solve.
+ */
+template<typename T>
+struct InteriorPointWorkspace
+{
+  // masks of the finite sides of the inequality constraints
+  Vec<T> mask_l;
+  Vec<T> mask_u;
+  // unscaled complementarity of each constraint per unit of the scaled one
+  Vec<T> complementarity_scale;
+  // slacks and multipliers of the inequality constraints
+  Vec<T> t_l;
+  Vec<T> t_u;
+  Vec<T> lambda_l;
+  Vec<T> lambda_u;
+  // residuals of the optimality conditions
+  Vec<T> r_d;
+  Vec<T> r_p;
+  Vec<T> r_l;
+  Vec<T> r_u;
+  Vec<T> r_cl;
+  Vec<T> r_cu;
+  // weights of the inequality constraints and scaling of their rows
+  Vec<T> d;
+  Vec<T> s;
+  Vec<T> q;
+  Vec<T> Cx;
+  Vec<T> Cdx;
+  // steps of the slacks and of the multipliers
+  Vec<T> dt_l;
+  Vec<T> dt_u;
+  Vec<T> dlambda_l;
+  Vec<T> dlambda_u;
+  // right hand side, solution, residual and diagonal of the Newton system
+  Vec<T> rhs;
+  Vec<T> sol;
+  Vec<T> err;
+  Vec<T> work;
+  Vec<T> diag;
+  // values of the KKT matrix whose constraint columns are scaled
+  Vec<T> kkt_values;
+  // residuals of the stopping criterion
+  Vec<T> primal_residual_eq_scaled;
+  Vec<T> primal_residual_in_scaled_lo;
+  Vec<T> primal_residual_in_scaled_up;
+  Vec<T> dual_residual_scaled;
+  Vec<T> complementarity_unscaled;
+
+  /*!
+   * Allocates the vectors, when their dimensions change.
+   * @param n primal variable dimension.
+   * @param n_eq number of equality constraints.
+   * @param n_in number of inequality constraints.
+   * @param kkt_nnz number of nonzero entries of the KKT matrix.
+   */
+  void resize(isize n, isize n_eq, isize n_in, isize kkt_nnz)
+  {
+    if (r_d.size() == n && r_p.size() == n_eq && d.size() == n_in &&
+        kkt_values.size() == kkt_nnz) {
+      return;
+    }
+    isize n_tot = n + n_eq + n_in;
+    mask_l.resize(n_in);
+    mask_u.resize(n_in);
+    complementarity_scale.resize(n_in);
+    t_l.resize(n_in);
+    t_u.resize(n_in);
+    lambda_l.resize(n_in);
+    lambda_u.resize(n_in);
+    r_d.resize(n);
+    r_p.resize(n_eq);
+    r_l.resize(n_in);
+    r_u.resize(n_in);
+    r_cl.resize(n_in);
+    r_cu.resize(n_in);
+    d.resize(n_in);
+    s.resize(n_in);
+    q.resize(n_in);
+    Cx.resize(n_in);
+    Cdx.resize(n_in);
+    dt_l.resize(n_in);
+    dt_u.resize(n_in);
+    dlambda_l.resize(n_in);
+    dlambda_u.resize(n_in);
+    rhs.resize(n_tot);
+    sol.resize(n_tot);
+    err.resize(n_tot);
+    work.resize(n_tot);
+    diag.resize(n_tot);
+    kkt_values.resize(kkt_nnz);
+    primal_residual_eq_scaled.resize(n_eq);
+    primal_residual_in_scaled_lo.resize(n_in);
+    primal_residual_in_scaled_up.resize(n_in);
+    dual_residual_scaled.resize(n);
+    complementarity_unscaled.resize(n_in);
+  }
+};
 template<typename T, typename I>
 struct Workspace
 {
@@ -133,6 +286,20 @@ struct Workspace
     Eigen::Matrix<T, Eigen::Dynamic, 1> l_scaled;
     Eigen::Matrix<T, Eigen::Dynamic, 1> u_scaled;
     proxsuite::linalg::veg::Vec<I> kkt_nnz_counts;
+    // memory of the Anderson acceleration of the outer loop (sized at the
+    // solve)
+    AndersonAcceleration<T> anderson;
+    // time limit of the solve, and best iterate (sized at the solve)
+    Deadline deadline;
+    BestIterate<T> best;
+    // state of the outer loop, kept between the steps of a solve
+    SolveState<T> solve_state;
+    // vectors of the current outer iteration of PROXQP (sized at the solve)
+    OuterIteration<T> outer_iteration;
+    // iterates of the interior-point method (sized at the solve)
+    InteriorPointWorkspace<T> interior_point;
+    // factorizations of the previous solves
+    FactorizationCache<T, CachedFactorization<T, I>> factorization_cache;
 
     // stored in unique_ptr because we need a stable address
     std::unique_ptr<detail::AugmentedKkt<T, I>>
@@ -155,6 +322,12 @@ struct Workspace
     // Whether the workspace is dirty
     bool dirty;
     bool proximal_parameter_update;
+    // whether scaling variables loaded by the user are kept at setup
+    bool preconditioner_loaded;
+    // connected components of the KKT matrix (see
+    // detail::kkt_connected_components), found with its symbolic factorization
+    isize n_components;
+    proxsuite::linalg::veg::Vec<I> kkt_components;
 
   } internal;
 
@@ -206,6 +379,8 @@ struct Workspace
     // assuming H, AT, CT are sorted
     // and H is upper triangular
     {
+      data.kkt_col_ptrs_external = nullptr;
+      data.kkt_row_indices_external = nullptr;
       data.kkt_col_ptrs.resize_for_overwrite(n_tot + 1); //
       data.kkt_row_indices.resize_for_overwrite(nnz_tot);
       data.kkt_values.resize_for_overwrite(nnz_tot);
@@ -249,9 +424,6 @@ struct Workspace
       insert_submatrix(CT, false);
     }
 
-    data.kkt_col_ptrs_unscaled = data.kkt_col_ptrs;
-    data.kkt_row_indices_unscaled = data.kkt_row_indices;
-
     storage.resize_for_overwrite( //
       (StackReq::with_len(itag, n_tot) &
        proxsuite::linalg::sparse::factorize_symbolic_req( //
@@ -290,6 +462,9 @@ struct Workspace
         static_cast<I const*>(nullptr),
         kkt_sym,
         stack);
+      internal.kkt_components.resize_for_overwrite(n_tot);
+      internal.n_components = detail::kkt_connected_components(
+        internal.kkt_components.ptr_mut(), kkt_sym);
 
       auto pcol_ptrs = ldl.col_ptrs.ptr_mut();
       pcol_ptrs[0] = I(0);
@@ -323,6 +498,7 @@ struct Workspace
    * preconditioner for scaling the problem (and reduce its ill conditioning).
    * @param precond preconditioner chosen for the solver.
    * @param precond_req storage requirements for the solver's preconditioner.
+   * @param timings timings of the solver phases.
    */
   template<typename P>
   void setup_impl(const QpView<T, I> qp,
@@ -330,7 +506,8 @@ struct Workspace
                   const Settings<T>& settings,
                   bool execute_or_not,
                   P& precond,
-                  proxsuite::linalg::veg::dynstack::StackReq precond_req)
+                  proxsuite::linalg::veg::dynstack::StackReq precond_req,
+                  PhaseTimings<T>& timings)
   {
 
     auto& ldl = internal.ldl;
@@ -377,19 +554,41 @@ struct Workspace
 
     if (internal.do_symbolic_fact) {
 
+      // the sparsity pattern is not copied when the matrices are the blocks of
+      // the pattern set by the user (e.g., mapped from a file, see MappedQp)
+      I const* ext_col_ptrs = data.kkt_col_ptrs_external;
+      I const* ext_row_indices = data.kkt_row_indices_external;
+      bool own_pattern =
+        ext_col_ptrs == nullptr || qp.H.col_ptrs() != ext_col_ptrs ||
+        qp.AT.col_ptrs() != ext_col_ptrs + n ||
+        qp.CT.col_ptrs() != ext_col_ptrs + n + n_eq ||
+        qp.H.row_indices() != ext_row_indices ||
+        qp.AT.row_indices() != ext_row_indices ||
+        qp.CT.row_indices() != ext_row_indices || !qp.H.is_compressed() ||
+        !qp.AT.is_compressed() || !qp.CT.is_compressed();
+
       // form the full kkt matrix
       // assuming H, AT, CT are sorted
       // and H is upper triangular
       {
-        data.kkt_col_ptrs.resize_for_overwrite(n_tot + 1);
-        data.kkt_row_indices.resize_for_overwrite(nnz_tot);
+        if (own_pattern) {
+          data.kkt_col_ptrs_external = nullptr;
+          data.kkt_row_indices_external = nullptr;
+          data.kkt_col_ptrs.resize_for_overwrite(n_tot + 1);
+          data.kkt_row_indices.resize_for_overwrite(nnz_tot);
+        } else {
+          data.kkt_col_ptrs = proxsuite::linalg::veg::Vec<I>{};
+          data.kkt_row_indices = proxsuite::linalg::veg::Vec<I>{};
+        }
         data.kkt_values.resize_for_overwrite(nnz_tot);
 
         I* kktp = data.kkt_col_ptrs.ptr_mut();
         I* kkti = data.kkt_row_indices.ptr_mut();
         T* kktx = data.kkt_values.ptr_mut();
 
-        kktp[0] = 0;
+        if (own_pattern) {
+          kktp[0] = 0;
+        }
         usize col = 0;
         usize pos = 0;
 
@@ -403,17 +602,20 @@ struct Workspace
             usize col_start = m.col_start(j);
             usize col_end = m.col_end(j);
 
-            kktp[col + 1] =
-              checked_non_negative_plus(kktp[col], I(col_end - col_start));
+            if (own_pattern) {
+              kktp[col + 1] =
+                checked_non_negative_plus(kktp[col], I(col_end - col_start));
+            }
             ++col;
 
             for (usize p = col_start; p < col_end; ++p) {
-              usize i = zero_extend(mi[p]);
-              if (assert_sym_hi) {
-                VEG_ASSERT(i <= j);
+              if (own_pattern) {
+                usize i = zero_extend(mi[p]);
+                if (assert_sym_hi) {
+                  VEG_ASSERT(i <= j);
+                }
+                kkti[pos] = proxsuite::linalg::veg::nb::narrow<I>{}(i);
               }
-
-              kkti[pos] = proxsuite::linalg::veg::nb::narrow<I>{}(i);
               kktx[pos] = mx[p];
 
               ++pos;
@@ -426,10 +628,6 @@ struct Workspace
         insert_submatrix(qp.CT, false);
       }
 
-      data.kkt_col_ptrs_unscaled = data.kkt_col_ptrs;
-      data.kkt_row_indices_unscaled = data.kkt_row_indices;
-      data.kkt_values_unscaled = data.kkt_values;
-
       storage.resize_for_overwrite( //
         (StackReq::with_len(itag, n_tot) &
          proxsuite::linalg::sparse::factorize_symbolic_req( //
@@ -447,6 +645,8 @@ struct Workspace
 
       bool overflow = false;
       {
+        PhaseTimer<T> timer(timings, Phase::FACTORIZATION);
+        trace::Span span("setup_factorization");
         ldl.etree.resize_for_overwrite(n_tot);
         auto etree_ptr = ldl.etree.ptr_mut();
 
@@ -456,9 +656,9 @@ struct Workspace
           n_tot,
           n_tot,
           nnz_tot,
-          data.kkt_col_ptrs.ptr(),
+          data.kkt_col_ptrs_data(),
           nullptr,
-          data.kkt_row_indices.ptr(),
+          data.kkt_row_indices_data(),
         };
         proxsuite::linalg::sparse::factorize_symbolic_non_zeros( //
           ldl.col_ptrs.ptr_mut() + 1,
@@ -467,6 +667,9 @@ struct Workspace
           static_cast<I const*>(nullptr),
           kkt_sym,
           stack);
+        internal.kkt_components.resize_for_overwrite(n_tot);
+        internal.n_components = detail::kkt_connected_components(
+          internal.kkt_components.ptr_mut(), kkt_sym);
 
         auto pcol_ptrs = ldl.col_ptrs.ptr_mut();
         pcol_ptrs[0] = I(0); // pcol_ptrs +1: pointor towards the nbr of non
@@ -492,6 +695,8 @@ struct Workspace
       // do_ldlt = !overflow && lnnz < (10000000);
       do_ldlt = !overflow && lnnz < 10000000;
     } else {
+      // the matrices of qp may be the blocks of the kkt matrix themselves
+      // (e.g., when updating the model), the copy is then a no-op
       T* kktx = data.kkt_values.ptr_mut();
       usize pos = 0;
       auto insert_submatrix =
@@ -514,7 +719,6 @@ struct Workspace
       insert_submatrix(qp.H);
       insert_submatrix(qp.AT);
       insert_submatrix(qp.CT);
-      data.kkt_values_unscaled = data.kkt_values;
     }
 #define PROX_QP_ALL_OF(...)                                                    \
   ::proxsuite::linalg::veg::dynstack::StackReq::and_(                          \
@@ -559,6 +763,20 @@ struct Workspace
     });
 
     auto unscaled_primal_dual_residual_req = x_vec(n); // Hx
+    auto polish_req = PROX_QP_ALL_OF({
+      x_vec(n_tot), // rhs
+      x_vec(n_tot), // sol
+      x_vec(n_tot), // err
+      PROX_QP_ANY_OF({
+        x_vec(n_tot), // ldl_solve work
+        PROX_QP_ALL_OF({
+          x_vec(n),    // x_save
+          x_vec(n_eq), // y_save
+          x_vec(n_in), // z_save
+          unscaled_primal_dual_residual_req,
+        }),
+      }),
+    });
     auto line_search_req = PROX_QP_ALL_OF({
       x_vec(2 * n_in), // alphas
       x_vec(n),        // Cdx_active
@@ -599,21 +817,12 @@ struct Workspace
       line_search_req,
     });
 
+    // the residuals and the previous iterate of an outer iteration are kept
+    // in the workspace (see OuterIteration)
     auto iter_req = PROX_QP_ANY_OF({
-      PROX_QP_ALL_OF({ x_vec(n_eq), // primal_residual_eq_scaled
-                       x_vec(n_in), // primal_residual_in_scaled_lo
-                       x_vec(n_in), // primal_residual_in_scaled_up
-                       x_vec(n_in), // primal_residual_in_scaled_up
-                       x_vec(n),    // dual_residual_scaled
-                       PROX_QP_ANY_OF({
-                         unscaled_primal_dual_residual_req,
-                         PROX_QP_ALL_OF({
-                           x_vec(n),    // x_prev
-                           x_vec(n_eq), // y_prev
-                           x_vec(n_in), // z_prev
-                           primal_dual_newton_semi_smooth_req,
-                         }),
-                       }) }),
+      unscaled_primal_dual_residual_req,
+      polish_req,
+      primal_dual_newton_semi_smooth_req,
       refactorize_req, // mu_update
     });
 
@@ -673,13 +882,13 @@ struct Workspace
        undefined behavior if upper condition is not respected.
     */
 
-    proxsuite::linalg::sparse::MatMut<T, I> H_scaled =
+    proxsuite::linalg::sparse::MatValuesMut<T, I> H_scaled =
       detail::middle_cols_mut(kkt_top_n_rows, 0, n, data.H_nnz);
 
-    proxsuite::linalg::sparse::MatMut<T, I> AT_scaled =
+    proxsuite::linalg::sparse::MatValuesMut<T, I> AT_scaled =
       detail::middle_cols_mut(kkt_top_n_rows, n, n_eq, data.A_nnz);
 
-    proxsuite::linalg::sparse::MatMut<T, I> CT_scaled =
+    proxsuite::linalg::sparse::MatValuesMut<T, I> CT_scaled =
       detail::middle_cols_mut(kkt_top_n_rows, n + n_eq, n_in, data.C_nnz);
 
     g_scaled = data.g;
@@ -706,14 +915,17 @@ struct Workspace
     };
 
     DynStackMut stack = stack_mut();
-    precond.scale_qp_in_place(qp_scaled,
-                              execute_or_not,
-                              settings.preconditioner_max_iter,
-                              settings.preconditioner_accuracy,
-                              stack);
+    {
+      PhaseTimer<T> timer(timings, Phase::EQUILIBRATION);
+      precond.scale_qp_in_place(qp_scaled,
+                                execute_or_not,
+                                settings.preconditioner_max_iter,
+                                settings.preconditioner_accuracy,
+                                stack);
+    }
     kkt_nnz_counts.resize_for_overwrite(n_tot);
 
-    proxsuite::linalg::sparse::MatMut<T, I> kkt_active = {
+    proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_active = {
       proxsuite::linalg::sparse::from_raw_parts,
       n_tot,
       n_tot,
@@ -721,9 +933,9 @@ struct Workspace
         data.A_nnz, // these variables are not used for the matrix vector
                     // product in augmented KKT with Min res algorithm (to be
                     // exact, it should depend of the initial guess)
-      kkt.col_ptrs_mut(),
+      kkt.col_ptrs(),
       kkt_nnz_counts.ptr_mut(),
-      kkt.row_indices_mut(),
+      kkt.row_indices(),
       kkt.values_mut(),
     };
 
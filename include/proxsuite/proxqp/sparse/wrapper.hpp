@@ -11,6 +11,14 @@
 #include <proxsuite/proxqp/settings.hpp>
 #include <proxsuite/proxqp/sparse/solver.hpp>
 #include <proxsuite/proxqp/sparse/helpers.hpp>
+#include <proxsuite/proxqp/sparse/mapped_qp.hpp>
+#include <proxsuite/proxqp/sparse/low_rank.hpp>
+#include <proxsuite/proxqp/snapshot.hpp>
+#include <vector>
+#ifdef PROXSUITE_WITH_MULTITHREADING
+#include <atomic>
+#include <thread>
+#endif
 
 namespace proxsuite {
 namespace proxqp {
@@ -94,6 +102,9 @@ struct QP
   Model<T, I> model;
   Workspace<T, I> work;
   preconditioner::RuizEquilibration<T, I> ruiz;
+  // QP objects of the blocks of a block separable problem (see
+  // Settings::decompose_separable_blocks), set up by the first solve
+  std::vector<QP> blocks;
   /*!
    * Default constructor using the dimension of the matrices in entry.
    * @param _dim primal variable dimension.
@@ -110,6 +121,8 @@ struct QP
 
     work.timer.stop();
     work.internal.do_symbolic_fact = true;
+    work.internal.preconditioner_loaded = false;
+    work.internal.n_components = 1;
   }
   /*!
    * Default constructor using the sparsity structure of the matrices in entry.
@@ -173,11 +186,406 @@ struct QP
             std::optional<T> rho = std::nullopt,
             std::optional<T> mu_eq = std::nullopt,
             std::optional<T> mu_in = std::nullopt)
+  {
+    if (H != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        H.value().rows(),
+        model.dim,
+        "the row dimension for initializing H is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        H.value().cols(),
+        model.dim,
+        "the column dimension for initializing H is not valid.");
+    }
+    if (A != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A.value().rows(),
+        model.n_eq,
+        "the row dimension for initializing A is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A.value().cols(),
+        model.dim,
+        "the column dimension for initializing A is not valid.");
+    }
+    if (C != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C.value().rows(),
+        model.n_in,
+        "the row dimension for initializing C is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C.value().cols(),
+        model.dim,
+        "the column dimension for initializing C is not valid.");
+    }
+    // convert the matrices to the compressed column format used by the
+    // solver, i.e., the upper triangular part of H and the transposes of A
+    // and C
+    SparseMat<T, I> H_triu;
+    SparseMat<T, I> AT;
+    SparseMat<T, I> CT;
+    std::optional<proxsuite::linalg::sparse::MatRef<T, I>> H_triu_view;
+    std::optional<proxsuite::linalg::sparse::MatRef<T, I>> AT_view;
+    std::optional<proxsuite::linalg::sparse::MatRef<T, I>> CT_view;
+    if (H != std::nullopt) {
+      H_triu = H.value().template triangularView<Eigen::Upper>();
+      H_triu_view = { proxsuite::linalg::sparse::from_eigen, H_triu };
+    }
+    if (A != std::nullopt) {
+      AT = A.value().transpose();
+      AT_view = { proxsuite::linalg::sparse::from_eigen, AT };
+    }
+    if (C != std::nullopt) {
+      CT = C.value().transpose();
+      CT_view = { proxsuite::linalg::sparse::from_eigen, CT };
+    }
+    init(H_triu_view,
+         g,
+         AT_view,
+         b,
+         CT_view,
+         u,
+         l,
+         compute_preconditioner_,
+         rho,
+         mu_eq,
+         mu_in);
+  };
+  /*!
+   * Setups a QP model of diagonal plus low rank quadratic cost
+   * H = diag(d) + F F^T and equilibrates it, without forming H. The factor
+   * exposures v = F^T x are lifted into the problem (see LowRankHessian): the
+   * QP object is expected to be built with dimensions (n + k, n_eq + k, n_in),
+   * n and k being the dimension and the rank of H. Once solved,
+   * results.x.head(n) and results.y.head(n_eq) are the solution and the
+   * multipliers of A x = b of the original problem, results.x.tail(k) being
+   * F^T x.
+   * @param H diagonal plus low rank quadratic cost input defining the QP model.
+   * @param g linear cost input defining the QP model.
+   * @param A equality constraint matrix input defining the QP model.
+   * @param b equality constraint vector input defining the QP model.
+   * @param C inequality constraint matrix input defining the QP model.
+   * @param u lower inequality constraint vector input defining the QP model.
+   * @param l lower inequality constraint vector input defining the QP model.
+   * @param compute_preconditioner boolean parameter for executing or not the
+   * preconditioner.
+   * @param rho proximal step size wrt primal variable.
+   * @param mu_eq proximal step size wrt equality constrained multiplier.
+   * @param mu_in proximal step size wrt inequality constrained multiplier.
+   */
+  void init(LowRankHessian<T> const& H,
+            std::optional<VecRef<T>> g,
+            std::optional<SparseMat<T, I>> A,
+            std::optional<VecRef<T>> b,
+            std::optional<SparseMat<T, I>> C,
+            std::optional<VecRef<T>> u,
+            std::optional<VecRef<T>> l,
+            bool compute_preconditioner_ = true,
+            std::optional<T> rho = std::nullopt,
+            std::optional<T> mu_eq = std::nullopt,
+            std::optional<T> mu_in = std::nullopt)
+  {
+    isize n = H.dim();
+    isize k = H.rank();
+    isize n_eq = model.n_eq - k;
+    PROXSUITE_CHECK_ARGUMENT_SIZE(
+      model.dim,
+      n + k,
+      "the primal dimension of the QP object is not the dimension plus the "
+      "rank of H.");
+    PROXSUITE_THROW_PRETTY(
+      n_eq < 0,
+      std::invalid_argument,
+      "wrong argument size: the QP object has fewer equality constraints "
+      "than the rank of H.");
+    if (g != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        g.value().rows(),
+        n,
+        "the dimension wrt the primal variable x variable for initializing g "
+        "is not valid.");
+    }
+    if (A != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A.value().rows(),
+        n_eq,
+        "the row dimension for initializing A is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A.value().cols(),
+        n,
+        "the column dimension for initializing A is not valid.");
+    }
+    if (b != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        b.value().rows(),
+        n_eq,
+        "the dimension wrt equality constrained variables for initializing b "
+        "is not valid.");
+    }
+    if (C != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C.value().rows(),
+        model.n_in,
+        "the row dimension for initializing C is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C.value().cols(),
+        n,
+        "the column dimension for initializing C is not valid.");
+    }
+
+    using Triplet = Eigen::Triplet<T, I>;
+    std::vector<Triplet> triplets;
+    triplets.reserve(usize(model.dim));
+    for (isize i = 0; i < n; ++i) {
+      triplets.push_back(Triplet(I(i), I(i), H.d(i)));
+    }
+    for (isize j = 0; j < k; ++j) {
+      triplets.push_back(Triplet(I(n + j), I(n + j), T(1)));
+    }
+    SparseMat<T, I> H_lifted(model.dim, model.dim);
+    H_lifted.setFromTriplets(triplets.begin(), triplets.end());
+
+    triplets.clear();
+    triplets.reserve(usize(n * k + k));
+    if (A != std::nullopt) {
+      SparseMat<T, I> const& A_ = A.value();
+      triplets.reserve(usize(A_.nonZeros() + n * k + k));
+      for (isize col = 0; col < A_.outerSize(); ++col) {
+        for (typename SparseMat<T, I>::InnerIterator it(A_, col); it; ++it) {
+          triplets.push_back(Triplet(it.row(), it.col(), it.value()));
+        }
+      }
+    }
+    for (isize j = 0; j < k; ++j) {
+      for (isize i = 0; i < n; ++i) {
+        if (H.F(i, j) != T(0)) {
+          triplets.push_back(Triplet(I(n_eq + j), I(i), H.F(i, j)));
+        }
+      }
+      triplets.push_back(Triplet(I(n_eq + j), I(n + j), T(-1)));
+    }
+    SparseMat<T, I> A_lifted(model.n_eq, model.dim);
+    A_lifted.setFromTriplets(triplets.begin(), triplets.end());
+    Vec<T> b_lifted = Vec<T>::Zero(model.n_eq);
+    if (b != std::nullopt) {
+      b_lifted.head(n_eq) = b.value();
+    }
+    Vec<T> g_lifted = Vec<T>::Zero(model.dim);
+    if (g != std::nullopt) {
+      g_lifted.head(n) = g.value();
+    }
+    std::optional<SparseMat<T, I>> C_lifted;
+    if (C != std::nullopt) {
+      // the columns of v are empty
+      C_lifted = C.value();
+      C_lifted.value().conservativeResize(model.n_in, model.dim);
+    }
+
+    init(H_lifted,
+         g_lifted,
+         A_lifted,
+         b_lifted,
+         C_lifted,
+         u,
+         l,
+         compute_preconditioner_,
+         rho,
+         mu_eq,
+         mu_in);
+  };
+  /*!
+   * Setups a QP model whose quadratic cost is a least-squares term,
+   *
+   *   min 1/2 ||J x - r||^2 + g^T x  s.t.  A x = b, l <= C x <= u,
+   *
+   * without forming J^T J. The residual w = J x - r is lifted into the
+   * problem: the QP object is expected to be built with dimensions
+   * (n + n_res, n_eq + n_res, n_in), n and n_res being the number of columns
+   * and of rows of J, and it solves
+   *
+   *   min 1/2 ||w||^2 + g^T x  s.t.  A x = b, J x - w = r, l <= C x <= u.
+   *
+   * The lifted model only adds the non-zeros of J and 2 n_res unit entries,
+   * J being equilibrated by the preconditioner and used by the residuals as
+   * any constraint, which keeps the conditioning of J instead of squaring it.
+   * Once solved, results.x.head(n) and results.y.head(n_eq) are the solution
+   * and the multipliers of A x = b of the original problem,
+   * results.x.tail(n_res) being the residual J x - r.
+   * @param J least-squares matrix.
+   * @param r least-squares target vector.
+   * @param g linear cost input defining the QP model.
+   * @param A equality constraint matrix input defining the QP model.
+   * @param b equality constraint vector input defining the QP model.
+   * @param C inequality constraint matrix input defining the QP model.
+   * @param u upper inequality constraint vector input defining the QP model.
+   * @param l lower inequality constraint vector input defining the QP model.
+   * @param compute_preconditioner boolean parameter for executing or not the
+   * preconditioner.
+   * @param rho proximal step size wrt primal variable.
+   * @param mu_eq proximal step size wrt equality constrained multiplier.
+   * @param mu_in proximal step size wrt inequality constrained multiplier.
+   */
+  void init_least_squares(SparseMat<T, I> const& J,
+                          VecRef<T> r,
+                          std::optional<VecRef<T>> g,
+                          std::optional<SparseMat<T, I>> A,
+                          std::optional<VecRef<T>> b,
+                          std::optional<SparseMat<T, I>> C,
+                          std::optional<VecRef<T>> u,
+                          std::optional<VecRef<T>> l,
+                          bool compute_preconditioner_ = true,
+                          std::optional<T> rho = std::nullopt,
+                          std::optional<T> mu_eq = std::nullopt,
+                          std::optional<T> mu_in = std::nullopt)
+  {
+    isize n_res = J.rows();
+    isize n = J.cols();
+    isize n_eq = model.n_eq - n_res;
+    PROXSUITE_CHECK_ARGUMENT_SIZE(
+      model.dim,
+      n + n_res,
+      "the primal dimension of the QP object is not the number of columns "
+      "plus the number of rows of J.");
+    PROXSUITE_THROW_PRETTY(
+      n_eq < 0,
+      std::invalid_argument,
+      "wrong argument size: the QP object has fewer equality constraints "
+      "than the number of rows of J.");
+    PROXSUITE_CHECK_ARGUMENT_SIZE(
+      r.rows(), n_res, "the dimension of r is not the number of rows of J.");
+    if (g != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        g.value().rows(),
+        n,
+        "the dimension wrt the primal variable x variable for initializing g "
+        "is not valid.");
+    }
+    if (A != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A.value().rows(),
+        n_eq,
+        "the row dimension for initializing A is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A.value().cols(),
+        n,
+        "the column dimension for initializing A is not valid.");
+    }
+    if (b != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        b.value().rows(),
+        n_eq,
+        "the dimension wrt equality constrained variables for initializing b "
+        "is not valid.");
+    }
+    if (C != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C.value().rows(),
+        model.n_in,
+        "the row dimension for initializing C is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C.value().cols(),
+        n,
+        "the column dimension for initializing C is not valid.");
+    }
+
+    using Triplet = Eigen::Triplet<T, I>;
+    std::vector<Triplet> triplets;
+    triplets.reserve(usize(n_res));
+    for (isize i = 0; i < n_res; ++i) {
+      triplets.push_back(Triplet(I(n + i), I(n + i), T(1)));
+    }
+    SparseMat<T, I> H_lifted(model.dim, model.dim);
+    H_lifted.setFromTriplets(triplets.begin(), triplets.end());
+
+    triplets.clear();
+    triplets.reserve(usize(J.nonZeros() + n_res));
+    if (A != std::nullopt) {
+      SparseMat<T, I> const& A_ = A.value();
+      triplets.reserve(usize(A_.nonZeros() + J.nonZeros() + n_res));
+      for (isize col = 0; col < A_.outerSize(); ++col) {
+        for (typename SparseMat<T, I>::InnerIterator it(A_, col); it; ++it) {
+          triplets.push_back(Triplet(it.row(), it.col(), it.value()));
+        }
+      }
+    }
+    for (isize col = 0; col < J.outerSize(); ++col) {
+      for (typename SparseMat<T, I>::InnerIterator it(J, col); it; ++it) {
+        triplets.push_back(Triplet(I(n_eq + it.row()), it.col(), it.value()));
+      }
+    }
+    for (isize i = 0; i < n_res; ++i) {
+      triplets.push_back(Triplet(I(n_eq + i), I(n + i), T(-1)));
+    }
+    SparseMat<T, I> A_lifted(model.n_eq, model.dim);
+    A_lifted.setFromTriplets(triplets.begin(), triplets.end());
+    Vec<T> b_lifted(model.n_eq);
+    if (b != std::nullopt) {
+      b_lifted.head(n_eq) = b.value();
+    } else {
+      b_lifted.head(n_eq).setZero();
+    }
+    b_lifted.tail(n_res) = r;
+    Vec<T> g_lifted = Vec<T>::Zero(model.dim);
+    if (g != std::nullopt) {
+      g_lifted.head(n) = g.value();
+    }
+    std::optional<SparseMat<T, I>> C_lifted;
+    if (C != std::nullopt) {
+      // the columns of w are empty
+      C_lifted = C.value();
+      C_lifted.value().conservativeResize(model.n_in, model.dim);
+    }
+
+    init(H_lifted,
+         g_lifted,
+         A_lifted,
+         b_lifted,
+         C_lifted,
+         u,
+         l,
+         compute_preconditioner_,
+         rho,
+         mu_eq,
+         mu_in);
+  };
+  /*!
+   * Setups the QP model from views of matrices already stored in the
+   * compressed column format used by the solver, and equilibrates it. The
+   * matrices are read in place, without intermediary conversions (e.g., from
+   * the buffers of a scipy.sparse matrix).
+   * @param H_triu upper triangular part of the quadratic cost input defining
+   * the QP model.
+   * @param g linear cost input defining the QP model.
+   * @param AT transposed equality constraint matrix input defining the QP
+   * model.
+   * @param b equality constraint vector input defining the QP model.
+   * @param CT transposed inequality constraint matrix input defining the QP
+   * model.
+   * @param u lower inequality constraint vector input defining the QP model.
+   * @param l lower inequality constraint vector input defining the QP model.
+   * @param compute_preconditioner boolean parameter for executing or not the
+   * preconditioner.
+   * @param rho proximal step size wrt primal variable.
+   * @param mu_eq proximal step size wrt equality constrained multiplier.
+   * @param mu_in proximal step size wrt inequality constrained multiplier.
+   */
+  void init(std::optional<proxsuite::linalg::sparse::MatRef<T, I>> H_triu,
+            std::optional<VecRef<T>> g,
+            std::optional<proxsuite::linalg::sparse::MatRef<T, I>> AT,
+            std::optional<VecRef<T>> b,
+            std::optional<proxsuite::linalg::sparse::MatRef<T, I>> CT,
+            std::optional<VecRef<T>> u,
+            std::optional<VecRef<T>> l,
+            bool compute_preconditioner_ = true,
+            std::optional<T> rho = std::nullopt,
+            std::optional<T> mu_eq = std::nullopt,
+            std::optional<T> mu_in = std::nullopt)
   {
     if (settings.compute_timings) {
       work.timer.stop();
       work.timer.start();
     }
+    blocks.clear();
+    work.internal.factorization_cache.clear();
     if (g != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(
         g.value().rows(),
@@ -206,39 +614,42 @@ struct QP
         "the dimension wrt inequality constrained variables for initializing l "
         "is not valid.");
     }
-    if (H != std::nullopt) {
+    if (H_triu != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        H.value().rows(),
+        H_triu.value().nrows(),
         model.dim,
         "the row dimension for initializing H is not valid.");
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        H.value().cols(),
+        H_triu.value().ncols(),
         model.dim,
         "the column dimension for initializing H is not valid.");
     }
-    if (A != std::nullopt) {
+    if (AT != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        A.value().rows(),
+        AT.value().nrows(),
+        model.dim,
+        "the row dimension for initializing AT is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        AT.value().ncols(),
         model.n_eq,
-        "the row dimension for initializing A is not valid.");
+        "the column dimension for initializing AT is not valid.");
+    }
+    if (CT != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        A.value().cols(),
+        CT.value().nrows(),
         model.dim,
-        "the column dimension for initializing A is not valid.");
-    }
-    if (C != std::nullopt) {
+        "the row dimension for initializing CT is not valid.");
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        C.value().rows(),
+        CT.value().ncols(),
         model.n_in,
-        "the row dimension for initializing C is not valid.");
-      PROXSUITE_CHECK_ARGUMENT_SIZE(
-        C.value().cols(),
-        model.dim,
-        "the column dimension for initializing C is not valid.");
+        "the column dimension for initializing CT is not valid.");
     }
     work.internal.proximal_parameter_update = false;
     PreconditionerStatus preconditioner_status;
-    if (compute_preconditioner_) {
+    if (compute_preconditioner_ && work.internal.preconditioner_loaded) {
+      // scaling variables loaded by the user are re-used as they are
+      preconditioner_status = proxsuite::proxqp::PreconditionerStatus::KEEP;
+    } else if (compute_preconditioner_) {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::EXECUTE;
     } else {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::IDENTITY;
@@ -263,52 +674,64 @@ struct QP
     } // else qpmodel.l remains initialzed to a matrix with zero elements or
       // zero shape
 
-    // avoid allocations when H is not nullopt
-    SparseMat<T, I> AT(model.dim, model.n_eq);
-    if (A != std::nullopt) {
-      AT = (A.value()).transpose();
-    } else {
-      AT.setZero();
-    }
-    SparseMat<T, I> CT(model.dim, model.n_in);
-    if (C != std::nullopt) {
-      CT = (C.value()).transpose();
-    } else {
-      CT.setZero();
-    }
-    if (H != std::nullopt) {
-      SparseMat<T, I> H_triu =
-        (H.value()).template triangularView<Eigen::Upper>();
-      sparse::QpView<T, I> qp = {
-        { proxsuite::linalg::sparse::from_eigen, H_triu },
-        { proxsuite::linalg::sparse::from_eigen, model.g },
-        { proxsuite::linalg::sparse::from_eigen, AT },
-        { proxsuite::linalg::sparse::from_eigen, model.b },
-        { proxsuite::linalg::sparse::from_eigen, CT },
-        { proxsuite::linalg::sparse::from_eigen, model.l },
-        { proxsuite::linalg::sparse::from_eigen, model.u }
-      };
-      qp_setup(qp, results, model, work, settings, ruiz, preconditioner_status);
-    } else {
-      SparseMat<T, I> H_triu(model.dim, model.dim);
-      H_triu.setZero();
-      H_triu = (H.value()).template triangularView<Eigen::Upper>();
-      sparse::QpView<T, I> qp = {
-        { proxsuite::linalg::sparse::from_eigen, H_triu },
-        { proxsuite::linalg::sparse::from_eigen, model.g },
-        { proxsuite::linalg::sparse::from_eigen, AT },
-        { proxsuite::linalg::sparse::from_eigen, model.b },
-        { proxsuite::linalg::sparse::from_eigen, CT },
-        { proxsuite::linalg::sparse::from_eigen, model.l },
-        { proxsuite::linalg::sparse::from_eigen, model.u }
-      };
-      qp_setup(qp, results, model, work, settings, ruiz, preconditioner_status);
-    }
+    // missing matrices are replaced by empty ones
+    SparseMat<T, I> H_zero(model.dim, model.dim);
+    SparseMat<T, I> AT_zero(model.dim, model.n_eq);
+    SparseMat<T, I> CT_zero(model.dim, model.n_in);
+    sparse::QpView<T, I> qp = {
+      H_triu.value_or(proxsuite::linalg::sparse::MatRef<T, I>{
+        proxsuite::linalg::sparse::from_eigen, H_zero }),
+      { proxsuite::linalg::sparse::from_eigen, model.g },
+      AT.value_or(proxsuite::linalg::sparse::MatRef<T, I>{
+        proxsuite::linalg::sparse::from_eigen, AT_zero }),
+      { proxsuite::linalg::sparse::from_eigen, model.b },
+      CT.value_or(proxsuite::linalg::sparse::MatRef<T, I>{
+        proxsuite::linalg::sparse::from_eigen, CT_zero }),
+      { proxsuite::linalg::sparse::from_eigen, model.l },
+      { proxsuite::linalg::sparse::from_eigen, model.u }
+    };
+    qp_setup(qp, results, model, work, settings, ruiz, preconditioner_status);
 
     if (settings.compute_timings) {
       results.info.setup_time += work.timer.elapsed().user; // in microseconds
     }
   };
+  /*!
+   * Setups the QP solver model from a problem mapped from a binary compressed
+   * column file. The model points to the sparsity pattern of the mapping
+   * instead of copying it, only the values of the matrices are copied (to be
+   * scaled by the preconditioner). The MappedQp object must hence outlive the
+   * QP object, or its next initialization with other matrices.
+   * @param qp problem mapped from a file written by write_mapped_qp.
+   * @param compute_preconditioner boolean parameter for executing or not the
+   * preconditioner.
+   * @param rho proximal step size wrt primal variable.
+   * @param mu_eq proximal step size wrt equality constrained multiplier.
+   * @param mu_in proximal step size wrt inequality constrained multiplier.
+   */
+  void init(MappedQp<T, I> const& qp,
+            bool compute_preconditioner_ = true,
+            std::optional<T> rho = std::nullopt,
+            std::optional<T> mu_eq = std::nullopt,
+            std::optional<T> mu_in = std::nullopt)
+  {
+    sparse::QpView<T, I> view = qp.view();
+    // the setup does not copy the pattern of the matrices pointing to it
+    model.kkt_col_ptrs_external = qp.kkt_col_ptrs();
+    model.kkt_row_indices_external = qp.kkt_row_indices();
+    work.internal.do_symbolic_fact = true;
+    init(view.H,
+         view.g.to_eigen(),
+         view.AT,
+         view.b.to_eigen(),
+         view.CT,
+         view.u.to_eigen(),
+         view.l.to_eigen(),
+         compute_preconditioner_,
+         rho,
+         mu_eq,
+         mu_in);
+  }
   /*!
    * Updates the QP model (with sparse matrix format) and re-equilibrates it if
    * specified by the user. If matrices in entry are not null, the update is
@@ -338,6 +761,101 @@ struct QP
               std::optional<T> rho = std::nullopt,
               std::optional<T> mu_eq = std::nullopt,
               std::optional<T> mu_in = std::nullopt)
+  {
+    if (H_ != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        H_.value().rows(),
+        model.dim,
+        "the row dimension for updating H is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        H_.value().cols(),
+        model.dim,
+        "the column dimension for updating H is not valid.");
+    }
+    if (A_ != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A_.value().rows(),
+        model.n_eq,
+        "the row dimension for updating A is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        A_.value().cols(),
+        model.dim,
+        "the column dimension for updating A is not valid.");
+    }
+    if (C_ != std::nullopt) {
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C_.value().rows(),
+        model.n_in,
+        "the row dimension for updating C is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        C_.value().cols(),
+        model.dim,
+        "the column dimension for updating C is not valid.");
+    }
+    SparseMat<T, I> H_triu;
+    SparseMat<T, I> AT;
+    SparseMat<T, I> CT;
+    std::optional<proxsuite::linalg::sparse::MatRef<T, I>> H_triu_view;
+    std::optional<proxsuite::linalg::sparse::MatRef<T, I>> AT_view;
+    std::optional<proxsuite::linalg::sparse::MatRef<T, I>> CT_view;
+    if (H_ != std::nullopt) {
+      H_triu = H_.value().template triangularView<Eigen::Upper>();
+      H_triu_view = { proxsuite::linalg::sparse::from_eigen, H_triu };
+    }
+    if (A_ != std::nullopt) {
+      AT = A_.value().transpose();
+      AT_view = { proxsuite::linalg::sparse::from_eigen, AT };
+    }
+    if (C_ != std::nullopt) {
+      CT = C_.value().transpose();
+      CT_view = { proxsuite::linalg::sparse::from_eigen, CT };
+    }
+    update(H_triu_view,
+           g_,
+           AT_view,
+           b_,
+           CT_view,
+           u_,
+           l_,
+           update_preconditioner_,
+           rho,
+           mu_eq,
+           mu_in);
+  };
+  /*!
+   * Updates the QP model from views of matrices stored in the compressed
+   * column format used by the solver, and re-equilibrates it if specified by
+   * the user. The matrices are read in place, without intermediary
+   * conversions. If matrices in entry are not null, the update is effective
+   * only if the sparsity structure of entry is the same as the one used for
+   * the initialization.
+   * @param H_triu upper triangular part of the quadratic cost input defining
+   * the QP model.
+   * @param g_ linear cost input defining the QP model.
+   * @param AT transposed equality constraint matrix input defining the QP
+   * model.
+   * @param b_ equality constraint vector input defining the QP model.
+   * @param CT transposed inequality constraint matrix input defining the QP
+   * model.
+   * @param u_ lower inequality constraint vector input defining the QP model.
+   * @param l_ lower inequality constraint vector input defining the QP model.
+   * @param update_preconditioner_ bool parameter for updating or not the
+   * preconditioner and the associated scaled model.
+   * @param rho proximal step size wrt primal variable.
+   * @param mu_eq proximal step size wrt equality constrained multiplier.
+   * @param mu_in proximal step size wrt inequality constrained multiplier.
+   */
+  void update(std::optional<proxsuite::linalg::sparse::MatRef<T, I>> H_triu,
+              std::optional<VecRef<T>> g_,
+              std::optional<proxsuite::linalg::sparse::MatRef<T, I>> AT,
+              std::optional<VecRef<T>> b_,
+              std::optional<proxsuite::linalg::sparse::MatRef<T, I>> CT,
+              std::optional<VecRef<T>> u_,
+              std::optional<VecRef<T>> l_,
+              bool update_preconditioner_ = true,
+              std::optional<T> rho = std::nullopt,
+              std::optional<T> mu_eq = std::nullopt,
+              std::optional<T> mu_in = std::nullopt)
   {
     if (settings.compute_timings) {
       work.timer.stop();
@@ -345,30 +863,22 @@ struct QP
     }
     work.internal.dirty = false;
     work.internal.proximal_parameter_update = false;
+    // the cached factorizations are the ones of the previous scaled matrices,
+    // which scaling anew with the same preconditioner only changes by rounding
+    // errors. Likewise, the QP objects of the blocks are kept, only their
+    // vectors being updated
+    bool keep_matrices = H_triu == std::nullopt && AT == std::nullopt &&
+                         CT == std::nullopt && !update_preconditioner_;
+    if (!keep_matrices) {
+      blocks.clear();
+      work.internal.factorization_cache.clear();
+    }
     PreconditionerStatus preconditioner_status;
     if (update_preconditioner_) {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::EXECUTE;
     } else {
       preconditioner_status = proxsuite::proxqp::PreconditionerStatus::KEEP;
     }
-    isize n = model.dim;
-    isize n_eq = model.n_eq;
-    isize n_in = model.n_in;
-    proxsuite::linalg::sparse::MatMut<T, I> kkt_unscaled =
-      model.kkt_mut_unscaled();
-
-    auto kkt_top_n_rows = detail::top_rows_mut_unchecked(
-      proxsuite::linalg::veg::unsafe, kkt_unscaled, n);
-
-    proxsuite::linalg::sparse::MatMut<T, I> H_unscaled =
-      detail::middle_cols_mut(kkt_top_n_rows, 0, n, model.H_nnz);
-
-    proxsuite::linalg::sparse::MatMut<T, I> AT_unscaled =
-      detail::middle_cols_mut(kkt_top_n_rows, n, n_eq, model.A_nnz);
-
-    proxsuite::linalg::sparse::MatMut<T, I> CT_unscaled =
-      detail::middle_cols_mut(kkt_top_n_rows, n + n_eq, n_in, model.C_nnz);
-
     // check the model is valid
     if (g_ != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(g_.value().rows(),
@@ -394,35 +904,35 @@ struct QP
                                     "the dimension wrt inequality constrained "
                                     "variables for updating l is not valid.");
     }
-    if (H_ != std::nullopt) {
+    if (H_triu != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        H_.value().rows(),
+        H_triu.value().nrows(),
         model.dim,
         "the row dimension for updating H is not valid.");
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        H_.value().cols(),
+        H_triu.value().ncols(),
         model.dim,
         "the column dimension for updating H is not valid.");
     }
-    if (A_ != std::nullopt) {
+    if (AT != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        A_.value().rows(),
+        AT.value().nrows(),
+        model.dim,
+        "the row dimension for updating AT is not valid.");
+      PROXSUITE_CHECK_ARGUMENT_SIZE(
+        AT.value().ncols(),
         model.n_eq,
-        "the row dimension for updating A is not valid.");
+        "the column dimension for updating AT is not valid.");
+    }
+    if (CT != std::nullopt) {
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        A_.value().cols(),
+        CT.value().nrows(),
         model.dim,
-        "the column dimension for updating A is not valid.");
-    }
-    if (C_ != std::nullopt) {
+        "the row dimension for updating CT is not valid.");
       PROXSUITE_CHECK_ARGUMENT_SIZE(
-        C_.value().rows(),
+        CT.value().ncols(),
         model.n_in,
-        "the row dimension for updating C is not valid.");
-      PROXSUITE_CHECK_ARGUMENT_SIZE(
-        C_.value().cols(),
-        model.dim,
-        "the column dimension for updating C is not valid.");
+        "the column dimension for updating CT is not valid.");
     }
 
     // update the model
@@ -439,158 +949,40 @@ struct QP
     if (l_ != std::nullopt) {
       model.l = l_.value();
     }
-    if (H_ != std::nullopt) {
-      SparseMat<T, I> H_triu =
-        H_.value().template triangularView<Eigen::Upper>();
-      if (A_ != std::nullopt) {
-        if (C_ != std::nullopt) {
-          bool res =
-            have_same_structure(
-              H_unscaled.as_const(),
-              { proxsuite::linalg::sparse::from_eigen, H_triu }) &&
-            have_same_structure(AT_unscaled.as_const(),
-                                { proxsuite::linalg::sparse::from_eigen,
-                                  SparseMat<T, I>(A_.value().transpose()) }) &&
-            have_same_structure(CT_unscaled.as_const(),
-                                { proxsuite::linalg::sparse::from_eigen,
-                                  SparseMat<T, I>(C_.value().transpose()) });
-          /* TO PUT IN DEBUG MODE
-          std::cout << "have same structure = " << res << std::endl;
-          */
-          if (res) {
-            copy(H_unscaled,
-                 { proxsuite::linalg::sparse::from_eigen,
-                   H_triu }); // copy rhs into lhs
-            copy(
-              AT_unscaled,
-              { proxsuite::linalg::sparse::from_eigen,
-                SparseMat<T, I>(A_.value().transpose()) }); // copy rhs into lhs
-            copy(
-              CT_unscaled,
-              { proxsuite::linalg::sparse::from_eigen,
-                SparseMat<T, I>(C_.value().transpose()) }); // copy rhs into lhs
-          }
-        } else {
-          bool res =
-            have_same_structure(
-              H_unscaled.as_const(),
-              { proxsuite::linalg::sparse::from_eigen, H_triu }) &&
-            have_same_structure(AT_unscaled.as_const(),
-                                { proxsuite::linalg::sparse::from_eigen,
-                                  SparseMat<T, I>(A_.value().transpose()) });
-          /* TO PUT IN DEBUG MODE
-          std::cout << "have same structure = " << res << std::endl;
-          */
-          if (res) {
-            copy(H_unscaled,
-                 { proxsuite::linalg::sparse::from_eigen,
-                   H_triu }); // copy rhs into lhs
-            copy(
-              AT_unscaled,
-              { proxsuite::linalg::sparse::from_eigen,
-                SparseMat<T, I>(A_.value().transpose()) }); // copy rhs into lhs
-          }
-        }
-      } else if (C_ != std::nullopt) {
-        bool res =
-          have_same_structure(
-            H_unscaled.as_const(),
-            { proxsuite::linalg::sparse::from_eigen, H_triu }) &&
-          have_same_structure(CT_unscaled.as_const(),
-                              { proxsuite::linalg::sparse::from_eigen,
-                                SparseMat<T, I>(C_.value().transpose()) });
-        /* TO PUT IN DEBUG MODE
-        std::cout << "have same structure = " << res << std::endl;
-        */
-        if (res) {
-          copy(H_unscaled,
-               { proxsuite::linalg::sparse::from_eigen,
-                 H_triu }); // copy rhs into lhs
-          copy(
-            CT_unscaled,
-            { proxsuite::linalg::sparse::from_eigen,
-              SparseMat<T, I>(C_.value().transpose()) }); // copy rhs into lhs
-        }
-      } else {
-
-        bool res = have_same_structure(
-          H_unscaled.as_const(),
-          { proxsuite::linalg::sparse::from_eigen, H_triu });
-        /* TO PUT IN DEBUG MODE
-        std::cout << "have same structure = " << res << std::endl;
-        */
-        if (res) {
-          copy(H_unscaled,
-               { proxsuite::linalg::sparse::from_eigen,
-                 H_.value() }); // copy rhs into lhs
-        }
+    // the kkt blocks (H is already upper triangular) are unscaled in place,
+    // then updated and read in place by the setup
+    sparse::QpViewMut<T, I> qp = detail::model_qp_view_mut(model);
+    // the matrices are updated only if all of them have the same sparsity
+    // structure as the ones used for the initialization
+    bool res = true;
+    if (H_triu != std::nullopt) {
+      res = res && have_same_structure(qp.H.as_const(), H_triu.value());
+    }
+    if (AT != std::nullopt) {
+      res = res && have_same_structure(qp.AT.as_const(), AT.value());
+    }
+    if (CT != std::nullopt) {
+      res = res && have_same_structure(qp.CT.as_const(), CT.value());
+    }
+    /* TO PUT IN DEBUG MODE
+    std::cout << "have same structure = " << res << std::endl;
+    */
+    ruiz.unscale_matrices_in_place(qp.H, qp.AT, qp.CT);
+    if (res) {
+      if (H_triu != std::nullopt) {
+        copy(qp.H, H_triu.value()); // copy rhs into lhs
       }
-    } else if (A_ != std::nullopt) {
-      if (C_ != std::nullopt) {
-        bool res =
-          have_same_structure(AT_unscaled.as_const(),
-                              { proxsuite::linalg::sparse::from_eigen,
-                                SparseMat<T, I>(A_.value().transpose()) }) &&
-          have_same_structure(CT_unscaled.as_const(),
-                              { proxsuite::linalg::sparse::from_eigen,
-                                SparseMat<T, I>(C_.value().transpose()) });
-        /* TO PUT IN DEBUG MODE
-        std::cout << "have same structure = " << res << std::endl;
-        */
-        if (res) {
-          copy(
-            AT_unscaled,
-            { proxsuite::linalg::sparse::from_eigen,
-              SparseMat<T, I>(A_.value().transpose()) }); // copy rhs into lhs
-          copy(
-            CT_unscaled,
-            { proxsuite::linalg::sparse::from_eigen,
-              SparseMat<T, I>(C_.value().transpose()) }); // copy rhs into lhs
-        }
-      } else {
-        bool res =
-          have_same_structure(AT_unscaled.as_const(),
-                              { proxsuite::linalg::sparse::from_eigen,
-                                SparseMat<T, I>(A_.value().transpose()) });
-        /* TO PUT IN DEBUG MODE
-        std::cout << "have same structure = " << res << std::endl;
-        */
-        if (res) {
-          copy(
-            AT_unscaled,
-            { proxsuite::linalg::sparse::from_eigen,
-              SparseMat<T, I>(A_.value().transpose()) }); // copy rhs into lhs
-        }
+      if (AT != std::nullopt) {
+        copy(qp.AT, AT.value()); // copy rhs into lhs
       }
-    } else if (C_ != std::nullopt) {
-      bool res =
-        have_same_structure(CT_unscaled.as_const(),
-                            { proxsuite::linalg::sparse::from_eigen,
-                              SparseMat<T, I>(C_.value().transpose()) });
-      /* TO PUT IN DEBUG MODE
-      std::cout << "have same structure = " << res << std::endl;
-      */
-      if (res) {
-        copy(CT_unscaled,
-             { proxsuite::linalg::sparse::from_eigen,
-               SparseMat<T, I>(C_.value().transpose()) }); // copy rhs into lhs
+      if (CT != std::nullopt) {
+        copy(qp.CT, CT.value()); // copy rhs into lhs
       }
     }
 
-    SparseMat<T, I> H_triu =
-      H_unscaled.to_eigen().template triangularView<Eigen::Upper>();
-    sparse::QpView<T, I> qp = {
-      { proxsuite::linalg::sparse::from_eigen, H_triu },
-      { proxsuite::linalg::sparse::from_eigen, model.g },
-      { proxsuite::linalg::sparse::from_eigen, AT_unscaled.to_eigen() },
-      { proxsuite::linalg::sparse::from_eigen, model.b },
-      { proxsuite::linalg::sparse::from_eigen, CT_unscaled.to_eigen() },
-      { proxsuite::linalg::sparse::from_eigen, model.l },
-      { proxsuite::linalg::sparse::from_eigen, model.u }
-    };
     proxsuite::proxqp::sparse::update_proximal_parameters(
       results, work, rho, mu_eq, mu_in);
-    qp_setup(qp,
+    qp_setup(qp.as_const(),
              results,
              model,
              work,
@@ -598,16 +990,244 @@ struct QP
              ruiz,
              preconditioner_status); // store model value + performs scaling
                                      // according to chosen options
+    if (!blocks.empty()) {
+      update_blocks(g_ != std::nullopt,
+                    b_ != std::nullopt,
+                    u_ != std::nullopt || l_ != std::nullopt,
+                    rho,
+                    mu_eq,
+                    mu_in);
+    }
     if (settings.compute_timings) {
       results.info.setup_time = work.timer.elapsed().user; // in microseconds
     }
   };
+  /*!
+   * Updates the vectors of the QP model, when the matrices are not modified
+   * (it avoids ambiguities between the overloads taking sparse matrices or
+   * views of them).
+   * @param g_ linear cost input defining the QP model.
+   * @param b_ equality constraint vector input defining the QP model.
+   * @param u_ lower inequality constraint vector input defining the QP model.
+   * @param l_ lower inequality constraint vector input defining the QP model.
+   * @param update_preconditioner_ bool parameter for updating or not the
+   * preconditioner and the associated scaled model.
+   * @param rho proximal step size wrt primal variable.
+   * @param mu_eq proximal step size wrt equality constrained multiplier.
+   * @param mu_in proximal step size wrt inequality constrained multiplier.
+   */
+  void update([[maybe_unused]] const std::nullopt_t H_,
+              std::optional<VecRef<T>> g_,
+              [[maybe_unused]] const std::nullopt_t A_,
+              std::optional<VecRef<T>> b_,
+              [[maybe_unused]] const std::nullopt_t C_,
+              std::optional<VecRef<T>> u_,
+              std::optional<VecRef<T>> l_,
+              bool update_preconditioner_ = true,
+              std::optional<T> rho = std::nullopt,
+              std::optional<T> mu_eq = std::nullopt,
+              std::optional<T> mu_in = std::nullopt)
+  {
+    using OptMatRef = std::optional<proxsuite::linalg::sparse::MatRef<T, I>>;
+    update(OptMatRef{},
+           g_,
+           OptMatRef{},
+           b_,
+           OptMatRef{},
+           u_,
+           l_,
+           update_preconditioner_,
+           rho,
+           mu_eq,
+           mu_in);
+  };
+
+  /*!
+   * Returns the kkt matrix of the model (upper triangular part) with unscaled
+   * values. The model only stores its scaled version, the unscaled values are
+   * derived on demand from the preconditioner scaling variables.
+   */
+  SparseMat<T, I> unscaled_kkt() const
+  {
+    SparseMat<T, I> kkt = model.kkt().to_eigen();
+    proxsuite::linalg::sparse::MatValuesMut<T, I> kkt_mut = {
+      proxsuite::linalg::sparse::from_eigen, kkt
+    };
+    auto kkt_top_n_rows = detail::top_rows_mut_unchecked(
+      proxsuite::linalg::veg::unsafe, kkt_mut, model.dim);
+    ruiz.unscale_matrices_in_place(
+      detail::middle_cols_mut(kkt_top_n_rows, 0, model.dim, model.H_nnz),
+      detail::middle_cols_mut(
+        kkt_top_n_rows, model.dim, model.n_eq, model.A_nnz),
+      detail::middle_cols_mut(
+        kkt_top_n_rows, model.dim + model.n_eq, model.n_in, model.C_nnz));
+    return kkt;
+  }
+  /*!
+   * Loads preconditioner scaling variables, e.g., exported from another QP
+   * object of the same dimensions (via its ruiz.delta and ruiz.c members).
+   * The next calls to init with compute_preconditioner set to true re-use
+   * them and skip the ruiz equilibration algorithm, until the preconditioner
+   * is re-computed by an update or disabled by an init.
+   * @param delta scaling vector (of size dim + n_eq + n_in).
+   * @param c cost scaling factor.
+   */
+  void load_preconditioner(VecRef<T> delta, T c)
+  {
+    if (!model.kkt_is_set()) {
+      ruiz.load(delta, c);
+    } else {
+      // the kkt matrix being the only copy of the matrices of the model, it
+      // is scaled anew with the loaded scaling variables
+      preconditioner::RuizEquilibration<T, I> loaded = ruiz;
+      loaded.load(delta, c);
+      sparse::QpViewMut<T, I> qp = detail::model_qp_view_mut(model);
+      ruiz.unscale_matrices_in_place(qp.H, qp.AT, qp.CT);
+      ruiz = loaded;
+      work.setup_impl(
+        qp.as_const(),
+        model,
+        settings,
+        false,
+        ruiz,
+        preconditioner::RuizEquilibration<T, I>::scale_qp_in_place_req(
+          proxsuite::linalg::veg::Tag<T>{}, model.dim, model.n_eq, model.n_in),
+        results.info.phase_timings);
+    }
+    work.internal.preconditioner_loaded = true;
+    blocks.clear();
+    work.internal.factorization_cache.clear();
+  }
+  /*!
+   * Saves a binary snapshot of the QP object (model, settings, preconditioner,
+   * symbolic factorization and last results).
+   * @param path path of the snapshot file.
+   */
+  void save_snapshot(const std::string& path) const
+  {
+    snapshot::Writer out(path, snapshot::Backend::SPARSE, sizeof(T), sizeof(I));
+    out.write_pod(model.dim);
+    out.write_pod(model.n_eq);
+    out.write_pod(model.n_in);
+    // the deadline is a point of the steady clock of this process, which has no
+    // meaning once the snapshot is reloaded
+    Settings<T> saved_settings = settings;
+    saved_settings.deadline = std::chrono::steady_clock::time_point::max();
+    out.write_pod(saved_settings);
+    // model
+    out.write_pod(model.H_nnz);
+    out.write_pod(model.A_nnz);
+    out.write_pod(model.C_nnz);
+    // the pattern is saved in any case, even when it is not owned
+    isize n_tot = model.dim + model.n_eq + model.n_in;
+    isize nnz = model.kkt_values.len();
+    out.write_array(model.kkt_col_ptrs_data(),
+                    model.kkt_is_set() ? n_tot + 1 : 0);
+    out.write_array(model.kkt_row_indices_data(), nnz);
+    out.write_vec(model.kkt_values);
+    out.write_eigen(model.g);
+    out.write_eigen(model.b);
+    out.write_eigen(model.l);
+    out.write_eigen(model.u);
+    // preconditioner
+    out.write_eigen(ruiz.delta);
+    out.write_pod(ruiz.c);
+    // symbolic factorization (the numeric one is recomputed by each solve)
+    out.write_pod(work.internal.do_ldlt);
+    out.write_pod(work.lnnz);
+    out.write_vec(work.internal.ldl.etree);
+    out.write_vec(work.internal.ldl.perm_inv);
+    out.write_vec(work.internal.ldl.col_ptrs);
+    out.write_pod(work.internal.n_components);
+    out.write_vec(work.internal.kkt_components);
+    out.write_pod(work.internal.dirty);
+    out.write_pod(work.internal.proximal_parameter_update);
+    out.write_pod(work.internal.preconditioner_loaded);
+    // results
+    out.write_eigen(results.x);
+    out.write_eigen(results.y);
+    out.write_eigen(results.z);
+    out.write_vec(results.active_constraints);
+    out.write_pod(results.info);
+  }
+  /*!
+   * Loads a binary snapshot saved by save_snapshot, so that the QP object is
+   * ready to be solved without executing anew the preconditioner and the
+   * symbolic factorization of the setup. The QP object is resized to the
+   * dimensions of the snapshot if needed.
+   * @param path path of the snapshot file.
+   */
+  void load_snapshot(const std::string& path)
+  {
+    snapshot::Reader in(path, snapshot::Backend::SPARSE, sizeof(T), sizeof(I));
+    isize dim = in.read_pod<isize>();
+    isize n_eq = in.read_pod<isize>();
+    isize n_in = in.read_pod<isize>();
+    if (dim != model.dim || n_eq != model.n_eq || n_in != model.n_in) {
+      *this = QP(dim, n_eq, n_in);
+    }
+    settings = in.read_pod<Settings<T>>();
+    // model
+    model.H_nnz = in.read_pod<isize>();
+    model.A_nnz = in.read_pod<isize>();
+    model.C_nnz = in.read_pod<isize>();
+    model.kkt_col_ptrs_external = nullptr;
+    model.kkt_row_indices_external = nullptr;
+    in.read_vec(model.kkt_col_ptrs);
+    in.read_vec(model.kkt_row_indices);
+    in.read_vec(model.kkt_values);
+    in.read_eigen(model.g);
+    in.read_eigen(model.b);
+    in.read_eigen(model.l);
+    in.read_eigen(model.u);
+    // preconditioner
+    in.read_eigen(ruiz.delta);
+    ruiz.c = in.read_pod<T>();
+    // symbolic factorization
+    work.internal.do_ldlt = in.read_pod<bool>();
+    work.lnnz = in.read_pod<isize>();
+    in.read_vec(work.internal.ldl.etree);
+    in.read_vec(work.internal.ldl.perm_inv);
+    in.read_vec(work.internal.ldl.col_ptrs);
+    work.internal.n_components = in.read_pod<isize>();
+    in.read_vec(work.internal.kkt_components);
+    blocks.clear();
+    work.internal.factorization_cache.clear();
+    bool dirty = in.read_pod<bool>();
+    work.internal.proximal_parameter_update = in.read_pod<bool>();
+    work.internal.preconditioner_loaded = in.read_pod<bool>();
+    // results
+    in.read_eigen(results.x);
+    in.read_eigen(results.y);
+    in.read_eigen(results.z);
+    in.read_vec(results.active_constraints);
+    results.info = in.read_pod<Info<T>>();
 
+    // rebuild the scaled model and the solver storage from the loaded
+    // scaling variables, reusing the loaded symbolic factorization
+    work.internal.do_symbolic_fact = false;
+    sparse::QpViewMut<T, I> qp = detail::model_qp_view_mut(model);
+    ruiz.unscale_matrices_in_place(qp.H, qp.AT, qp.CT);
+    work.setup_impl(
+      qp.as_const(),
+      model,
+      settings,
+      false,
+      ruiz,
+      preconditioner::RuizEquilibration<T, I>::scale_qp_in_place_req(
+        proxsuite::linalg::veg::Tag<T>{}, model.dim, model.n_eq, model.n_in),
+      results.info.phase_timings);
+    work.internal.dirty = dirty;
+  }
   /*!
    * Solves the QP problem using PRXOQP algorithm.
    */
   void solve()
   {
+    if (solves_blocks()) {
+      solve_blocks();
+      return;
+    }
     qp_solve( //
       results,
       model,
@@ -615,6 +1235,24 @@ struct QP
       work,
       ruiz);
   };
+  /*!
+   * Solves the QP problem using PROXQP algorithm, calling an observer at each
+   * outer iteration. The problem is solved as a whole, even when it is block
+   * separable.
+   * @param observer callable receiving the IterationRecord of each outer
+   * iteration (e.g., a RingBufferObserver).
+   */
+  template<typename Observer>
+  void solve(Observer&& observer)
+  {
+    qp_solve( //
+      results,
+      model,
+      settings,
+      work,
+      ruiz,
+      observer);
+  };
   /*!
    * Solves the QP problem using PROXQP algorithm and a warm start.
    * @param x primal warm start.
@@ -626,6 +1264,10 @@ struct QP
              std::optional<VecRef<T>> z)
   {
     proxsuite::proxqp::sparse::warm_start(x, y, z, results, settings, model);
+    if (solves_blocks()) {
+      solve_blocks();
+      return;
+    }
     qp_solve( //
       results,
       model,
@@ -633,10 +1275,399 @@ struct QP
       work,
       ruiz);
   };
+  /*!
+   * Starts a step-wise solve of the QP problem, whose outer iterations are run
+   * by calls to step() until is_done(). Several QP objects can hence be solved
+   * in an interleaved way (e.g., by a scheduler giving priority to the solves
+   * closest to their deadline). The problem is solved as a whole, even when it
+   * is block separable. The results are only meaningful once the solve is
+   * done, and begin_solve() must be called again after an update of the
+   * model.
+   */
+  void begin_solve()
+  {
+    qp_solve_begin( //
+      results,
+      model,
+      settings,
+      work,
+      ruiz);
+  };
+  /*!
+   * Runs iterations of the solve started by begin_solve(), until it is done
+   * or max_inner_iters inner iterations have been run. A step may stop in the
+   * middle of an outer iteration, which the next step then resumes. The first
+   * step also computes the initial factorization.
+   * @param max_inner_iters number of inner iterations after which the step
+   * returns (at least one is run).
+   * @return true once the solve is done.
+   */
+  bool step(isize max_inner_iters)
+  {
+    return qp_solve_step( //
+      results,
+      model,
+      settings,
+      work,
+      ruiz,
+      max_inner_iters);
+  };
+  /*!
+   * Returns whether the solve started by begin_solve() is done (or whether no
+   * step-wise solve was started).
+   */
+  bool is_done() const { return work.internal.solve_state.done; }
+  /*!
+   * Returns the cache of the factorizations computed at the start of the
+   * solves (see Settings::factorization_cache_max_bytes), e.g., for its hit
+   * and miss statistics.
+   */
+  const FactorizationCache<T, CachedFactorization<T, I>>& factorization_cache()
+    const
+  {
+    return work.internal.factorization_cache;
+  }
   /*!
    * Clean-ups solver's results.
    */
   void cleanup() { results.cleanup(); }
+  /*!
+   * Returns whether the problem is solved as independent QP problems, one for
+   * each of its blocks (i.e., the connected components of its KKT matrix).
+   */
+  bool solves_blocks() const
+  {
+    return settings.decompose_separable_blocks &&
+           work.internal.n_components > 1;
+  }
+  /*!
+   * Assigns each row of the KKT matrix (a variable, then an equality or an
+   * inequality constraint) to the QP object of its block. A block is a
+   * connected component of the KKT matrix, except that the constraints
+   * without any variable are added to the first block.
+   * @param block output block of each row.
+   * @param sizes output dimensions (dim, n_eq and n_in) of each block.
+   * @return the index of each row in the QP object of its block.
+   */
+  std::vector<isize> block_indices(std::vector<isize>& block,
+                                   std::vector<isize>& sizes) const
+  {
+    isize n = model.dim;
+    isize n_tot = n + model.n_eq + model.n_in;
+    isize n_components = work.internal.n_components;
+    I const* component = work.internal.kkt_components.ptr();
+
+    std::vector<isize> component_block(usize(n_components), -1);
+    for (isize i = 0; i < n; ++i) {
+      component_block[usize(component[i])] = 0;
+    }
+    isize n_blocks = 0;
+    for (isize& k : component_block) {
+      k = k == 0 ? n_blocks++ : 0;
+    }
+
+    block.resize(usize(n_tot));
+    sizes.assign(3 * usize(n_blocks), 0);
+    std::vector<isize> index(block.size());
+    for (isize i = 0; i < n_tot; ++i) {
+      isize kind = i < n ? 0 : (i < n + model.n_eq ? 1 : 2);
+      block[usize(i)] = component_block[usize(component[i])];
+      index[usize(i)] = sizes[3 * usize(block[usize(i)]) + usize(kind)]++;
+    }
+    return index;
+  }
+  /*!
+   * Sets up the QP objects of the blocks from the unscaled model. The blocks
+   * are scaled with the scaling variables of the whole problem, and start
+   * from its current proximal step sizes.
+   */
+  void setup_blocks()
+  {
+    isize n = model.dim;
+    isize n_eq = model.n_eq;
+    isize n_tot = n + n_eq + model.n_in;
+    std::vector<isize> block;
+    std::vector<isize> sizes;
+    std::vector<isize> index = block_indices(block, sizes);
+    isize n_blocks = isize(sizes.size()) / 3;
+
+    blocks.clear();
+    blocks.reserve(usize(n_blocks));
+    std::vector<Vec<T>> g(sizes.size() / 3);
+    std::vector<Vec<T>> b(sizes.size() / 3);
+    std::vector<Vec<T>> u(sizes.size() / 3);
+    std::vector<Vec<T>> l(sizes.size() / 3);
+    std::vector<Vec<T>> delta(sizes.size() / 3);
+    for (isize k = 0; k < n_blocks; ++k) {
+      isize const* size = sizes.data() + 3 * k;
+      blocks.emplace_back(size[0], size[1], size[2]);
+      g[usize(k)].resize(size[0]);
+      b[usize(k)].resize(size[1]);
+      u[usize(k)].resize(size[2]);
+      l[usize(k)].resize(size[2]);
+      delta[usize(k)].resize(size[0] + size[1] + size[2]);
+    }
+
+    // columns of H, AT and CT of each block
+    using Triplets = std::vector<Eigen::Triplet<T, I>>;
+    std::vector<Triplets> triplets(3 * usize(n_blocks));
+    SparseMat<T, I> kkt = unscaled_kkt();
+    for (isize j = 0; j < n_tot; ++j) {
+      isize kind = j < n ? 0 : (j < n + n_eq ? 1 : 2);
+      Triplets& block_triplets =
+        triplets[3 * usize(block[usize(j)]) + usize(kind)];
+      for (typename SparseMat<T, I>::InnerIterator it(kkt, j); it; ++it) {
+        block_triplets.emplace_back(
+          I(index[usize(it.row())]), I(index[usize(j)]), it.value());
+      }
+    }
+    // vectors of each block
+    for (isize i = 0; i < n_tot; ++i) {
+      usize k = usize(block[usize(i)]);
+      isize idx = index[usize(i)];
+      isize const* size = sizes.data() + 3 * k;
+      if (i < n) {
+        g[k](idx) = model.g(i);
+        delta[k](idx) = ruiz.delta(i);
+      } else if (i < n + n_eq) {
+        b[k](idx) = model.b(i - n);
+        delta[k](size[0] + idx) = ruiz.delta(i);
+      } else {
+        u[k](idx) = model.u(i - n - n_eq);
+        l[k](idx) = model.l(i - n - n_eq);
+        delta[k](size[0] + size[1] + idx) = ruiz.delta(i);
+      }
+    }
+
+    for (isize k = 0; k < n_blocks; ++k) {
+      QP& qp = blocks[usize(k)];
+      isize const* size = sizes.data() + 3 * k;
+      SparseMat<T, I> H_triu(size[0], size[0]);
+      SparseMat<T, I> AT(size[0], size[1]);
+      SparseMat<T, I> CT(size[0], size[2]);
+      Triplets const* block_triplets = triplets.data() + 3 * k;
+      H_triu.setFromTriplets(block_triplets[0].begin(),
+                             block_triplets[0].end());
+      AT.setFromTriplets(block_triplets[1].begin(), block_triplets[1].end());
+      CT.setFromTriplets(block_triplets[2].begin(), block_triplets[2].end());
+
+      qp.settings = settings;
+      qp.settings.decompose_separable_blocks = false;
+      qp.load_preconditioner(delta[usize(k)], ruiz.c);
+      qp.init(proxsuite::linalg::sparse::MatRef<T, I>{
+                   proxsuite::linalg::sparse::from_eigen, H_triu },
+                 g[usize(k)],
+                 proxsuite::linalg::sparse::MatRef<T, I>{
+                   proxsuite::linalg::sparse::from_eigen, AT },
+                 b[usize(k)],
+                 proxsuite::linalg::sparse::MatRef<T, I>{
+                   proxsuite::linalg::sparse::from_eigen, CT },
+                 u[usize(k)],
+                 l[usize(k)],
+                 true,
+                 results.info.rho,
+                 results.info.mu_eq,
+                 results.info.mu_in);
+    }
+  }
+  /*!
+   * Updates the vectors of the QP objects of the blocks from the model, when
+   * its matrices and its preconditioner are kept.
+   * @param update_g whether g is updated.
+   * @param update_b whether b is updated.
+   * @param update_ul whether u and l are updated.
+   * @param rho proximal step size wrt primal variable.
+   * @param mu_eq proximal step size wrt equality constrained multiplier.
+   * @param mu_in proximal step size wrt inequality constrained multiplier.
+   */
+  void update_blocks(bool update_g,
+                     bool update_b,
+                     bool update_ul,
+                     std::optional<T> rho,
+                     std::optional<T> mu_eq,
+                     std::optional<T> mu_in)
+  {
+    isize n = model.dim;
+    isize n_eq = model.n_eq;
+    isize n_tot = n + n_eq + model.n_in;
+    std::vector<isize> block;
+    std::vector<isize> sizes;
+    std::vector<isize> index = block_indices(block, sizes);
+    usize n_blocks = blocks.size();
+
+    std::vector<Vec<T>> g(n_blocks);
+    std::vector<Vec<T>> b(n_blocks);
+    std::vector<Vec<T>> u(n_blocks);
+    std::vector<Vec<T>> l(n_blocks);
+    for (usize k = 0; k < n_blocks; ++k) {
+      isize const* size = sizes.data() + 3 * k;
+      g[k].resize(size[0]);
+      b[k].resize(size[1]);
+      u[k].resize(size[2]);
+      l[k].resize(size[2]);
+    }
+    for (isize i = 0; i < n_tot; ++i) {
+      usize k = usize(block[usize(i)]);
+      isize idx = index[usize(i)];
+      if (i < n) {
+        g[k](idx) = model.g(i);
+      } else if (i < n + n_eq) {
+        b[k](idx) = model.b(i - n);
+      } else {
+        u[k](idx) = model.u(i - n - n_eq);
+        l[k](idx) = model.l(i - n - n_eq);
+      }
+    }
+
+    using OptVecRef = std::optional<VecRef<T>>;
+    for (usize k = 0; k < n_blocks; ++k) {
+      QP& qp = blocks[k];
+      qp.settings = settings;
+      qp.settings.decompose_separable_blocks = false;
+      qp.update(std::nullopt,
+                update_g ? OptVecRef(g[k]) : std::nullopt,
+                std::nullopt,
+                update_b ? OptVecRef(b[k]) : std::nullopt,
+                std::nullopt,
+                update_ul ? OptVecRef(u[k]) : std::nullopt,
+                update_ul ? OptVecRef(l[k]) : std::nullopt,
+                false,
+                rho,
+                mu_eq,
+                mu_in);
+    }
+  }
+  /*!
+   * Solves the blocks of a block separable problem as independent QP
+   * problems, each one with its own proximal step sizes and active set, on
+   * settings.nb_threads threads. The results of the blocks are then gathered:
+   * the iteration counts are summed, the residuals are the maximal ones and
+   * the status is the one of the first block which is not solved, if any (the
+   * other statistics of the blocks are in blocks[k].results.info). Without
+   * multithreading support (PROXSUITE_WITH_MULTITHREADING), the blocks are
+   * solved one after the other.
+   */
+  void solve_blocks()
+  {
+    trace::Span span("solve_blocks");
+    if (settings.compute_timings) {
+      work.timer.stop();
+      work.timer.start();
+    }
+    if (blocks.empty()) {
+      setup_blocks();
+    }
+    isize n = model.dim;
+    isize n_eq = model.n_eq;
+    isize n_tot = n + n_eq + model.n_in;
+    std::vector<isize> block;
+    std::vector<isize> sizes;
+    std::vector<isize> index = block_indices(block, sizes);
+
+#ifdef PROXSUITE_WITH_MULTITHREADING
+    isize n_blocks = isize(blocks.size());
+    isize n_threads = settings.nb_threads > 0
+                        ? settings.nb_threads
+                        : isize(std::thread::hardware_concurrency());
+    n_threads = std::max(isize(1), std::min(n_threads, n_blocks));
+#else
+    isize n_threads = 1;
+#endif
+
+    // the blocks start from the current results when the initial guess uses
+    // them (a block which has just been set up has no previous result)
+    bool warm_start =
+      settings.initial_guess == InitialGuessStatus::WARM_START ||
+      settings.initial_guess ==
+        InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT ||
+      settings.initial_guess ==
+        InitialGuessStatus::COLD_START_WITH_PREVIOUS_RESULT;
+    for (QP& qp : blocks) {
+      qp.settings = settings;
+      qp.settings.decompose_separable_blocks = false;
+      // the outputs of parallel solves would be interleaved
+      qp.settings.verbose = settings.verbose && n_threads == 1;
+    }
+    if (warm_start) {
+      for (isize i = 0; i < n_tot; ++i) {
+        Results<T>& block_results = blocks[usize(block[usize(i)])].results;
+        isize idx = index[usize(i)];
+        if (i < n) {
+          block_results.x(idx) = results.x(i);
+        } else if (i < n + n_eq) {
+          block_results.y(idx) = results.y(i - n);
+        } else {
+          block_results.z(idx) = results.z(i - n - n_eq);
+        }
+      }
+    }
+
+#ifdef PROXSUITE_WITH_MULTITHREADING
+    // the blocks are distributed dynamically, their solve times being
+    // possibly very different
+    std::atomic<isize> next_block{ 0 };
+    auto solve_next_blocks = [&]() -> void {
+      for (isize k = next_block++; k < n_blocks; k = next_block++) {
+        blocks[usize(k)].solve();
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(usize(n_threads - 1));
+    for (isize t = 1; t < n_threads; ++t) {
+      threads.emplace_back(solve_next_blocks);
+    }
+    solve_next_blocks();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+#else
+    for (QP& qp : blocks) {
+      qp.solve();
+    }
+#endif
+
+    for (isize i = 0; i < n_tot; ++i) {
+      Results<T> const& block_results = blocks[usize(block[usize(i)])].results;
+      isize idx = index[usize(i)];
+      if (i < n) {
+        results.x(i) = block_results.x(idx);
+      } else if (i < n + n_eq) {
+        results.y(i - n) = block_results.y(idx);
+      } else {
+        results.z(i - n - n_eq) = block_results.z(idx);
+        results.active_constraints[i - n - n_eq] =
+          block_results.active_constraints[idx];
+      }
+    }
+    Info<T>& info = results.info;
+    info.status = QPSolverOutput::PROXQP_SOLVED;
+    info.iter = 0;
+    info.iter_ext = 0;
+    info.mu_updates = 0;
+    info.rho_updates = 0;
+    info.polished = true;
+    info.objValue = 0;
+    info.pri_res = 0;
+    info.dua_res = 0;
+    for (QP const& qp : blocks) {
+      Info<T> const& block_info = qp.results.info;
+      if (info.status == QPSolverOutput::PROXQP_SOLVED) {
+        info.status = block_info.status;
+      }
+      info.iter += block_info.iter;
+      info.iter_ext += block_info.iter_ext;
+      info.mu_updates += block_info.mu_updates;
+      info.rho_updates += block_info.rho_updates;
+      info.polished = info.polished && block_info.polished;
+      info.objValue += block_info.objValue;
+      info.pri_res = std::max(info.pri_res, block_info.pri_res);
+      info.dua_res = std::max(info.dua_res, block_info.dua_res);
+    }
+    if (settings.compute_timings) {
+      info.solve_time = work.timer.elapsed().user; // in microseconds
+      info.run_time = info.solve_time + info.setup_time;
+    }
+  }
 };
 /*!
  * Solves the QP problem using PROXQP algorithm without the need to define a QP
@@ -19,7 +19,8 @@ enum struct QPSolverOutput
   PROXQP_SOLVED,           // the problem is solved.
   PROXQP_MAX_ITER_REACHED, // the maximum number of iterations has been reached.
   PROXQP_PRIMAL_INFEASIBLE, // the problem is primal infeasible.
-  PROXQP_DUAL_INFEASIBLE    // the problem is dual infeasible.
+  PROXQP_DUAL_INFEASIBLE,   // the problem is dual infeasible.
+  PROXQP_TIME_LIMIT_REACHED // the time limit has been reached.
 };
 // INITIAL GUESS STATUS
 enum struct InitialGuessStatus
@@ -38,6 +39,12 @@ enum struct PreconditionerStatus
   IDENTITY // do not execute, hence use identity preconditioner (for init
            // method)
 };
+// SOLVER METHOD
+enum struct SolverMethod
+{
+  PROXQP,        // proximal augmented Lagrangian with semi-smooth Newton steps
+  INTERIOR_POINT // primal-dual interior-point (Mehrotra predictor-corrector)
+};
 
 } // namespace proxqp
 } // namespace proxsuite
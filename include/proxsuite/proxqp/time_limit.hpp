@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file time_limit.hpp
+ */
+#ifndef PROXSUITE_QP_TIME_LIMIT_HPP
+#define PROXSUITE_QP_TIME_LIMIT_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include "proxsuite/proxqp/timings.hpp"
+#include "proxsuite/proxqp/sparse/fwd.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+///
+/// @brief Deadline of a solve.
+///
+/*!
+ * The deadline is stored in ticks of detail::Clock, so that checking it costs
+ * a single read of the clock, and nothing when no time limit is set.
+ */
+struct Deadline
+{
+  Deadline()
+    : m_is_set(false)
+    , m_end(0)
+  {
+  }
+  /*!
+   * Starts the countdown, ending at the earliest of the two limits. The
+   * deadline is unset if both are infinite.
+   * @param time_limit maximal duration from now, in microseconds.
+   * @param deadline absolute deadline, std::chrono::steady_clock::time_point's
+   * max() if none.
+   */
+  template<typename T>
+  void start(T time_limit, std::chrono::steady_clock::time_point deadline)
+  {
+    using namespace std::chrono;
+    double remaining = double(time_limit);
+    if (deadline != steady_clock::time_point::max()) {
+      double until_deadline =
+        double(duration_cast<nanoseconds>(deadline - steady_clock::now())
+                 .count()) *
+        1e-3;
+      remaining = std::min(remaining, until_deadline);
+    }
+    m_is_set = remaining < std::numeric_limits<double>::infinity();
+    if (!m_is_set) {
+      return;
+    }
+    std::int64_t now = detail::Clock::now();
+    double ticks = std::max(remaining, 0.) / detail::Clock::to_microseconds(1);
+    if (ticks < double(std::numeric_limits<std::int64_t>::max() - now)) {
+      m_end = now + std::int64_t(ticks);
+    } else {
+      m_end = std::numeric_limits<std::int64_t>::max();
+    }
+  }
+  /*!
+   * Unsets the deadline.
+   */
+  void clear() { m_is_set = false; }
+  bool is_set() const noexcept { return m_is_set; }
+  bool reached() const noexcept
+  {
+    return m_is_set && detail::Clock::now() >= m_end;
+  }
+
+private:
+  bool m_is_set;
+  std::int64_t m_end;
+};
+
+///
+/// @brief Best iterate of a solve stopped by its deadline.
+///
+/*!
+ * The iterates are ranked by a merit function, which is the largest of their
+ * primal and dual residuals (and of their complementarity gap for the
+ * interior-point method).
+ */
+template<typename T>
+struct BestIterate
+{
+  sparse::Vec<T> x;
+  sparse::Vec<T> y;
+  sparse::Vec<T> z;
+  T merit;
+  T pri_res;
+  T dua_res;
+
+  BestIterate()
+    : merit(std::numeric_limits<T>::infinity())
+    , pri_res(0)
+    , dua_res(0)
+  {
+  }
+  /*!
+   * Allocates the iterate, when its dimensions change, and clears it.
+   */
+  void resize(sparse::isize n, sparse::isize n_eq, sparse::isize n_in)
+  {
+    x.resize(n);
+    y.resize(n_eq);
+    z.resize(n_in);
+    reset();
+  }
+  void reset() { merit = std::numeric_limits<T>::infinity(); }
+  bool is_set() const
+  {
+    return merit < std::numeric_limits<T>::infinity();
+  }
+  /*!
+   * Keeps the iterate (x_, y_, z_) if its merit is lower than the one of the
+   * best iterate.
+   */
+  template<typename X, typename Y, typename Z>
+  void update(X const& x_,
+              Y const& y_,
+              Z const& z_,
+              T pri_res_,
+              T dua_res_,
+              T merit_)
+  {
+    if (merit_ < merit) {
+      x = x_;
+      y = y_;
+      z = z_;
+      pri_res = pri_res_;
+      dua_res = dua_res_;
+      merit = merit_;
+    }
+  }
+};
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_TIME_LIMIT_HPP */
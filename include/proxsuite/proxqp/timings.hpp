@@ -6,6 +6,23 @@
 #define PROXSUITE_QP_TIMINGS_HPP
 
 #include <chrono>
+#include <cstdint>
+
+#ifdef PROXSUITE_WITH_TSC_TIMER
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||            \
+  defined(_M_IX86)
+#define PROXSUITE_TIMER_HAS_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+#endif
 
 namespace proxsuite {
 namespace proxqp {
@@ -26,11 +43,115 @@ struct CPUTimes
   void clear() { wall = user = system = 0; }
 };
 
+namespace detail {
+///
+/// @brief Clock of the timers, counting in ticks.
+///
+/*!
+ * By default, a tick is a nanosecond of std::chrono::steady_clock. When
+ * PROXSUITE_WITH_TSC_TIMER is defined, the ticks are read from the time stamp
+ * counter of x86 processors with a single instruction. The counter is
+ * calibrated once against steady_clock, at the first use of a timer. If the
+ * counter is not available or not invariant (i.e., its rate may change with
+ * the frequency of the processor), clock_gettime(CLOCK_MONOTONIC_RAW) is used
+ * instead.
+ */
+struct Clock
+{
+  static std::int64_t now() noexcept
+  {
+#ifdef PROXSUITE_TIMER_HAS_TSC
+    if (tsc().invariant) {
+      return std::int64_t(__rdtsc());
+    }
+#endif
+#if defined(PROXSUITE_WITH_TSC_TIMER) && defined(CLOCK_MONOTONIC_RAW)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return std::int64_t(ts.tv_sec) * 1000000000 + std::int64_t(ts.tv_nsec);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+  }
+  static double to_microseconds(std::int64_t ticks) noexcept
+  {
+#ifdef PROXSUITE_TIMER_HAS_TSC
+    if (tsc().invariant) {
+      return double(ticks) * tsc().microseconds_per_tick;
+    }
+#endif
+    return double(ticks) * 1e-3;
+  }
+
+#ifdef PROXSUITE_TIMER_HAS_TSC
+  struct Tsc
+  {
+    bool invariant;
+    double microseconds_per_tick;
+  };
+  static Tsc const& tsc() noexcept
+  {
+    static Tsc const value = calibrate_tsc();
+    return value;
+  }
+  static bool tsc_is_invariant() noexcept
+  {
+    // bit 8 of edx for the leaf 0x80000007 of cpuid
+#ifdef _MSC_VER
+    int regs[4];
+    __cpuid(regs, int(0x80000000));
+    if (unsigned(regs[0]) < 0x80000007u) {
+      return false;
+    }
+    __cpuid(regs, int(0x80000007));
+    return (unsigned(regs[3]) >> 8) & 1u;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) == 0 ||
+        eax < 0x80000007u) {
+      return false;
+    }
+    __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+    return (edx >> 8) & 1u;
+#endif
+  }
+  static Tsc calibrate_tsc() noexcept
+  {
+    Tsc res{ false, 0 };
+    if (!tsc_is_invariant()) {
+      return res;
+    }
+    // counts the ticks during two milliseconds of steady_clock
+    using namespace std::chrono;
+    steady_clock::time_point t0 = steady_clock::now();
+    std::int64_t c0 = std::int64_t(__rdtsc());
+    steady_clock::time_point t1;
+    do {
+      t1 = steady_clock::now();
+    } while (t1 - t0 < milliseconds(2));
+    std::int64_t c1 = std::int64_t(__rdtsc());
+    if (c1 > c0) {
+      res.invariant = true;
+      res.microseconds_per_tick =
+        double(duration_cast<nanoseconds>(t1 - t0).count()) * 1e-3 /
+        double(c1 - c0);
+    }
+    return res;
+  }
+#endif
+};
+} // namespace detail
+
 ///
 /// @brief This class mimics the way "boost/timer/timer.hpp" operates while
 /// using the modern std::chrono library.
 /// Importantly, this class will only have an effect for C++11 and more.
 ///
+/*!
+ * The clock it reads is chosen at compile time (see detail::Clock).
+ */
 template<typename T>
 struct Timer
 {
@@ -46,13 +167,8 @@ struct Timer
       return m_times;
 
     CPUTimes current(m_times);
-    std::chrono::time_point<std::chrono::steady_clock> current_clock =
-      std::chrono::steady_clock::now();
-    current.user +=
-      static_cast<T>(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                       current_clock - m_start)
-                       .count()) *
-      1e-3;
+    current.user += detail::Clock::to_microseconds(detail::Clock::now() -
+                                                   m_start);
 
     return current;
   }
@@ -62,7 +178,7 @@ struct Timer
     if (m_is_stopped) {
       m_is_stopped = false;
       m_times.clear();
-      m_start = std::chrono::steady_clock::now();
+      m_start = detail::Clock::now();
     }
   }
 
@@ -72,18 +188,16 @@ struct Timer
       return;
     m_is_stopped = true;
 
-    m_end = std::chrono::steady_clock::now();
-    m_times.user +=
-      static_cast<double>(
-        std::chrono::duration_cast<std::chrono::nanoseconds>(m_end - m_start)
-          .count()) *
-      1e-3;
+    m_end = detail::Clock::now();
+    m_times.user += detail::Clock::to_microseconds(m_end - m_start);
   }
 
   void resume()
   {
-    if (m_is_stopped)
-      m_start = std::chrono::steady_clock::now();
+    if (m_is_stopped) {
+      m_is_stopped = false;
+      m_start = detail::Clock::now();
+    }
   }
 
   bool is_stopped() const { return m_is_stopped; }
@@ -92,7 +206,87 @@ protected:
   CPUTimes m_times;
   bool m_is_stopped;
 
-  std::chrono::time_point<std::chrono::steady_clock> m_start, m_end;
+  std::int64_t m_start, m_end;
+};
+
+// SOLVER PHASES (timed when PROXSUITE_WITH_PHASE_TIMINGS is defined)
+enum struct Phase
+{
+  EQUILIBRATION,        // ruiz equilibration and scaling of the model
+  FACTORIZATION,        // initial factorization of the kkt matrix
+  REFACTORIZATION,      // refactorizations and proximal parameter updates
+  ACTIVE_SET_UPDATE,    // row additions and deletions of the active set
+  ITERATIVE_REFINEMENT, // solves of the newton steps
+  LINE_SEARCH,          // primal dual line search
+  RESIDUALS,            // evaluation of the primal and dual residuals
+  POLISH,               // polishing steps
+};
+static constexpr int n_phases = 8;
+
+///
+/// @brief This class stores the cumulative time and the number of calls of
+/// each phase of the solver.
+///
+/*!
+ * The phases measure the last setup and solve of a QP object, or the last
+ * solve if it is solved again without an intermediary update. A phase may
+ * include another one (e.g., a solve with iterative refinement may trigger a
+ * refactorization). It stays at zero unless PROXSUITE_WITH_PHASE_TIMINGS is
+ * defined.
+ */
+template<typename T>
+struct PhaseTimings
+{
+  T times[n_phases];             // in microseconds
+  std::int64_t counts[n_phases]; // number of calls
+
+  T time(Phase phase) const { return times[int(phase)]; }
+  std::int64_t count(Phase phase) const { return counts[int(phase)]; }
+  void clear()
+  {
+    for (int k = 0; k < n_phases; ++k) {
+      times[k] = T(0);
+      counts[k] = 0;
+    }
+  }
+};
+
+///
+/// @brief Scoped timer adding the time spent in its scope to a phase.
+///
+/*!
+ * It is empty and its calls are inlined to nothing when
+ * PROXSUITE_WITH_PHASE_TIMINGS is not defined.
+ */
+template<typename T>
+struct PhaseTimer
+{
+#ifdef PROXSUITE_WITH_PHASE_TIMINGS
+  PhaseTimer(PhaseTimings<T>& timings, Phase phase)
+    : m_timings(timings)
+    , m_phase(int(phase))
+    , m_start(detail::Clock::now())
+  {
+  }
+  ~PhaseTimer()
+  {
+    m_timings.times[m_phase] +=
+      static_cast<T>(detail::Clock::to_microseconds(detail::Clock::now() -
+                                                    m_start));
+    ++m_timings.counts[m_phase];
+  }
+#else
+  PhaseTimer(PhaseTimings<T>& /*timings*/, Phase /*phase*/) noexcept {}
+#endif
+  PhaseTimer(PhaseTimer const&) = delete;
+  PhaseTimer& operator=(PhaseTimer const&) = delete;
+
+#ifdef PROXSUITE_WITH_PHASE_TIMINGS
+private:
+  PhaseTimings<T>& m_timings;
+  int m_phase;
+  std::int64_t m_start;
+#endif
 };
 
 } // namespace proxqp
@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2022 INRIA
+//
+/**
+ * @file trace.hpp
+ */
+#ifndef PROXSUITE_QP_TRACE_HPP
+#define PROXSUITE_QP_TRACE_HPP
+
+#include <proxsuite/linalg/veg/internal/macros.hpp>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "proxsuite/proxqp/timings.hpp"
+
+namespace proxsuite {
+namespace proxqp {
+namespace trace {
+///
+/// @brief Span of the solvers, with the ticks of its start and end.
+///
+struct Event
+{
+  char const* name;   // static string naming the span
+  std::int64_t index; // iteration of the span, or -1
+  std::int64_t start;
+  std::int64_t end;
+};
+
+///
+/// @brief In-memory buffer of the spans of the solvers.
+///
+/*!
+ * The spans are recorded only when PROXSUITE_WITH_TRACING is defined, by the
+ * thread in which a Session of the recorder is open. They are buffered and
+ * written once the solve is done, so that tracing does not perturb the
+ * measured times with file writes.
+ *
+ * Example:
+ * \code
+ * trace::Recorder recorder;
+ * {
+ *   trace::Session session(recorder);
+ *   qp.init(H, g, A, b, C, l, u);
+ *   qp.solve();
+ * }
+ * recorder.write_chrome_trace("proxqp_trace.json");
+ * \endcode
+ */
+struct Recorder
+{
+  /*!
+   * Constructor.
+   * @param capacity number of events reserved upfront.
+   */
+  explicit Recorder(std::size_t capacity = 4096)
+    : origin(proxqp::detail::Clock::now())
+  {
+    events.reserve(capacity);
+  }
+
+  void record(Event const& event) { events.push_back(event); }
+  void clear()
+  {
+    events.clear();
+    origin = proxqp::detail::Clock::now();
+  }
+  /*!
+   * Writes the recorded spans as complete events of the Chrome trace event
+   * format, readable by chrome://tracing or Perfetto.
+   * @param path path of the JSON file.
+   */
+  void write_chrome_trace(std::string const& path) const
+  {
+    using proxqp::detail::Clock;
+    std::ofstream out(path, std::ios::trunc);
+    PROXSUITE_THROW_PRETTY(!out,
+                           std::runtime_error,
+                           "the trace file " << path
+                                             << " could not be opened.");
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (std::size_t k = 0; k < events.size(); ++k) {
+      Event const& event = events[k];
+      out << (k == 0 ? "\n" : ",\n") << "{\"name\":\"" << event.name
+          << "\",\"cat\":\"proxqp\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+          << ",\"ts\":" << Clock::to_microseconds(event.start - origin)
+          << ",\"dur\":" << Clock::to_microseconds(event.end - event.start);
+      if (event.index >= 0) {
+        out << ",\"args\":{\"index\":" << event.index << "}";
+      }
+      out << "}";
+    }
+    out << "\n]}\n";
+    PROXSUITE_THROW_PRETTY(!out,
+                           std::runtime_error,
+                           "writing the trace file failed.");
+  }
+
+  std::vector<Event> events;
+  std::int64_t origin; // ticks of the time origin of the trace
+};
+
+namespace detail {
+inline Recorder*&
+current_recorder() noexcept
+{
+  static thread_local Recorder* recorder = nullptr;
+  return recorder;
+}
+} // namespace detail
+
+///
+/// @brief Scope during which the spans of the current thread are recorded.
+///
+struct Session
+{
+  explicit Session(Recorder& recorder)
+    : previous(detail::current_recorder())
+  {
+    detail::current_recorder() = &recorder;
+  }
+  ~Session() { detail::current_recorder() = previous; }
+  Session(Session const&) = delete;
+  Session& operator=(Session const&) = delete;
+
+private:
+  Recorder* previous;
+};
+
+///
+/// @brief Scoped span of the solvers.
+///
+/*!
+ * It is empty and its calls are inlined to nothing when
+ * PROXSUITE_WITH_TRACING is not defined.
+ */
+struct Span
+{
+#ifdef PROXSUITE_WITH_TRACING
+  explicit Span(char const* name, std::int64_t index = -1) noexcept
+    : recorder(detail::current_recorder())
+    , event{ name, index, 0, 0 }
+  {
+    if (recorder != nullptr) {
+      event.start = proxqp::detail::Clock::now();
+    }
+  }
+  ~Span()
+  {
+    if (recorder != nullptr) {
+      event.end = proxqp::detail::Clock::now();
+      recorder->record(event);
+    }
+  }
+#else
+  explicit Span(char const* /*name*/, std::int64_t /*index*/ = -1) noexcept {}
+#endif
+  Span(Span const&) = delete;
+  Span& operator=(Span const&) = delete;
+
+#ifdef PROXSUITE_WITH_TRACING
+private:
+  Recorder* recorder;
+  Event event;
+#endif
+};
+
+} // namespace trace
+} // namespace proxqp
+} // namespace proxsuite
+
+#endif /* end of include guard PROXSUITE_QP_TRACE_HPP */
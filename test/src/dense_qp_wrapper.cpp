@@ -4270,3 +4270,943 @@ TEST_CASE("Test g update for different warm start with previous result option")
   std::cout << "setup timing " << Qp2.results.info.setup_time << " solve time "
             << Qp2.results.info.solve_time << std::endl;
 }
+
+DOCTEST_TEST_CASE("sparse random strongly convex qp with equality and "
+                  "inequality constraints: test loading the preconditioner "
+                  "of another QP object")
+{
+  std::cout << "---testing sparse random strongly convex qp with equality and "
+               "inequality constraints: test loading the preconditioner of "
+               "another QP object---"
+            << std::endl;
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 10;
+
+  dense::isize n_eq(dim / 4);
+  dense::isize n_in(dim / 4);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in }; // creating QP object
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+
+  // same problem family: only the vectors change
+  auto g = utils::rand::vector_rand<T>(dim);
+  dense::QP<T> Qp2{ dim, n_eq, n_in };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.load_preconditioner(Qp.ruiz.delta, Qp.ruiz.c);
+  Qp2.init(qp.H, g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  CHECK(Qp2.ruiz.delta == Qp.ruiz.delta);
+  CHECK(Qp2.ruiz.c == Qp.ruiz.c);
+  Qp2.solve();
+
+  T pri_res = std::max((qp.A * Qp2.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                       (dense::positive_part(qp.C * Qp2.results.x - qp.u) +
+                        dense::negative_part(qp.C * Qp2.results.x - qp.l))
+                         .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp2.results.x + g + qp.A.transpose() * Qp2.results.y +
+               qp.C.transpose() * Qp2.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+  CHECK(pri_res <= eps_abs);
+
+  // re-initializing without preconditioner discards the loaded one
+  Qp2.init(qp.H, g, qp.A, qp.b, qp.C, qp.u, qp.l, false);
+  CHECK(Qp2.ruiz.delta == dense::Vec<T>::Ones(dim + n_eq + n_in));
+  CHECK(Qp2.ruiz.c == T(1));
+
+  // the dimension of the scaling variables is checked
+  dense::QP<T> Qp3{ dim + 1, n_eq, n_in };
+  CHECK_THROWS(Qp3.load_preconditioner(Qp.ruiz.delta, Qp.ruiz.c));
+
+  std::cout << "--n = " << dim << " n_eq " << n_eq << " n_in " << n_in
+            << std::endl;
+  std::cout << "; dual residual " << dua_res << "; primal residual " << pri_res
+            << std::endl;
+  std::cout << "total number of iteration: " << Qp2.results.info.iter
+            << std::endl;
+}
+
+DOCTEST_TEST_CASE("sparse random strongly convex qp with equality and "
+                  "inequality constraints: test saving and loading a snapshot "
+                  "of the QP object")
+{
+  std::cout << "---testing sparse random strongly convex qp with equality and "
+               "inequality constraints: test saving and loading a snapshot of "
+               "the QP object---"
+            << std::endl;
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 10;
+
+  dense::isize n_eq(dim / 4);
+  dense::isize n_in(dim / 4);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in }; // creating QP object
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  // an absolute deadline is not saved
+  Qp.settings.deadline =
+    std::chrono::steady_clock::now() + std::chrono::hours(1);
+  std::string path = "dense_qp_wrapper_snapshot.bin";
+  Qp.save_snapshot(path);
+
+  // the QP object is resized to the dimensions of the snapshot
+  dense::QP<T> Qp2{ 1, 0, 0 };
+  Qp2.load_snapshot(path);
+  CHECK(Qp2.model.dim == dim);
+  CHECK(Qp2.model.H == qp.H);
+  CHECK(Qp2.ruiz.delta == Qp.ruiz.delta);
+  CHECK(Qp2.ruiz.c == Qp.ruiz.c);
+  CHECK(Qp2.results.x == Qp.results.x);
+  CHECK(Qp2.settings.eps_abs == eps_abs);
+  CHECK(Qp2.settings.deadline == std::chrono::steady_clock::time_point::max());
+  // warm started with the previous result and the loaded factorization
+  Qp2.solve();
+
+  T pri_res = std::max((qp.A * Qp2.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                       (dense::positive_part(qp.C * Qp2.results.x - qp.u) +
+                        dense::negative_part(qp.C * Qp2.results.x - qp.l))
+                         .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp2.results.x + qp.g + qp.A.transpose() * Qp2.results.y +
+               qp.C.transpose() * Qp2.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+  CHECK(pri_res <= eps_abs);
+  CHECK(Qp2.results.info.iter <= Qp.results.info.iter);
+
+  std::remove(path.c_str());
+  CHECK_THROWS(Qp2.load_snapshot(path));
+
+  std::cout << "--n = " << dim << " n_eq " << n_eq << " n_in " << n_in
+            << std::endl;
+  std::cout << "; dual residual " << dua_res << "; primal residual " << pri_res
+            << std::endl;
+  std::cout << "total number of iteration: " << Qp2.results.info.iter
+            << std::endl;
+}
+
+DOCTEST_TEST_CASE("sparse random strongly convex qp with equality and "
+                  "inequality constraints: test a model not owning its "
+                  "matrices")
+{
+  std::cout << "---testing sparse random strongly convex qp with equality and "
+               "inequality constraints: test a model not owning its "
+               "matrices---"
+            << std::endl;
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 10;
+
+  dense::isize n_eq(dim / 4);
+  dense::isize n_in(dim / 4);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in }; // creating QP object
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+
+  dense::QP<T> Qp2{ dim, n_eq, n_in, dense::ModelStorage::NON_OWNING };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  CHECK(Qp2.model.H.size() == 0);
+  CHECK(Qp2.model.A.size() == 0);
+  CHECK(Qp2.model.C.size() == 0);
+  Qp2.solve();
+  CHECK(Qp2.results.info.iter == Qp.results.info.iter);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-12);
+  CHECK(std::abs(Qp2.results.info.objValue - Qp.results.info.objValue) <=
+        1e-12);
+  // solving anew re-uses the scaled matrices
+  Qp2.solve();
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-12);
+
+  // updating the vectors recovers the matrices from their scaled copy
+  auto g = utils::rand::vector_rand<T>(dim);
+  Qp.update(std::nullopt, g, std::nullopt, std::nullopt, std::nullopt,
+            std::nullopt, std::nullopt);
+  Qp.solve();
+  Qp2.update(std::nullopt, g, std::nullopt, std::nullopt, std::nullopt,
+             std::nullopt, std::nullopt);
+  Qp2.solve();
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-9);
+
+  // updating a matrix only
+  qp.H.diagonal().array() += T(1);
+  Qp.update(qp.H, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+            std::nullopt, std::nullopt);
+  Qp.solve();
+  Qp2.update(qp.H, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+             std::nullopt, std::nullopt);
+  Qp2.solve();
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-9);
+  CHECK(std::abs(Qp2.results.info.objValue - Qp.results.info.objValue) <=
+        1e-9);
+
+  T pri_res = std::max((qp.A * Qp2.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                       (dense::positive_part(qp.C * Qp2.results.x - qp.u) +
+                        dense::negative_part(qp.C * Qp2.results.x - qp.l))
+                         .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp2.results.x + g + qp.A.transpose() * Qp2.results.y +
+               qp.C.transpose() * Qp2.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+  CHECK(pri_res <= eps_abs);
+  CHECK_THROWS(Qp2.model.to_sparse());
+
+  std::cout << "--n = " << dim << " n_eq " << n_eq << " n_in " << n_in
+            << std::endl;
+  std::cout << "; dual residual " << dua_res << "; primal residual " << pri_res
+            << std::endl;
+  std::cout << "total number of iteration: " << Qp2.results.info.iter
+            << std::endl;
+}
+
+TEST_CASE("dense QP: observing the outer iterations of a solve")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 20;
+  dense::isize n_eq(dim / 4);
+  dense::isize n_in(dim / 4);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  RingBufferObserver<T> observer(3);
+  Qp.solve(observer);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // the records are taken at the start of each outer iteration
+  CHECK(observer.total() > 3);
+  CHECK(observer.total() <= Qp.results.info.iter_ext + 1);
+  CHECK(observer.size() == 3);
+  IterationRecord<T> const& last = observer.back();
+  CHECK(last.iter == observer.total() - 1);
+  CHECK(last.iter_inner <= Qp.results.info.iter);
+  CHECK(last.pri_res >= 0);
+  CHECK(last.dua_res >= 0);
+  CHECK(last.mu_in > 0);
+  CHECK(last.rho == Qp.results.info.rho);
+  CHECK(last.n_active >= 0);
+  CHECK(last.n_active <= n_in);
+  for (dense::isize k = 1; k < observer.size(); ++k) {
+    CHECK(observer[k].iter == observer[k - 1].iter + 1);
+  }
+
+  // the same solve without observer
+  dense::QP<T> Qp2{ dim, n_eq, n_in };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.iter == Qp.results.info.iter);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() == 0);
+}
+
+TEST_CASE("dense QP: condensed KKT mode with many inequality constraints")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 10;
+  dense::isize n_eq(2);
+  dense::isize n_in(60);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  CHECK(dense::resolve_kkt_mode(dense::KktMode::AUTOMATIC, dim, n_eq, n_in) ==
+        dense::KktMode::CONDENSED);
+  CHECK(dense::resolve_kkt_mode(dense::KktMode::AUTOMATIC, dim, n_eq, 5) ==
+        dense::KktMode::AUGMENTED);
+  CHECK(dense::resolve_kkt_mode(dense::KktMode::AUGMENTED, dim, n_eq, n_in) ==
+        dense::KktMode::AUGMENTED);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  CHECK(Qp.work.kkt_mode == dense::KktMode::CONDENSED);
+  CHECK(Qp.work.kkt.rows() == dim);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  T pri_res = std::max(
+    (qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+    (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+     dense::negative_part(qp.C * Qp.results.x - qp.l))
+      .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+  CHECK(pri_res <= eps_abs);
+
+  // same solution with the augmented KKT system
+  dense::QP<T> Qp2{
+    dim, n_eq, n_in, dense::ModelStorage::OWNING, dense::KktMode::AUGMENTED
+  };
+  CHECK(Qp2.work.kkt.rows() == dim + n_eq);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+
+  // warm started re-solve, which updates the active set of the factorization
+  Qp.settings.initial_guess = InitialGuessStatus::WARM_START;
+  Qp.solve(Qp.results.x, Qp.results.y, Qp.results.z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+}
+
+TEST_CASE("dense QP: dual KKT mode with a large primal dimension")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 80;
+  dense::isize n_eq(3);
+  dense::isize n_in(12);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+  dense::Mat<T> H_diagonal = qp.H.diagonal().asDiagonal();
+
+  // the AUTOMATIC mode chooses the dual KKT system for a diagonal H only
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  CHECK(Qp.work.kkt_mode == dense::KktMode::AUGMENTED);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(H_diagonal, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.work.kkt_mode == dense::KktMode::DUAL);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  T pri_res = std::max(
+    (qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+    (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+     dense::negative_part(qp.C * Qp.results.x - qp.l))
+      .lpNorm<Eigen::Infinity>());
+  T dua_res = (H_diagonal * Qp.results.x + qp.g +
+               qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+  CHECK(pri_res <= eps_abs);
+
+  dense::QP<T> Qp2{
+    dim, n_eq, n_in, dense::ModelStorage::OWNING, dense::KktMode::AUGMENTED
+  };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(H_diagonal, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+
+  // warm started re-solve, which updates the active set of the factorization
+  Qp.settings.initial_guess = InitialGuessStatus::WARM_START;
+  Qp.solve(Qp.results.x, Qp.results.y, Qp.results.z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+
+  // a non diagonal H falls back to the augmented KKT system
+  Qp.settings.initial_guess =
+    InitialGuessStatus::EQUALITY_CONSTRAINED_INITIAL_GUESS;
+  Qp.update(qp.H,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt);
+  Qp.solve();
+  CHECK(Qp.work.kkt_mode == dense::KktMode::AUGMENTED);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // unless the dual KKT system is requested, H + rho I being then factorized
+  dense::QP<T> Qp3{
+    dim, n_eq, n_in, dense::ModelStorage::OWNING, dense::KktMode::DUAL
+  };
+  CHECK(Qp3.work.kkt.size() == 0);
+  Qp3.settings.eps_abs = eps_abs;
+  Qp3.settings.eps_rel = 0;
+  Qp3.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp3.solve();
+  CHECK(Qp3.work.kkt_mode == dense::KktMode::DUAL);
+  CHECK(!Qp3.work.h_diagonal);
+  CHECK(Qp3.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp3.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+}
+
+TEST_CASE("dense QP: banded KKT mode with a stage-wise MPC problem")
+{
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize nx = 4;
+  dense::isize nu = 2;
+  dense::isize n_stages = 15;
+
+  // random dynamics, input bounds and a bound on the first state component
+  std::vector<dense::Stage<T>> stages(static_cast<std::size_t>(n_stages));
+  for (dense::isize k = 0; k < n_stages; ++k) {
+    dense::Stage<T>& stage = stages[static_cast<std::size_t>(k)];
+    bool last = k + 1 == n_stages;
+    dense::isize nu_k = last ? 0 : nu;
+    stage.Q = utils::rand::positive_definite_rand<T>(nx, T(1e-2));
+    stage.R.resize(0, 0);
+    if (!last) {
+      stage.R = utils::rand::positive_definite_rand<T>(nu, T(1e-2));
+    }
+    stage.q = utils::rand::vector_rand<T>(nx);
+    stage.r = utils::rand::vector_rand<T>(nu_k);
+    if (!last) {
+      stage.A = dense::Mat<T>::Identity(nx, nx) +
+                T(0.1) * utils::rand::matrix_rand<T>(nx, nx);
+      stage.B = utils::rand::matrix_rand<T>(nx, nu);
+      stage.c = T(0.1) * utils::rand::vector_rand<T>(nx);
+    }
+    stage.Cx = dense::Mat<T>::Zero(nu_k + 1, nx);
+    stage.Cx(nu_k, 0) = T(1);
+    stage.Cu = dense::Mat<T>::Zero(nu_k + 1, nu_k);
+    stage.Cu.topRows(nu_k).setIdentity();
+    stage.l = dense::Vec<T>::Constant(nu_k + 1, T(-0.2));
+    stage.u = dense::Vec<T>::Constant(nu_k + 1, T(0.2));
+  }
+  dense::Vec<T> x_init = dense::Vec<T>::Constant(nx, T(0.1));
+  dense::Model<T> qp = dense::stagewise_model(stages, x_init);
+  CHECK(qp.dim == n_stages * nx + (n_stages - 1) * nu);
+  CHECK(qp.n_eq == n_stages * nx);
+  CHECK(qp.n_in == n_stages + (n_stages - 1) * nu);
+
+  dense::QP<T> Qp{ qp.dim,
+                   qp.n_eq,
+                   qp.n_in,
+                   dense::ModelStorage::OWNING,
+                   dense::KktMode::BANDED };
+  CHECK(Qp.work.kkt_mode == dense::KktMode::BANDED);
+  CHECK(Qp.work.kkt.size() == 0);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp.results.z.array() != 0).count() > 0);
+  // the bandwidth spans a few stages instead of the whole horizon
+  CHECK(Qp.work.band_ldl.dim() == qp.n_total);
+  CHECK(Qp.work.band_ldl.bandwidth() <= 3 * (2 * nx + nu));
+
+  T pri_res = std::max(
+    (qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+    (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+     dense::negative_part(qp.C * Qp.results.x - qp.l))
+      .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+  CHECK(pri_res <= eps_abs);
+
+  // same solution with the augmented KKT system
+  dense::QP<T> Qp2{ qp.dim,
+                    qp.n_eq,
+                    qp.n_in,
+                    dense::ModelStorage::OWNING,
+                    dense::KktMode::AUGMENTED };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+  CHECK((Qp2.results.z - Qp.results.z).lpNorm<Eigen::Infinity>() <= 1e-6);
+
+  // warm started re-solve from a new initial state, which updates the active
+  // set of the factorization
+  x_init.setConstant(T(-0.15));
+  qp.b.head(nx) = x_init;
+  Qp.settings.initial_guess = InitialGuessStatus::WARM_START;
+  Qp.update(std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            qp.b,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt);
+  Qp.solve(Qp.results.x, Qp.results.y, Qp.results.z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  Qp2.update(std::nullopt,
+             std::nullopt,
+             std::nullopt,
+             qp.b,
+             std::nullopt,
+             std::nullopt,
+             std::nullopt);
+  Qp2.solve();
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+
+  // the factorization is restored from a snapshot
+  std::string path = "dense_qp_wrapper_banded_snapshot.bin";
+  Qp.save_snapshot(path);
+  dense::QP<T> Qp3{ 1, 0, 0 };
+  Qp3.load_snapshot(path);
+  std::remove(path.c_str());
+  CHECK(Qp3.work.kkt_mode == dense::KktMode::BANDED);
+  CHECK(Qp3.work.band_ldl.bandwidth() == Qp.work.band_ldl.bandwidth());
+  Qp3.settings.initial_guess =
+    InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT;
+  Qp3.solve();
+  CHECK(Qp3.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp3.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+}
+
+TEST_CASE("dense QP: polishing of the solution")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 50;
+  dense::isize n_eq(10);
+  dense::isize n_in(25);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.polish = true;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.results.info.polished);
+
+  T pri_res = std::max((qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                       (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+                        dense::negative_part(qp.C * Qp.results.x - qp.l))
+                         .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(pri_res <= eps_abs);
+  CHECK(dua_res <= eps_abs);
+
+  // same solution in no more iterations than without polishing
+  dense::QP<T> Qp2{ dim, n_eq, n_in };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(!Qp2.results.info.polished);
+  CHECK(Qp.results.info.iter <= Qp2.results.info.iter);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+  CHECK((Qp2.results.z - Qp.results.z).lpNorm<Eigen::Infinity>() <= 1e-6);
+}
+
+TEST_CASE("dense QP: Anderson acceleration of the outer loop")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 50;
+  dense::isize n_eq(10);
+  dense::isize n_in(25);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  // the Martinez update keeps the proximal parameters constant over several
+  // outer iterations
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.bcl_update = false;
+  Qp.settings.anderson_acceleration = true;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  T pri_res = std::max((qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                       (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+                        dense::negative_part(qp.C * Qp.results.x - qp.l))
+                         .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(pri_res <= eps_abs);
+  CHECK(dua_res <= eps_abs);
+
+  // same solution in no more outer iterations than without acceleration
+  dense::QP<T> Qp2{ dim, n_eq, n_in };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.settings.bcl_update = false;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.results.info.iter_ext <= Qp2.results.info.iter_ext);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+
+  // the memory of the previous solve is not used by a warm started one
+  qp.g += T(1e-2) * utils::rand::vector_rand<T>(dim);
+  Qp.update(std::nullopt,
+            qp.g,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+             qp.C.transpose() * Qp.results.z)
+              .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+}
+
+TEST_CASE("dense QP: interior point method")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 50;
+  dense::isize n_eq(10);
+  dense::isize n_in(25);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+  // one sided constraints
+  qp.u.head(5).setConstant(std::numeric_limits<T>::infinity());
+  qp.l.tail(5).setConstant(-std::numeric_limits<T>::infinity());
+
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  T pri_res = std::max((qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                       (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+                        dense::negative_part(qp.C * Qp.results.x - qp.l))
+                         .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(pri_res <= eps_abs);
+  CHECK(dua_res <= eps_abs);
+
+  // same solution as PROXQP
+  dense::QP<T> Qp2{ dim, n_eq, n_in };
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((Qp2.results.x - Qp.results.x).lpNorm<Eigen::Infinity>() <= 1e-6);
+  CHECK((Qp2.results.z - Qp.results.z).lpNorm<Eigen::Infinity>() <= 1e-6);
+
+  // second solve after an update of the model
+  qp.g += T(1e-2) * utils::rand::vector_rand<T>(dim);
+  Qp.update(std::nullopt,
+            qp.g,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+             qp.C.transpose() * Qp.results.z)
+              .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+}
+
+TEST_CASE("dense QP: time limit")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 50;
+  dense::isize n_eq(10);
+  dense::isize n_in(25);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.time_limit = T(0);
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+  CHECK(Qp.results.x.allFinite());
+  CHECK(Qp.results.z.allFinite());
+  // the residuals are the ones of the returned iterate
+  T pri_res = std::max((qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                       (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+                        dense::negative_part(qp.C * Qp.results.x - qp.l))
+                         .lpNorm<Eigen::Infinity>());
+  CHECK(std::abs(pri_res - Qp.results.info.pri_res) <=
+        1e-8 * std::max(T(1), pri_res));
+
+  // absolute deadline, already passed
+  Qp.settings.time_limit = std::numeric_limits<T>::infinity();
+  Qp.settings.deadline = std::chrono::steady_clock::now();
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+
+  // a generous limit does not change the solve
+  Qp.settings.deadline = std::chrono::steady_clock::time_point::max();
+  Qp.settings.time_limit = T(1e7);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  T dua_res = (qp.H * Qp.results.x + qp.g + qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+
+  // interior-point method
+  Qp.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp.settings.time_limit = T(0);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+  CHECK(Qp.results.x.allFinite());
+  Qp.settings.time_limit = T(1e7);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // deadline reached during the inner loop of the last outer iteration: the
+  // best iterate is returned rather than the unchecked inner iterate
+  Qp.settings.method = SolverMethod::PROXQP;
+  Qp.settings.max_iter = 1;
+  Qp.settings.initial_guess = InitialGuessStatus::NO_INITIAL_GUESS;
+  Qp.begin_solve();
+  CHECK(!Qp.step(1));
+  Qp.work.deadline.start(T(0), std::chrono::steady_clock::time_point::max());
+  CHECK(Qp.step(std::numeric_limits<dense::isize>::max()));
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+  pri_res = std::max((qp.A * Qp.results.x - qp.b).lpNorm<Eigen::Infinity>(),
+                     (dense::positive_part(qp.C * Qp.results.x - qp.u) +
+                      dense::negative_part(qp.C * Qp.results.x - qp.l))
+                       .lpNorm<Eigen::Infinity>());
+  CHECK(std::abs(pri_res - Qp.results.info.pri_res) <=
+        1e-8 * std::max(T(1), pri_res));
+}
+
+TEST_CASE("dense QP: step-wise solve")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 50;
+  dense::isize n_eq(10);
+  dense::isize n_in(25);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+  proxqp::dense::Model<T> qp2 = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // two interleaved solves, one of them on the same problem
+  dense::QP<T> Qp_a{ dim, n_eq, n_in };
+  Qp_a.settings.eps_abs = eps_abs;
+  Qp_a.settings.eps_rel = 0;
+  Qp_a.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  dense::QP<T> Qp_b{ dim, n_eq, n_in };
+  Qp_b.settings.eps_abs = eps_abs;
+  Qp_b.settings.eps_rel = 0;
+  Qp_b.init(qp2.H, qp2.g, qp2.A, qp2.b, qp2.C, qp2.u, qp2.l);
+  CHECK(Qp_a.is_done());
+  Qp_a.begin_solve();
+  Qp_b.begin_solve();
+  CHECK(!Qp_a.is_done());
+  isize n_steps = 0;
+  while (!Qp_a.is_done() || !Qp_b.is_done()) {
+    if (!Qp_a.is_done()) {
+      Qp_a.step(1);
+      ++n_steps;
+    }
+    Qp_b.step(1);
+  }
+  // a step runs a single Newton step, even in the middle of an inner loop
+  CHECK(n_steps >= Qp.results.info.iter);
+  CHECK(Qp.results.info.iter > Qp.results.info.iter_ext);
+  CHECK(Qp_a.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp_b.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  // the iterates are the ones of a solve in one call
+  CHECK(Qp_a.results.info.iter == Qp.results.info.iter);
+  CHECK(Qp_a.results.info.iter_ext == Qp.results.info.iter_ext);
+  CHECK(Qp_a.results.x == Qp.results.x);
+  CHECK(Qp_a.results.z == Qp.results.z);
+  T dua_res = (qp2.H * Qp_b.results.x + qp2.g +
+               qp2.A.transpose() * Qp_b.results.y +
+               qp2.C.transpose() * Qp_b.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+
+  // a second step-wise solve, with a single step
+  Qp_a.begin_solve();
+  CHECK(Qp_a.step(std::numeric_limits<isize>::max()));
+  CHECK(Qp_a.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // the interior-point method is run one iteration per step
+  dense::QP<T> Qp_ipm{ dim, n_eq, n_in };
+  Qp_ipm.settings.eps_abs = eps_abs;
+  Qp_ipm.settings.eps_rel = 0;
+  Qp_ipm.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp_ipm.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp_ipm.solve();
+  CHECK(Qp_ipm.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  dense::QP<T> Qp_ipm_a{ dim, n_eq, n_in };
+  Qp_ipm_a.settings.eps_abs = eps_abs;
+  Qp_ipm_a.settings.eps_rel = 0;
+  Qp_ipm_a.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp_ipm_a.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp_ipm_a.begin_solve();
+  n_steps = 0;
+  while (!Qp_ipm_a.step(1)) {
+    ++n_steps;
+    CHECK(Qp_ipm_a.results.info.iter == n_steps);
+  }
+  CHECK(n_steps == Qp_ipm.results.info.iter);
+  CHECK(Qp_ipm_a.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp_ipm_a.results.x == Qp_ipm.results.x);
+}
+
+TEST_CASE("dense QP: factorization cache")
+{
+  double sparsity_factor = 0.15;
+  T eps_abs = T(1e-9);
+  utils::rand::set_seed(1);
+  dense::isize dim = 50;
+  dense::isize n_eq(10);
+  dense::isize n_in(25);
+  T strong_convexity_factor(1.e-2);
+  proxqp::dense::Model<T> qp = proxqp::utils::dense_strongly_convex_qp(
+    dim, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  dense::QP<T> Qp{ dim, n_eq, n_in };
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.initial_guess = InitialGuessStatus::WARM_START;
+  Qp.settings.factorization_cache_max_bytes = 1 << 24;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  dense::QP<T> Qp_ref{ dim, n_eq, n_in };
+  Qp_ref.settings.eps_abs = eps_abs;
+  Qp_ref.settings.eps_rel = 0;
+  Qp_ref.settings.initial_guess = InitialGuessStatus::WARM_START;
+  Qp_ref.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+
+  dense::Vec<T> x = dense::Vec<T>::Zero(dim);
+  dense::Vec<T> y = dense::Vec<T>::Zero(n_eq);
+  dense::Vec<T> z = dense::Vec<T>::Zero(n_in);
+  Qp.solve(x, y, z);
+  Qp_ref.solve(x, y, z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.factorization_cache().misses() == 1);
+  CHECK(Qp.factorization_cache().size() == 1);
+
+  // warm starts from the same solution: the second one restores the
+  // factorization of its active set
+  x = Qp.results.x;
+  y = Qp.results.y;
+  z = Qp.results.z;
+  CHECK((z.array() != 0).any());
+  Qp.solve(x, y, z);
+  Qp.solve(x, y, z);
+  Qp_ref.solve(x, y, z);
+  Qp_ref.solve(x, y, z);
+  CHECK(Qp.factorization_cache().hits() == 1);
+  CHECK(Qp.factorization_cache().misses() == 2);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.results.info.iter == Qp_ref.results.info.iter);
+  CHECK(Qp.results.x == Qp_ref.results.x);
+  CHECK(Qp.results.z == Qp_ref.results.z);
+  CHECK(Qp_ref.factorization_cache().size() == 0);
+
+  // the cache is kept when only the vectors change
+  dense::Vec<T> g = qp.g + dense::Vec<T>::Constant(dim, T(1e-2));
+  Qp.update(std::nullopt,
+            g,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  Qp.solve(x, y, z);
+  CHECK(Qp.factorization_cache().hits() == 2);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  T dua_res = (qp.H * Qp.results.x + g + qp.A.transpose() * Qp.results.y +
+               qp.C.transpose() * Qp.results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(dua_res <= eps_abs);
+
+  // and cleared when the matrices change
+  Qp.update(qp.H,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  CHECK(Qp.factorization_cache().size() == 0);
+  Qp.solve(x, y, z);
+  CHECK(Qp.factorization_cache().misses() == 3);
+  CHECK(Qp.factorization_cache().size() == 1);
+
+  // nothing is kept above the memory cap
+  Qp.settings.factorization_cache_max_bytes = 1;
+  Qp.update(qp.H,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  Qp.solve(x, y, z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.factorization_cache().misses() == 4);
+  CHECK(Qp.factorization_cache().size() == 0);
+}
@@ -3924,5 +3924,82 @@ class DenseQpWrapper(unittest.TestCase):
         )
 
 
+    def test_case_float32(self):
+        print(
+            "------------------------dense random strongly convex qp with equality and inequality constraints: test float32 QP object"
+        )
+        n = 10
+        H, g, A, b, C, u, l = generate_mixed_qp(n)
+        n_eq = A.shape[0]
+        n_in = C.shape[0]
+        H, A, C = H.toarray(), A.toarray(), C.toarray()
+
+        Qp = proxsuite.proxqp.dense.QP_f32(n, n_eq, n_in)
+        Qp.settings.eps_abs = 1.0e-4
+        Qp.settings.verbose = False
+        Qp.init(
+            H=np.asfortranarray(H, dtype=np.float32),
+            g=g.astype(np.float32),
+            A=np.asfortranarray(A, dtype=np.float32),
+            b=b.astype(np.float32),
+            C=np.asfortranarray(C, dtype=np.float32),
+            u=u.astype(np.float32),
+            l=l.astype(np.float32),
+        )
+        Qp.solve()
+        assert Qp.results.x.dtype == np.float32
+        assert isinstance(Qp.results, proxsuite.proxqp.Results_f32)
+        x = Qp.results.x.astype(np.float64)
+        y = Qp.results.y.astype(np.float64)
+        z = Qp.results.z.astype(np.float64)
+        dua_res = normInf(H @ x + g + A.transpose() @ y + C.transpose() @ z)
+        pri_res = max(
+            normInf(A @ x - b),
+            normInf(np.maximum(C @ x - u, 0) + np.minimum(C @ x - l, 0)),
+        )
+        assert dua_res <= 1e-3
+        assert pri_res <= 1e-3
+        print("--n = {} ; n_eq = {} ; n_in = {}".format(n, n_eq, n_in))
+        print("dual residual = {} ; primal residual = {}".format(dua_res, pri_res))
+        print("total number of iteration: {}".format(Qp.results.info.iter))
+
+    def test_case_non_owning_model(self):
+        print(
+            "------------------------dense random strongly convex qp with equality and inequality constraints: test a model not owning its matrices"
+        )
+        n = 10
+        H, g, A, b, C, u, l = generate_mixed_qp(n)
+        n_eq = A.shape[0]
+        n_in = C.shape[0]
+        H, A, C = H.toarray(), A.toarray(), C.toarray()
+
+        Qp = proxsuite.proxqp.dense.QP(
+            n, n_eq, n_in, proxsuite.proxqp.dense.ModelStorage.NON_OWNING
+        )
+        Qp.settings.eps_abs = 1.0e-9
+        Qp.settings.verbose = False
+        Qp.init(H=H, g=g, A=A, b=b, C=C, u=u, l=l)
+        assert Qp.model.H.size == 0
+        Qp.solve()
+        g = np.random.randn(n)
+        Qp.update(g=g)
+        Qp.solve()
+        x = Qp.results.x
+        y = Qp.results.y
+        z = Qp.results.z
+        dua_res = normInf(H @ x + g + A.transpose() @ y + C.transpose() @ z)
+        pri_res = max(
+            normInf(A @ x - b),
+            normInf(np.maximum(C @ x - u, 0) + np.minimum(C @ x - l, 0)),
+        )
+        assert dua_res <= 1e-9
+        assert pri_res <= 1e-9
+        obj = 0.5 * x @ H @ x + g @ x
+        assert abs(Qp.results.info.objValue - obj) <= 1e-9 * max(1.0, abs(obj))
+        print("--n = {} ; n_eq = {} ; n_in = {}".format(n, n_eq, n_in))
+        print("dual residual = {} ; primal residual = {}".format(dua_res, pri_res))
+        print("total number of iteration: {}".format(Qp.results.info.iter))
+
+
 if __name__ == "__main__":
     unittest.main()
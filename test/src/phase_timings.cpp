@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2022 INRIA
+//
+// the phases are only timed when this macro is defined
+#define PROXSUITE_WITH_PHASE_TIMINGS
+#include <doctest.hpp>
+#include <proxsuite/proxqp/dense/dense.hpp>
+#include <proxsuite/proxqp/sparse/sparse.hpp>
+#include <proxsuite/proxqp/utils/random_qp_problems.hpp>
+
+using namespace proxsuite::proxqp;
+using T = double;
+using I = utils::c_int;
+
+namespace {
+void
+check_phases(PhaseTimings<T> const& timings)
+{
+  for (int k = 0; k < n_phases; ++k) {
+    CHECK(timings.times[k] >= T(0));
+    CHECK(timings.counts[k] >= 0);
+  }
+  CHECK(timings.count(Phase::EQUILIBRATION) > 0);
+  CHECK(timings.count(Phase::FACTORIZATION) > 0);
+  CHECK(timings.count(Phase::RESIDUALS) > 0);
+}
+} // namespace
+
+TEST_CASE("dense qp: phase timings of a setup and a solve")
+{
+  isize n = 20;
+  isize n_eq = 5;
+  isize n_in = 5;
+  utils::rand::set_seed(1);
+  dense::Model<T> qp = utils::dense_strongly_convex_qp(
+    n, n_eq, n_in, T(0.15), T(1.e-2));
+
+  dense::QP<T> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = 1.E-9;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  CHECK(Qp.results.info.phase_timings.count(Phase::EQUILIBRATION) == 1);
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) == 0);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  check_phases(Qp.results.info.phase_timings);
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) >=
+        Qp.results.info.iter);
+
+  // solving again (warm started by default) only measures the second solve
+  std::int64_t n_residuals =
+    Qp.results.info.phase_timings.count(Phase::RESIDUALS);
+  Qp.solve();
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) > 0);
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) <= n_residuals);
+}
+
+TEST_CASE("sparse qp: phase timings of a setup and a solve")
+{
+  isize n = 20;
+  isize n_eq = 5;
+  isize n_in = 5;
+  utils::rand::set_seed(1);
+  sparse::SparseModel<T> qp = utils::sparse_strongly_convex_qp(
+    n, n_eq, n_in, T(0.15), T(1.e-2));
+
+  sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = 1.E-9;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  CHECK(Qp.results.info.phase_timings.count(Phase::EQUILIBRATION) == 1);
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) == 0);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  check_phases(Qp.results.info.phase_timings);
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) >=
+        Qp.results.info.iter);
+
+  std::int64_t n_residuals =
+    Qp.results.info.phase_timings.count(Phase::RESIDUALS);
+  Qp.solve();
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) > 0);
+  CHECK(Qp.results.info.phase_timings.count(Phase::RESIDUALS) <= n_residuals);
+}
@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2022 INRIA
+//
+#include <doctest.hpp>
+#include <proxsuite/proxqp/presolve.hpp>
+#include <proxsuite/proxqp/dense/dense.hpp>
+#include <proxsuite/proxqp/sparse/sparse.hpp>
+#include <proxsuite/proxqp/utils/random_qp_problems.hpp>
+
+using namespace proxsuite::proxqp;
+using T = double;
+using I = utils::c_int;
+
+namespace {
+/*!
+ * Random problem with the structures removed by the presolve: a free row, an
+ * empty row, an inequality with l == u, two bounds on x_1, an equality fixing
+ * x_2 and a variable x_{n-1} appearing in no constraint.
+ */
+dense::Model<T>
+structured_qp(isize n, isize n_eq, isize n_in)
+{
+  dense::Model<T> qp =
+    utils::dense_strongly_convex_qp(n, n_eq, n_in, T(0.3), T(1.e-2));
+  dense::Vec<T> x_feasible = utils::rand::vector_rand<T>(n);
+  isize last = n - 1;
+  qp.H.row(last).setZero();
+  qp.H.col(last).setZero();
+  qp.H(last, last) = T(2);
+  qp.A.col(last).setZero();
+  qp.C.col(last).setZero();
+  qp.g(1) = T(-100); // pushes x_1 on its upper bound
+
+  isize m_eq = n_eq + 1;
+  isize m_in = n_in + 5;
+  dense::Model<T> out(n, m_eq, m_in);
+  out.H = qp.H;
+  out.g = qp.g;
+  out.A.setZero();
+  out.A.topRows(n_eq) = qp.A;
+  out.A(n_eq, 2) = T(3);
+  out.b = out.A * x_feasible;
+
+  out.C.setZero();
+  out.C.topRows(n_in) = qp.C;
+  out.l.head(n_in) = qp.C * x_feasible - dense::Vec<T>::Ones(n_in);
+  out.u.head(n_in) = qp.C * x_feasible + dense::Vec<T>::Ones(n_in);
+  // free row
+  out.C.row(n_in) = qp.C.row(0);
+  out.l(n_in) = T(-1.E30);
+  out.u(n_in) = T(1.E30);
+  // empty row
+  out.l(n_in + 1) = T(-1);
+  out.u(n_in + 1) = T(1);
+  // equality
+  out.C.row(n_in + 2) = qp.C.row(1);
+  out.l(n_in + 2) = out.u(n_in + 2) = qp.C.row(1).dot(x_feasible);
+  // bounds on x_1, the tightest upper bound being the one of the second row
+  out.C(n_in + 3, 1) = T(1);
+  out.l(n_in + 3) = x_feasible(1) - T(1);
+  out.u(n_in + 3) = x_feasible(1) + T(2);
+  out.C(n_in + 4, 1) = T(-2);
+  out.l(n_in + 4) = T(-2) * (x_feasible(1) + T(0.5));
+  out.u(n_in + 4) = T(1.E30);
+  return out;
+}
+
+void
+check_kkt(dense::Model<T> const& qp, Results<T> const& results, T eps)
+{
+  T pri_res = std::max(
+    (qp.A * results.x - qp.b).lpNorm<Eigen::Infinity>(),
+    (dense::positive_part(qp.C * results.x - qp.u) +
+     dense::negative_part(qp.C * results.x - qp.l))
+      .lpNorm<Eigen::Infinity>());
+  T dua_res = (qp.H * results.x + qp.g + qp.A.transpose() * results.y +
+               qp.C.transpose() * results.z)
+                .lpNorm<Eigen::Infinity>();
+  CHECK(pri_res <= eps);
+  CHECK(dua_res <= eps);
+  // complementarity
+  for (isize i = 0; i < qp.n_in; ++i) {
+    T c = qp.C.row(i).dot(results.x);
+    if (results.z(i) > eps) {
+      CHECK(std::abs(c - qp.u(i)) <= eps);
+    } else if (results.z(i) < -eps) {
+      CHECK(std::abs(c - qp.l(i)) <= eps);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("presolve of a dense qp")
+{
+  utils::rand::set_seed(1);
+  isize n = 12;
+  dense::Model<T> qp = structured_qp(n, 3, 6);
+  T eps_abs = T(1.E-9);
+
+  Presolve<T> presolve;
+  presolve.run(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  CHECK(presolve.info.free_rows == 1);
+  CHECK(presolve.info.empty_rows == 1);
+  CHECK(presolve.info.equalities == 1);
+  CHECK(presolve.info.merged_bounds == 1);
+  CHECK(presolve.info.fixed_vars == 1);
+  CHECK(presolve.info.empty_cols == 1);
+  CHECK(presolve.dim == n - 2);
+  CHECK(presolve.n_eq == qp.n_eq - 1 + 1);
+  CHECK(presolve.n_in == qp.n_in - 4);
+
+  dense::QP<T> reduced(presolve.dim, presolve.n_eq, presolve.n_in);
+  reduced.settings.eps_abs = eps_abs;
+  reduced.settings.eps_rel = 0;
+  reduced.init(presolve.H.toDense(),
+               presolve.g,
+               presolve.A.toDense(),
+               presolve.b,
+               presolve.C.toDense(),
+               presolve.u,
+               presolve.l);
+  reduced.solve();
+  CHECK(reduced.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  presolve.postsolve(reduced.results);
+  CHECK(reduced.results.x.rows() == n);
+  check_kkt(qp, reduced.results, T(1.E-7));
+
+  dense::QP<T> original(qp.dim, qp.n_eq, qp.n_in);
+  original.settings.eps_abs = eps_abs;
+  original.settings.eps_rel = 0;
+  original.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  original.solve();
+  CHECK(original.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK((original.results.x - reduced.results.x).lpNorm<Eigen::Infinity>() <=
+        T(1.E-6));
+  CHECK(std::abs(original.results.info.objValue -
+                 reduced.results.info.objValue) <= T(1.E-6));
+}
+
+TEST_CASE("presolve of a sparse qp")
+{
+  utils::rand::set_seed(2);
+  isize n = 30;
+  dense::Model<T> qp = structured_qp(n, 5, 10);
+  T eps_abs = T(1.E-9);
+
+  sparse::SparseMat<T, I> H = qp.H.sparseView();
+  sparse::SparseMat<T, I> A = qp.A.sparseView();
+  sparse::SparseMat<T, I> C = qp.C.sparseView();
+  Presolve<T> presolve;
+  presolve.run(H, qp.g, A, qp.b, C, qp.u, qp.l);
+  CHECK(presolve.dim == n - 2);
+
+  sparse::SparseMat<T, I> H_reduced = presolve.H;
+  sparse::SparseMat<T, I> A_reduced = presolve.A;
+  sparse::SparseMat<T, I> C_reduced = presolve.C;
+  sparse::QP<T, I> reduced(presolve.dim, presolve.n_eq, presolve.n_in);
+  reduced.settings.eps_abs = eps_abs;
+  reduced.settings.eps_rel = 0;
+  reduced.init(H_reduced,
+               presolve.g,
+               A_reduced,
+               presolve.b,
+               C_reduced,
+               presolve.u,
+               presolve.l);
+  reduced.solve();
+  CHECK(reduced.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  presolve.postsolve(reduced.results);
+  check_kkt(qp, reduced.results, T(1.E-7));
+
+  // the bound of x_1 given by the second row is active
+  CHECK(reduced.results.z(qp.n_in - 2) == 0);
+  CHECK(reduced.results.z(qp.n_in - 1) < 0);
+}
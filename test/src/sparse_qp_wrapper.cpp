@@ -325,16 +325,8 @@ TEST_CASE("sparse random strongly convex qp with equality and "
     auto H_new = 2. * qp.H; // keep same sparsity structure
     std::cout << "H generated " << H_new << std::endl;
     Qp.update(H_new, g, qp.A, qp.b, qp.C, qp.u, qp.l, false);
-    proxsuite::linalg::sparse::MatMut<T, I> kkt_unscaled =
-      Qp.model.kkt_mut_unscaled();
-    auto kkt_top_n_rows =
-      proxsuite::proxqp::sparse::detail::top_rows_mut_unchecked(
-        proxsuite::linalg::veg::unsafe, kkt_unscaled, n);
-
-    proxsuite::linalg::sparse::MatMut<T, I> H_unscaled =
-      proxsuite::proxqp::sparse::detail::middle_cols_mut(
-        kkt_top_n_rows, 0, n, Qp.model.H_nnz);
-    std::cout << " H_unscaled " << H_unscaled.to_eigen() << std::endl;
+    SparseMat<T> H_unscaled = Qp.unscaled_kkt().block(0, 0, n, n);
+    std::cout << " H_unscaled " << H_unscaled << std::endl;
     Qp.solve();
 
     dua_res = proxqp::dense::infty_norm(
@@ -3065,15 +3057,8 @@ TEST_CASE("Test A update for different initial guess")
     std::cout << "setup timing " << Qp.results.info.setup_time << " solve time "
               << Qp.results.info.solve_time << std::endl;
     // get stored A from KKT matrix
-    auto kkt_unscaled = Qp.model.kkt_mut_unscaled();
-    auto kkt_top_n_rows =
-      proxsuite::proxqp::sparse::detail::top_rows_mut_unchecked(
-        proxsuite::linalg::veg::unsafe, kkt_unscaled, n);
     SparseMat<T> A_unscaled =
-      proxsuite::proxqp::sparse::detail::middle_cols_mut(
-        kkt_top_n_rows, n, n_eq, Qp.model.A_nnz)
-        .to_eigen()
-        .transpose();
+      Qp.unscaled_kkt().block(0, n, n, n_eq).transpose();
     SparseMat<T> diff_mat = A_unscaled - A;
     T diff = std::max(std::abs(diff_mat.coeffs().maxCoeff()),
                       std::abs(diff_mat.coeffs().minCoeff()));
@@ -3112,13 +3097,7 @@ TEST_CASE("Test A update for different initial guess")
                  sparse::detail::positive_part(qp.C * Qp2.results.x - qp.u) +
                  sparse::detail::negative_part(qp.C * Qp2.results.x - qp.l)));
     // get stored A from KKT matrix
-    kkt_unscaled = Qp2.model.kkt_mut_unscaled();
-    kkt_top_n_rows = proxsuite::proxqp::sparse::detail::top_rows_mut_unchecked(
-      proxsuite::linalg::veg::unsafe, kkt_unscaled, n);
-    A_unscaled = proxsuite::proxqp::sparse::detail::middle_cols_mut(
-                   kkt_top_n_rows, n, n_eq, Qp2.model.A_nnz)
-                   .to_eigen()
-                   .transpose();
+    A_unscaled = Qp2.unscaled_kkt().block(0, n, n, n_eq).transpose();
     diff_mat = A_unscaled - A;
     diff = std::max(std::abs(diff_mat.coeffs().maxCoeff()),
                     std::abs(diff_mat.coeffs().minCoeff()));
@@ -3167,13 +3146,7 @@ TEST_CASE("Test A update for different initial guess")
                  sparse::detail::positive_part(qp.C * Qp3.results.x - qp.u) +
                  sparse::detail::negative_part(qp.C * Qp3.results.x - qp.l)));
     // get stored A from KKT matrix
-    kkt_unscaled = Qp3.model.kkt_mut_unscaled();
-    kkt_top_n_rows = proxsuite::proxqp::sparse::detail::top_rows_mut_unchecked(
-      proxsuite::linalg::veg::unsafe, kkt_unscaled, n);
-    A_unscaled = proxsuite::proxqp::sparse::detail::middle_cols_mut(
-                   kkt_top_n_rows, n, n_eq, Qp3.model.A_nnz)
-                   .to_eigen()
-                   .transpose();
+    A_unscaled = Qp3.unscaled_kkt().block(0, n, n, n_eq).transpose();
     diff_mat = A_unscaled - A;
     diff = std::max(std::abs(diff_mat.coeffs().maxCoeff()),
                     std::abs(diff_mat.coeffs().minCoeff()));
@@ -3222,13 +3195,7 @@ TEST_CASE("Test A update for different initial guess")
                  sparse::detail::positive_part(qp.C * Qp4.results.x - qp.u) +
                  sparse::detail::negative_part(qp.C * Qp4.results.x - qp.l)));
     // get stored A from KKT matrix
-    kkt_unscaled = Qp4.model.kkt_mut_unscaled();
-    kkt_top_n_rows = proxsuite::proxqp::sparse::detail::top_rows_mut_unchecked(
-      proxsuite::linalg::veg::unsafe, kkt_unscaled, n);
-    A_unscaled = proxsuite::proxqp::sparse::detail::middle_cols_mut(
-                   kkt_top_n_rows, n, n_eq, Qp4.model.A_nnz)
-                   .to_eigen()
-                   .transpose();
+    A_unscaled = Qp4.unscaled_kkt().block(0, n, n, n_eq).transpose();
     diff_mat = A_unscaled - A;
     diff = std::max(std::abs(diff_mat.coeffs().maxCoeff()),
                     std::abs(diff_mat.coeffs().minCoeff()));
@@ -3277,13 +3244,7 @@ TEST_CASE("Test A update for different initial guess")
                  sparse::detail::positive_part(qp.C * Qp5.results.x - qp.u) +
                  sparse::detail::negative_part(qp.C * Qp5.results.x - qp.l)));
     // get stored A from KKT matrix
-    kkt_unscaled = Qp5.model.kkt_mut_unscaled();
-    kkt_top_n_rows = proxsuite::proxqp::sparse::detail::top_rows_mut_unchecked(
-      proxsuite::linalg::veg::unsafe, kkt_unscaled, n);
-    A_unscaled = proxsuite::proxqp::sparse::detail::middle_cols_mut(
-                   kkt_top_n_rows, n, n_eq, Qp5.model.A_nnz)
-                   .to_eigen()
-                   .transpose();
+    A_unscaled = Qp5.unscaled_kkt().block(0, n, n, n_eq).transpose();
     diff_mat = A_unscaled - A;
     diff = std::max(std::abs(diff_mat.coeffs().maxCoeff()),
                     std::abs(diff_mat.coeffs().minCoeff()));
@@ -3560,3 +3521,1128 @@ TEST_CASE("Test rho update for different initial guess")
               << " solve time " << Qp5.results.info.solve_time << std::endl;
   }
 }
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: test loading the preconditioner of another "
+          "QP object")
+{
+
+  std::cout << "------------------------sparse random strongly convex qp with "
+               "equality and inequality constraints: test loading the "
+               "preconditioner of another QP object"
+            << std::endl;
+  for (auto const& dims : { proxsuite::linalg::veg::tuplify(50, 10, 25),
+                            proxsuite::linalg::veg::tuplify(10, 2, 2) }) {
+    VEG_BIND(auto const&, (n, n_eq, n_in), dims);
+
+    T sparsity_factor = 0.15;
+    T strong_convexity_factor = 0.01;
+    T eps_abs = 1.E-9;
+    ::proxsuite::proxqp::utils::rand::set_seed(1);
+    proxqp::sparse::SparseModel<T> qp = utils::sparse_strongly_convex_qp(
+      n, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+    proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+    Qp.settings.eps_abs = eps_abs;
+    Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    Qp.solve();
+
+    // same problem family: only the vectors change
+    auto g = utils::rand::vector_rand<T>(n);
+    proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+    Qp2.settings.eps_abs = eps_abs;
+    Qp2.load_preconditioner(Qp.ruiz.delta, Qp.ruiz.c);
+    Qp2.init(qp.H, g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    CHECK(Qp2.ruiz.delta == Qp.ruiz.delta);
+    CHECK(Qp2.ruiz.c == Qp.ruiz.c);
+    Qp2.solve();
+    T dua_res = proxqp::dense::infty_norm(
+      qp.H.selfadjointView<Eigen::Upper>() * Qp2.results.x + g +
+      qp.A.transpose() * Qp2.results.y + qp.C.transpose() * Qp2.results.z);
+    T pri_res =
+      std::max(proxqp::dense::infty_norm(qp.A * Qp2.results.x - qp.b),
+               proxqp::dense::infty_norm(
+                 sparse::detail::positive_part(qp.C * Qp2.results.x - qp.u) +
+                 sparse::detail::negative_part(qp.C * Qp2.results.x - qp.l)));
+    CHECK(dua_res <= eps_abs);
+    CHECK(pri_res <= eps_abs);
+
+    // re-initializing without preconditioner discards the loaded one
+    Qp2.init(qp.H, g, qp.A, qp.b, qp.C, qp.u, qp.l, false);
+    CHECK(Qp2.ruiz.delta == sparse::Vec<T>::Ones(n + n_eq + n_in));
+    CHECK(Qp2.ruiz.c == T(1));
+
+    std::cout << "--n = " << n << " n_eq " << n_eq << " n_in " << n_in
+              << std::endl;
+    std::cout << "; dual residual " << dua_res << "; primal residual "
+              << pri_res << std::endl;
+    std::cout << "total number of iteration: " << Qp2.results.info.iter
+              << std::endl;
+  }
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: test saving and loading a snapshot of the "
+          "QP object")
+{
+
+  std::cout << "------------------------sparse random strongly convex qp with "
+               "equality and inequality constraints: test saving and loading a "
+               "snapshot of the QP object"
+            << std::endl;
+  for (auto const& dims : { proxsuite::linalg::veg::tuplify(50, 10, 25),
+                            proxsuite::linalg::veg::tuplify(10, 2, 2) }) {
+    VEG_BIND(auto const&, (n, n_eq, n_in), dims);
+
+    T sparsity_factor = 0.15;
+    T strong_convexity_factor = 0.01;
+    T eps_abs = 1.E-9;
+    ::proxsuite::proxqp::utils::rand::set_seed(1);
+    proxqp::sparse::SparseModel<T> qp = utils::sparse_strongly_convex_qp(
+      n, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+    proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+    Qp.settings.eps_abs = eps_abs;
+    Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    std::string path = "sparse_qp_wrapper_snapshot.bin";
+    Qp.save_snapshot(path);
+    Qp.solve();
+
+    // the QP object is resized to the dimensions of the snapshot
+    proxqp::sparse::QP<T, I> Qp2(1, 0, 0);
+    Qp2.load_snapshot(path);
+    CHECK(Qp2.model.dim == n);
+    CHECK(Qp2.ruiz.delta == Qp.ruiz.delta);
+    CHECK(Qp2.ruiz.c == Qp.ruiz.c);
+    CHECK(Qp2.settings.eps_abs == eps_abs);
+    Qp2.solve();
+    CHECK(Qp2.results.info.iter == Qp.results.info.iter);
+    T dua_res = proxqp::dense::infty_norm(
+      qp.H.selfadjointView<Eigen::Upper>() * Qp2.results.x + qp.g +
+      qp.A.transpose() * Qp2.results.y + qp.C.transpose() * Qp2.results.z);
+    T pri_res =
+      std::max(proxqp::dense::infty_norm(qp.A * Qp2.results.x - qp.b),
+               proxqp::dense::infty_norm(
+                 sparse::detail::positive_part(qp.C * Qp2.results.x - qp.u) +
+                 sparse::detail::negative_part(qp.C * Qp2.results.x - qp.l)));
+    CHECK(dua_res <= eps_abs);
+    CHECK(pri_res <= eps_abs);
+
+    // a snapshot of a solved QP object is warm started with its results (an
+    // absolute deadline is not saved)
+    Qp.settings.deadline =
+      std::chrono::steady_clock::now() + std::chrono::hours(1);
+    Qp.save_snapshot(path);
+    proxqp::sparse::QP<T, I> Qp3(n, n_eq, n_in);
+    Qp3.load_snapshot(path);
+    CHECK(Qp3.settings.deadline ==
+          std::chrono::steady_clock::time_point::max());
+    Qp3.solve();
+    CHECK(Qp3.results.info.iter <= Qp.results.info.iter);
+    CHECK(proxqp::dense::infty_norm(Qp3.results.x - Qp.results.x) <= 1.E-6);
+    std::remove(path.c_str());
+    CHECK_THROWS(Qp3.load_snapshot(path));
+
+    std::cout << "--n = " << n << " n_eq " << n_eq << " n_in " << n_in
+              << std::endl;
+    std::cout << "; dual residual " << dua_res << "; primal residual "
+              << pri_res << std::endl;
+    std::cout << "total number of iteration: " << Qp2.results.info.iter
+              << std::endl;
+  }
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: test init and update with views of "
+          "compressed column matrices")
+{
+
+  std::cout << "------------------------sparse random strongly convex qp with "
+               "equality and inequality constraints: test init and update with "
+               "views of compressed column matrices"
+            << std::endl;
+  for (auto const& dims : { proxsuite::linalg::veg::tuplify(50, 10, 25),
+                            proxsuite::linalg::veg::tuplify(10, 2, 2) }) {
+    VEG_BIND(auto const&, (n, n_eq, n_in), dims);
+
+    T sparsity_factor = 0.15;
+    T strong_convexity_factor = 0.01;
+    T eps_abs = 1.E-9;
+    ::proxsuite::proxqp::utils::rand::set_seed(1);
+    proxqp::sparse::SparseModel<T> qp = utils::sparse_strongly_convex_qp(
+      n, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+    proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+    Qp.settings.eps_abs = eps_abs;
+    Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    Qp.solve();
+
+    // the matrices are given in the storage format of the solver
+    proxqp::sparse::SparseMat<T, I> H_triu =
+      qp.H.template triangularView<Eigen::Upper>();
+    proxqp::sparse::SparseMat<T, I> AT = qp.A.transpose();
+    proxqp::sparse::SparseMat<T, I> CT = qp.C.transpose();
+    proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+    Qp2.settings.eps_abs = eps_abs;
+    Qp2.init({ { proxsuite::linalg::sparse::from_eigen, H_triu } },
+             qp.g,
+             { { proxsuite::linalg::sparse::from_eigen, AT } },
+             qp.b,
+             { { proxsuite::linalg::sparse::from_eigen, CT } },
+             qp.u,
+             qp.l);
+    Qp2.solve();
+    CHECK(Qp2.results.info.iter == Qp.results.info.iter);
+    CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-9);
+
+    // the update is read in place as well
+    H_triu *= T(2);
+    qp.H *= T(2);
+    Qp.update(qp.H,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt);
+    Qp.solve();
+    Qp2.update({ { proxsuite::linalg::sparse::from_eigen, H_triu } },
+               std::nullopt,
+               std::nullopt,
+               std::nullopt,
+               std::nullopt,
+               std::nullopt,
+               std::nullopt);
+    Qp2.solve();
+    CHECK(Qp2.results.info.iter == Qp.results.info.iter);
+    T dua_res = proxqp::dense::infty_norm(
+      qp.H.selfadjointView<Eigen::Upper>() * Qp2.results.x + qp.g +
+      qp.A.transpose() * Qp2.results.y + qp.C.transpose() * Qp2.results.z);
+    T pri_res =
+      std::max(proxqp::dense::infty_norm(qp.A * Qp2.results.x - qp.b),
+               proxqp::dense::infty_norm(
+                 sparse::detail::positive_part(qp.C * Qp2.results.x - qp.u) +
+                 sparse::detail::negative_part(qp.C * Qp2.results.x - qp.l)));
+    CHECK(dua_res <= eps_abs);
+    CHECK(pri_res <= eps_abs);
+
+    std::cout << "--n = " << n << " n_eq " << n_eq << " n_in " << n_in
+              << std::endl;
+    std::cout << "; dual residual " << dua_res << "; primal residual "
+              << pri_res << std::endl;
+    std::cout << "total number of iteration: " << Qp2.results.info.iter
+              << std::endl;
+  }
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: test the unscaled kkt matrix derived from "
+          "its scaled storage")
+{
+
+  std::cout << "------------------------sparse random strongly convex qp with "
+               "equality and inequality constraints: test the unscaled kkt "
+               "matrix derived from its scaled storage"
+            << std::endl;
+  T sparsity_factor = 0.15;
+  T strong_convexity_factor = 0.01;
+  T eps_abs = 1.E-9;
+  isize n = 50;
+  isize n_eq = 10;
+  isize n_in = 25;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp = utils::sparse_strongly_convex_qp(
+    n, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.initial_guess = InitialGuessStatus::NO_INITIAL_GUESS;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  isize iter = Qp.results.info.iter;
+  sparse::Vec<T> x = Qp.results.x;
+
+  SparseMat<T> kkt = Qp.unscaled_kkt();
+  SparseMat<T> H_triu = qp.H.triangularView<Eigen::Upper>();
+  SparseMat<T> A = qp.A;
+  SparseMat<T> C = qp.C;
+  SparseMat<T> diff_mat = SparseMat<T>(kkt.block(0, 0, n, n)) - H_triu;
+  CHECK(diff_mat.norm() <= 1.E-12 * H_triu.norm());
+  diff_mat = SparseMat<T>(kkt.block(0, n, n, n_eq).transpose()) - A;
+  CHECK(diff_mat.norm() <= 1.E-12 * A.norm());
+  diff_mat = SparseMat<T>(kkt.block(0, n + n_eq, n, n_in).transpose()) - C;
+  CHECK(diff_mat.norm() <= 1.E-12 * C.norm());
+
+  // re-solving restores the scaled vectors from the model
+  for (isize i = 0; i < 3; ++i) {
+    Qp.solve();
+    CHECK(Qp.results.info.iter == iter);
+    CHECK(proxqp::dense::infty_norm(Qp.results.x - x) <= 1.E-12);
+  }
+
+  // updates keeping the preconditioner unscale the stored kkt matrix first
+  qp.H *= T(2);
+  for (isize i = 0; i < 2; ++i) {
+    Qp.update(qp.H,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt,
+              std::nullopt,
+              false);
+    Qp.solve();
+    T dua_res = proxqp::dense::infty_norm(
+      qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + qp.g +
+      qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+    T pri_res =
+      std::max(proxqp::dense::infty_norm(qp.A * Qp.results.x - qp.b),
+               proxqp::dense::infty_norm(
+                 sparse::detail::positive_part(qp.C * Qp.results.x - qp.u) +
+                 sparse::detail::negative_part(qp.C * Qp.results.x - qp.l)));
+    CHECK(dua_res <= eps_abs);
+    CHECK(pri_res <= eps_abs);
+  }
+  kkt = Qp.unscaled_kkt();
+  diff_mat = SparseMat<T>(kkt.block(0, n, n, n_eq).transpose()) - A;
+  CHECK(diff_mat.norm() <= 1.E-12 * A.norm());
+
+  // loading scaling variables rescales the stored kkt matrix
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.load_preconditioner(Qp.ruiz.delta, Qp.ruiz.c);
+  kkt = Qp2.unscaled_kkt();
+  diff_mat = SparseMat<T>(kkt.block(0, n, n, n_eq).transpose()) - A;
+  CHECK(diff_mat.norm() <= 1.E-12 * A.norm());
+  Qp2.solve();
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-6);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: test init from a memory mapped compressed "
+          "column file")
+{
+
+  std::cout << "------------------------sparse random strongly convex qp with "
+               "equality and inequality constraints: test init from a memory "
+               "mapped compressed column file"
+            << std::endl;
+  for (auto const& dims : { proxsuite::linalg::veg::tuplify(50, 10, 25),
+                            proxsuite::linalg::veg::tuplify(10, 0, 2) }) {
+    VEG_BIND(auto const&, (n, n_eq, n_in), dims);
+
+    T sparsity_factor = 0.15;
+    T strong_convexity_factor = 0.01;
+    T eps_abs = 1.E-9;
+    ::proxsuite::proxqp::utils::rand::set_seed(1);
+    proxqp::sparse::SparseModel<T> qp = utils::sparse_strongly_convex_qp(
+      n, n_eq, n_in, sparsity_factor, strong_convexity_factor);
+
+    proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+    Qp.settings.eps_abs = eps_abs;
+    Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    Qp.solve();
+
+    proxqp::sparse::SparseMat<T, I> H_triu =
+      qp.H.template triangularView<Eigen::Upper>();
+    proxqp::sparse::SparseMat<T, I> AT = qp.A.transpose();
+    proxqp::sparse::SparseMat<T, I> CT = qp.C.transpose();
+    std::string path = "sparse_qp_wrapper_mapped.bin";
+    sparse::write_mapped_qp<T, I>(
+      path,
+      { { proxsuite::linalg::sparse::from_eigen, H_triu },
+        { proxsuite::linalg::sparse::from_eigen, qp.g },
+        { proxsuite::linalg::sparse::from_eigen, AT },
+        { proxsuite::linalg::sparse::from_eigen, qp.b },
+        { proxsuite::linalg::sparse::from_eigen, CT },
+        { proxsuite::linalg::sparse::from_eigen, qp.l },
+        { proxsuite::linalg::sparse::from_eigen, qp.u } });
+    sparse::MappedQp<T, I> mapped(path);
+    CHECK(mapped.dim == n);
+    CHECK(mapped.n_eq == n_eq);
+    CHECK(mapped.n_in == n_in);
+    CHECK(mapped.H_nnz == H_triu.nonZeros());
+
+    // only the values of the matrices are copied by the model
+    proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+    Qp2.settings.eps_abs = eps_abs;
+    Qp2.init(mapped);
+    CHECK(Qp2.model.kkt_col_ptrs.len() == 0);
+    CHECK(Qp2.model.kkt_row_indices.len() == 0);
+    CHECK(Qp2.model.kkt().col_ptrs() == mapped.kkt_col_ptrs());
+    Qp2.solve();
+    CHECK(Qp2.results.info.iter == Qp.results.info.iter);
+    CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-9);
+
+    // updates and snapshots read the mapped pattern
+    qp.H *= T(2);
+    Qp2.update(qp.H,
+               std::nullopt,
+               std::nullopt,
+               std::nullopt,
+               std::nullopt,
+               std::nullopt,
+               std::nullopt,
+               false);
+    std::string snapshot_path = "sparse_qp_wrapper_mapped_snapshot.bin";
+    Qp2.save_snapshot(snapshot_path);
+    Qp2.solve();
+    T dua_res = proxqp::dense::infty_norm(
+      qp.H.selfadjointView<Eigen::Upper>() * Qp2.results.x + qp.g +
+      qp.A.transpose() * Qp2.results.y + qp.C.transpose() * Qp2.results.z);
+    T pri_res =
+      std::max(proxqp::dense::infty_norm(qp.A * Qp2.results.x - qp.b),
+               proxqp::dense::infty_norm(
+                 sparse::detail::positive_part(qp.C * Qp2.results.x - qp.u) +
+                 sparse::detail::negative_part(qp.C * Qp2.results.x - qp.l)));
+    CHECK(dua_res <= eps_abs);
+    CHECK(pri_res <= eps_abs);
+
+    proxqp::sparse::QP<T, I> Qp3(n, n_eq, n_in);
+    Qp3.load_snapshot(snapshot_path);
+    CHECK(Qp3.model.kkt_col_ptrs.len() == n + n_eq + n_in + 1);
+    Qp3.solve();
+    CHECK(Qp3.results.info.iter == Qp2.results.info.iter);
+    std::remove(snapshot_path.c_str());
+
+    // a later init with other matrices owns its pattern again
+    Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    CHECK(Qp2.model.kkt_col_ptrs.len() == n + n_eq + n_in + 1);
+    Qp2.solve();
+    CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp3.results.x) <= 1.E-6);
+
+    std::remove(path.c_str());
+    CHECK_THROWS((sparse::MappedQp<T, I>(path)));
+
+    std::cout << "--n = " << n << " n_eq " << n_eq << " n_in " << n_in
+              << std::endl;
+    std::cout << "; dual residual " << dua_res << "; primal residual "
+              << pri_res << std::endl;
+    std::cout << "total number of iteration: " << Qp2.results.info.iter
+              << std::endl;
+  }
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: observing the outer iterations")
+{
+  isize n = 20;
+  isize n_eq = 5;
+  isize n_in = 5;
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  RingBufferObserver<T> observer(3);
+  Qp.solve(observer);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // the records are taken at the start of each outer iteration
+  CHECK(observer.total() > 3);
+  CHECK(observer.total() <= Qp.results.info.iter_ext);
+  CHECK(observer.size() == 3);
+  IterationRecord<T> const& last = observer.back();
+  CHECK(last.iter == observer.total() - 1);
+  CHECK(last.iter_inner <= Qp.results.info.iter);
+  CHECK(last.pri_res >= 0);
+  CHECK(last.dua_res >= 0);
+  CHECK(last.mu_in > 0);
+  CHECK(last.n_active >= 0);
+  CHECK(last.n_active <= n_in);
+  CHECK(last.alpha > 0);
+
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.iter == Qp.results.info.iter);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) == 0);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: solving the blocks of a block separable "
+          "qp independently")
+{
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  // three independent problems, plus an inequality without any variable
+  isize dims[3][3] = { { 8, 2, 3 }, { 12, 3, 4 }, { 6, 1, 2 } };
+  isize n = 26;
+  isize n_eq = 6;
+  isize n_in = 10;
+  proxqp::dense::Model<T> qp(n, n_eq, n_in);
+  qp.H.setZero();
+  qp.A.setZero();
+  qp.C.setZero();
+  qp.l(n_in - 1) = -1;
+  qp.u(n_in - 1) = 1;
+  isize offsets[3] = { 0, 0, 0 };
+  for (auto const& d : dims) {
+    proxqp::dense::Model<T> block =
+      utils::dense_strongly_convex_qp(d[0], d[1], d[2], T(0.9), T(0.01));
+    qp.H.block(offsets[0], offsets[0], d[0], d[0]) = block.H;
+    qp.g.segment(offsets[0], d[0]) = block.g;
+    qp.A.block(offsets[1], offsets[0], d[1], d[0]) = block.A;
+    qp.b.segment(offsets[1], d[1]) = block.b;
+    qp.C.block(offsets[2], offsets[0], d[2], d[0]) = block.C;
+    qp.u.segment(offsets[2], d[2]) = block.u;
+    qp.l.segment(offsets[2], d[2]) = block.l;
+    for (isize k = 0; k < 3; ++k) {
+      offsets[k] += d[k];
+    }
+  }
+  // the variables of the blocks are interleaved
+  Eigen::PermutationMatrix<Eigen::Dynamic> perm(n);
+  for (isize i = 0; i < n; ++i) {
+    perm.indices()(i) = int((7 * i) % n);
+  }
+  qp.H = perm * qp.H * perm.transpose();
+  qp.g = perm * qp.g;
+  qp.A = qp.A * perm.transpose();
+  qp.C = qp.C * perm.transpose();
+  proxqp::sparse::SparseMat<T, I> H = qp.H.sparseView();
+  proxqp::sparse::SparseMat<T, I> A = qp.A.sparseView();
+  proxqp::sparse::SparseMat<T, I> C = qp.C.sparseView();
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.decompose_separable_blocks = true;
+  Qp.settings.nb_threads = 2;
+  Qp.init(H, qp.g, A, qp.b, C, qp.u, qp.l);
+  CHECK(Qp.work.internal.n_components == 4);
+  Qp.solve();
+  CHECK(Qp.blocks.size() == 3);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  isize iter = 0;
+  for (auto const& block : Qp.blocks) {
+    CHECK(block.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+    iter += block.results.info.iter;
+  }
+  CHECK(Qp.results.info.iter == iter);
+
+  T pri_res = std::max(
+    proxqp::dense::infty_norm(qp.A * Qp.results.x - qp.b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(qp.C * Qp.results.x - qp.u) +
+      proxqp::sparse::detail::negative_part(qp.C * Qp.results.x - qp.l)));
+  T dua_res = proxqp::dense::infty_norm(qp.H * Qp.results.x + qp.g +
+                                        qp.A.transpose() * Qp.results.y +
+                                        qp.C.transpose() * Qp.results.z);
+  CHECK(pri_res <= eps_abs);
+  CHECK(dua_res <= eps_abs);
+  CHECK(Qp.results.z(n_in - 1) == 0);
+
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.init(H, qp.g, A, qp.b, C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.blocks.empty());
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-6);
+  CHECK(std::abs(Qp2.results.info.objValue - Qp.results.info.objValue) <=
+        1.E-6);
+
+  // the blocks are set up anew by an update, and warm started
+  proxqp::dense::Vec<T> g = qp.g * T(2);
+  Qp.update(std::nullopt,
+            g,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt);
+  CHECK(Qp.blocks.empty());
+  Qp2.update(std::nullopt,
+             g,
+             std::nullopt,
+             std::nullopt,
+             std::nullopt,
+             std::nullopt,
+             std::nullopt);
+  Qp2.solve();
+  Qp.solve(Qp2.results.x, Qp2.results.y, Qp2.results.z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-6);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.z - Qp.results.z) <= 1.E-6);
+
+  // the blocks are kept by an update of the vectors keeping the
+  // preconditioner, and start from their previous results
+  g = qp.g * T(2.1);
+  proxqp::sparse::QP<T, I> Qp3(n, n_eq, n_in);
+  Qp3.settings.eps_abs = eps_abs;
+  Qp3.settings.decompose_separable_blocks = true;
+  Qp3.init(H, g, A, qp.b, C, qp.u, qp.l);
+  Qp3.solve();
+  CHECK(Qp3.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  Qp.settings.initial_guess =
+    InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT;
+  auto const* first_block = Qp.blocks.data();
+  Qp.update(std::nullopt,
+            g,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  CHECK(Qp.blocks.size() == 3);
+  CHECK(Qp.blocks.data() == first_block);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(proxqp::dense::infty_norm(Qp3.results.x - Qp.results.x) <= 1.E-6);
+  CHECK(Qp.results.info.iter < Qp3.results.info.iter);
+  // a matrix update sets the blocks up anew
+  Qp.update(H,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  CHECK(Qp.blocks.empty());
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: diagonal plus low rank quadratic cost")
+{
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  // factor model: budget constraint and long only bounded positions
+  isize n = 50;
+  isize k = 3;
+  isize n_eq = 1;
+  isize n_in = n;
+  proxqp::sparse::LowRankHessian<T> H_low_rank(
+    (T(0.1) + rand::vector_rand<T>(n).array().abs()).matrix(),
+    rand::matrix_rand<T>(n, k));
+  CHECK(H_low_rank.dim() == n);
+  CHECK(H_low_rank.rank() == k);
+  proxqp::dense::Vec<T> g = rand::vector_rand<T>(n);
+  proxqp::dense::Mat<T> A = proxqp::dense::Mat<T>::Ones(n_eq, n);
+  proxqp::dense::Vec<T> b = proxqp::dense::Vec<T>::Ones(n_eq);
+  proxqp::dense::Mat<T> C = proxqp::dense::Mat<T>::Identity(n_in, n);
+  proxqp::dense::Vec<T> l = proxqp::dense::Vec<T>::Zero(n_in);
+  proxqp::dense::Vec<T> u = proxqp::dense::Vec<T>::Constant(n_in, T(0.1));
+  proxqp::sparse::SparseMat<T, I> A_sparse = A.sparseView();
+  proxqp::sparse::SparseMat<T, I> C_sparse = C.sparseView();
+
+  proxqp::sparse::QP<T, I> Qp(n + k, n_eq + k, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(H_low_rank, g, A_sparse, b, C_sparse, u, l);
+  // the lifted matrices hold O(nk) coefficients
+  CHECK(Qp.model.H_nnz == n + k);
+  CHECK(Qp.model.A_nnz == n * n_eq + n * k + k);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  proxqp::dense::Mat<T> H = H_low_rank.d.asDiagonal();
+  H += H_low_rank.F * H_low_rank.F.transpose();
+  proxqp::dense::Vec<T> x = Qp.results.x.head(n);
+  proxqp::dense::Vec<T> y = Qp.results.y.head(n_eq);
+  proxqp::dense::Vec<T> z = Qp.results.z;
+  CHECK(proxqp::dense::infty_norm(H_low_rank.apply(x) - H * x) <= 1.E-12);
+  T pri_res = std::max(
+    proxqp::dense::infty_norm(A * x - b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(C * x - u) +
+      proxqp::sparse::detail::negative_part(C * x - l)));
+  T dua_res = proxqp::dense::infty_norm(H * x + g + A.transpose() * y +
+                                        C.transpose() * z);
+  CHECK(pri_res <= 1.E-8);
+  CHECK(dua_res <= 1.E-8);
+  CHECK(proxqp::dense::infty_norm(Qp.results.x.tail(k) -
+                                  H_low_rank.F.transpose() * x) <= 1.E-8);
+
+  // same solution with the formed quadratic cost
+  proxqp::sparse::SparseMat<T, I> H_sparse = H.sparseView();
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(H_sparse, g, A_sparse, b, C_sparse, u, l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - x) <= 1.E-6);
+  CHECK(std::abs(Qp2.results.info.objValue - Qp.results.info.objValue) <=
+        1.E-6);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: least-squares objective without forming "
+          "J^T J")
+{
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  // tall sparse J, one equality constraint and bounds on x
+  isize n = 20;
+  isize n_res = 200;
+  isize n_eq = 1;
+  isize n_in = n;
+  proxqp::dense::Mat<T> J_dense =
+    rand::sparse_matrix_rand_not_compressed<T>(n_res, n, 0.2);
+  proxqp::sparse::SparseMat<T, I> J = J_dense.sparseView();
+  proxqp::dense::Vec<T> r = rand::vector_rand<T>(n_res);
+  proxqp::dense::Vec<T> g = T(0.1) * rand::vector_rand<T>(n);
+  proxqp::dense::Mat<T> A = proxqp::dense::Mat<T>::Ones(n_eq, n);
+  proxqp::dense::Vec<T> b = proxqp::dense::Vec<T>::Constant(n_eq, T(0.2));
+  proxqp::dense::Mat<T> C = proxqp::dense::Mat<T>::Identity(n_in, n);
+  proxqp::dense::Vec<T> l = proxqp::dense::Vec<T>::Constant(n_in, T(-0.02));
+  proxqp::dense::Vec<T> u = proxqp::dense::Vec<T>::Constant(n_in, T(0.05));
+  proxqp::sparse::SparseMat<T, I> A_sparse = A.sparseView();
+  proxqp::sparse::SparseMat<T, I> C_sparse = C.sparseView();
+
+  proxqp::sparse::QP<T, I> Qp(n + n_res, n_eq + n_res, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init_least_squares(J, r, g, A_sparse, b, C_sparse, u, l);
+  // the lifted matrices hold O(nnz(J)) coefficients
+  CHECK(Qp.model.H_nnz == n_res);
+  CHECK(Qp.model.A_nnz == n * n_eq + J.nonZeros() + n_res);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // KKT residuals of the original problem, of Hessian J^T J
+  proxqp::dense::Mat<T> H = J_dense.transpose() * J_dense;
+  proxqp::dense::Vec<T> g_qp = g - J_dense.transpose() * r;
+  proxqp::dense::Vec<T> x = Qp.results.x.head(n);
+  proxqp::dense::Vec<T> y = Qp.results.y.head(n_eq);
+  proxqp::dense::Vec<T> z = Qp.results.z;
+  T pri_res = std::max(
+    proxqp::dense::infty_norm(A * x - b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(C * x - u) +
+      proxqp::sparse::detail::negative_part(C * x - l)));
+  T dua_res = proxqp::dense::infty_norm(H * x + g_qp + A.transpose() * y +
+                                        C.transpose() * z);
+  CHECK(pri_res <= 1.E-8);
+  CHECK(dua_res <= 1.E-8);
+  CHECK(proxqp::dense::infty_norm(Qp.results.x.tail(n_res) -
+                                  (J_dense * x - r)) <= 1.E-8);
+  CHECK((z.array() != 0).count() > 0);
+
+  // same solution with the formed Hessian
+  proxqp::sparse::SparseMat<T, I> H_sparse = H.sparseView();
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(H_sparse, g_qp, A_sparse, b, C_sparse, u, l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - x) <= 1.E-6);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.z - z) <= 1.E-6);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: polishing of the solution")
+{
+  isize n = 50;
+  isize n_eq = 10;
+  isize n_in = 25;
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.polish = true;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.results.info.polished);
+
+  T pri_res = std::max(
+    proxqp::dense::infty_norm(qp.A * Qp.results.x - qp.b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(qp.C * Qp.results.x - qp.u) +
+      proxqp::sparse::detail::negative_part(qp.C * Qp.results.x - qp.l)));
+  T dua_res = proxqp::dense::infty_norm(
+    qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + qp.g +
+    qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+  CHECK(pri_res <= eps_abs);
+  CHECK(dua_res <= eps_abs);
+
+  // same solution in no more iterations than without polishing
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(!Qp2.results.info.polished);
+  CHECK(Qp.results.info.iter <= Qp2.results.info.iter);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-6);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.z - Qp.results.z) <= 1.E-6);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: Anderson acceleration of the outer loop")
+{
+  isize n = 50;
+  isize n_eq = 10;
+  isize n_in = 25;
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.anderson_acceleration = true;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  T pri_res = std::max(
+    proxqp::dense::infty_norm(qp.A * Qp.results.x - qp.b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(qp.C * Qp.results.x - qp.u) +
+      proxqp::sparse::detail::negative_part(qp.C * Qp.results.x - qp.l)));
+  T dua_res = proxqp::dense::infty_norm(
+    qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + qp.g +
+    qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+  CHECK(pri_res <= eps_abs);
+  CHECK(dua_res <= eps_abs);
+
+  // same solution as without acceleration
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-6);
+
+  // the memory of the previous solve is not used by a warm started one
+  qp.g += T(1e-2) * utils::rand::vector_rand<T>(n);
+  Qp.update(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l, false);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  dua_res = proxqp::dense::infty_norm(
+    qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + qp.g +
+    qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+  CHECK(dua_res <= eps_abs);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: interior point method")
+{
+  isize n = 50;
+  isize n_eq = 10;
+  isize n_in = 25;
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+  // one sided and free constraints
+  qp.u.head(5).setConstant(std::numeric_limits<T>::infinity());
+  qp.l.tail(5).setConstant(-std::numeric_limits<T>::infinity());
+  qp.u(n_in - 1) = std::numeric_limits<T>::infinity();
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  T pri_res = std::max(
+    proxqp::dense::infty_norm(qp.A * Qp.results.x - qp.b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(qp.C * Qp.results.x - qp.u) +
+      proxqp::sparse::detail::negative_part(qp.C * Qp.results.x - qp.l)));
+  T dua_res = proxqp::dense::infty_norm(
+    qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + qp.g +
+    qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+  CHECK(pri_res <= eps_abs);
+  CHECK(dua_res <= eps_abs);
+
+  // same solution as PROXQP
+  proxqp::sparse::QP<T, I> Qp2(n, n_eq, n_in);
+  Qp2.settings.eps_abs = eps_abs;
+  Qp2.settings.eps_rel = 0;
+  Qp2.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp2.solve();
+  CHECK(Qp2.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.x - Qp.results.x) <= 1.E-6);
+  CHECK(proxqp::dense::infty_norm(Qp2.results.z - Qp.results.z) <= 1.E-6);
+
+  // second solve after an update of the model
+  qp.g += T(1e-2) * utils::rand::vector_rand<T>(n);
+  Qp.update(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l, false);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  dua_res = proxqp::dense::infty_norm(
+    qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + qp.g +
+    qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+  CHECK(dua_res <= eps_abs);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: time limit")
+{
+  isize n = 50;
+  isize n_eq = 10;
+  isize n_in = 25;
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.time_limit = T(0);
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+  CHECK(Qp.results.x.allFinite());
+  CHECK(Qp.results.z.allFinite());
+  // the residuals are the ones of the returned iterate
+  T pri_res = std::max(
+    proxqp::dense::infty_norm(qp.A * Qp.results.x - qp.b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(qp.C * Qp.results.x - qp.u) +
+      proxqp::sparse::detail::negative_part(qp.C * Qp.results.x - qp.l)));
+  CHECK(std::abs(pri_res - Qp.results.info.pri_res) <=
+        1e-8 * std::max(T(1), pri_res));
+
+  // absolute deadline, already passed
+  Qp.settings.time_limit = std::numeric_limits<T>::infinity();
+  Qp.settings.deadline = std::chrono::steady_clock::now();
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+
+  // a generous limit does not change the solve
+  Qp.settings.deadline = std::chrono::steady_clock::time_point::max();
+  Qp.settings.time_limit = T(1e7);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  T dua_res = proxqp::dense::infty_norm(
+    qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + qp.g +
+    qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+  CHECK(dua_res <= eps_abs);
+
+  // interior-point method
+  Qp.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp.settings.time_limit = T(0);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+  CHECK(Qp.results.x.allFinite());
+  Qp.settings.time_limit = T(1e7);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // deadline reached during the inner loop of the last outer iteration: the
+  // best iterate is returned rather than the unchecked inner iterate
+  Qp.settings.method = SolverMethod::PROXQP;
+  Qp.settings.max_iter = 1;
+  Qp.settings.initial_guess = InitialGuessStatus::NO_INITIAL_GUESS;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.begin_solve();
+  CHECK(!Qp.step(1));
+  Qp.work.internal.deadline.start(
+    T(0), std::chrono::steady_clock::time_point::max());
+  CHECK(Qp.step(std::numeric_limits<isize>::max()));
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_TIME_LIMIT_REACHED);
+  pri_res = std::max(
+    proxqp::dense::infty_norm(qp.A * Qp.results.x - qp.b),
+    proxqp::dense::infty_norm(
+      proxqp::sparse::detail::positive_part(qp.C * Qp.results.x - qp.u) +
+      proxqp::sparse::detail::negative_part(qp.C * Qp.results.x - qp.l)));
+  CHECK(std::abs(pri_res - Qp.results.info.pri_res) <=
+        1e-8 * std::max(T(1), pri_res));
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: step-wise solve")
+{
+  isize n = 50;
+  isize n_eq = 10;
+  isize n_in = 25;
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+  proxqp::sparse::SparseModel<T> qp2 =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // two interleaved solves, one of them on the same problem
+  proxqp::sparse::QP<T, I> Qp_a(n, n_eq, n_in);
+  Qp_a.settings.eps_abs = eps_abs;
+  Qp_a.settings.eps_rel = 0;
+  Qp_a.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  proxqp::sparse::QP<T, I> Qp_b(n, n_eq, n_in);
+  Qp_b.settings.eps_abs = eps_abs;
+  Qp_b.settings.eps_rel = 0;
+  Qp_b.init(qp2.H, qp2.g, qp2.A, qp2.b, qp2.C, qp2.u, qp2.l);
+  CHECK(Qp_a.is_done());
+  Qp_a.begin_solve();
+  Qp_b.begin_solve();
+  CHECK(!Qp_a.is_done());
+  isize n_steps = 0;
+  while (!Qp_a.is_done() || !Qp_b.is_done()) {
+    if (!Qp_a.is_done()) {
+      Qp_a.step(1);
+      ++n_steps;
+    }
+    Qp_b.step(1);
+  }
+  // a step runs a single Newton step, even in the middle of an inner loop
+  CHECK(n_steps >= Qp.results.info.iter);
+  CHECK(Qp.results.info.iter > Qp.results.info.iter_ext);
+  CHECK(Qp_a.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp_b.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  // the iterates are the ones of a solve in one call
+  CHECK(Qp_a.results.info.iter == Qp.results.info.iter);
+  CHECK(Qp_a.results.info.iter_ext == Qp.results.info.iter_ext);
+  CHECK(Qp_a.results.x == Qp.results.x);
+  CHECK(Qp_a.results.z == Qp.results.z);
+  T dua_res = proxqp::dense::infty_norm(
+    qp2.H.selfadjointView<Eigen::Upper>() * Qp_b.results.x + qp2.g +
+    qp2.A.transpose() * Qp_b.results.y + qp2.C.transpose() * Qp_b.results.z);
+  CHECK(dua_res <= eps_abs);
+
+  // a second step-wise solve, with a single step
+  Qp_a.begin_solve();
+  CHECK(Qp_a.step(std::numeric_limits<isize>::max()));
+  CHECK(Qp_a.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+
+  // the interior-point method is run one iteration per step
+  proxqp::sparse::QP<T, I> Qp_ipm(n, n_eq, n_in);
+  Qp_ipm.settings.eps_abs = eps_abs;
+  Qp_ipm.settings.eps_rel = 0;
+  Qp_ipm.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp_ipm.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp_ipm.solve();
+  CHECK(Qp_ipm.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  proxqp::sparse::QP<T, I> Qp_ipm_a(n, n_eq, n_in);
+  Qp_ipm_a.settings.eps_abs = eps_abs;
+  Qp_ipm_a.settings.eps_rel = 0;
+  Qp_ipm_a.settings.method = SolverMethod::INTERIOR_POINT;
+  Qp_ipm_a.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  Qp_ipm_a.begin_solve();
+  n_steps = 0;
+  while (!Qp_ipm_a.step(1)) {
+    ++n_steps;
+    CHECK(Qp_ipm_a.results.info.iter == n_steps);
+  }
+  CHECK(n_steps == Qp_ipm.results.info.iter);
+  CHECK(Qp_ipm_a.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp_ipm_a.results.x == Qp_ipm.results.x);
+}
+
+TEST_CASE("sparse random strongly convex qp with equality and "
+          "inequality constraints: factorization cache")
+{
+  isize n = 50;
+  isize n_eq = 10;
+  isize n_in = 25;
+  T eps_abs = 1.E-9;
+  ::proxsuite::proxqp::utils::rand::set_seed(1);
+  proxqp::sparse::SparseModel<T> qp =
+    utils::sparse_strongly_convex_qp(n, n_eq, n_in, T(0.15), T(0.01));
+
+  proxqp::sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.settings.eps_rel = 0;
+  Qp.settings.initial_guess = InitialGuessStatus::WARM_START;
+  Qp.settings.factorization_cache_max_bytes = 1 << 24;
+  Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+  proxqp::sparse::QP<T, I> Qp_ref(n, n_eq, n_in);
+  Qp_ref.settings.eps_abs = eps_abs;
+  Qp_ref.settings.eps_rel = 0;
+  Qp_ref.settings.initial_guess = InitialGuessStatus::WARM_START;
+  Qp_ref.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+
+  proxqp::dense::Vec<T> x = proxqp::dense::Vec<T>::Zero(n);
+  proxqp::dense::Vec<T> y = proxqp::dense::Vec<T>::Zero(n_eq);
+  proxqp::dense::Vec<T> z = proxqp::dense::Vec<T>::Zero(n_in);
+  Qp.solve(x, y, z);
+  Qp_ref.solve(x, y, z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.factorization_cache().misses() == 1);
+  CHECK(Qp.factorization_cache().size() == 1);
+
+  // warm starts from the same solution: the second one restores the
+  // factorization of its active set
+  x = Qp.results.x;
+  y = Qp.results.y;
+  z = Qp.results.z;
+  CHECK((z.array() != 0).any());
+  Qp.solve(x, y, z);
+  Qp.solve(x, y, z);
+  Qp_ref.solve(x, y, z);
+  Qp_ref.solve(x, y, z);
+  CHECK(Qp.factorization_cache().hits() == 1);
+  CHECK(Qp.factorization_cache().misses() == 2);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.results.info.iter == Qp_ref.results.info.iter);
+  CHECK(Qp.results.x == Qp_ref.results.x);
+  CHECK(Qp.results.z == Qp_ref.results.z);
+  CHECK(Qp_ref.factorization_cache().size() == 0);
+
+  // the cache is kept when only the vectors change
+  proxqp::dense::Vec<T> g =
+    qp.g + proxqp::dense::Vec<T>::Constant(n, T(1e-2));
+  Qp.update(std::nullopt,
+            g,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  Qp.solve(x, y, z);
+  CHECK(Qp.factorization_cache().hits() == 2);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  T dua_res = proxqp::dense::infty_norm(
+    qp.H.selfadjointView<Eigen::Upper>() * Qp.results.x + g +
+    qp.A.transpose() * Qp.results.y + qp.C.transpose() * Qp.results.z);
+  CHECK(dua_res <= eps_abs);
+
+  // and cleared when the matrices change
+  Qp.update(qp.H,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  CHECK(Qp.factorization_cache().size() == 0);
+  Qp.solve(x, y, z);
+  CHECK(Qp.factorization_cache().misses() == 3);
+  CHECK(Qp.factorization_cache().size() == 1);
+
+  // nothing is kept above the memory cap
+  Qp.settings.factorization_cache_max_bytes = 1;
+  Qp.update(qp.H,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            false);
+  Qp.solve(x, y, z);
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  CHECK(Qp.factorization_cache().misses() == 4);
+  CHECK(Qp.factorization_cache().size() == 0);
+}
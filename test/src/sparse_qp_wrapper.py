@@ -3941,5 +3941,108 @@ class SparseQpWrapper(unittest.TestCase):
         )
 
 
+    def test_case_init_and_update_without_conversions(self):
+        print(
+            "------------------------sparse random strongly convex qp with equality and inequality constraints: test init and update without conversions"
+        )
+        n = 10
+        H, g, A, b, C, u, l = generate_mixed_qp(n)
+        n_eq = A.shape[0]
+        n_in = C.shape[0]
+
+        Qp = proxsuite.proxqp.sparse.QP(n, n_eq, n_in)
+        Qp.settings.eps_abs = 1.0e-9
+        Qp.settings.verbose = False
+        Qp.init(H=H, g=g, A=A, b=b, C=C, u=u, l=l)
+        Qp.solve()
+
+        # an upper triangular csc H and csr A and C are read in place
+        H_triu = spa.triu(H, format="csc")
+        Qp2 = proxsuite.proxqp.sparse.QP(n, n_eq, n_in)
+        Qp2.settings.eps_abs = 1.0e-9
+        Qp2.settings.verbose = False
+        Qp2.init(
+            H=H_triu,
+            g=g,
+            A=spa.csr_matrix(A),
+            b=b,
+            C=spa.csr_matrix(C),
+            u=u,
+            l=l,
+        )
+        Qp2.solve()
+        assert Qp2.results.info.iter == Qp.results.info.iter
+        assert normInf(Qp2.results.x - Qp.results.x) <= 1e-9
+
+        # the results are views into the storage of the solver
+        x = Qp2.results.x
+        H = 2.0 * H
+        Qp2.update(H=spa.triu(H, format="csc"))
+        Qp2.solve()
+        assert np.array_equal(x, Qp2.results.x)
+        dua_res = normInf(
+            H @ Qp2.results.x
+            + g
+            + A.transpose() @ Qp2.results.y
+            + C.transpose() @ Qp2.results.z
+        )
+        pri_res = max(
+            normInf(A @ Qp2.results.x - b),
+            normInf(
+                np.maximum(C @ Qp2.results.x - u, 0)
+                + np.minimum(C @ Qp2.results.x - l, 0)
+            ),
+        )
+        assert dua_res <= 1e-9
+        assert pri_res <= 1e-9
+        print("--n = {} ; n_eq = {} ; n_in = {}".format(n, n_eq, n_in))
+        print("dual residual = {} ; primal residual = {}".format(dua_res, pri_res))
+        print("total number of iteration: {}".format(Qp2.results.info.iter))
+
+
+    def test_case_float32_and_int64_indices(self):
+        print(
+            "------------------------sparse random strongly convex qp with equality and inequality constraints: test float32 and int64 QP objects"
+        )
+        n = 10
+        H, g, A, b, C, u, l = generate_mixed_qp(n)
+        n_eq = A.shape[0]
+        n_in = C.shape[0]
+
+        for QP, dtype in [
+            (proxsuite.proxqp.sparse.QP_f32, np.float32),
+            (proxsuite.proxqp.sparse.QP_i64, np.float64),
+        ]:
+            Qp = QP(n, n_eq, n_in)
+            Qp.settings.eps_abs = 1.0e-4
+            Qp.settings.verbose = False
+            Qp.init(
+                H=H.astype(dtype),
+                g=g.astype(dtype),
+                A=A.astype(dtype),
+                b=b.astype(dtype),
+                C=C.astype(dtype),
+                u=u.astype(dtype),
+                l=l.astype(dtype),
+            )
+            Qp.solve()
+            assert Qp.results.x.dtype == dtype
+            x = Qp.results.x.astype(np.float64)
+            y = Qp.results.y.astype(np.float64)
+            z = Qp.results.z.astype(np.float64)
+            dua_res = normInf(H @ x + g + A.transpose() @ y + C.transpose() @ z)
+            pri_res = max(
+                normInf(A @ x - b),
+                normInf(np.maximum(C @ x - u, 0) + np.minimum(C @ x - l, 0)),
+            )
+            assert dua_res <= 1e-3
+            assert pri_res <= 1e-3
+            print("--n = {} ; n_eq = {} ; n_in = {}".format(n, n_eq, n_in))
+            print(
+                "dual residual = {} ; primal residual = {}".format(dua_res, pri_res)
+            )
+            print("total number of iteration: {}".format(Qp.results.info.iter))
+
+
 if __name__ == "__main__":
     unittest.main()
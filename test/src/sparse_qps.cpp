@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2022 INRIA
+//
+#include <doctest.hpp>
+#include <maros_meszaros.hpp>
+#include <proxsuite/proxqp/sparse/sparse.hpp>
+#include <proxsuite/proxqp/sparse/qps.hpp>
+#include <proxsuite/proxqp/timings.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace proxsuite::proxqp;
+using T = double;
+using I = mat_int32_t;
+
+#define MAROS_MESZAROS_DIR PROBLEM_PATH "/data/maros_meszaros_data/"
+
+char const* qps_test_qp = R"(NAME          TESTQP
+* rows of all types, with a range on an equality row
+ROWS
+ N  COST
+ G  R1
+ L  R2
+ E  R3
+ E  R4
+ N  FREE
+COLUMNS
+    X1        COST      1.0        R1        1.0
+    X1        R2        1.0        R4        2.0
+    X1        FREE      3.0
+    X2        COST      1.0        R1        1.0
+    X2        R3        1.0
+    X3        R2        1.0
+RHS
+    RHS       COST      -4.0       R1        1.0
+    RHS       R2        2.0        R3        1.5
+RANGES
+    RNG       R4        -1.5
+BOUNDS
+ UP BND       X1        1.0
+ FR BND       X2
+ MI BND       X3
+QUADOBJ
+    X1        X1        4.0
+    X1        X2        1.0
+    X2        X2        2.0
+    X3        X3        1.0
+ENDATA
+)";
+
+TEST_CASE("sparse qp read from a QPS stream")
+{
+  std::istringstream in(qps_test_qp);
+  auto qps = sparse::read_qps<T, I>(in);
+  CHECK(qps.name == "TESTQP");
+  CHECK(qps.dim == 3);
+  CHECK(qps.n_eq == 1);
+  CHECK(qps.n_in == 4); // R1, R2, R4 and the bounds of X1
+  CHECK(qps.objective_constant == T(4));
+
+  sparse::DMat<T> H(3, 3);
+  H << 4, 1, 0, //
+    0, 2, 0,    //
+    0, 0, 1;
+  sparse::DMat<T> AT(3, 1);
+  AT << 0, 1, 0;
+  sparse::DMat<T> CT(3, 4);
+  CT << 1, 1, 2, 1, //
+    1, 0, 0, 0,     //
+    0, 1, 0, 0;
+  CHECK(sparse::DMat<T>(qps.H) == H);
+  CHECK(sparse::DMat<T>(qps.AT) == AT);
+  CHECK(sparse::DMat<T>(qps.CT) == CT);
+
+  T const inf = std::numeric_limits<T>::infinity();
+  sparse::Vec<T> g(3), b(1), l(4), u(4);
+  g << 1, 1, 0;
+  b << 1.5;
+  l << 1, -inf, -1.5, 0;
+  u << inf, 2, 0, 1;
+  CHECK(qps.g == g);
+  CHECK(qps.b == b);
+  CHECK(qps.l == l);
+  CHECK(qps.u == u);
+
+  // the matrices are given as views to the solver
+  T eps_abs = 1.E-9;
+  sparse::QP<T, I> Qp(qps.dim, qps.n_eq, qps.n_in);
+  Qp.settings.eps_abs = eps_abs;
+  Qp.init(qps.H_view(),
+          qps.g,
+          qps.AT_view(),
+          qps.b,
+          qps.CT_view(),
+          qps.u,
+          qps.l);
+  Qp.solve();
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  sparse::Vec<T> x_sol(3);
+  x_sol << 0, 1.5, 0;
+  CHECK(dense::infty_norm(Qp.results.x - x_sol) <= 1.E-6);
+}
+
+TEST_CASE("sparse qp read from a QPS stream: unordered quadratic objective")
+{
+  // the upper triangular part of H is written column by column, from the last
+  // column to the first one
+  std::string text = qps_test_qp;
+  std::string quadobj = "QUADOBJ\n"
+                        "    X3        X3        1.0\n"
+                        "    X2        X2        2.0\n"
+                        "    X1        X2        1.0\n"
+                        "    X1        X1        4.0\n";
+  auto begin = text.find("QUADOBJ");
+  text.replace(begin, text.find("ENDATA") - begin, quadobj);
+  std::istringstream in(text);
+  auto qps = sparse::read_qps<T, I>(in);
+
+  sparse::DMat<T> H(3, 3);
+  H << 4, 1, 0, //
+    0, 2, 0,    //
+    0, 0, 1;
+  CHECK(sparse::DMat<T>(qps.H) == H);
+  // the row indices of each column are sorted
+  for (isize j = 0; j < qps.dim; ++j) {
+    for (I p = qps.H.outerIndexPtr()[j] + 1; p < qps.H.outerIndexPtr()[j + 1];
+         ++p) {
+      CHECK(qps.H.innerIndexPtr()[p - 1] < qps.H.innerIndexPtr()[p]);
+    }
+  }
+}
+
+TEST_CASE("sparse qp read from an invalid QPS stream")
+{
+  std::istringstream unknown_row("NAME TEST\nROWS\n N  COST\nCOLUMNS\n"
+                                 "    X1  COST  1.0  R1  1.0\nENDATA\n");
+  CHECK_THROWS((sparse::read_qps<T, I>(unknown_row)));
+  std::istringstream split_column("NAME TEST\nROWS\n N  COST\nCOLUMNS\n"
+                                  "    X1  COST  1.0\n    X2  COST  1.0\n"
+                                  "    X1  COST  1.0\nENDATA\n");
+  CHECK_THROWS((sparse::read_qps<T, I>(split_column)));
+  std::istringstream no_objective("NAME TEST\nROWS\n E  R1\nENDATA\n");
+  CHECK_THROWS((sparse::read_qps<T, I>(no_objective)));
+}
+
+namespace {
+// writes a preprocessed maros meszaros problem to a QPS file
+void
+write_qps(std::string const& path, PreprocessedQpSparse const& qp)
+{
+  using RowMat = Eigen::SparseMatrix<T, Eigen::RowMajor, I>;
+  isize n = qp.H.rows();
+  isize n_eq = qp.AT.cols();
+  isize n_in = qp.CT.cols();
+  // the bounds beyond 1e20 are infinite for the solver
+  T const inf = T(1.E20);
+
+  std::ofstream out(path);
+  out << std::setprecision(17);
+  out << "NAME TEST\nROWS\n N  COST\n";
+  for (isize k = 0; k < n_eq; ++k) {
+    out << " E  E" << k << '\n';
+  }
+  for (isize k = 0; k < n_in; ++k) {
+    out << (qp.l[k] <= -inf ? " L  I" : " G  I") << k << '\n';
+  }
+  // A is written by columns
+  RowMat A_T = qp.AT;
+  RowMat C_T = qp.CT;
+  out << "COLUMNS\n";
+  for (isize j = 0; j < n; ++j) {
+    out << "    X" << j << "  COST  " << qp.g[j] << '\n';
+    for (RowMat::InnerIterator it(A_T, j); it; ++it) {
+      out << "    X" << j << "  E" << it.col() << "  " << it.value() << '\n';
+    }
+    for (RowMat::InnerIterator it(C_T, j); it; ++it) {
+      out << "    X" << j << "  I" << it.col() << "  " << it.value() << '\n';
+    }
+  }
+  out << "RHS\n";
+  for (isize k = 0; k < n_eq; ++k) {
+    out << "    RHS  E" << k << "  " << qp.b[k] << '\n';
+  }
+  for (isize k = 0; k < n_in; ++k) {
+    out << "    RHS  I" << k << "  " << (qp.l[k] <= -inf ? qp.u[k] : qp.l[k])
+        << '\n';
+  }
+  out << "RANGES\n";
+  for (isize k = 0; k < n_in; ++k) {
+    if (qp.l[k] > -inf && qp.u[k] < inf) {
+      out << "    RNG  I" << k << "  " << qp.u[k] - qp.l[k] << '\n';
+    }
+  }
+  out << "BOUNDS\n";
+  for (isize j = 0; j < n; ++j) {
+    out << " FR BND  X" << j << '\n';
+  }
+  // the lower triangular part of H is written by columns
+  RowMat H = qp.H;
+  out << "QUADOBJ\n";
+  for (isize i = 0; i < n; ++i) {
+    for (RowMat::InnerIterator it(H, i); it; ++it) {
+      out << "    X" << i << "  X" << it.col() << "  " << it.value() << '\n';
+    }
+  }
+  out << "ENDATA\n";
+}
+} // namespace
+
+TEST_CASE("sparse maros meszaros read from QPS files: comparison with the "
+          "mat files")
+{
+  char const* files[] = {
+    MAROS_MESZAROS_DIR "HS21.mat",     MAROS_MESZAROS_DIR "QAFIRO.mat",
+    MAROS_MESZAROS_DIR "CVXQP1_S.mat", MAROS_MESZAROS_DIR "QSHARE1B.mat",
+    MAROS_MESZAROS_DIR "BOYD1.mat",    MAROS_MESZAROS_DIR "EXDATA.mat",
+  };
+  for (auto const* file : files) {
+    Timer<T> timer;
+    auto qp_raw = load_qp(file);
+    timer.stop();
+    T mat_time = timer.elapsed().user;
+    PreprocessedQpSparse qp = preprocess_qp_sparse(VEG_FWD(qp_raw));
+
+    std::string path = "sparse_qps_test.qps";
+    write_qps(path, qp);
+    timer.start();
+    auto qps = sparse::read_qps<T, I>(path);
+    timer.stop();
+    T qps_time = timer.elapsed().user;
+    std::remove(path.c_str());
+
+    CHECK(qps.dim == qp.H.rows());
+    CHECK(qps.n_eq == qp.AT.cols());
+    CHECK(qps.n_in == qp.CT.cols());
+    CHECK((qps.H - qp.H).norm() == T(0));
+    CHECK((qps.AT - qp.AT).norm() == T(0));
+    CHECK((qps.CT - qp.CT).norm() == T(0));
+    CHECK(qps.g == qp.g);
+    CHECK(qps.b == qp.b);
+    CHECK(qps.l.cwiseMax(T(-1.E20)) == qp.l.cwiseMax(T(-1.E20)));
+    CHECK(qps.u.cwiseMin(T(1.E20)) == qp.u.cwiseMin(T(1.E20)));
+    std::cout << " path: " << file << " nnz(H) " << qps.H.nonZeros()
+              << " nnz(A) + nnz(C) "
+              << qps.AT.nonZeros() + qps.CT.nonZeros()
+              << " loading time (in microseconds) from the mat file: "
+              << mat_time << ", from the QPS file: " << qps_time << std::endl;
+  }
+}
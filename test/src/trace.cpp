@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2022 INRIA
+//
+// the spans are only recorded when this macro is defined (it may already be
+// set by the build)
+#ifndef PROXSUITE_WITH_TRACING
+#define PROXSUITE_WITH_TRACING
+#endif
+#include <doctest.hpp>
+#include <proxsuite/proxqp/dense/dense.hpp>
+#include <proxsuite/proxqp/sparse/sparse.hpp>
+#include <proxsuite/proxqp/utils/random_qp_problems.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace proxsuite::proxqp;
+using T = double;
+using I = utils::c_int;
+
+namespace {
+isize
+count_spans(trace::Recorder const& recorder, char const* name)
+{
+  isize count = 0;
+  for (trace::Event const& event : recorder.events) {
+    count += isize(std::strcmp(event.name, name) == 0);
+  }
+  return count;
+}
+void
+check_spans(trace::Recorder const& recorder)
+{
+  for (char const* name : { "init",
+                            "ruiz_iteration",
+                            "setup_factorization",
+                            "solve",
+                            "outer_iteration",
+                            "newton_step",
+                            "iterative_refinement" }) {
+    CHECK(count_spans(recorder, name) > 0);
+  }
+  CHECK(count_spans(recorder, "init") == 1);
+  CHECK(count_spans(recorder, "solve") == 1);
+  for (trace::Event const& event : recorder.events) {
+    CHECK(event.end >= event.start);
+    CHECK(event.start >= recorder.origin);
+  }
+}
+} // namespace
+
+TEST_CASE("dense qp: tracing the spans of a setup and a solve")
+{
+  isize n = 20;
+  isize n_eq = 5;
+  isize n_in = 5;
+  utils::rand::set_seed(1);
+  dense::Model<T> qp = utils::dense_strongly_convex_qp(
+    n, n_eq, n_in, T(0.15), T(1.e-2));
+
+  dense::QP<T> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = 1.E-9;
+  trace::Recorder recorder;
+  {
+    trace::Session session(recorder);
+    Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    Qp.solve();
+  }
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  check_spans(recorder);
+
+  // nothing is recorded out of a session
+  isize n_events = isize(recorder.events.size());
+  Qp.solve();
+  CHECK(isize(recorder.events.size()) == n_events);
+
+  std::string path = "dense_trace.json";
+  recorder.write_chrome_trace(path);
+  std::ifstream in(path);
+  std::stringstream content;
+  content << in.rdbuf();
+  CHECK(content.str().find("\"traceEvents\"") != std::string::npos);
+  CHECK(content.str().find("\"name\":\"outer_iteration\"") !=
+        std::string::npos);
+  in.close();
+  std::remove(path.c_str());
+}
+
+TEST_CASE("sparse qp: tracing the spans of a setup and a solve")
+{
+  isize n = 20;
+  isize n_eq = 5;
+  isize n_in = 5;
+  utils::rand::set_seed(1);
+  sparse::SparseModel<T> qp = utils::sparse_strongly_convex_qp(
+    n, n_eq, n_in, T(0.15), T(1.e-2));
+
+  sparse::QP<T, I> Qp(n, n_eq, n_in);
+  Qp.settings.eps_abs = 1.E-9;
+  trace::Recorder recorder;
+  {
+    trace::Session session(recorder);
+    Qp.init(qp.H, qp.g, qp.A, qp.b, qp.C, qp.u, qp.l);
+    Qp.solve();
+  }
+  CHECK(Qp.results.info.status == QPSolverOutput::PROXQP_SOLVED);
+  check_spans(recorder);
+  CHECK(count_spans(recorder, "refactorize") > 0);
+}
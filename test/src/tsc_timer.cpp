@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2022 INRIA
+//
+// the timers read the time stamp counter, and the phases are timed, when these
+// macros are defined (they may already be set by the build)
+#ifndef PROXSUITE_WITH_TSC_TIMER
+#define PROXSUITE_WITH_TSC_TIMER
+#endif
+#ifndef PROXSUITE_WITH_PHASE_TIMINGS
+#define PROXSUITE_WITH_PHASE_TIMINGS
+#endif
+#include <doctest.hpp>
+#include <proxsuite/proxqp/timings.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace proxsuite::proxqp;
+using T = double;
+
+TEST_CASE("timer reading the time stamp counter")
+{
+  std::int64_t t0 = detail::Clock::now();
+  std::int64_t t1 = detail::Clock::now();
+  CHECK(t1 >= t0);
+
+  Timer<T> timer;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  T running = timer.elapsed().user;
+  timer.stop();
+  T elapsed = timer.elapsed().user;
+  // in microseconds, with a loose upper bound for loaded machines
+  CHECK(running >= T(15000));
+  CHECK(elapsed >= running);
+  CHECK(elapsed <= T(1.E6));
+  // a stopped timer does not count anymore
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  CHECK(timer.elapsed().user == elapsed);
+
+  PhaseTimings<T> timings;
+  timings.clear();
+  {
+    PhaseTimer<T> phase_timer(timings, Phase::RESIDUALS);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CHECK(timings.count(Phase::RESIDUALS) == 1);
+  CHECK(timings.time(Phase::RESIDUALS) >= T(7500));
+  CHECK(timings.time(Phase::RESIDUALS) <= T(1.E6));
+}